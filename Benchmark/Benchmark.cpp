@@ -0,0 +1,630 @@
+﻿#include "Camera.h"             // Camera (Draw のベンチマーク), SetPose
+#include "CameraMath.h"         // VEC4Transform, TransformCoord, TransformPointsBatch, Frustum, TestSpheresBatch など
+#include "Clipping.h"           // ClipLineCohenSutherland, ComputeOutCode
+#include "Matrix.h"             // MatrixMultiply, PerspectiveFovLH
+#include "Profiler.h"           // PROFILER_ENABLED
+#include "Quaternion.h"         // Quaternion::operator*, ToRotationMatrix
+#include "RenderSink.h"         // RenderSink インターフェース
+#include "SceneGraph.h"         // SceneGraph (シーングラフ版の Draw)
+#include "SegmentBVH.h"         // SegmentBVH (BVH 版の Draw)
+#include "SoftwareRenderSink.h" // SoftwareRenderSink (--raster のときの描画先)
+#include "WireMesh.h"           // CreateCubeMesh (シーングラフの形状)
+#include <algorithm>            // std::sort, std::min, std::max
+#include <chrono>               // std::chrono::steady_clock
+#include <cmath>                // std::cbrt, std::lround
+#include <cstdint>              // uint64_t
+#include <cstdio>               // snprintf
+#include <cstdlib>              // strtod, strtoull
+#include <fstream>              // std::ofstream (--out)
+#include <functional>           // std::function (数学関数のベンチマークの一覧)
+#include <iostream>             // std::cout, std::cerr
+#include <random>               // std::mt19937 (入力データの生成)
+#include <string>               // std::string
+#include <thread>               // std::thread::hardware_concurrency
+#include <vector>               // std::vector
+#if defined(_MSC_VER)
+#include <intrin.h>             // _ReadWriteBarrier
+#endif
+
+/*
+ * Benchmark.cpp
+ * 役割:
+ *   数学関数 (MatrixMultiply, VEC4Transform, TransformCoord, TransformPointAffine, Quaternion::operator*, ToRotationMatrix,
+ *   ClipLineCohenSutherland) の 1 回あたりの時間と、Camera::Draw による描画パイプライン全体の
+ *   線分 1 本あたりの時間を測り、結果を JSON で出力するベンチマークです。
+ *   最適化の効果を数字で確かめたり、以前の結果と比べて性能の低下を見つけたりするために使います。
+ *
+ * 仕組み:
+ *   - DxLib を使わずにビルドします (Camera.cpp の入力関数は HeadlessDxLib/DxLib.h の何もしない関数になる)。
+ *   - 各ベンチマークは「計測する処理 (body)」を 1 回呼ぶ関数です。まず body を 1 回呼んで作業領域を
+ *     確保させ (ウォームアップ)、次に合計が --min-time 秒を超える呼び出し回数を探し、その回数で
+ *     --repetitions 回計測して、1 回あたりの時間の中央値と最小値を結果にします。
+ *   - 数学関数は 256 個の入力をまとめて処理する body で測り、1 要素あたりの時間 (ns_per_op) を出します。
+ *     結果は配列に書き出し、EscapePointer でコンパイラに「使われる値」と思わせて、計算が省かれないようにします。
+ *   - 描画は、立方体 [-500, 500]^3 に乱数で置いた線分 (10^3 本から --max-segments 本まで 10 倍ずつ) を、
+ *     固定した 3 つの視点 (inside / outside / oblique) から Camera::Draw で描き、1 フレームの時間と
+ *     線分 1 本あたりの時間 (ns_per_segment)、1 秒あたりの線分の数 (segments_per_second) を出します。
+ *     SegmentBuffer 版 (全線分を変換) と SegmentBVH 版 (視錐台カリングあり) の両方を測ります。
+ *     Draw.Replay は、カメラもシーンも変わらないときに前のフレームの描画コマンドを使い回す場合の時間です
+ *     (他の描画のベンチマークでは使い回しを無効にしています)。
+ *     Draw.Coherent は、SegmentBuffer 版で、視点から少しずつ前後に動くカメラ (1 回に 2.5、最大 80 離れる) で
+ *     描く場合の時間です。前のフレームのブロックの分類を使い回します (他の描画のベンチマークでは無効にしています)。
+ *     Draw.Graph は、同じ立方体の形状 1 つを、同じ範囲の格子の上に約 (本数 / 12) 個置いたシーングラフ
+ *     (GRAPH_GROUP_CUBES^3 個ずつグループのノードにまとめる) を描く場合の時間です。線分の本数は立方体の数 × 12 です。
+ *   - 描画先は、既定では描画コマンドを数えるだけの NullRenderSink です (パイプラインだけを測る)。
+ *     --raster を付けると SoftwareRenderSink に実際に描き、ラスタライズの時間も含めます。
+ *   - 乱数の種は固定なので、同じビルドなら毎回同じ入力で測ります。
+ *
+ * 使い方:
+ *   cmake -S Benchmark -B build-bench -DCMAKE_BUILD_TYPE=Release && cmake --build build-bench
+ *   build-bench/WireframeBenchmark --out baseline.json           // 全部 (10^7 本まで。数分かかる)
+ *   build-bench/WireframeBenchmark --quick                       // 短時間の確認 (10^5 本まで)
+ *   build-bench/WireframeBenchmark --filter Draw.BVH --threads 4 // 名前に Draw.BVH を含むものだけ、4 スレッドで
+ *
+ * 出力 (JSON):
+ *   { "context": { "simd": "AVX2", "threads": 1, ... },
+ *     "benchmarks": [
+ *       { "name": "MatrixMultiply", "kind": "micro", "iterations": ..., "ns_per_op": ..., "ns_per_op_min": ..., "ops_per_second": ... },
+ *       { "name": "Draw.BVH/inside/1000000", "kind": "draw", "segments": 1000000, "visible_segments": ...,
+ *         "iterations": ..., "ns_per_frame": ..., "ns_per_frame_min": ..., "ns_per_segment": ..., "segments_per_second": ... } ] }
+ */
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // 数学関数のベンチマークで 1 回の body が処理する入力の数
+    const size_t MICRO_BATCH = 256;
+    // 描画のベンチマークの線分の数の最小値 (ここから 10 倍ずつ増やす)
+    const size_t MIN_SCENE_SEGMENTS = 1000;
+    // 合成シーンの線分を置く立方体の半分の大きさ (Camera の farZ = 1000 に収まる程度)
+    const float SCENE_HALF_EXTENT = 500.0f;
+    // 合成シーンの線分の長さの範囲
+    const float SEGMENT_MIN_LENGTH = 1.0f;
+    const float SEGMENT_MAX_LENGTH = 20.0f;
+    // 入力データの乱数の種 (固定)
+    const unsigned int RANDOM_SEED = 12345;
+
+    // コマンドライン引数
+    struct BenchmarkOptions {
+        std::string outputPath;                // 結果の JSON の書き出し先 (空なら標準出力)
+        std::string filter;                    // 名前にこの文字列を含むベンチマークだけを実行する (空なら全部)
+        double minSeconds = 0.5;               // 1 回の計測で最低限続ける時間 (秒)
+        int repetitions = 5;                   // 計測を繰り返す回数 (中央値と最小値を採る)
+        size_t maxSegments = 10000000;         // 描画のベンチマークの線分の数の最大値
+        unsigned int threads = 1;              // Camera::SetDrawThreadCount に渡すスレッド数 (0 なら論理コア数)
+        bool raster = false;                   // true なら SoftwareRenderSink に実際に描く
+    };
+
+    // 1 つのベンチマークの結果
+    struct BenchmarkResult {
+        std::string name;            // ベンチマークの名前
+        std::string kind;            // "micro" (数学関数) / "draw" (Camera::Draw)
+        uint64_t iterations = 0;     // 1 回の計測での body の呼び出し回数
+        double nsPerCall = 0.0;      // body 1 回あたりの時間 (中央値)
+        double nsPerCallMin = 0.0;   // body 1 回あたりの時間 (最小値)
+        uint64_t itemsPerCall = 0;   // body 1 回で処理する要素の数 (micro: 入力の数, draw: 線分の数)
+        size_t visibleSegments = 0;  // draw: 描画コマンドとして記録された線分の数
+    };
+
+    // 値を書き込んだ領域をコンパイラから見えない使い道に渡し、計算や書き込みが省かれないようにする
+#if defined(_MSC_VER)
+    const void* volatile escapeSink = nullptr;
+    inline void EscapePointer(const void* p) { escapeSink = p; _ReadWriteBarrier(); }
+#else
+    inline void EscapePointer(const void* p) { asm volatile("" : : "g"(p) : "memory"); }
+#endif
+
+    // body を iterations 回呼んだ時間 (ナノ秒)
+    template <typename Body>
+    double TimeCalls(Body& body, uint64_t iterations) {
+        const Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) { body(); }
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // body の 1 回あたりの時間を測る
+    template <typename Body>
+    void Measure(Body body, const BenchmarkOptions& options, BenchmarkResult& result) {
+        body(); // ウォームアップ (作業領域の確保、キャッシュへの読み込み)
+
+        // 合計が minSeconds を超える呼び出し回数を探す
+        const double minNs = options.minSeconds * 1e9;
+        uint64_t iterations = 1;
+        for (;;) {
+            const double ns = TimeCalls(body, iterations);
+            if (ns >= minNs || iterations >= (uint64_t(1) << 40)) { break; }
+            // 目標の時間に届くように回数を増やす (1 回で増やすのは 2～10 倍)
+            const double scale = (ns > 0.0) ? std::min(10.0, std::max(2.0, minNs * 1.2 / ns)) : 10.0;
+            iterations = static_cast<uint64_t>(iterations * scale) + 1;
+        }
+
+        std::vector<double> perCall;
+        for (int r = 0; r < options.repetitions; ++r) {
+            perCall.push_back(TimeCalls(body, iterations) / static_cast<double>(iterations));
+        }
+        std::sort(perCall.begin(), perCall.end());
+        result.iterations = iterations;
+        result.nsPerCall = perCall[perCall.size() / 2];
+        result.nsPerCallMin = perCall.front();
+    }
+
+    // name を実行するかどうか (--filter)
+    bool Selected(const std::string& name, const BenchmarkOptions& options) {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    // 経過を標準エラーに 1 行出す (JSON は標準出力かファイルに出すので混ざらない)
+    void ReportProgress(const BenchmarkResult& r) {
+        char line[256];
+        if (r.kind == "draw") {
+            snprintf(line, sizeof(line), "%-36s %12.1f us/frame %9.2f ns/segment %8zu visible\n",
+                r.name.c_str(), r.nsPerCall / 1000.0, r.nsPerCall / r.itemsPerCall, r.visibleSegments);
+        }
+        else {
+            snprintf(line, sizeof(line), "%-36s %12.2f ns/op\n", r.name.c_str(), r.nsPerCall / r.itemsPerCall);
+        }
+        std::cerr << line;
+    }
+
+    // --- 入力データの生成 ---
+
+    // 単位球面上の一様な方向
+    Vector3D RandomDirection(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (;;) {
+            const Vector3D v = { unit(rng), unit(rng), unit(rng) };
+            const float lengthSq = v.x * v.x + v.y * v.y + v.z * v.z;
+            if (lengthSq > 1e-4f && lengthSq <= 1.0f) { return v.Normalized(); }
+        }
+    }
+
+    // ランダムな回転のクォータニオン
+    Quaternion RandomRotation(std::mt19937& rng) {
+        std::uniform_real_distribution<float> angle(-PI, PI);
+        return Quaternion::FromAxisAngle(RandomDirection(rng), angle(rng));
+    }
+
+    // ランダムな回転と平行移動の行列 (ワールド行列に近い値)
+    Matrix RandomAffine(std::mt19937& rng) {
+        std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+        Matrix m = RandomRotation(rng).ToRotationMatrix();
+        m.m[3][0] = offset(rng);
+        m.m[3][1] = offset(rng);
+        m.m[3][2] = offset(rng);
+        return m;
+    }
+
+    // ベンチマーク用の固定のビュー・プロジェクション行列 (原点から +Z を見る)
+    Matrix BenchmarkViewProjection() {
+        Matrix view = Matrix::Identity();
+        view.m[3][2] = 50.0f; // カメラは (0, 0, -50)
+        return MatrixMultiply(view, PerspectiveFovLH(60.0f * ONE_DEGREE, WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 1000.0f));
+    }
+
+    // 立方体 [-SCENE_HALF_EXTENT, SCENE_HALF_EXTENT]^3 に、count 本の線分をランダムに置く
+    SegmentBuffer GenerateScene(size_t count, unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coordinate(-SCENE_HALF_EXTENT, SCENE_HALF_EXTENT);
+        std::uniform_real_distribution<float> length(SEGMENT_MIN_LENGTH, SEGMENT_MAX_LENGTH);
+        SegmentBuffer scene;
+        scene.Reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Vector3D start = { coordinate(rng), coordinate(rng), coordinate(rng) };
+            scene.Append(start, start + RandomDirection(rng) * length(rng));
+        }
+        return scene;
+    }
+
+    // 立方体 [-SCENE_HALF_EXTENT, SCENE_HALF_EXTENT]^3 を 1 辺 n 個の格子に分け、各セルに立方体を 1 つずつ置いたシーングラフを作る
+    // (n は立方体の辺の合計がほぼ count 本になるように選ぶ)。立方体は 1 つの形状を共有し、ノードごとに Y 軸周りに乱数で回す。
+    // 隣り合う GRAPH_GROUP_CUBES^3 個のセルを 1 つのグループのノードにまとめ、立方体はグループからの相対位置に置く。
+    const int GRAPH_GROUP_CUBES = 4;
+    void GenerateGraphScene(size_t count, unsigned int seed, SceneGraph& graph) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> angle(0.0f, 2.0f * PI);
+        const int n = std::max(1, static_cast<int>(std::lround(std::cbrt(static_cast<double>(count) / 12.0))));
+        const float cellSize = 2.0f * SCENE_HALF_EXTENT / static_cast<float>(n);
+        graph.Clear();
+        const uint32_t cube = graph.AddGeometry(CreateCubeMesh(cellSize * 0.5f, { 0.0f, 0.0f, 0.0f }));
+        for (int gz = 0; gz < n; gz += GRAPH_GROUP_CUBES) {
+            for (int gy = 0; gy < n; gy += GRAPH_GROUP_CUBES) {
+                for (int gx = 0; gx < n; gx += GRAPH_GROUP_CUBES) {
+                    // グループの原点は、グループの最初のセルの角
+                    const uint32_t group = graph.AddNode(SceneGraph::NO_NODE, GetMatrixTranslation(
+                        -SCENE_HALF_EXTENT + cellSize * gx, -SCENE_HALF_EXTENT + cellSize * gy, -SCENE_HALF_EXTENT + cellSize * gz));
+                    for (int z = gz; z < std::min(n, gz + GRAPH_GROUP_CUBES); ++z) {
+                        for (int y = gy; y < std::min(n, gy + GRAPH_GROUP_CUBES); ++y) {
+                            for (int x = gx; x < std::min(n, gx + GRAPH_GROUP_CUBES); ++x) {
+                                const Matrix local = MatrixMultiply<MatrixShape::Affine>(GetMatrixAxisYLH(angle(rng)), GetMatrixTranslation(
+                                    cellSize * (x - gx + 0.5f), cellSize * (y - gy + 0.5f), cellSize * (z - gz + 0.5f)));
+                                graph.AddNode(group, local, cube);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // --- 数学関数のベンチマーク ---
+
+    void RunMicroBenchmarks(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+        std::mt19937 rng(RANDOM_SEED);
+        std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+
+        std::vector<Matrix> matricesA(MICRO_BATCH), matricesB(MICRO_BATCH), outMatrices(MICRO_BATCH);
+        std::vector<Quaternion> quaternionsA(MICRO_BATCH), quaternionsB(MICRO_BATCH), outQuaternions(MICRO_BATCH);
+        std::vector<Vector4D> points4(MICRO_BATCH), outPoints4(MICRO_BATCH);
+        std::vector<Vector3D> points3(MICRO_BATCH), outPoints3(MICRO_BATCH);
+        std::vector<Vector3DA> points3A(MICRO_BATCH), outPoints3A(MICRO_BATCH);
+        for (size_t i = 0; i < MICRO_BATCH; ++i) {
+            matricesA[i] = RandomAffine(rng);
+            matricesB[i] = RandomAffine(rng);
+            quaternionsA[i] = RandomRotation(rng);
+            quaternionsB[i] = RandomRotation(rng);
+            points3[i] = { coordinate(rng), coordinate(rng), coordinate(rng) + 300.0f }; // 大半がカメラの前方
+            points4[i] = Vector4D(points3[i].x, points3[i].y, points3[i].z, 1.0f);
+            points3A[i] = Vector3DA(points3[i]);
+        }
+        const Matrix viewProjection = BenchmarkViewProjection();
+
+        // ClipLineCohenSutherland の入力: 視錐台の境界をまたぐ (切り取りが必要な) 線分だけを集める
+        std::vector<Vector4D> clipStarts, clipEnds;
+        while (clipStarts.size() < MICRO_BATCH) {
+            const Vector4D a = VEC4Transform(Vector4D(coordinate(rng), coordinate(rng), coordinate(rng) + 100.0f, 1.0f), viewProjection);
+            const Vector4D b = VEC4Transform(Vector4D(coordinate(rng), coordinate(rng), coordinate(rng) + 100.0f, 1.0f), viewProjection);
+            const int outcodeA = ComputeOutCode(a), outcodeB = ComputeOutCode(b);
+            if ((outcodeA | outcodeB) != 0 && (outcodeA & outcodeB) == 0) {
+                clipStarts.push_back(a);
+                clipEnds.push_back(b);
+            }
+        }
+        std::vector<Vector4D> outClipStarts(MICRO_BATCH), outClipEnds(MICRO_BATCH);
+        std::vector<uint8_t> outAccepted(MICRO_BATCH);
+
+        // 一括変換 (Camera::Draw の内部で使う) の入力
+        std::vector<float> xs(MICRO_BATCH), ys(MICRO_BATCH), zs(MICRO_BATCH);
+        for (size_t i = 0; i < MICRO_BATCH; ++i) { xs[i] = points3[i].x; ys[i] = points3[i].y; zs[i] = points3[i].z; }
+        std::vector<float> outX(MICRO_BATCH), outY(MICRO_BATCH), outZ(MICRO_BATCH), outW(MICRO_BATCH);
+        const SimdLevel simdLevel = DetectSimdLevel();
+        // 視錐台と境界球・AABB の一括判定の入力 (中心の周りに半径 / 半分の大きさ 1～20 の球と箱)
+        const Frustum frustum = Frustum::FromViewProjection(viewProjection);
+        std::uniform_real_distribution<float> extent(1.0f, 20.0f);
+        std::vector<float> boundsX(MICRO_BATCH), boundsY(MICRO_BATCH), boundsZ(MICRO_BATCH), boundsR(MICRO_BATCH);
+        std::vector<float> minXs(MICRO_BATCH), minYs(MICRO_BATCH), minZs(MICRO_BATCH), maxXs(MICRO_BATCH), maxYs(MICRO_BATCH), maxZs(MICRO_BATCH);
+        for (size_t i = 0; i < MICRO_BATCH; ++i) {
+            boundsX[i] = coordinate(rng); boundsY[i] = coordinate(rng); boundsZ[i] = coordinate(rng) + 100.0f;
+            boundsR[i] = extent(rng);
+            minXs[i] = boundsX[i] - boundsR[i]; minYs[i] = boundsY[i] - boundsR[i]; minZs[i] = boundsZ[i] - boundsR[i];
+            maxXs[i] = boundsX[i] + boundsR[i]; maxYs[i] = boundsY[i] + boundsR[i]; maxZs[i] = boundsZ[i] + boundsR[i];
+        }
+        std::vector<FrustumTest> outTests(MICRO_BATCH);
+
+        // Camera::Update (入力なし) とビュー・プロジェクション行列の取得 (毎フレーム Draw の前に行う処理)
+        Camera camera;
+
+        struct MicroBenchmark {
+            const char* name;
+            std::function<void()> body;
+        };
+        const MicroBenchmark benchmarks[] = {
+            { "MatrixMultiply", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outMatrices[i] = MatrixMultiply(matricesA[i], matricesB[i]); }
+                EscapePointer(outMatrices.data());
+            } },
+            { "MatrixMultiply<Affine>", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outMatrices[i] = MatrixMultiply<MatrixShape::Affine>(matricesA[i], matricesB[i]); }
+                EscapePointer(outMatrices.data());
+            } },
+            { "VEC4Transform", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outPoints4[i] = VEC4Transform(points4[i], viewProjection); }
+                EscapePointer(outPoints4.data());
+            } },
+            { "TransformCoord", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outPoints3[i] = TransformCoord(points3[i], viewProjection); }
+                EscapePointer(outPoints3.data());
+            } },
+            { "TransformPointAffine", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outPoints3A[i] = TransformPointAffine(points3A[i], matricesA[i]); }
+                EscapePointer(outPoints3A.data());
+            } },
+            { "TransformPointsBatch", [&]() {
+                TransformPointsBatch(xs.data(), ys.data(), zs.data(), MICRO_BATCH, viewProjection,
+                    outX.data(), outY.data(), outZ.data(), outW.data(), simdLevel);
+                EscapePointer(outX.data());
+                EscapePointer(outW.data());
+            } },
+            { "Quaternion::operator*", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outQuaternions[i] = quaternionsA[i] * quaternionsB[i]; }
+                EscapePointer(outQuaternions.data());
+            } },
+            { "Quaternion::ToRotationMatrix", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) { outMatrices[i] = quaternionsA[i].ToRotationMatrix(); }
+                EscapePointer(outMatrices.data());
+            } },
+            { "TestSpheresBatch", [&]() {
+                TestSpheresBatch(frustum, boundsX.data(), boundsY.data(), boundsZ.data(), boundsR.data(), MICRO_BATCH, outTests.data(), simdLevel);
+                EscapePointer(outTests.data());
+            } },
+            { "TestAABBsBatch", [&]() {
+                TestAABBsBatch(frustum, minXs.data(), minYs.data(), minZs.data(), maxXs.data(), maxYs.data(), maxZs.data(),
+                    MICRO_BATCH, outTests.data(), simdLevel);
+                EscapePointer(outTests.data());
+            } },
+            { "Camera::Update+GetViewProjectionMatrix", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) {
+                    camera.Update();
+                    EscapePointer(&camera.GetViewProjectionMatrix());
+                }
+            } },
+            { "ClipLineCohenSutherland", [&]() {
+                for (size_t i = 0; i < MICRO_BATCH; ++i) {
+                    Vector4D a = clipStarts[i], b = clipEnds[i];
+                    outAccepted[i] = ClipLineCohenSutherland(a, b) ? 1 : 0;
+                    outClipStarts[i] = a;
+                    outClipEnds[i] = b;
+                }
+                EscapePointer(outAccepted.data());
+                EscapePointer(outClipStarts.data());
+                EscapePointer(outClipEnds.data());
+            } },
+        };
+
+        for (const MicroBenchmark& benchmark : benchmarks) {
+            if (!Selected(benchmark.name, options)) { continue; }
+            BenchmarkResult result;
+            result.name = benchmark.name;
+            result.kind = "micro";
+            result.itemsPerCall = MICRO_BATCH;
+            Measure(benchmark.body, options, result);
+            ReportProgress(result);
+            results.push_back(result);
+        }
+    }
+
+    // --- 描画のベンチマーク ---
+
+    // 描画コマンドを数えるだけの描画先 (パイプラインの時間だけを測るため、ラスタライズしない)
+    class NullRenderSink : public RenderSink
+    {
+    public:
+        void Clear() override {}
+        void DrawLine(int, int, int, int, RenderColor) override { ++lineCount; }
+        void DrawLineAA(float, float, float, float, RenderColor) override { ++lineCount; }
+        void DrawBox(int, int, int, int, RenderColor, bool) override {}
+        void DrawCircle(int, int, int, RenderColor, bool) override {}
+        void DrawString(int, int, const char*, RenderColor) override {}
+        void SetBlendAlpha(int) override {}
+        void SetClipRect(int, int, int, int) override {}
+        void ResetClipRect() override {}
+        void Submit(const DrawCommandList& commands) override { lineCount += commands.Size(); }
+
+        size_t lineCount = 0; // 受け取った線の数 (最適化で描画の呼び出しが省かれないように数えておく)
+    };
+
+    // 固定の視点
+    struct CameraPose {
+        const char* name;
+        Vector3D position;
+        Quaternion orientation;
+    };
+
+    std::vector<CameraPose> BenchmarkPoses() {
+        // oblique: 立方体の角の外側から、中心の方へ斜めに見下ろす (ヨー 45 度のあと、右方向の軸で下に 30 度)
+        const Quaternion yaw = Quaternion::FromAxisAngle({ 0.0f, 1.0f, 0.0f }, 45.0f * ONE_DEGREE);
+        const Vector3D right = VEC3Transform({ 1.0f, 0.0f, 0.0f }, yaw.ToRotationMatrix());
+        const Quaternion pitch = Quaternion::FromAxisAngle(right, 30.0f * ONE_DEGREE);
+        return {
+            // inside: シーンの中心から +Z を見る (線分の一部だけが視錐台に入る)
+            { "inside", { 0.0f, 0.0f, 0.0f }, Quaternion::Identity() },
+            // outside: シーンの手前から +Z を見る (立方体の大半が視錐台に入り、奥は farZ で切られる)
+            { "outside", { 0.0f, 0.0f, -1.5f * SCENE_HALF_EXTENT }, Quaternion::Identity() },
+            { "oblique", { -1.2f * SCENE_HALF_EXTENT, 0.8f * SCENE_HALF_EXTENT, -1.2f * SCENE_HALF_EXTENT }, pitch * yaw },
+        };
+    }
+
+    // 描画のベンチマークの種類 (名前の先頭)
+    //   Draw.Buffer: SegmentBuffer 版 (全線分を変換), Draw.BVH: SegmentBVH 版 (視錐台カリングあり),
+    //   Draw.Replay: SegmentBVH 版で、カメラもシーンも変わらないので前のフレームの描画コマンドを使い回す場合
+    //   Draw.Coherent: SegmentBuffer 版で、カメラが少しずつ動き、前のフレームのブロックの分類を使い回す場合
+    //   Draw.Graph: SceneGraph 版で、1 つの形状を共有する立方体をノードごとの変換行列で置いたシーン
+    const char* const DRAW_VARIANT_NAMES[] = { "Draw.Buffer/", "Draw.BVH/", "Draw.Replay/", "Draw.Coherent/", "Draw.Graph/" };
+    const int DRAW_VARIANT_COUNT = sizeof(DRAW_VARIANT_NAMES) / sizeof(DRAW_VARIANT_NAMES[0]);
+    // Draw.Coherent でカメラを 1 回の描画ごとに動かす距離と、折り返すまでの回数
+    // (60fps で MOVE_SPEED 150/秒 の移動に相当する 2.5 ずつ、32 回進んで 32 回戻る)
+    const float COHERENT_STEP = 2.5f;
+    const int COHERENT_HALF_PERIOD = 32;
+
+    void RunDrawBenchmarks(const BenchmarkOptions& options, std::vector<BenchmarkResult>& results) {
+        Camera camera;
+        camera.SetDrawThreadCount(options.threads);
+        NullRenderSink nullSink;
+        SoftwareRenderSink softwareSink(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT));
+        RenderSink& sink = options.raster ? static_cast<RenderSink&>(softwareSink) : static_cast<RenderSink&>(nullSink);
+        const std::vector<CameraPose> poses = BenchmarkPoses();
+
+        for (size_t count = MIN_SCENE_SEGMENTS; count <= options.maxSegments; count *= 10) {
+            const std::string suffix = "/" + std::to_string(count);
+            // この本数のベンチマークが 1 つも選ばれていなければ、シーンを作らずに次へ
+            bool anySelected = false;
+            for (const CameraPose& pose : poses) {
+                for (const char* variantName : DRAW_VARIANT_NAMES) {
+                    anySelected = anySelected || Selected(std::string(variantName) + pose.name + suffix, options);
+                }
+            }
+            if (!anySelected) { continue; }
+
+            const SegmentBuffer scene = GenerateScene(count, RANDOM_SEED + static_cast<unsigned int>(count));
+            SegmentBVH bvh;
+            bool bvhBuilt = false;
+            SceneGraph graph;
+            bool graphBuilt = false;
+
+            for (const CameraPose& pose : poses) {
+                camera.SetPose(pose.position, pose.orientation);
+                for (int variant = 0; variant < DRAW_VARIANT_COUNT; ++variant) {
+                    const bool useBvh = (variant == 1 || variant == 2);
+                    const bool replay = (variant == 2);
+                    const bool coherent = (variant == 3);
+                    const bool useGraph = (variant == 4);
+                    BenchmarkResult result;
+                    result.name = std::string(DRAW_VARIANT_NAMES[variant]) + pose.name + suffix;
+                    if (!Selected(result.name, options)) { continue; }
+                    // Replay 以外は、カメラが動かなくても毎回変換・クリッピングさせる
+                    camera.SetDrawCacheEnabled(replay);
+                    // Coherent 以外は、前のフレームのブロックの分類も使わずに毎回アウトコードを計算させる
+                    camera.SetVisibilityCacheEnabled(coherent);
+                    if (useBvh && !bvhBuilt) {
+                        bvh.Build(scene, camera.GetDrawThreadPool());
+                        bvhBuilt = true;
+                    }
+                    if (useGraph && !graphBuilt) {
+                        GenerateGraphScene(count, RANDOM_SEED + static_cast<unsigned int>(count), graph);
+                        graphBuilt = true;
+                    }
+                    result.kind = "draw";
+                    result.itemsPerCall = count;
+                    if (useBvh) { Measure([&]() { camera.Draw(bvh, sink); }, options, result); }
+                    else if (useGraph) {
+                        // 線分の本数は、形状を持つノードの辺の数の合計 (count とは少し違う)
+                        result.itemsPerCall = 0;
+                        for (uint32_t node = 0; node < graph.NodeCount(); ++node) {
+                            const uint32_t geometry = graph.GetNodeGeometry(node);
+                            if (geometry != SceneGraph::NO_GEOMETRY) { result.itemsPerCall += graph.GetGeometry(geometry).EdgeCount(); }
+                        }
+                        Measure([&]() { camera.Draw(graph, sink); }, options, result);
+                    }
+                    else if (coherent) {
+                        // 前方に少しずつ進み、COHERENT_HALF_PERIOD 回ごとに折り返す (視点から離れすぎないように)
+                        const Vector3D forward = camera.GetForwardVector();
+                        int frame = 0;
+                        Measure([&]() {
+                            const int phase = frame++ % (2 * COHERENT_HALF_PERIOD);
+                            const int steps = (phase < COHERENT_HALF_PERIOD) ? phase : 2 * COHERENT_HALF_PERIOD - phase;
+                            camera.SetPose(pose.position + forward * (COHERENT_STEP * steps), pose.orientation);
+                            camera.Draw(scene, sink);
+                        }, options, result);
+                        camera.SetPose(pose.position, pose.orientation);
+                    }
+                    else { Measure([&]() { camera.Draw(scene, sink); }, options, result); }
+                    result.visibleSegments = camera.GetDrawCommands().Size();
+                    ReportProgress(result);
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    // --- 結果の出力 ---
+
+    const char* SimdLevelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    std::string CompilerName() {
+#if defined(_MSC_VER)
+        return "MSVC " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+        return std::string("Clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        return std::string("GCC ") + __VERSION__;
+#else
+        return "unknown";
+#endif
+    }
+
+    void WriteJson(std::ostream& out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+        char buffer[512];
+        out << "{\n  \"context\": {";
+        snprintf(buffer, sizeof(buffer),
+            "\"compiler\": \"%s\", \"simd\": \"%s\", \"threads\": %u, \"raster\": %s, \"profiler\": %s, "
+            "\"min_time_s\": %.3f, \"repetitions\": %d, \"micro_batch\": %zu",
+            CompilerName().c_str(), SimdLevelName(DetectSimdLevel()), options.threads, options.raster ? "true" : "false",
+            PROFILER_ENABLED ? "true" : "false", options.minSeconds, options.repetitions, MICRO_BATCH);
+        out << buffer << "},\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            const double nsPerItem = r.nsPerCall / r.itemsPerCall;
+            if (r.kind == "draw") {
+                snprintf(buffer, sizeof(buffer),
+                    "    {\"name\": \"%s\", \"kind\": \"draw\", \"segments\": %llu, \"visible_segments\": %zu, \"iterations\": %llu, "
+                    "\"ns_per_frame\": %.1f, \"ns_per_frame_min\": %.1f, \"ns_per_segment\": %.3f, \"segments_per_second\": %.0f}",
+                    r.name.c_str(), static_cast<unsigned long long>(r.itemsPerCall), r.visibleSegments,
+                    static_cast<unsigned long long>(r.iterations), r.nsPerCall, r.nsPerCallMin, nsPerItem, 1e9 / nsPerItem);
+            }
+            else {
+                snprintf(buffer, sizeof(buffer),
+                    "    {\"name\": \"%s\", \"kind\": \"micro\", \"iterations\": %llu, "
+                    "\"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, \"ops_per_second\": %.0f}",
+                    r.name.c_str(), static_cast<unsigned long long>(r.iterations * r.itemsPerCall),
+                    nsPerItem, r.nsPerCallMin / r.itemsPerCall, 1e9 / nsPerItem);
+            }
+            out << buffer << ((i + 1 < results.size()) ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+    void PrintUsage() {
+        std::cerr <<
+            "usage: WireframeBenchmark [options]\n"
+            "  --out <path>          結果の JSON をファイルに書き出す (省略時は標準出力)\n"
+            "  --filter <text>       名前に text を含むベンチマークだけを実行する\n"
+            "  --min-time <seconds>  1 回の計測で最低限続ける時間 (既定 0.5)\n"
+            "  --repetitions <n>     計測を繰り返す回数 (既定 5。中央値を結果にする)\n"
+            "  --max-segments <n>    描画のベンチマークの線分の数の最大値 (既定 10000000)\n"
+            "  --threads <n>         Camera::Draw のスレッド数 (既定 1。0 なら論理コア数)\n"
+            "  --raster              SoftwareRenderSink に実際に描く (既定は描画コマンドを数えるだけ)\n"
+            "  --quick               短時間の確認用 (--min-time 0.05 --repetitions 3 --max-segments 100000)\n";
+    }
+
+    // コマンドライン引数を読む (不正な引数があれば false)
+    bool ParseOptions(int argc, char** argv, BenchmarkOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = (i + 1 < argc);
+            if (arg == "--out" && hasValue) { options.outputPath = argv[++i]; }
+            else if (arg == "--filter" && hasValue) { options.filter = argv[++i]; }
+            else if (arg == "--min-time" && hasValue) { options.minSeconds = std::strtod(argv[++i], nullptr); }
+            else if (arg == "--repetitions" && hasValue) { options.repetitions = std::max(1, std::atoi(argv[++i])); }
+            else if (arg == "--max-segments" && hasValue) { options.maxSegments = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10)); }
+            else if (arg == "--threads" && hasValue) { options.threads = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)); }
+            else if (arg == "--raster") { options.raster = true; }
+            else if (arg == "--quick") { options.minSeconds = 0.05; options.repetitions = 3; options.maxSegments = 100000; }
+            else { return false; }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (options.threads == 0) { // 0 のときは Camera と同じく論理コア数にして、実際の数を記録する
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<BenchmarkResult> results;
+    RunMicroBenchmarks(options, results);
+    RunDrawBenchmarks(options, results);
+
+    if (options.outputPath.empty()) {
+        WriteJson(std::cout, options, results);
+        return 0;
+    }
+    std::ofstream out(options.outputPath);
+    if (out) { WriteJson(out, options, results); }
+    if (!out) {
+        std::cerr << "結果を書き込めませんでした: " << options.outputPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/*
+ * HeadlessDxLib/DxLib.h
+ * 役割:
+ *   ベンチマーク (Benchmark.cpp) を DxLib なしでビルドするための、DxLib.h の代わりのヘッダーです。
+ *   Camera.cpp が使う入力関数 (マウスとキーボード) だけを、何もしない関数として定義します。
+ *   描画は RenderSink (SoftwareRenderSink など) を通すので、描画関数の代わりは必要ありません。
+ *
+ * 仕組み:
+ *   Benchmark/CMakeLists.txt で、このディレクトリを Project1 より先にインクルードパスに加えています。
+ *   Camera.cpp の `#include "DxLib.h"` はこのファイルに解決されます。
+ *   入力は常に「何も押されていない・マウスは画面中央」なので、Camera::Update はカメラを動かしません
+ *   (ベンチマークでは Camera::SetPose で視点を固定します)。
+ */
+
+// キーコード (DxLib と同じ値。CheckHitKey は常に 0 を返すので、値そのものは使われない)
+#define KEY_INPUT_Q        0x10
+#define KEY_INPUT_W        0x11
+#define KEY_INPUT_E        0x12
+#define KEY_INPUT_LCONTROL 0x1D
+#define KEY_INPUT_A        0x1E
+#define KEY_INPUT_S        0x1F
+#define KEY_INPUT_D        0x20
+#define KEY_INPUT_SPACE    0x39
+
+// マウスカーソルの位置 (SetMousePoint で設定した位置をそのまま GetMousePoint で返す)
+namespace HeadlessDxLib {
+    inline int& MouseX() { static int x = 0; return x; }
+    inline int& MouseY() { static int y = 0; return y; }
+}
+
+inline int SetMousePoint(int pointX, int pointY) {
+    HeadlessDxLib::MouseX() = pointX;
+    HeadlessDxLib::MouseY() = pointY;
+    return 0;
+}
+
+inline int GetMousePoint(int* xBuf, int* yBuf) {
+    if (xBuf != nullptr) { *xBuf = HeadlessDxLib::MouseX(); }
+    if (yBuf != nullptr) { *yBuf = HeadlessDxLib::MouseY(); }
+    return 0;
+}
+
+// キーは常に押されていない
+inline int CheckHitKey(int /*keyCode*/) { return 0; }
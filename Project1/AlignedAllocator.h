@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>  // std::size_t
+#include <cstdlib>  // std::malloc, std::free
+#include <cstdint>  // std::uintptr_t
+#include <new>      // std::bad_alloc
+#include <limits>   // std::numeric_limits (max_size 用)
+
+/*
+ * AlignedAllocator.h
+ * 役割:
+ *   `std::vector` などの標準コンテナに渡して、確保されるメモリの先頭アドレスを
+ *   指定したバイト境界 (例: 32バイト) に揃えるためのアロケータを定義します。
+ *   SSE (16バイト) や AVX (32バイト) の整列ロード/ストア命令は、データの先頭が
+ *   境界に揃っていることを前提にしているため、SIMD で処理する配列の格納に使います。
+ *
+ * 実装について:
+ *   - C++14 (このプロジェクトの既定の言語モード) では、整列指定付きの operator new が
+ *     使えないため、`std::malloc` で少し多めに確保し、先頭をずらして境界に合わせています。
+ *   - ずらす前の元のポインタは、返すアドレスの直前に保存しておき、解放時に取り出します。
+ *
+ * 使い方:
+ *   std::vector<float, AlignedAllocator<float, 32>> xs; // 先頭が 32 バイト境界に揃う float 配列
+ */
+
+template <typename T, std::size_t Alignment>
+class AlignedAllocator
+{
+    // Alignment は 2 のべき乗で、かつポインタ 1 個分以上である必要がある
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment は 2 のべき乗である必要があります。");
+    static_assert(Alignment >= sizeof(void*), "Alignment はポインタサイズ以上である必要があります。");
+
+public:
+    typedef T value_type;
+
+    // 別の型用の同じアロケータを得るための仕組み (std::vector の内部で使われる)
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator() noexcept {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    // n 個分の T を格納できる、境界に揃ったメモリを確保する
+    T* allocate(std::size_t n) {
+        if (n > max_size()) { throw std::bad_alloc(); }
+        // 境界合わせの余白 + 元ポインタ保存領域の分だけ多めに確保する
+        std::size_t bytes = n * sizeof(T) + Alignment + sizeof(void*);
+        void* raw = std::malloc(bytes);
+        if (!raw) { throw std::bad_alloc(); }
+        // 元ポインタを保存する領域を確保した後ろの位置から、次の境界まで進める
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        std::uintptr_t aligned = (start + (Alignment - 1)) & ~static_cast<std::uintptr_t>(Alignment - 1);
+        // 返すアドレスの直前に、malloc が返した元のポインタを保存しておく
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    // allocate で確保したメモリを解放する
+    void deallocate(T* p, std::size_t) noexcept {
+        if (p) { std::free(reinterpret_cast<void**>(p)[-1]); }
+    }
+
+    std::size_t max_size() const noexcept {
+        return (std::numeric_limits<std::size_t>::max() - Alignment - sizeof(void*)) / sizeof(T);
+    }
+};
+
+// 状態を持たないアロケータなので、同じ Alignment 同士なら常に等しい
+template <typename T, typename U, std::size_t A>
+inline bool operator==(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) noexcept { return true; }
+template <typename T, typename U, std::size_t A>
+inline bool operator!=(const AlignedAllocator<T, A>&, const AlignedAllocator<U, A>&) noexcept { return false; }
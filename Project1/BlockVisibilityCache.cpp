@@ -0,0 +1,113 @@
+#include "BlockVisibilityCache.h" // 対応するヘッダーファイル
+#include <cmath>                  // std::sqrt
+
+/*
+ * BlockVisibilityCache.cpp
+ * 概要:
+ *   BlockVisibilityCache クラスの実装です。
+ *   分類の計算 (余裕と最大距離) は変換済みの点を持っている WireframePipeline が行い、
+ *   ここでは記録と、今のカメラの状態で使い回せるかどうかの判定だけを行います。
+ */
+
+// 余裕の 1e-4 倍程度は、クリップ座標の計算の誤差で変わり得るとみなす
+const float BlockVisibilityCache::MARGIN_TOLERANCE = 1e-4f;
+
+// 今回のカメラの状態を設定する
+void BlockVisibilityCache::SetPose(const FrustumPose& newPose)
+{
+    // レンズの設定が変わると視錐台の形が変わり、余裕の前提 (カメラに固定された視錐台) が成り立たない
+    if (hasPose && (newPose.fovY != pose.fovY || newPose.aspectRatio != pose.aspectRatio ||
+        newPose.nearZ != pose.nearZ || newPose.farZ != pose.farZ)) {
+        Invalidate();
+    }
+    pose = newPose;
+    hasPose = true;
+}
+
+// Run の準備
+void BlockVisibilityCache::BeginRun(const void* newSource, uint64_t newSourceVersion, const std::vector<SegmentRange>& blocks)
+{
+    // 線分の入れ物か内容が変わっていたら、どのブロックの記録も使えない
+    if (newSource != source || newSourceVersion != sourceVersion) {
+        entries.clear();
+        source = newSource;
+        sourceVersion = newSourceVersion;
+    }
+    // 前回と同じ範囲のブロックの記録を引き継ぐ。ブロックは線分の順番に並んでいる (BVH の範囲も木の順番) ので、
+    // 前回の記録を先頭から 1 回たどるだけで探せる。視錐台に入る範囲が増減しても、変わらなかった範囲は使い回せる。
+    previousEntries.swap(entries);
+    entries.resize(blocks.size());
+    size_t previous = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const SegmentRange& block = blocks[i];
+        while (previous < previousEntries.size() && previousEntries[previous].first < block.first) { ++previous; }
+        Entry& entry = entries[i];
+        if (previous < previousEntries.size() && previousEntries[previous].first == block.first &&
+            previousEntries[previous].count == block.count) {
+            entry = previousEntries[previous];
+        }
+        else {
+            entry = Entry();
+            entry.first = block.first;
+            entry.count = block.count;
+        }
+        entry.reused = false;
+    }
+}
+
+// 前の分類が今回も使えるか判定する
+BlockVisibility BlockVisibilityCache::TryReuse(size_t block)
+{
+    Entry& entry = entries[block];
+    if (!hasPose || (entry.visibility != BlockVisibility::Inside && entry.visibility != BlockVisibility::Outside)) {
+        return BlockVisibility::Unknown;
+    }
+
+    // 分類したときからのカメラの移動量
+    const float moved = (pose.position - entry.position).Length();
+    // 向きの差: q と -q は同じ回転なので、近い方の符号で差を取る
+    const Quaternion& q0 = entry.orientation;
+    const Quaternion& q1 = pose.orientation;
+    const float sign = (q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w < 0.0f) ? -1.0f : 1.0f;
+    const float dx = q1.x - sign * q0.x, dy = q1.y - sign * q0.y, dz = q1.z - sign * q0.z, dw = q1.w - sign * q0.w;
+    const float chord = 2.0f * std::sqrt(dx * dx + dy * dy + dz * dz + dw * dw); // 平面の法線が動く量の上限
+
+    // どの点についても、平面までの距離の変化はこれ以下 (BlockVisibilityCache.h)
+    const float reach = entry.maxDistance + moved; // 今のカメラから最も遠い点までの距離の上限
+    const float drift = moved + chord * reach;
+    if (entry.margin <= drift + MARGIN_TOLERANCE * reach) { return BlockVisibility::Unknown; }
+
+    entry.reused = true;
+    return entry.visibility;
+}
+
+// 分類の結果を記録する
+void BlockVisibilityCache::Store(size_t block, BlockVisibility visibility, float margin, float maxDistance)
+{
+    Entry& entry = entries[block];
+    entry.visibility = visibility;
+    entry.reused = false;
+    entry.margin = margin;
+    entry.maxDistance = maxDistance;
+    entry.position = pose.position;
+    entry.orientation = pose.orientation;
+}
+
+// 全ての分類を捨てる
+void BlockVisibilityCache::Invalidate()
+{
+    entries.clear();
+    previousEntries.clear();
+    source = nullptr;
+    sourceVersion = 0;
+}
+
+// 直前の Run で使い回したブロックの数
+size_t BlockVisibilityCache::GetReusedBlockCount() const
+{
+    size_t reused = 0;
+    for (const Entry& entry : entries) {
+        if (entry.reused) { ++reused; }
+    }
+    return reused;
+}
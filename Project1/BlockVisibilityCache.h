@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>         // size_t
+#include <cstdint>         // uint8_t, uint64_t
+#include <vector>          // std::vector
+#include "Vector.h"        // Vector3D
+#include "Quaternion.h"    // Quaternion
+#include "SegmentBuffer.h" // SegmentRange
+
+/*
+ * BlockVisibilityCache.h
+ * 役割:
+ *   WireframePipeline のブロック (DRAW_BLOCK_SEGMENTS 本ずつの線分) ごとに、前のフレームの分類
+ *   (視錐台の完全に内側 / 完全に外 / 境界をまたぐ) を覚えておく `BlockVisibilityCache` を定義します。
+ *   カメラが少しずつ動く間 (滑らかな移動) は、ほとんどのブロックの分類は前のフレームと変わりません。
+ *   分類が変わり得ないと分かったブロックは、アウトコードの計算 (ComputeOutCodesBatch) と振り分けを省略し、
+ *   完全に外のブロックはクリップ座標への変換も省略します (時間的コヒーレンス)。
+ *
+ * 使い回してよいかの判定:
+ *   - 分類したときに、ブロックの全ての点について「視錐台の平面までの距離 (ワールド座標)」の最小値を
+ *     余裕 (margin) として記録します。内側のブロックは全平面の内側への距離、外のブロックは各線分を外と
+ *     判定した平面の外側への距離です。同時に、カメラの位置・向きと、カメラから最も遠い点までの距離も記録します。
+ *   - レンズの設定が同じなら、視錐台はカメラに固定されたまま動くので、カメラが t だけ移動し、
+ *     向きが変わって平面の法線が最大 c (弦の長さ) だけ動いたとき、どの点の平面までの距離の変化も
+ *     |t| + c * (カメラから最も遠い点までの距離 + |t|) 以下です。これが余裕より小さければ、
+ *     どの点も平面の同じ側に残るので、前の分類をそのまま使えます。
+ *   - c はクォータニオンの差から求めます (単位クォータニオン q0, q1 の回転の差の弦の長さは 2|q1 - q0| 以下)。
+ *   - 前の分類との比較は、毎フレームの移動量 (lastWorldMoveOffset) を足し合わせる代わりに、分類したときの
+ *     カメラの位置・向きと今の位置・向きの差で行います。シミュレーションのスレッドが 1 フレームに何ステップ
+ *     進めても、フレームを飛ばしても、差は常に正しく求まります。
+ *   - 線分の内容 (版番号)、線分の入れ物、レンズの設定のどれかが変わったら、全てのブロックを分類し直します。
+ *     ブロックは範囲 (先頭の線分と本数) で前回の記録と対応させるので、BVH で視錐台に入る範囲が
+ *     増減したフレームでも、前回と同じ範囲のブロックは使い回せます。
+ *
+ * 使い方 (Camera::Draw):
+ *   visibility.SetPose({ position, orientation, fovY, aspectRatio, nearZ, farZ }); // 毎フレーム
+ *   pipeline.Run(worldLines, viewProj, W, H, pool, out, &visibility);
+ */
+
+// ブロックと視錐台の位置関係
+enum class BlockVisibility : uint8_t {
+    Unknown,    // 分類していない (または前の分類を使い回せない)
+    Inside,     // 全ての線分の両端点が視錐台の内部
+    Outside,    // 全ての線分が視錐台の外 (どの線分も、両端点が同じ平面の外側)
+    Straddling  // それ以外 (クリッピングが必要な線分を含む)
+};
+
+// 視錐台を決めるカメラの状態
+struct FrustumPose {
+    Vector3D position;       // カメラの位置
+    Quaternion orientation;  // カメラの向き (正規化済み)
+    float fovY;              // レンズの設定 (どれかが変わったら、全てのブロックを分類し直す)
+    float aspectRatio;
+    float nearZ;
+    float farZ;
+};
+
+class BlockVisibilityCache
+{
+public:
+    // 浮動小数点の誤差に備えて、余裕から差し引く割合 (カメラから最も遠い点までの距離に対して)
+    static const float MARGIN_TOLERANCE;
+
+    // 今回の視錐台を決めるカメラの状態を設定する (Run の前に毎回呼ぶ。レンズの設定が変わったら全て捨てる)
+    void SetPose(const FrustumPose& newPose);
+    const FrustumPose& GetPose() const { return pose; }
+    // Run の準備: source (線分の入れ物) とその版番号、またはブロックの区切り方が前回と違うブロックの分類を捨てる
+    void BeginRun(const void* source, uint64_t sourceVersion, const std::vector<SegmentRange>& blocks);
+    // ブロック block の前の分類が今回もそのまま使えるなら Inside / Outside を、使えなければ Unknown を返す
+    BlockVisibility TryReuse(size_t block);
+    // ブロック block を今のカメラの状態で分類した結果を記録する
+    // margin: 視錐台がこの距離より小さく動いても分類が変わらない距離 (Inside / Outside のとき)
+    // maxDistance: ブロック内の点とカメラの距離の最大値
+    void Store(size_t block, BlockVisibility visibility, float margin, float maxDistance);
+    // 全ての分類を捨てる
+    void Invalidate();
+
+    // 直前の Run のブロックの数と、そのうち前の分類を使い回したブロックの数
+    size_t GetBlockCount() const { return entries.size(); }
+    size_t GetReusedBlockCount() const;
+
+private:
+    // ブロック 1 つ分の記録 (各ブロックは自分のものだけを読み書きするので、並列処理でもロックは不要)
+    struct Entry {
+        size_t first = 0;          // ブロックの範囲 (区切り方が変わったかどうかの判定用)
+        size_t count = 0;
+        BlockVisibility visibility = BlockVisibility::Unknown;
+        bool reused = false;       // 直前の Run で使い回したか
+        float margin = 0.0f;       // 分類したときの余裕 (ワールド座標の距離)
+        float maxDistance = 0.0f;  // 分類したときの、カメラから最も遠い点までの距離
+        Vector3D position;         // 分類したときのカメラの位置
+        Quaternion orientation;    // 分類したときのカメラの向き
+    };
+
+    std::vector<Entry> entries;         // ブロックごとの記録 (Run のブロックの番号順)
+    std::vector<Entry> previousEntries; // BeginRun で引き継ぐ前の記録 (フレームをまたいで使い回す)
+    FrustumPose pose = {};              // 今回のカメラの状態
+    bool hasPose = false;               // pose が設定済みか
+    const void* source = nullptr;       // 前回の Run の線分の入れ物
+    uint64_t sourceVersion = 0;         // その版番号
+};
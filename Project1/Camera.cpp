@@ -46,7 +46,7 @@
  * 4. クリッピングについて:
  *    - 最初のバージョンでは、オブジェクトがカメラより奥にあるかどうかのZ座標チェックのみでした。
  *      画面の左右上下にはみ出す場合や、遠すぎる場合の処理が不十分でした。
- *    - このコードでは、「Cohen-Sutherlandアルゴリズム」という手法 (`ClipLineCohenSutherland` 関数) を使って、
+ *    - このコードでは、「Cohen-Sutherlandアルゴリズム」という手法 (`ClipLineCohenSutherland` 関数、Clipping.h) を使って、
  *      線分がカメラの「視錐台（見える範囲を表す四角錐）」の内側にあるかどうかを判定し、
  *      はみ出した部分を正確に切り取る「クリッピング」処理を行っています。
  *    - 視錐台は、Near平面、Far平面、左、右、上、下の合計6つの平面で定義されます。
@@ -55,6 +55,12 @@
  *      完全に内側にあるか（そのまま描画）、あるいは一部がはみ出しているか（クリッピング必要）を判断します。
  *    - クリッピングが必要な場合は、線分と視錐台の境界平面との交点を計算し、線分を短くする処理を繰り返します。
  *    - これにより、画面に表示されるべき部分だけが正確に描画されるようになります。
+ *    - 変換からクリッピング、スクリーン座標への変換までの処理は `WireframePipeline` にまとめられており、
+ *      線分が多い場合は `SetDrawThreadCount` で設定したスレッド数で並列に処理されます。
+ *    - 多くの線分は「完全に内側」か「1 つの平面の完全に外側」のどちらかなので、`Draw` ではまず
+ *      全端点のアウトコードを SIMD でまとめて計算し (`ComputeOutCodesBatch`)、線分を
+ *      accept / reject / clip の 3 つのリストに振り分けます (`ClassifySegments`)。
+ *      反復的なクリッピング処理は clip リストの線分にだけ行います。
  *
  * [このコードに関する注意点]
  * - 回転の適用順序: `Update` 関数内の `orientation = deltaRotation * orientation;` という行は、
@@ -77,7 +83,7 @@
 #include "DxLib.h"      // DxLibライブラリの関数を使うために必要
 #include "CameraMath.h" // PerspectiveFovLHなどの数学関数 (自作ヘッダーと想定)
 #include "Common.h"     // WINDOW_WIDTHなどの共通定数 (自作ヘッダーと想定)
-#include <cmath>        // fabsf, sqrtf, sinf, cosf などの数学関数
+#include <cmath>        // std::fabs, sqrtf, sinf, cosf などの数学関数
 #include <algorithm>    // std::min, std::max など (現在は未使用だが、将来使う可能性あり)
 #include <stdexcept>    // 例外処理クラス (現在は未使用だが、エラー処理で使う可能性あり)
 #include <string>       // std::string クラス (デバッグ情報用)
@@ -87,137 +93,24 @@
 #include "Vector.h"     // Vector3D, Vector4D 構造体 (自作ヘッダーと想定)
 #include "Matrix.h"     // Matrix 構造体, MatrixMultiply など (自作ヘッダーと想定)
 #include "Quaternion.h" // Quaternion 構造体, FromAxisAngle など (自作ヘッダーと想定)
+#include "SegmentBuffer.h" // SegmentBuffer クラス (Draw の引数)
+#include "ThreadPool.h" // ThreadPool クラス (描画の並列処理)
+#include "RenderSink.h" // RenderSink インターフェース (描画先)
+#include "SegmentBVH.h" // SegmentBVH クラス (視錐台カリング)
+#include "FrameTelemetry.h" // FrameTelemetryRecord 構造体 (フレームの記録)
+#include "Profiler.h"   // PROFILE_SCOPE (処理時間の計測)
+#include <thread>       // std::thread::hardware_concurrency
 
  // --- 匿名名前空間 ---
  // この .cpp ファイルの内部でのみ使用される関数や定数を定義する。
  // 他のファイルで同じ名前が使われていても、名前の衝突を防ぐことができる。
 namespace {
-    // 4次元ベクトル start から end へ、パラメータ t (0.0～1.0) を使って線形補間するインライン関数
-    // クリッピングで交点を計算する際に使用する。w成分も補間することが重要。
-    inline Vector4D VectorLerp4D(const Vector4D& start, const Vector4D& end, float t) {
-        return {
-            start.x + (end.x - start.x) * t,
-            start.y + (end.y - start.y) * t,
-            start.z + (end.z - start.z) * t,
-            start.w + (end.w - start.w) * t
-        };
-    }
-
-    // Cohen-Sutherlandアルゴリズムで使用する領域コード（アウトコード）の定数
-    const int INSIDE = 0;        // 000000: 完全に視錐台の内部
-    const int LEFT = 1;          // 000001: 左境界の外側 (x < -w)
-    const int RIGHT = 2;         // 000010: 右境界の外側 (x > w)
-    const int BOTTOM = 4;        // 000100: 下境界の外側 (y < -w)
-    const int TOP = 8;           // 001000: 上境界の外側 (y > w)
-    const int OUTCODE_NEAR = 16; // 010000: Near平面より手前 (z < 0)
-    const int OUTCODE_FAR = 32;  // 100000: Far平面より奥 (z > w)
-
-    // クリップ座標系の点 p が、視錐台のどの領域にあるかを示すアウトコードを計算する関数
-    // 元のコードのロジックを保持。w<=0 の場合の厳密なチェックは含まれていない点に注意。
-    int ComputeOutCode(const Vector4D& p) {
-        int code = INSIDE; // まず内部と仮定
-        // 各境界との比較を行い、外側にあれば対応するビットを立てる
-        if (p.x < -p.w) { code |= LEFT; }
-        else if (p.x > p.w) { code |= RIGHT; }
-        if (p.y < -p.w) { code |= BOTTOM; }
-        else if (p.y > p.w) { code |= TOP; }
-        if (p.z < 0.0f) { code |= OUTCODE_NEAR; }
-        else if (p.z > p.w) { code |= OUTCODE_FAR; }
-        return code; // 計算されたアウトコードを返す
-    }
-
-    // Cohen-Sutherlandアルゴリズムによる線分クリッピング関数
-    // 引数: p1_clip, p2_clip (クリップ座標系の線分端点、クリップされると値が変更される)
-    // 戻り値: 線分の一部でも視錐台内にあれば true、完全に外部なら false
-    // 元のコードのロジックを保持
-    bool ClipLineCohenSutherland(Vector4D& p1_clip, Vector4D& p2_clip) {
-        int outcode1 = ComputeOutCode(p1_clip); // 始点のアウトコード
-        int outcode2 = ComputeOutCode(p2_clip); // 終点のアウトコード
-        const int MAX_ITERATIONS = 10; // 無限ループ防止のための最大反復回数
-        int iterations = 0; // 現在の反復回数
-
-        while (iterations < MAX_ITERATIONS) { // 最大反復回数に達するまでループ
-            iterations++;
-            // Case 1: 両端点が内部にある場合 (Trivial Accept)
-            if ((outcode1 | outcode2) == 0) {
-                return true; // 線分全体が表示されるので true
-            }
-            // Case 2: 両端点が同じ外部領域にある場合 (Trivial Reject)
-            else if ((outcode1 & outcode2) != 0) {
-                return false; // 線分全体が表示されないので false
-            }
-            // Case 3: クリッピングが必要な場合
-            else {
-                // 外部にある方の点のアウトコードを選択
-                int outcode_outside = (outcode1 != 0) ? outcode1 : outcode2;
-                float t = 0.0f; // 交点のパラメータ (0.0 <= t <= 1.0)
-                Vector4D intersection_point; // 交点の座標
-                // 線分の方向ベクトル成分
-                float dx = p2_clip.x - p1_clip.x, dy = p2_clip.y - p1_clip.y;
-                float dz = p2_clip.z - p1_clip.z, dw = p2_clip.w - p1_clip.w;
-                float denominator; // 割り算の分母
-
-                // 外部コードに対応する境界平面との交差パラメータ t を計算
-                if (outcode_outside & LEFT) {         // 左平面 (x = -w)
-                    denominator = dx + dw;
-                    if (std::fabsf(denominator) < 1e-6f) { return false; } // 平行チェック
-                    t = (-p1_clip.x - p1_clip.w) / denominator;
-                }
-                else if (outcode_outside & RIGHT) {   // 右平面 (x = w)
-                    denominator = dx - dw;
-                    if (std::fabsf(denominator) < 1e-6f) { return false; }
-                    t = (p1_clip.w - p1_clip.x) / denominator;
-                }
-                else if (outcode_outside & BOTTOM) {  // 下平面 (y = -w)
-                    denominator = dy + dw;
-                    if (std::fabsf(denominator) < 1e-6f) { return false; }
-                    t = (-p1_clip.y - p1_clip.w) / denominator;
-                }
-                else if (outcode_outside & TOP) {     // 上平面 (y = w)
-                    denominator = dy - dw;
-                    if (std::fabsf(denominator) < 1e-6f) { return false; }
-                    t = (p1_clip.w - p1_clip.y) / denominator;
-                }
-                else if (outcode_outside & OUTCODE_NEAR) { // Near平面 (z = 0)
-                    if (std::fabsf(dz) < 1e-6f) { return false; } // 平行チェック
-                    t = -p1_clip.z / dz;
-                }
-                else if (outcode_outside & OUTCODE_FAR) {  // Far平面 (z = w)
-                    denominator = dz - dw;
-                    if (std::fabsf(denominator) < 1e-6f) { return false; } // 平行チェック
-                    t = (p1_clip.w - p1_clip.z) / denominator;
-                }
-                else {
-                    return false; // 通常は到達しない
-                }
-
-                // パラメータ t が線分上にない場合は棄却
-                if (t < 0.0f || t > 1.0f) { return false; }
-
-                // 交点の座標を線形補間で計算
-                intersection_point = VectorLerp4D(p1_clip, p2_clip, t);
-
-                // 外部にあった点を交点に置き換え、その点のアウトコードを再計算
-                if (outcode_outside == outcode1) {
-                    p1_clip = intersection_point; // 始点を更新
-                    outcode1 = ComputeOutCode(p1_clip); // 始点のアウトコードを再計算
-                }
-                else {
-                    p2_clip = intersection_point; // 終点を更新
-                    outcode2 = ComputeOutCode(p2_clip); // 終点のアウトコードを再計算
-                }
-                // ループの最初に戻り、再度判定を行う
-            }
-        }
-        // 最大反復回数に達した場合 (通常は起こらないが、念のため)
-        return false;
-    }
-
     // カメラ制御用の定数
-    static const float MOVE_SPEED = 2.5f;   // 移動速度 (単位/フレーム or 秒)
+    // 移動速度とロール回転速度は 1 秒あたりの値 (以前の 1 フレームあたりの値 × 60fps。Update で経過時間を掛ける)
+    static const float MOVE_SPEED = 150.0f;   // 移動速度 (単位/秒)
     // static const float ROTATION_SENSITIVITY = 5.0f; // この定数は MOUSE_ANGLE_RATE の計算に使われていない
     static const float MOUSE_ANGLE_RATE = ONE_DEGREE * 0.1f; // マウス感度 (1ピクセル移動あたり0.1度回転)
-    static const float ROLL_SPEED = 2.0f * ONE_DEGREE; // ロール回転速度 (1フレームあたり2度回転)
+    static const float ROLL_SPEED = 120.0f * ONE_DEGREE; // ロール回転速度 (1秒あたり120度回転)
 
     // --- Camera クラスに必要なメンバ変数の仮宣言 (コメント) ---
     // float fovY; float aspectRatio; float nearZ; float farZ; // プロジェクション用
@@ -231,6 +124,8 @@ namespace {
 
 // --- Camera クラス メンバー関数の実装 ---
 
+const float Camera::DEFAULT_UPDATE_SECONDS = 1.0f / 60.0f;
+
 // コンストラクタ: Cameraオブジェクト生成時に呼び出される初期化処理
 Camera::Camera() : position{ 0.0f, 0.0f, -50.0f }, orientation() {
     // メンバ変数の初期化リストで position と orientation を初期化
@@ -244,64 +139,182 @@ Camera::Camera() : position{ 0.0f, 0.0f, -50.0f }, orientation() {
     //       ここで初期化されていない場合、Camera.h でのデフォルト初期化に依存します。
 }
 
-// デストラクタ: Cameraオブジェクトが破棄されるときに呼び出される (今回は特に処理なし)
+// デストラクタ: Cameraオブジェクトが破棄されるときに呼び出される
+// (drawThreadPool は unique_ptr なので自動的に解放され、ワーカースレッドも終了する)
 Camera::~Camera() {}
 
+// Draw() の処理に使うスレッド数を設定する
+// count: 使うスレッドの総数 (呼び出し元スレッドを含む)。0 を指定すると CPU の論理コア数に合わせる。
+void Camera::SetDrawThreadCount(unsigned int count) {
+    if (count == 0) {
+        count = std::thread::hardware_concurrency(); // 論理コア数 (取得できない場合は 0)
+        if (count == 0) { count = 1; }
+    }
+    if (count == GetDrawThreadCount()) { return; } // 変更がなければ何もしない
+    // 呼び出し元スレッドもワーカーとして働くので、追加で起動するスレッドは count - 1 本
+    if (count > 1) { drawThreadPool.reset(new ThreadPool(count - 1)); }
+    else { drawThreadPool.reset(); } // 1 スレッドならプールは不要
+}
+
+// Draw() の処理に使うスレッド数を返す (呼び出し元スレッドを含む)
+unsigned int Camera::GetDrawThreadCount() const {
+    return drawThreadPool ? drawThreadPool->GetWorkerCount() : 1;
+}
+
 // カメラの現在のワールド座標を返す Getter 関数
 Vector3D Camera::GetPosition() const {
     return position; // メンバ変数 position の値を返す
 }
 
-// 現在のカメラの状態からビュー行列 (View Matrix) を計算して返す Getter 関数
+// カメラの位置と向きを直接設定する
+void Camera::SetPose(const Vector3D& newPosition, const Quaternion& newOrientation) {
+    position = newPosition;
+    orientation = newOrientation.Normalized();
+    MarkOrientationChanged(); // 軸ベクトルとビュー行列は次に使われるときに計算し直される
+}
+
+// 現在の状態をスナップショットにする
+CameraSnapshot Camera::CaptureSnapshot() const {
+    CameraSnapshot snapshot;
+    snapshot.position = position;
+    snapshot.orientation = orientation;
+    snapshot.mouseMoveX = lastMouseMoveX;
+    snapshot.mouseMoveY = lastMouseMoveY;
+    snapshot.yawAngle = lastYawAngle;
+    snapshot.pitchAngle = lastPitchAngle;
+    snapshot.rollAngle = lastRollAngle;
+    snapshot.moveForward = lastMoveForward;
+    snapshot.moveRight = lastMoveRight;
+    snapshot.moveUp = lastMoveUp;
+    snapshot.worldMoveOffset = lastWorldMoveOffset;
+    return snapshot;
+}
+
+// スナップショットの状態を設定する
+void Camera::ApplySnapshot(const CameraSnapshot& snapshot) {
+    // 止まっている間は同じ位置・向きが届くので、キャッシュした行列をそのまま使えるように比べてから設定する
+    if (snapshot.orientation.x != orientation.x || snapshot.orientation.y != orientation.y ||
+        snapshot.orientation.z != orientation.z || snapshot.orientation.w != orientation.w) {
+        orientation = snapshot.orientation;
+        MarkOrientationChanged();
+    }
+    if (snapshot.position.x != position.x || snapshot.position.y != position.y || snapshot.position.z != position.z) {
+        position = snapshot.position;
+        MarkPositionChanged();
+    }
+    lastMouseMoveX = snapshot.mouseMoveX;
+    lastMouseMoveY = snapshot.mouseMoveY;
+    lastYawAngle = snapshot.yawAngle;
+    lastPitchAngle = snapshot.pitchAngle;
+    lastRollAngle = snapshot.rollAngle;
+    lastMoveForward = snapshot.moveForward;
+    lastMoveRight = snapshot.moveRight;
+    lastMoveUp = snapshot.moveUp;
+    lastWorldMoveOffset = snapshot.worldMoveOffset;
+}
+
+// レンズ (プロジェクション) の設定を変更する
+bool Camera::SetLens(float newFovY, float newAspectRatio, float newNearZ, float newFarZ) {
+    // PerspectiveFovLH が例外を投げる値や、意味のない値は受け付けない (NaN もここで弾かれる)
+    if (!(newFovY > 0.0f && newFovY < PI) || !(newAspectRatio > 0.0f) || !(newNearZ > 0.0f && newNearZ < newFarZ)) {
+        return false;
+    }
+    fovY = newFovY;
+    aspectRatio = newAspectRatio;
+    nearZ = newNearZ;
+    farZ = newFarZ;
+    dirtyFlags |= DIRTY_PROJECTION;
+    return true;
+}
+
+// 向きが変わっていれば、ローカル軸ベクトルを計算し直す
+void Camera::RefreshBasis() const {
+    if ((dirtyFlags & DIRTY_BASIS) == 0) { return; }
+    // 回転行列の各行が、ローカル座標系の X / Y / Z 軸 (右・上・前) をワールド座標系で表したベクトルになる
+    // (VEC3Transform({1,0,0}, rotMat) などと同じ値を、回転行列を 1 回作るだけで得る)
+    const Matrix rotMat = orientation.ToRotationMatrix();
+    currentRight = { rotMat.m[0][0], rotMat.m[0][1], rotMat.m[0][2] };
+    currentUp = { rotMat.m[1][0], rotMat.m[1][1], rotMat.m[1][2] };
+    currentForward = { rotMat.m[2][0], rotMat.m[2][1], rotMat.m[2][2] };
+    dirtyFlags &= ~DIRTY_BASIS;
+}
+
+// 位置・向き・レンズの設定が変わっていれば、行列を計算し直す
+void Camera::RefreshMatrices() const {
+    const bool viewChanged = (dirtyFlags & DIRTY_VIEW) != 0;
+    const bool projectionChanged = (dirtyFlags & DIRTY_PROJECTION) != 0;
+    if (viewChanged) {
+        RefreshBasis();
+        // ビュー行列 = 逆平行移動行列 * 逆回転行列 (DirectX スタイル)。
+        // 逆回転行列は回転行列の転置なので、その列はローカル軸ベクトルになる。
+        // 平行移動の行は、逆平行移動 (-position) を逆回転した値 (各軸ベクトルとの内積の符号を反転したもの)。
+        // 回転だけの行列 (平行移動の行が 0 のアフィン変換) で -position を変換すれば、その 3 つの内積が 1 回で求まる。
+        viewMatrix = Matrix::Identity();
+        viewMatrix.m[0][0] = currentRight.x; viewMatrix.m[0][1] = currentUp.x; viewMatrix.m[0][2] = currentForward.x;
+        viewMatrix.m[1][0] = currentRight.y; viewMatrix.m[1][1] = currentUp.y; viewMatrix.m[1][2] = currentForward.y;
+        viewMatrix.m[2][0] = currentRight.z; viewMatrix.m[2][1] = currentUp.z; viewMatrix.m[2][2] = currentForward.z;
+        const Vector3DA translation = TransformPointAffine(Vector3DA(-position.x, -position.y, -position.z), viewMatrix);
+        viewMatrix.m[3][0] = translation.x; viewMatrix.m[3][1] = translation.y; viewMatrix.m[3][2] = translation.z;
+    }
+    if (projectionChanged) {
+        projectionMatrix = PerspectiveFovLH(fovY, aspectRatio, nearZ, farZ);
+    }
+    if (viewChanged || projectionChanged) {
+        viewProjectionMatrix = MatrixMultiply(viewMatrix, projectionMatrix); // ビュー * プロジェクション
+        frustum = Frustum::FromViewProjection(viewProjectionMatrix);
+        ++viewProjectionVersion;
+        dirtyFlags &= ~(DIRTY_VIEW | DIRTY_PROJECTION);
+    }
+}
+
+// 現在のカメラの状態からビュー行列 (View Matrix) を返す Getter 関数
 // ビュー行列は、ワールド座標系の点をカメラ視点の座標系（ビュー座標系）に変換する
-Matrix Camera::GetViewMatrix() const {
-    // 1. カメラの回転の逆を表すクォータニオンを計算 (共役を取る)
-    Quaternion invOrientation = orientation.Conjugate();
-    // 2. 逆回転クォータニオンを回転行列に変換
-    Matrix invRotationMatrix = invOrientation.ToRotationMatrix();
-    // 3. カメラの位置を打ち消す逆平行移動行列を計算
-    Matrix invTranslate = Matrix::Identity(); // まず単位行列を作成
-    invTranslate.m[3][0] = -position.x; // 平行移動成分を設定
-    invTranslate.m[3][1] = -position.y;
-    invTranslate.m[3][2] = -position.z;
-    // 4. ビュー行列 = 逆平行移動行列 * 逆回転行列 (DirectX スタイル)
-    Matrix viewMatrix = MatrixMultiply(invTranslate, invRotationMatrix);
-    return viewMatrix; // 計算したビュー行列を返す
+const Matrix& Camera::GetViewMatrix() const {
+    RefreshMatrices(); // 位置か向きが変わっていたときだけ計算し直す
+    return viewMatrix;
 }
 
-// 現在のカメラの設定からプロジェクション行列 (Projection Matrix) を計算して返す Getter 関数
+// 現在のカメラの設定 (fovY, aspectRatio, nearZ, farZ) からプロジェクション行列 (Projection Matrix) を返す Getter 関数
 // プロジェクション行列は、ビュー座標系の点をクリップ座標系に変換し、遠近感を適用する
-Matrix Camera::GetProjectionMatrix() const {
-    // Camera.h で定義されているメンバ変数 fovY, aspectRatio, nearZ, farZ を使って
-    // PerspectiveFovLH 関数 (CameraMath.h で定義想定) を呼び出し、透視投影行列を計算する
-    // return PerspectiveFovLH(fovY, aspectRatio, nearZ, farZ);
-
-    // 仮の実装 (もしメンバ変数が Camera.h で初期化されていない場合)
-    // これらの値が Camera.h で正しく設定されていることを確認してください。
-    return PerspectiveFovLH(60.0f * ONE_DEGREE, WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 1000.0f);
+const Matrix& Camera::GetProjectionMatrix() const {
+    RefreshMatrices(); // レンズの設定が変わっていたときだけ計算し直す
+    return projectionMatrix;
 }
 
-// カメラの前方ベクトル (+Z方向) の現在のワールド空間での向きを計算して返す Getter 関数
+// ビュー行列 * プロジェクション行列 を返す Getter 関数 (Draw などで使う)
+const Matrix& Camera::GetViewProjectionMatrix() const {
+    RefreshMatrices();
+    return viewProjectionMatrix;
+}
+
+// ビュー・プロジェクション行列の版番号を返す Getter 関数
+uint64_t Camera::GetViewProjectionVersion() const {
+    RefreshMatrices();
+    return viewProjectionVersion;
+}
+
+// 現在の視錐台を返す Getter 関数 (ビュー・プロジェクション行列と同時に計算し直される)
+const Frustum& Camera::GetFrustum() const {
+    RefreshMatrices();
+    return frustum;
+}
+
+// カメラの前方ベクトル (+Z方向) の現在のワールド空間での向きを返す Getter 関数
 Vector3D Camera::GetForwardVector() const {
-    // 現在のカメラの向きを表すクォータニオンを行列に変換
-    Matrix rotMat = orientation.ToRotationMatrix();
-    // ローカル座標系の前方ベクトル (0, 0, 1) を回転行列で変換
-    // VEC3TransformNormal を使い、結果を Normalize() するのがより正確
-    return VEC3Transform({ 0.0f, 0.0f, 1.0f }, rotMat);
+    RefreshBasis(); // 向きが変わっていたときだけ、回転行列から計算し直す
+    return currentForward;
 }
 
-// カメラの右方ベクトル (+X方向) の現在のワールド空間での向きを計算して返す Getter 関数
+// カメラの右方ベクトル (+X方向) の現在のワールド空間での向きを返す Getter 関数
 Vector3D Camera::GetRightVector() const {
-    Matrix rotMat = orientation.ToRotationMatrix();
-    // ローカル座標系の右方ベクトル (1, 0, 0) を回転行列で変換
-    return VEC3Transform({ 1.0f, 0.0f, 0.0f }, rotMat);
+    RefreshBasis();
+    return currentRight;
 }
 
-// カメラの上方ベクトル (+Y方向) の現在のワールド空間での向きを計算して返す Getter 関数
+// カメラの上方ベクトル (+Y方向) の現在のワールド空間での向きを返す Getter 関数
 Vector3D Camera::GetUpVector() const {
-    Matrix rotMat = orientation.ToRotationMatrix();
-    // ローカル座標系の上方ベクトル (0, 1, 0) を回転行列で変換
-    return VEC3Transform({ 0.0f, 1.0f, 0.0f }, rotMat);
+    RefreshBasis();
+    return currentUp;
 }
 
 // ワールド座標をスクリーン座標に変換するヘルパー関数 (これはCameraクラスのメンバではないグローバル関数)
@@ -312,7 +325,7 @@ Vector3D WorldToScreen(const Vector3D& worldPos, const Matrix& viewProjMatrix) {
     Vector4D clipPos = VEC4Transform({ worldPos.x, worldPos.y, worldPos.z, 1.0f }, viewProjMatrix);
 
     // 2. 視錐台内外の簡易チェック (パースペクティブ除算前)
-    if (std::fabsf(clipPos.w) < 1e-6f || clipPos.z < 0.0f || clipPos.z > clipPos.w) {
+    if (std::fabs(clipPos.w) < 1e-6f || clipPos.z < 0.0f || clipPos.z > clipPos.w) {
         return { -1.0f, -1.0f, 0.0f }; // 範囲外 (または視点の後ろ)
     }
 
@@ -332,50 +345,148 @@ Vector3D WorldToScreen(const Vector3D& worldPos, const Matrix& viewProjMatrix) {
 }
 
 // ワールド空間の線分 (`worldLines`) をカメラ視点で描画するメソッド
-void Camera::Draw(const std::vector<std::vector<Vector3D>>& worldLines) {
-    // 必要な行列を事前に計算
-    Matrix viewMatrix = GetViewMatrix();
-    Matrix projMatrix = GetProjectionMatrix();
-    Matrix viewProjMatrix = MatrixMultiply(viewMatrix, projMatrix); // ビュー * プロジェクション
-
-    // 受け取った全ての線分についてループ処理
-    for (const auto& line : worldLines) {
-        // 線分は2点以上必要
-        if (line.size() < 2) { continue; }
-
-        // 線分の始点と終点をワールド座標からクリップ座標へ変換
-        Vector4D p1_clip = VEC4Transform({ line[0].x, line[0].y, line[0].z, 1.0f }, viewProjMatrix);
-        Vector4D p2_clip = VEC4Transform({ line[1].x, line[1].y, line[1].z, 1.0f }, viewProjMatrix);
-
-        // クリッピング処理のために座標をコピー
-        Vector4D p1_clipped = p1_clip;
-        Vector4D p2_clipped = p2_clip;
-
-        // Cohen-Sutherlandアルゴリズムで線分をクリッピング
-        if (ClipLineCohenSutherland(p1_clipped, p2_clipped)) {
-            // 線分の一部でも視錐台内に残った場合...
-
-            // NDC座標とスクリーン座標を計算 (元のコードのロジックを保持)
-            Vector3D p1_ndc, p2_ndc; // NDC座標用
-            // パースペクティブ除算の前に w 成分がゼロに近くないかチェック
-            if (fabsf(p1_clipped.w) > 1e-6f && fabsf(p2_clipped.w) > 1e-6f) {
-                // NDC座標を計算 (x/w, y/w, z/w)
-                p1_ndc = { p1_clipped.x / p1_clipped.w, p1_clipped.y / p1_clipped.w, p1_clipped.z / p1_clipped.w };
-                p2_ndc = { p2_clipped.x / p2_clipped.w, p2_clipped.y / p2_clipped.w, p2_clipped.z / p2_clipped.w };
-
-                // NDC座標をスクリーン座標 (int) に変換
-                float hW = WINDOW_WIDTH / 2.f, hH = WINDOW_HEIGHT / 2.f;
-                int sx1 = static_cast<int>(p1_ndc.x * hW + hW);
-                int sy1 = static_cast<int>(-p1_ndc.y * hH + hH); // Y軸反転
-                int sx2 = static_cast<int>(p2_ndc.x * hW + hW);
-                int sy2 = static_cast<int>(-p2_ndc.y * hH + hH); // Y軸反転
-
-                // DxLibの関数で線を描画
-                DrawLine(sx1, sy1, sx2, sy2, GetColor(255, 255, 255)); // 白色
-            }
-        }
-        // else: 線分が完全に視錐台の外なら何もしない
+void Camera::Draw(const SegmentBuffer& worldLines, RenderSink& sink) {
+    PROFILE_SCOPE(ProfileStage::CameraDraw);
+    // ビュー * プロジェクション (位置・向き・レンズが前回から変わっていなければ計算済みの行列)
+    const Matrix& viewProjMatrix = GetViewProjectionMatrix();
+    // カメラも線分も前回から変わっていなければ、前回の描画コマンドをそのまま使う
+    if (ReplayIfUnchanged({ viewProjectionVersion, &worldLines, worldLines.GetVersion(), nullptr, 0, nullptr, 0, nullptr, 0 }, sink)) {
+        return;
+    }
+
+    // 全線分を「クリップ座標への一括変換 → アウトコードによる振り分け → クリッピング →
+    // スクリーン座標への変換」と処理し、画面に描く線分のリストを作る (WireframePipeline.cpp)。
+    // 線分が多い場合は drawThreadPool のスレッドで分担して処理されるが、結果の順番は常に同じ。
+    // 前のフレームから分類が変わらないブロックは、アウトコードの計算を省略する (BlockVisibilityCache.h)。
+    pipeline.Run(worldLines, viewProjMatrix, WINDOW_WIDTH, WINDOW_HEIGHT, drawThreadPool.get(), visibleSegments,
+        PrepareVisibilityCache());
+    objectSegments.clear();
+    dynamicSegments.clear();
+    meshSegments.clear();
+
+    SubmitVisibleSegments(sink);
+}
+
+// BVH で視錐台カリングしてから描画するメソッド
+void Camera::Draw(const SegmentBVH& scene, RenderSink& sink) {
+    DrawScene(&scene, nullptr, nullptr, nullptr, sink);
+}
+
+// BVH で視錐台カリングした線分と、毎フレーム作る線分を描画するメソッド
+void Camera::Draw(const SegmentBVH& scene, const SegmentBuffer& dynamicLines, RenderSink& sink) {
+    DrawScene(&scene, nullptr, &dynamicLines, nullptr, sink);
+}
+
+// BVH で視錐台カリングした線分と、毎フレーム作る線分・メッシュを描画するメソッド
+void Camera::Draw(const SegmentBVH& scene, const SegmentBuffer& dynamicLines, const WireMesh& dynamicMesh, RenderSink& sink) {
+    DrawScene(&scene, nullptr, &dynamicLines, &dynamicMesh, sink);
+}
+
+// シーングラフの物体だけを描画するメソッド
+void Camera::Draw(const SceneGraph& objects, RenderSink& sink) {
+    DrawScene(nullptr, &objects, nullptr, nullptr, sink);
+}
+
+// BVH で視錐台カリングした線分と、シーングラフの物体と、毎フレーム作る線分・メッシュを描画するメソッド
+void Camera::Draw(const SegmentBVH& scene, const SceneGraph& objects, const SegmentBuffer& dynamicLines,
+    const WireMesh& dynamicMesh, RenderSink& sink) {
+    DrawScene(&scene, &objects, &dynamicLines, &dynamicMesh, sink);
+}
+
+// BVH 版の Draw の本体 (nullptr の入力はなしとして扱う)
+void Camera::DrawScene(const SegmentBVH* scene, const SceneGraph* objects, const SegmentBuffer* dynamicLines,
+    const WireMesh* dynamicMesh, RenderSink& sink) {
+    PROFILE_SCOPE(ProfileStage::CameraDraw);
+    const Matrix& viewProjMatrix = GetViewProjectionMatrix(); // ビュー * プロジェクション
+    // カメラも線分・物体・メッシュも前回から変わっていなければ、カリングからやり直さずに前回の描画コマンドを使う
+    // (BVH の版番号は、Build / Refit で並べ替え直される GetSegments() の版番号で代用する)
+    if (ReplayIfUnchanged({ viewProjectionVersion, scene, scene ? scene->GetSegments().GetVersion() : 0,
+            objects, objects ? objects->GetVersion() : 0, dynamicLines, dynamicLines ? dynamicLines->GetVersion() : 0,
+            dynamicMesh, dynamicMesh ? dynamicMesh->GetVersion() : 0 }, sink)) {
+        return;
+    }
+
+    // BVH をたどって、視錐台に入る線分の範囲だけを集める (SegmentBVH.cpp)。
+    // 視錐台の外の部分木は丸ごと読み飛ばされるので、処理量は画面に映る線分の数にほぼ比例する。
+    // シーングラフも同じく、境界球が視錐台の外の部分木を丸ごと読み飛ばす (SceneGraph.cpp)。
+    {
+        PROFILE_SCOPE(ProfileStage::DrawCull);
+        if (scene) { scene->Cull(GetFrustum(), visibleRanges); } else { visibleRanges.clear(); }
+        if (objects) { objects->Cull(GetFrustum(), visibleNodes); } else { visibleNodes.clear(); }
+    }
+
+    // 集めた範囲の線分だけを変換・クリッピングする (完全に内側の範囲はクリッピングを省略。
+    // 境界をまたぐ範囲も、前のフレームから分類が変わらないブロックはアウトコードの計算を省略する)
+    if (scene) {
+        pipeline.Run(scene->GetSegments(), visibleRanges, viewProjMatrix, WINDOW_WIDTH, WINDOW_HEIGHT, drawThreadPool.get(), visibleSegments,
+            PrepareVisibilityCache());
+    }
+    else {
+        visibleSegments.clear();
+    }
+    // シーングラフの物体は、ノードごとに「ワールド座標の変換行列 × ビュー・プロジェクション行列」を 1 回だけ求め、
+    // 形状の頂点をローカル座標から直接クリップ座標に変換する (形状の頂点をワールド座標に書き換えることはしない)
+    objectSegments.clear();
+    for (uint32_t node : visibleNodes) {
+        const Matrix nodeViewProj = MatrixMultiply(objects->GetWorldTransform(node), viewProjMatrix);
+        pipeline.Run(objects->GetGeometry(objects->GetNodeGeometry(node)), nodeViewProj, WINDOW_WIDTH, WINDOW_HEIGHT,
+            drawThreadPool.get(), nodeSegments);
+        objectSegments.insert(objectSegments.end(), nodeSegments.begin(), nodeSegments.end());
+    }
+    // 毎フレーム作る線分は BVH がないので、全線分を変換・クリッピングする
+    dynamicSegments.clear();
+    if (dynamicLines) {
+        pipeline.Run(*dynamicLines, viewProjMatrix, WINDOW_WIDTH, WINDOW_HEIGHT, drawThreadPool.get(), dynamicSegments);
+    }
+    // メッシュは全頂点を 1 回ずつ変換してから、辺を頂点番号で引いてクリッピングする
+    meshSegments.clear();
+    if (dynamicMesh) {
+        pipeline.Run(*dynamicMesh, viewProjMatrix, WINDOW_WIDTH, WINDOW_HEIGHT, drawThreadPool.get(), meshSegments);
+    }
+
+    SubmitVisibleSegments(sink);
+}
+
+// 入力が前回の Draw と同じなら、前回の描画コマンドを描画先に渡す
+bool Camera::ReplayIfUnchanged(const DrawCacheKey& key, RenderSink& sink) {
+    lastDrawReplayed = drawCacheEnabled && drawCacheValid && key == drawCacheKey;
+    if (lastDrawReplayed) {
+        PROFILE_SCOPE(ProfileStage::DrawRaster);
+        sink.Submit(drawCommands);
+        return true;
     }
+    drawCacheKey = key;
+    drawCacheValid = drawCacheEnabled;
+    return false;
+}
+
+// 前のフレームの分類の記録に、今のカメラの状態を設定する
+BlockVisibilityCache* Camera::PrepareVisibilityCache() {
+    if (!visibilityCacheEnabled) { return nullptr; }
+    sceneVisibility.SetPose({ position, orientation, fovY, aspectRatio, nearZ, farZ });
+    return &sceneVisibility;
+}
+
+// 線を描画コマンドとして記録し、描画先 (sink) にまとめて渡す
+void Camera::SubmitVisibleSegments(RenderSink& sink) {
+    PROFILE_SCOPE(ProfileStage::DrawRaster);
+    // (DxLib などの描画関数はスレッドセーフではないため、記録と描画はここで行う)
+    const RenderColor lineColor = GetRenderColor(255, 255, 255); // 白色 (全ての線で共通なので 1 回だけ決める)
+    drawCommands.Clear(); // 容量は前のフレームのまま残る
+    drawCommands.Reserve(visibleSegments.size() + objectSegments.size() + dynamicSegments.size() + meshSegments.size());
+    for (const ScreenSegment& s : visibleSegments) {
+        drawCommands.AddLine(s.x1, s.y1, s.x2, s.y2, lineColor);
+    }
+    for (const ScreenSegment& s : objectSegments) {
+        drawCommands.AddLine(s.x1, s.y1, s.x2, s.y2, lineColor);
+    }
+    for (const ScreenSegment& s : dynamicSegments) {
+        drawCommands.AddLine(s.x1, s.y1, s.x2, s.y2, lineColor);
+    }
+    for (const ScreenSegment& s : meshSegments) {
+        drawCommands.AddLine(s.x1, s.y1, s.x2, s.y2, lineColor);
+    }
+    sink.Submit(drawCommands);
 
     // デバッグ用: 前回の移動方向を示す線を描画 (メンバ変数 lastWorldMoveOffset が必要)
     // if (lastWorldMoveOffset.LengthSq() > 1e-12f) { // 前回のフレームで移動があった場合
@@ -386,70 +497,95 @@ void Camera::Draw(const std::vector<std::vector<Vector3D>>& worldLines) {
     //     Vector3D endScreen = WorldToScreen(moveEndPos, viewProjMatrix);
     //     // 両端が画面内なら線を描画
     //     if (startScreen.x >= 0.0f && endScreen.x >= 0.0f) {
-    //         DrawLine(static_cast<int>(startScreen.x), static_cast<int>(startScreen.y),
-    //                  static_cast<int>(endScreen.x), static_cast<int>(endScreen.y),
-    //                  GetColor(0, 255, 255)); // 水色
+    //         sink.DrawLine(static_cast<int>(startScreen.x), static_cast<int>(startScreen.y),
+    //                       static_cast<int>(endScreen.x), static_cast<int>(endScreen.y),
+    //                       GetRenderColor(0, 255, 255)); // 水色
     //     }
     // }
 } // Draw 関数の終わり
 
 
-// カメラの状態を更新するメソッド (毎フレーム呼び出される)
-void Camera::Update() {
-    // --- 1. マウスによる視点回転量の計算 ---
+// カメラの状態を更新するメソッド (入力を読み取って Step に渡す)
+// deltaSeconds: 前回の Update からの経過時間 (秒)
+void Camera::Update(float deltaSeconds) {
+    Step(ReadInput(), deltaSeconds);
+}
+
+// マウスの移動量とキーの状態を読み取り、マウスカーソルを画面中央に戻す
+CameraInput Camera::ReadInput() {
+    CameraInput input;
     int currentMouseX = 0, currentMouseY = 0;
     GetMousePoint(&currentMouseX, &currentMouseY); // 現在のマウス座標を取得
     const int centerX = static_cast<int>(WINDOW_WIDTH / 2); // 画面中央 X
     const int centerY = static_cast<int>(WINDOW_HEIGHT / 2); // 画面中央 Y
-    int mouseMoveX = currentMouseX - centerX; // 前フレームからのX移動量
-    int mouseMoveY = currentMouseY - centerY; // 前フレームからのY移動量
+    input.mouseMoveX = currentMouseX - centerX; // 前回読み取ってからの X 移動量
+    input.mouseMoveY = currentMouseY - centerY; // 前回読み取ってからの Y 移動量
+    if (CheckHitKey(KEY_INPUT_W)) { input.keys |= CameraInput::MOVE_FORWARD; }
+    if (CheckHitKey(KEY_INPUT_S)) { input.keys |= CameraInput::MOVE_BACK; }
+    if (CheckHitKey(KEY_INPUT_D)) { input.keys |= CameraInput::MOVE_RIGHT; }
+    if (CheckHitKey(KEY_INPUT_A)) { input.keys |= CameraInput::MOVE_LEFT; }
+    if (CheckHitKey(KEY_INPUT_SPACE)) { input.keys |= CameraInput::MOVE_UP; }
+    if (CheckHitKey(KEY_INPUT_LCONTROL)) { input.keys |= CameraInput::MOVE_DOWN; }
+    if (CheckHitKey(KEY_INPUT_E)) { input.keys |= CameraInput::ROLL_RIGHT; }
+    if (CheckHitKey(KEY_INPUT_Q)) { input.keys |= CameraInput::ROLL_LEFT; }
+    // マウスカーソルを画面中央に戻す
+    // これにより、次に読み取るときに再び中央からの相対移動量を取得できる（相対マウスモード）
+    SetMousePoint(centerX, centerY);
+    return input;
+}
+
+// 入力に応じてカメラの状態を更新するメソッド (毎フレーム、またはシミュレーションのステップごとに呼び出される)
+// deltaSeconds: 前回の Step からの経過時間 (秒)
+void Camera::Step(const CameraInput& input, float deltaSeconds) {
+    PROFILE_SCOPE(ProfileStage::CameraUpdate);
+    // --- 1. マウスによる視点回転量の計算 ---
     // 移動量をメンバ変数に保存 (デバッグ情報表示用)
-    lastMouseMoveX = mouseMoveX;
-    lastMouseMoveY = mouseMoveY;
+    lastMouseMoveX = input.mouseMoveX;
+    lastMouseMoveY = input.mouseMoveY;
 
     // マウス移動量から、このフレームでの回転角度（ラジアン単位）を計算
     // 回転量はメンバ変数に保存 (デバッグ情報表示用)
-    lastYawAngle = static_cast<float>(mouseMoveX) * MOUSE_ANGLE_RATE;   // ヨー角 (左右回転、カメラの上軸周り)
-    lastPitchAngle = static_cast<float>(mouseMoveY) * MOUSE_ANGLE_RATE; // ピッチ角 (上下回転、カメラの右軸周り)
+    lastYawAngle = static_cast<float>(input.mouseMoveX) * MOUSE_ANGLE_RATE;   // ヨー角 (左右回転、カメラの上軸周り)
+    lastPitchAngle = static_cast<float>(input.mouseMoveY) * MOUSE_ANGLE_RATE; // ピッチ角 (上下回転、カメラの右軸周り)
 
     // --- 2. キーボードによるロール回転量の計算 ---
     // ロール角 (傾き回転、カメラの前方軸周り)
     lastRollAngle = 0.0f; // フレーム開始時にリセット
-    if (CheckHitKey(KEY_INPUT_E)) { lastRollAngle += ROLL_SPEED; } // Eキーで右回りロール
-    if (CheckHitKey(KEY_INPUT_Q)) { lastRollAngle -= ROLL_SPEED; } // Qキーで左回りロール
+    if (input.keys & CameraInput::ROLL_RIGHT) { lastRollAngle += ROLL_SPEED * deltaSeconds; } // Eキーで右回りロール
+    if (input.keys & CameraInput::ROLL_LEFT) { lastRollAngle -= ROLL_SPEED * deltaSeconds; }  // Qキーで左回りロール
 
     // --- 3. 回転の適用 ---
-    // まず、現在のカメラのローカル座標軸ベクトルを取得する
+    // まず、現在のカメラのローカル座標軸ベクトル (currentUp など) を最新にする
     // これらのベクトルは、この後の回転計算の軸として使われる
-    // 計算結果はメンバ変数に保存 (デバッグ情報表示用、および移動計算用)
-    currentUp = GetUpVector();
-    currentRight = GetRightVector();
-    currentForward = GetForwardVector();
-
-    // 各回転軸と角度から、このフレームでの差分回転を表すクォータニオンを生成
-    Quaternion yawDelta = Quaternion::FromAxisAngle(currentUp, lastYawAngle);
-    Quaternion pitchDelta = Quaternion::FromAxisAngle(currentRight, lastPitchAngle);
-    Quaternion rollDelta = Quaternion::FromAxisAngle(currentForward, lastRollAngle);
-
-    // ３つの差分回転クォータニオンを合成して、このフレーム全体の回転を表すクォータニオンを計算
-    // 合成順序は Roll -> Pitch -> Yaw (ローカル軸周りの回転順序)
-    Quaternion deltaRotation = rollDelta * pitchDelta * yawDelta;
-
-    // 現在のカメラの向き (`orientation`) に、計算した差分回転 (`deltaRotation`) を適用する
-    // 注意: `deltaRotation * orientation` はワールド座標系での回転適用。
-    //       FPS視点操作としては `orientation * deltaRotation` (ローカル座標系での適用) が一般的。
-    orientation = deltaRotation * orientation;
-    // クォータニオンは計算誤差で長さが1からずれる可能性があるので、正規化して長さを1に保つ
-    orientation.Normalize();
+    // (前回の回転の後に計算した値が残っていれば、回転行列は作り直さない)
+    RefreshBasis();
+
+    // 回転の入力がないフレームは向きを変えない (軸ベクトルとビュー行列のキャッシュもそのまま使える)
+    if (lastYawAngle != 0.0f || lastPitchAngle != 0.0f || lastRollAngle != 0.0f) {
+        // 各回転軸と角度から、このフレームでの差分回転を表すクォータニオンを生成
+        Quaternion yawDelta = Quaternion::FromAxisAngle(currentUp, lastYawAngle);
+        Quaternion pitchDelta = Quaternion::FromAxisAngle(currentRight, lastPitchAngle);
+        Quaternion rollDelta = Quaternion::FromAxisAngle(currentForward, lastRollAngle);
+
+        // ３つの差分回転クォータニオンを合成して、このフレーム全体の回転を表すクォータニオンを計算
+        // 合成順序は Roll -> Pitch -> Yaw (ローカル軸周りの回転順序)
+        Quaternion deltaRotation = rollDelta * pitchDelta * yawDelta;
+
+        // 現在のカメラの向き (`orientation`) に、計算した差分回転 (`deltaRotation`) を適用する
+        // 注意: `deltaRotation * orientation` はワールド座標系での回転適用。
+        //       FPS視点操作としては `orientation * deltaRotation` (ローカル座標系での適用) が一般的。
+        orientation = deltaRotation * orientation;
+        // クォータニオンは計算誤差で長さが1からずれる可能性があるので、正規化して長さを1に保つ
+        orientation.Normalize();
+        MarkOrientationChanged();
+    }
 
     // ピッチ角制限は削除 // 元のコードにあったコメント。このコードにはピッチ制限処理自体がない。
 
     // --- 4. カメラの向きベクトル再計算 ---
     // 回転が適用された後の、最新のローカル軸ベクトルを計算し、メンバ変数に保存する
-    // これは次の移動計算で使われる。
-    currentForward = GetForwardVector();
-    currentRight = GetRightVector();
-    currentUp = GetUpVector();
+    // これは次の移動計算で使われる。(回転行列を作るのはここで 1 回だけ)
+    RefreshBasis();
 
     // --- 5. キーボードによる移動入力の取得 ---
     // 各方向への移動入力状態 (-1.0, 0.0, or 1.0) をメンバ変数に保存 (デバッグ情報表示用)
@@ -457,31 +593,30 @@ void Camera::Update() {
     lastMoveRight = 0.0f;   // 左右移動用フラグをリセット
     lastMoveUp = 0.0f;      // 上下移動用フラグをリセット
     // 対応するキーが押されていたらフラグを更新
-    if (CheckHitKey(KEY_INPUT_W)) { lastMoveForward += 1.0f; } // 前進
-    if (CheckHitKey(KEY_INPUT_S)) { lastMoveForward -= 1.0f; } // 後退
-    if (CheckHitKey(KEY_INPUT_D)) { lastMoveRight += 1.0f; }   // 右移動
-    if (CheckHitKey(KEY_INPUT_A)) { lastMoveRight -= 1.0f; }   // 左移動
-    if (CheckHitKey(KEY_INPUT_SPACE)) { lastMoveUp += 1.0f; }    // 上昇
-    if (CheckHitKey(KEY_INPUT_LCONTROL)) { lastMoveUp -= 1.0f; } // 下降
+    if (input.keys & CameraInput::MOVE_FORWARD) { lastMoveForward += 1.0f; } // 前進
+    if (input.keys & CameraInput::MOVE_BACK) { lastMoveForward -= 1.0f; }    // 後退
+    if (input.keys & CameraInput::MOVE_RIGHT) { lastMoveRight += 1.0f; }     // 右移動
+    if (input.keys & CameraInput::MOVE_LEFT) { lastMoveRight -= 1.0f; }      // 左移動
+    if (input.keys & CameraInput::MOVE_UP) { lastMoveUp += 1.0f; }           // 上昇
+    if (input.keys & CameraInput::MOVE_DOWN) { lastMoveUp -= 1.0f; }         // 下降
 
     // --- 6. 移動量の計算とカメラ位置の更新 ---
     // このフレームで実際に移動するワールド空間でのベクトル (`lastWorldMoveOffset`) を計算
     lastWorldMoveOffset = { 0.0f, 0.0f, 0.0f }; // 移動オフセットをリセット
-    // 各ローカル軸の方向に入力フラグと移動速度を掛けて、移動ベクトルを合成
-    lastWorldMoveOffset += currentForward * lastMoveForward * MOVE_SPEED; // 前後方向の移動量
-    lastWorldMoveOffset += currentRight * lastMoveRight * MOVE_SPEED;   // 左右方向の移動量
-    lastWorldMoveOffset += currentUp * lastMoveUp * MOVE_SPEED;       // 上下方向の移動量
+    // 各ローカル軸の方向に入力フラグと移動距離 (移動速度 × 経過時間) を掛けて、移動ベクトルを合成
+    const float moveDistance = MOVE_SPEED * deltaSeconds;
+    lastWorldMoveOffset += currentForward * lastMoveForward * moveDistance; // 前後方向の移動量
+    lastWorldMoveOffset += currentRight * lastMoveRight * moveDistance;   // 左右方向の移動量
+    lastWorldMoveOffset += currentUp * lastMoveUp * moveDistance;       // 上下方向の移動量
     // 計算された移動オフセットを、現在のカメラの位置 `position` に加算して、位置を更新
-    position += lastWorldMoveOffset;
-
-    // --- 7. マウスカーソルを画面中央に戻す ---
-    // これにより、次のフレームで再び中央からの相対移動量を取得できる（相対マウスモード）
-    SetMousePoint(centerX, centerY);
+    if (lastMoveForward != 0.0f || lastMoveRight != 0.0f || lastMoveUp != 0.0f) {
+        position += lastWorldMoveOffset;
+        MarkPositionChanged(); // ビュー行列は次に使われるときに計算し直される
+    }
 
-    // --- デバッグログ出力 ---
-    // 現在のフレームの詳細なカメラ情報をログファイルに出力する
-    LogDebug(GetDetailedDebugInfo());
-} // Update 関数の終わり
+    // 現在のフレームの詳細なカメラ情報は、呼び出し元が FillTelemetry でフレームの記録に書き込む
+    // (以前はここで GetDetailedDebugInfo の文字列を毎フレームログに書いていた)
+} // Step 関数の終わり
 
 // デバッグ情報（画面表示用）を文字列として返す関数
 std::string Camera::GetDebugInfo() const {
@@ -504,6 +639,7 @@ std::string Camera::GetDebugInfo() const {
 
 // デバッグ情報（ログファイル用）を文字列として返す関数
 std::string Camera::GetDetailedDebugInfo() const {
+    RefreshBasis(); // 軸ベクトルを最新にしておく
     // 元のコードの通り。対応するメンバ変数(last*, current*)が必要。
     std::stringstream ss; // 文字列ストリーム
     ss << std::fixed << std::setprecision(4); // 小数点以下4桁で表示
@@ -529,4 +665,26 @@ std::string Camera::GetDetailedDebugInfo() const {
     ss << "MoveOffset(x:" << lastWorldMoveOffset.x << ",y:" << lastWorldMoveOffset.y << ",z:" << lastWorldMoveOffset.z << ")";
     // 組み立てた文字列を返す
     return ss.str();
-} // GetDetailedDebugInfo 関数の終わり
\ No newline at end of file
+} // GetDetailedDebugInfo 関数の終わり
+
+// GetDetailedDebugInfo と同じ項目をフレームの記録にコピーする関数
+void Camera::FillTelemetry(FrameTelemetryRecord& record) const {
+    RefreshBasis(); // 軸ベクトルを最新にしておく
+    const Vector3D* vectors[] = { &position, &currentForward, &currentRight, &currentUp, &lastWorldMoveOffset };
+    float* targets[] = { record.position, record.axisForward, record.axisRight, record.axisUp, record.moveOffset };
+    for (int i = 0; i < 5; ++i) {
+        targets[i][0] = vectors[i]->x; targets[i][1] = vectors[i]->y; targets[i][2] = vectors[i]->z;
+    }
+    record.orientation[0] = orientation.x; record.orientation[1] = orientation.y;
+    record.orientation[2] = orientation.z; record.orientation[3] = orientation.w;
+    record.mouseMove[0] = lastMouseMoveX;
+    record.mouseMove[1] = lastMouseMoveY;
+    record.rotationRadians[0] = lastYawAngle;
+    record.rotationRadians[1] = lastPitchAngle;
+    record.rotationRadians[2] = lastRollAngle;
+    record.keyInput[0] = lastMoveForward;
+    record.keyInput[1] = lastMoveRight;
+    record.keyInput[2] = lastMoveUp;
+    // ロールの入力は Update で保存していないので、回転角度の符号から求める (E: +1, Q: -1, 両方: 0)
+    record.keyInput[3] = (lastRollAngle > 0.0f) ? 1.0f : ((lastRollAngle < 0.0f) ? -1.0f : 0.0f);
+} // FillTelemetry 関数の終わり
\ No newline at end of file
@@ -1,116 +1,357 @@
 #pragma once
-#include "Common.h"     // 萔 (WINDOW_WIDTH, WINDOW_HEIGHT, ONE_DEGREE, PI)
-#include "Vector.h"     // Vector3D \
-#include <vector>       // std::vector (Draw\bḧŎgp)
-#include <string>       // std::string (fobOp)
-#include <sstream>      // std::stringstream (fobOp)
-#include <iomanip>      // std::setprecision (fobOp)
-#include "Matrix.h"     // Matrix \ (r[EvWFNVsp)
-#include "Quaternion.h" // Quaternion \ (J̌Ǘp)
+#include "Common.h"     // 定数 (WINDOW_WIDTH, WINDOW_HEIGHT, ONE_DEGREE, PI)
+#include "Vector.h"     // Vector3D 構造体
+#include <vector>       // std::vector
+#include <string>       // std::string (デバッグ情報用)
+#include <sstream>      // std::stringstream (デバッグ情報用)
+#include <iomanip>      // std::setprecision (デバッグ情報用)
+#include "Matrix.h"     // Matrix 構造体 (ビュー・プロジェクション行列用)
+#include "CameraMath.h" // Frustum 構造体 (視錐台)
+#include "Quaternion.h" // Quaternion 構造体 (カメラの向き管理用)
+#include "SegmentBuffer.h" // SegmentBuffer クラス (Drawメソッドの引数で使用)
+#include "WireMesh.h"   // WireMesh クラス (Drawメソッドの引数で使用)
+#include "WireframePipeline.h" // WireframePipeline クラス (変換・クリッピング処理), ScreenSegment 構造体
+#include "DrawCommandList.h" // DrawCommandList クラス (描画コマンドの記録)
+#include "BlockVisibilityCache.h" // BlockVisibilityCache クラス (前のフレームの分類の使い回し)
+#include "SceneGraph.h" // SceneGraph クラス (ノードごとの変換行列を持つ物体。Drawメソッドの引数で使用)
+#include <memory>       // std::unique_ptr (スレッドプールの所有)
+#include <cstdint>      // uint64_t (スナップショットのステップ番号)
+
+class RenderSink; // 前方宣言 (描画先のインターフェース。定義は RenderSink.h)
+class SegmentBVH; // 前方宣言 (線分の BVH。定義は SegmentBVH.h)
+class ThreadPool; // 前方宣言 (Draw の並列処理に使うスレッドプール。定義は ThreadPool.h)
+struct FrameTelemetryRecord; // 前方宣言 (フレームの記録。定義は FrameTelemetry.h)
 
 /*
  * Camera.h
- * Tv:
- *   FPS (First Person Shooter) _̃J@\񋟂NX̃wb_[t@CłB
- *   J̈ʒuAi]jApȂǂ̏ǗA
- *   J_̕`ɕKvȌvZAĴ̑iړA]js߂
- *   {Iȋ@\ioϐ⃁o֐j`܂B
+ * 概要:
+ *   FPS (First Person Shooter) 視点のカメラ機能を提供するクラスのヘッダーファイルです。
+ *   カメラの位置、向き（回転）、視野角などの情報を管理し、
+ *   カメラ視点からの描画に必要な計算や、カメラ自体の操作（移動、回転）を行うための
+ *   基本的な機能（メンバ変数やメンバ関数）を定義します。
+ *
+ * 元のコード(最初のバージョン)からの改善点 (このヘッダーファイルで定義されている内容):
+ * 1. 回転の管理方法:
+ *    - 元のコードではオイラー角（X,Y,Z軸周りの回転角度）で向きを管理していましたが、
+ *      このヘッダーではクォータニオン (`orientation` メンバ変数) を使用しています。
+ *    - クォータニオンを使うことで、特定の角度で回転がおかしくなる「ジンバルロック」問題を回避できます。
+ *
+ * 2. 標準的な座標変換機能:
+ *    - 3Dグラフィックスで一般的に使われるビュー行列 (`GetViewMatrix`) と
+ *      プロジェクション行列 (`GetProjectionMatrix`) を計算・取得する関数を提供します。
+ *    - これにより、ワールド座標からスクリーン座標への変換を正確に行うことができます。
+ *
+ * 3. ローカル座標軸の取得:
+ *    - カメラ自身の前・右・上方向を示すベクトル (`GetForwardVector` など) を取得できます。
+ *    - これを使うことで、カメラの向いている方向を基準とした移動（ローカル移動）が可能になります。
+ *
+ * 4. 状態管理用のメンバ変数:
+ *    - カメラの視野角(`fovY`)、画面比率(`aspectRatio`)、描画する奥行き範囲(`nearZ`, `farZ`)など、
+ *      プロジェクション計算に必要なパラメータをメンバ変数として持ちます。
+ *    - また、デバッグ情報の表示に必要な、前回のフレームでのマウス移動量(`lastMouseMoveX`)や
+ *      計算された回転角度(`lastYawAngle`)などもメンバ変数として保持します。
+ *
+ * 5. 軸ベクトルと行列のキャッシュ:
+ *    - ローカル軸ベクトル、ビュー行列、プロジェクション行列、その積 (ビュー・プロジェクション行列)、視錐台は
+ *      メンバ変数に保存しておき、位置・向き・レンズの設定が変わったときだけ計算し直します (dirtyFlags)。
+ *    - 計算し直すのは、変わった後に初めて Get... が呼ばれたときです。そのため const の Get... 関数も
+ *      キャッシュを書き換えます (同じ Camera の関数を複数のスレッドから同時に呼ばないでください)。
+ *    - レンズの設定 (視野角・アスペクト比・ニア/ファークリップ面) は `SetLens` などで変更できます。
+ *    - ビュー・プロジェクション行列を計算し直すたびに版番号 (`GetViewProjectionVersion`) が変わります。
  *
- * ̃R[h(ŏ̃o[W)̉P_ (̃wb_[t@CŒ`Ăe):
- * 1. ]̊Ǘ@:
- *    - ̃R[hł̓IC[piX,Y,Z̉]pxjŌǗĂ܂A
- *      ̃wb_[ł̓NH[^jI (`orientation` oϐ) gpĂ܂B
- *    - NH[^jIgƂŁÅpxŉ]ȂuWobNvł܂B
+ * 6. 時間に基づく移動とスナップショット:
+ *    - `Update(deltaSeconds)` は、キー入力による移動とロール回転に経過時間を掛けます (MOVE_SPEED は 1 秒あたり)。
+ *      そのため、Update を呼ぶ間隔 (フレームレート) が変わってもカメラの速さは変わりません。
+ *      マウスによる回転は、マウスが動いた量そのものなので経過時間には依存しません。
+ *    - 位置・向きと、デバッグ表示・フレームの記録に使う入力の値は `CameraSnapshot` にまとめて取り出し
+ *      (`CaptureSnapshot`)、別の Camera に設定できます (`ApplySnapshot`)。
+ *      シミュレーションのスレッドで Update した Camera の状態を、描画のスレッドの Camera に渡すのに使います
+ *      (CameraSimulation.h)。
+ *    - Update は「入力の読み取り (`ReadInput`)」と「入力による更新 (`Step`)」に分かれています。
+ *      ReadInput は DxLib の入力関数 (GetMousePoint, CheckHitKey, SetMousePoint) を呼ぶのでメインのスレッドで、
+ *      Step は DxLib の関数を呼ばないので、どのスレッドでも実行できます。
  *
- * 2. WIȍWϊ@\:
- *    - 3DOtBbNXňʓIɎgr[s (`GetViewMatrix`) 
- *      vWFNVs (`GetProjectionMatrix`) vZE擾֐񋟂܂B
- *    - ɂA[hWXN[Wւ̕ϊ𐳊mɍsƂł܂B
+ * 7. 描画結果の使い回し:
+ *    - Draw は、前回の Draw と「ビュー・プロジェクション行列の版番号」「渡された線分・メッシュとその版番号
+ *      (SegmentBuffer::GetVersion など)」が全て同じなら、変換・カリング・クリッピングをせずに、
+ *      前回記録した描画コマンド (`GetDrawCommands`) をそのまま描画先に渡します。
+ *      カメラが止まっていて場面も変わらない間は、Draw の処理がほぼ描画先への受け渡しだけになります。
+ *    - 毎フレーム作り直す線分 (球の LOD や地面のグリッド) は、作り直すと版番号が変わります。
+ *      カメラが動いていないフレームでは作り直さないでください (Main.cpp は GetViewProjectionVersion で判定しています)。
  *
- * 3. [JW̎擾:
- *    - Jg̑OEEExNg (`GetForwardVector` Ȃ) 擾ł܂B
- *    - gƂŁAJ̌ĂƂړi[Jړj\ɂȂ܂B
+ * 8. 前のフレームの分類の使い回し (時間的コヒーレンス):
+ *    - Draw は、描画する線分 (SegmentBuffer 版の worldLines と BVH 版の scene) のブロックごとに、
+ *      視錐台との位置関係 (完全に内側 / 完全に外 / 境界をまたぐ) を `BlockVisibilityCache` に記録します。
+ *    - 次のフレームでは、分類したときからのカメラの移動量と向きの変化から視錐台が動いた距離の上限を求め、
+ *      それが記録した余裕より小さいブロックはアウトコードの計算を省略します (外のブロックは変換も省略)。
+ *      カメラが滑らかに動く間は、境界の近くのブロックだけを分類し直すことになります。
+ *    - 毎フレーム作り直す線分 (dynamicLines) は、作り直すと版番号が変わって記録が使えないので対象外です。
+ *    - `SetVisibilityCacheEnabled(false)` で無効にできます (出力される線分は有効なときと同じです)。
  *
- * 4. ԊǗp̃oϐ:
- *    - J̎p(`fovY`)Aʔ䗦(`aspectRatio`)A`悷鉜s͈(`nearZ`, `farZ`)ȂǁA
- *      vWFNVvZɕKvȃp[^oϐƂĎ܂B
- *    - ܂AfobO̕\ɕKvȁAÕt[ł̃}EXړ(`lastMouseMoveX`)
- *      vZꂽ]px(`lastYawAngle`)ȂǂoϐƂĕێ܂B
+ * 9. シーングラフの物体:
+ *    - Draw には、ワールド座標の線分 (BVH) とは別に、ノードごとに変換行列を持つ物体 (`SceneGraph`) を渡せます。
+ *    - シーングラフを境界球で階層的にカリングし (SceneGraph::Cull)、視錐台に入ったノードごとに
+ *      「ノードのワールド座標の変換行列 × ビュー・プロジェクション行列」を 1 回だけ計算して、
+ *      形状の頂点をローカル座標から直接クリップ座標に変換します。同じ形状を何個置いても、形状は 1 つだけです。
+ *    - 描画結果の使い回し (7.) では、シーングラフの版番号 (SceneGraph::GetVersion) も比べます。
+ *      ノードを動かす (SetLocalTransform) と版番号が変わるので、そのフレームは描画し直されます。
  *
- * ̃wb_[t@C̎g:
- *   - ̃t@C (: Main.cpp)  `#include "Camera.h"` ܂B
- *   - `Camera` NX̃IuWFNg쐬܂ (: `Camera mainCamera;`)B
- *   - Q[[v̒ŁAt[ `mainCamera.Update()` ĂяoāA
- *     vC[̓͂ȂǂɉăJ̏ԁiʒujXV܂B
- *   - `̍ۂɂ `mainCamera.Draw(worldLines)` ĂяoāA
- *     3DIuWFNgif[^jJ̎_`悵܂B
- *   - Kvɉ `mainCamera.GetPosition()`  `mainCamera.GetViewMatrix()` Ȃǂ
- *     J̏擾ėp܂B
- *   - fobOp `mainCamera.GetDebugInfo()`  `mainCamera.GetDetailedDebugInfo()` 
- *     ĂяoāAJ̏ԂmFł܂B
+ * このヘッダーファイルの使い方:
+ *   - 他のファイル (例: Main.cpp) で `#include "Camera.h"` します。
+ *   - `Camera` クラスのオブジェクトを作成します (例: `Camera mainCamera;`)。
+ *   - ゲームループの中で、毎フレーム `mainCamera.Update()` を呼び出して、
+ *     プレイヤーの入力などに応じてカメラの状態（位置や向き）を更新します。
+ *   - 描画の際には `mainCamera.Draw(worldLines, sink)` を呼び出して、
+ *     3Dオブジェクト（線データ）をカメラの視点から描画先 (`RenderSink`) に描画します。
+ *   - 必要に応じて `mainCamera.GetPosition()` や `mainCamera.GetViewMatrix()` などで
+ *     カメラの情報を取得して利用します。
+ *   - デバッグ用に `mainCamera.GetDebugInfo()` や `mainCamera.GetDetailedDebugInfo()` を
+ *     呼び出して、カメラの状態を確認できます。
  */
 
+// カメラの操作の入力 (Camera::Step に渡す)。Camera::ReadInput でメインのスレッドが読み取る。
+struct CameraInput {
+    // 押されているキー (keys のビット)
+    enum Key : uint32_t {
+        MOVE_FORWARD = 1u << 0, // W: 前進
+        MOVE_BACK = 1u << 1,    // S: 後退
+        MOVE_RIGHT = 1u << 2,   // D: 右移動
+        MOVE_LEFT = 1u << 3,    // A: 左移動
+        MOVE_UP = 1u << 4,      // Space: 上昇
+        MOVE_DOWN = 1u << 5,    // 左 Ctrl: 下降
+        ROLL_RIGHT = 1u << 6,   // E: 右回りロール
+        ROLL_LEFT = 1u << 7,    // Q: 左回りロール
+    };
+    int mouseMoveX = 0; // マウスの移動量 (前に読み取ってから。カーソルを画面中央に戻した位置からの移動量)
+    int mouseMoveY = 0;
+    uint32_t keys = 0;  // 押されているキー (Key の組み合わせ)
+};
+
+// Update で決まるカメラの状態 (位置・向きと、その Update の入力)。
+// CameraSimulation がシミュレーションのステップごとに作り、描画のスレッドに渡す (作った後は変更しない)。
+struct CameraSnapshot {
+    Vector3D position;          // カメラの位置
+    Quaternion orientation;     // カメラの向き
+    int mouseMoveX = 0;         // この Update でのマウスの移動量
+    int mouseMoveY = 0;
+    float yawAngle = 0.0f;      // この Update での回転角度 (ラジアン)
+    float pitchAngle = 0.0f;
+    float rollAngle = 0.0f;
+    float moveForward = 0.0f;   // この Update での移動の入力 (-1.0, 0.0, 1.0)
+    float moveRight = 0.0f;
+    float moveUp = 0.0f;
+    Vector3D worldMoveOffset;   // この Update での移動量 (ワールド座標)
+    uint64_t step = 0;          // 何回目のシミュレーションのステップで作ったか (CameraSimulation が設定する)
+};
+
 class Camera
 {
-public: // NX̊OANZXł郁o (֐ϐ)
-    // RXgN^: CameraIuWFNgƂɎIɌĂяo֐
+public: // クラスの外部からアクセスできるメンバ (関数や変数)
+    // コンストラクタ: Cameraオブジェクトが生成されるときに自動的に呼び出される関数
     Camera();
-    // fXgN^: CameraIuWFNgjƂɎIɌĂяo֐
+    // デストラクタ: Cameraオブジェクトが破棄されるときに自動的に呼び出される関数
     ~Camera();
 
-    // `惁\bh: [hԂ̐f[^(`worldLines`)󂯎AJ猩iFƂĕ`悷
-    void Draw(const std::vector<std::vector<Vector3D>>& worldLines);
-    // XV\bh: }EXL[{[h̓͂ɉāAJ̈ʒuXV
-    void Update();
+    // 描画メソッド: ワールド空間の線分データ(`worldLines`)を受け取り、カメラから見た景色として描画先(`sink`)に描画する
+    void Draw(const SegmentBuffer& worldLines, RenderSink& sink);
+    // 描画メソッド (BVH 版): `scene` の BVH を視錐台でたどり、視錐台に入る部分の線分だけを描画する。
+    // 視錐台の外の部分は変換もされず、完全に内側の部分はクリッピングが省略される。
+    void Draw(const SegmentBVH& scene, RenderSink& sink);
+    // 描画メソッド (BVH + 毎フレーム作る線分): `scene` に加えて、フレームごとに作り直す線分 `dynamicLines`
+    // (LOD を選んだ球など。BVH を持たないので全線分を変換する) も同じ描画コマンドに記録してまとめて描画する。
+    void Draw(const SegmentBVH& scene, const SegmentBuffer& dynamicLines, RenderSink& sink);
+    // 描画メソッド (BVH + 毎フレーム作る線分 + 毎フレーム作るメッシュ): `dynamicMesh` はインデックス付きメッシュ
+    // (LOD を選んだ球など) で、頂点を 1 回ずつだけ変換してから辺を描画する。
+    void Draw(const SegmentBVH& scene, const SegmentBuffer& dynamicLines, const WireMesh& dynamicMesh, RenderSink& sink);
+    // 描画メソッド (シーングラフ): `objects` のノードのうち視錐台に入るものだけを、ノードの変換行列で配置して描画する。
+    void Draw(const SceneGraph& objects, RenderSink& sink);
+    // 描画メソッド (BVH + シーングラフ + 毎フレーム作る線分・メッシュ): 全てを同じ描画コマンドに記録してまとめて描画する。
+    void Draw(const SegmentBVH& scene, const SceneGraph& objects, const SegmentBuffer& dynamicLines,
+        const WireMesh& dynamicMesh, RenderSink& sink);
+    // 直前の Draw で記録した描画コマンドを取得する (フレームの再描画や比較用)
+    const DrawCommandList& GetDrawCommands() const { return drawCommands; }
+    // 前回と同じ入力の Draw で、前回の描画コマンドを使い回すかどうか (初期値は true)。
+    // false にすると毎回変換・クリッピングする (ベンチマークで処理時間を測るときなど)。
+    void SetDrawCacheEnabled(bool enabled) { drawCacheEnabled = enabled; drawCacheValid = false; }
+    // 直前の Draw が、前回の描画コマンドを使い回しただけなら true
+    bool WasLastDrawReplayed() const { return lastDrawReplayed; }
+    // 前のフレームのブロックの分類 (視錐台の内側 / 外) を使い回すかどうか (初期値は true)。
+    // false にすると毎回全ブロックのアウトコードを計算する (出力される線分は変わらない)。
+    void SetVisibilityCacheEnabled(bool enabled) { visibilityCacheEnabled = enabled; sceneVisibility.Invalidate(); }
+    // 描画する線分のブロックの分類の記録 (直前の Draw で使い回したブロックの数などを調べるのに使う)
+    const BlockVisibilityCache& GetVisibilityCache() const { return sceneVisibility; }
+    // 更新メソッド: マウスやキーボードの入力に応じて、カメラの位置や向きを更新する (Step(ReadInput(), deltaSeconds) と同じ)
+    // deltaSeconds: 前回の Update からの経過時間 (秒)。キー入力による移動とロール回転の量に掛ける。
+    // DxLib の入力関数を呼ぶので、メインのスレッドから呼ぶこと。
+    void Update(float deltaSeconds = DEFAULT_UPDATE_SECONDS);
+    // 入力 input に応じて、カメラの位置や向きを deltaSeconds 秒分だけ更新する (DxLib の関数は呼ばない)
+    void Step(const CameraInput& input, float deltaSeconds = DEFAULT_UPDATE_SECONDS);
+    // マウスの移動量とキーの状態を読み取り、マウスカーソルを画面中央に戻す (メインのスレッドから呼ぶ)
+    static CameraInput ReadInput();
+    // Update の経過時間の既定値 (60fps の 1 フレーム分)
+    static const float DEFAULT_UPDATE_SECONDS;
+
+    // 現在の位置・向きと、最後の Update の入力をスナップショットにする (step は 0)
+    CameraSnapshot CaptureSnapshot() const;
+    // スナップショットの位置・向きと入力の値を設定する (変わったときだけ行列を計算し直す)
+    void ApplySnapshot(const CameraSnapshot& snapshot);
 
-    // --- Qb^[ (Getter) ֐ ---
-    // NX̓f[^擾邽߂̊֐Q (constwœf[^ύXȂƂۏ)
+    // Draw() の変換・クリッピング処理に使うスレッド数 (呼び出し元を含む) を設定・取得する
+    // 0 を指定すると CPU の論理コア数に合わせる。1 なら並列化しない (初期値)。
+    // 線分が少ない場合は、設定に関係なく 1 スレッドで処理される。
+    void SetDrawThreadCount(unsigned int count);
+    unsigned int GetDrawThreadCount() const;
+    // Draw() で使っているスレッドプール (1 スレッド設定のときは nullptr)。BVH の構築などにも使える。
+    ThreadPool* GetDrawThreadPool() const { return drawThreadPool.get(); }
 
-    // J݂̌̃[hW (Vector3D) 擾
+    // --- ゲッター (Getter) 関数 ---
+    // クラスの内部データを取得するための関数群 (const指定で内部データを変更しないことを保証)
+
+    // カメラの現在のワールド座標 (Vector3D) を取得する
     Vector3D GetPosition() const;
+    // 垂直方向の視野角 (ラジアン) を取得する (球の LOD の選択などに使う)
+    float GetFovY() const { return fovY; }
+    float GetAspectRatio() const { return aspectRatio; } // アスペクト比 (幅 / 高さ)
+    float GetNearZ() const { return nearZ; }             // ニアクリップ面までの距離
+    float GetFarZ() const { return farZ; }               // ファークリップ面までの距離
+    // カメラの位置と向きを直接設定する (入力を使わずに視点を固定するとき。ベンチマークなどで使う)
+    // orientation は正規化してから設定し、ローカル軸ベクトルも更新する。
+    void SetPose(const Vector3D& newPosition, const Quaternion& newOrientation);
+
+    // --- レンズ (プロジェクション) の設定 ---
+    // 不正な値 (視野角が 0 より大きく PI より小さくない、アスペクト比が 0 以下、0 < nearZ < farZ でない) なら
+    // 何も変更せずに false を返す。変更するとプロジェクション行列は次に使われるときに計算し直される。
+    bool SetLens(float newFovY, float newAspectRatio, float newNearZ, float newFarZ);
+    bool SetFovY(float newFovY) { return SetLens(newFovY, aspectRatio, nearZ, farZ); }
+    bool SetAspectRatio(float newAspectRatio) { return SetLens(fovY, newAspectRatio, nearZ, farZ); }
+    bool SetClipPlanes(float newNearZ, float newFarZ) { return SetLens(fovY, aspectRatio, newNearZ, newFarZ); }
+
+    // ビュー行列 (Matrix) を取得する。これはワールド座標系からカメラ座標系への変換を行う行列
+    const Matrix& GetViewMatrix() const;
+    // プロジェクション行列 (Matrix) を取得する。これはカメラ座標系からクリップ座標系への変換（透視投影）を行う行列
+    const Matrix& GetProjectionMatrix() const;
+    // ビュー行列 * プロジェクション行列 を取得する (ワールド座標系からクリップ座標系へ一度に変換する行列)
+    const Matrix& GetViewProjectionMatrix() const;
+    // ビュー・プロジェクション行列の版番号 (位置・向き・レンズの設定が変わり、行列を計算し直すたびに増える)。
+    // 同じ値なら、前に取得したときから行列も視錐台も変わっていない。
+    uint64_t GetViewProjectionVersion() const;
+    // 現在の視錐台 (GetViewProjectionMatrix から取り出した 6 平面) を取得する。
+    // 物体の境界球・AABB が映るかどうかを、線分を変換する前に判定するのに使う。
+    const Frustum& GetFrustum() const;
+
+    // カメラのローカル座標系の各軸が、現在ワールド座標系でどちらを向いているかを示すベクトルを取得する
+    Vector3D GetForwardVector() const; // カメラの前方 (+Z軸方向)
+    Vector3D GetRightVector() const;   // カメラの右方 (+X軸方向)
+    Vector3D GetUpVector() const;      // カメラの上方 (+Y軸方向)
+
+    // デバッグ情報取得用の関数
+    std::string GetDebugInfo() const;         // 画面表示に適した、短い形式のデバッグ情報文字列を返す
+    std::string GetDetailedDebugInfo() const; // ログファイル出力などに適した、詳細なデバッグ情報文字列を返す
+    // GetDetailedDebugInfo と同じ項目を、書式化せずにフレームの記録 (FrameTelemetry.h) にコピーする
+    // (フレーム番号と時間の項目は変更しない。毎フレームのログにはこちらを使う)
+    void FillTelemetry(FrameTelemetryRecord& record) const;
+
+private: // クラスの内部からのみアクセスできるメンバ (外部からは直接アクセスできない)
+    // visibleSegments, objectSegments, dynamicSegments, meshSegments を描画コマンドとして記録し、sink にまとめて渡す (各 Draw で共通の後半部分)
+    void SubmitVisibleSegments(RenderSink& sink);
+
+    // Draw の入力 (これが前回と同じなら、前回の描画コマンドを使い回せる)
+    struct DrawCacheKey {
+        uint64_t viewProjectionVersion;
+        const void* scene;           // 描画する線分 (SegmentBuffer または SegmentBVH)
+        uint64_t sceneVersion;
+        const void* objects;         // シーングラフ (なければ nullptr)
+        uint64_t objectsVersion;
+        const void* dynamicLines;    // 毎フレーム作る線分 (なければ nullptr)
+        uint64_t dynamicLinesVersion;
+        const void* dynamicMesh;     // 毎フレーム作るメッシュ (なければ nullptr)
+        uint64_t dynamicMeshVersion;
+        bool operator==(const DrawCacheKey& other) const {
+            return viewProjectionVersion == other.viewProjectionVersion && scene == other.scene &&
+                sceneVersion == other.sceneVersion && objects == other.objects &&
+                objectsVersion == other.objectsVersion && dynamicLines == other.dynamicLines &&
+                dynamicLinesVersion == other.dynamicLinesVersion && dynamicMesh == other.dynamicMesh &&
+                dynamicMeshVersion == other.dynamicMeshVersion;
+        }
+    };
+    // BVH 版の Draw の本体: nullptr の入力 (scene, objects, dynamicLines, dynamicMesh) は「なし」として扱う。
+    // 公開している Draw の各版は、足りない入力を nullptr にしてここに渡す。
+    void DrawScene(const SegmentBVH* scene, const SceneGraph* objects, const SegmentBuffer* dynamicLines,
+        const WireMesh* dynamicMesh, RenderSink& sink);
+    // key が前回の Draw と同じなら、前回の描画コマンドを sink に渡して true を返す。
+    // 違えば key を記録して false を返す (呼び出し元が変換・クリッピングして描画コマンドを作り直す)。
+    bool ReplayIfUnchanged(const DrawCacheKey& key, RenderSink& sink);
+    // 有効なら、sceneVisibility に今のカメラの状態を設定して返す (無効なら nullptr。pipeline.Run に渡す)
+    BlockVisibilityCache* PrepareVisibilityCache();
+
+    // キャッシュのうち、計算し直しが必要なもの (dirtyFlags のビット)
+    enum DirtyFlag : unsigned int {
+        DIRTY_BASIS = 1 << 0,      // ローカル軸ベクトル (向きが変わった)
+        DIRTY_VIEW = 1 << 1,       // ビュー行列 (位置か向きが変わった)
+        DIRTY_PROJECTION = 1 << 2  // プロジェクション行列 (レンズの設定が変わった)
+    };
+    // 向き / 位置が変わったことを記録する (計算し直すのは次に使われるとき)
+    void MarkOrientationChanged() { dirtyFlags |= DIRTY_BASIS | DIRTY_VIEW; }
+    void MarkPositionChanged() { dirtyFlags |= DIRTY_VIEW; }
+    // 必要ならローカル軸ベクトルを計算し直す (回転行列を 1 回だけ作り、その各行を軸ベクトルにする)
+    void RefreshBasis() const;
+    // 必要ならビュー行列・プロジェクション行列・ビュー・プロジェクション行列・視錐台を計算し直す
+    void RefreshMatrices() const;
+
+    // --- カメラの主要な状態を表すメンバ変数 ---
+    Vector3D position;      // カメラの現在のワールド座標 (x, y, z)
+    Quaternion orientation; // カメラの現在の向き（回転状態）を表すクォータニオン
+
+    // --- プロジェクション（透視投影）関連のパラメータ (初期値付き) ---
+    // これらの値は GetProjectionMatrix() 関数で使用される (変更は SetLens などで行う)
+    float fovY = 60.0f * ONE_DEGREE;            // 垂直方向の視野角 (Field of View Y)。ラジアン単位。
+    float aspectRatio = WINDOW_WIDTH / WINDOW_HEIGHT; // スクリーンのアスペクト比 (幅 / 高さ)。
+    float nearZ = 0.1f;                         // ニアクリップ面。これより手前は描画されない。
+    float farZ = 1000.0f;                       // ファークリップ面。これより奥は描画されない。
+
+    // --- デバッグ表示用変数 (Updateメソッド内で毎フレーム更新される) ---
+    // これらの変数は、主にデバッグ情報の表示やログ出力のために Update() 内で計算・保存される値。
+    int lastMouseMoveX = 0;     // 前回のUpdate()でのマウスカーソルのX方向移動量
+    int lastMouseMoveY = 0;     // 前回のUpdate()でのマウスカーソルのY方向移動量
+    float lastYawAngle = 0.0f;    // 前回のUpdate()で計算されたヨー角（左右回転）の大きさ (ラジアン)
+    float lastPitchAngle = 0.0f;  // 前回のUpdate()で計算されたピッチ角（上下回転）の大きさ (ラジアン)
+    float lastRollAngle = 0.0f;   // 前回のUpdate()で計算されたロール角（傾き回転）の大きさ (ラジアン)
+    float lastMoveForward = 0.0f; // 前回のUpdate()での前進/後退の入力状態 (-1.0, 0.0, 1.0)
+    float lastMoveRight = 0.0f;   // 前回のUpdate()での右/左移動の入力状態 (-1.0, 0.0, 1.0)
+    float lastMoveUp = 0.0f;      // 前回のUpdate()での上昇/下降の入力状態 (-1.0, 0.0, 1.0)
+    Vector3D lastWorldMoveOffset = { 0.0f, 0.0f, 0.0f }; // 前回のUpdate()で実際にカメラが移動したワールド空間でのベクトル
+
+    // --- キャッシュ (位置・向き・レンズの設定が変わったときだけ計算し直す) ---
+    // 現在のカメラのローカル軸ベクトル。向きが変わった後に初めて使われるときに RefreshBasis() で更新される。
+    // GetForwardVector() などや Update() の回転・移動の計算は、毎回回転行列を作らずにこの値を使う。
+    mutable Vector3D currentForward = { 0.0f, 0.0f, 1.0f }; // 現在のカメラの前方ベクトル (初期値はワールドZ+)
+    mutable Vector3D currentRight = { 1.0f, 0.0f, 0.0f };   // 現在のカメラの右方ベクトル (初期値はワールドX+)
+    mutable Vector3D currentUp = { 0.0f, 1.0f, 0.0f };     // 現在のカメラの上方ベクトル (初期値はワールドY+)
+    mutable Matrix viewMatrix;           // ビュー行列
+    mutable Matrix projectionMatrix;     // プロジェクション行列
+    mutable Matrix viewProjectionMatrix; // viewMatrix * projectionMatrix
+    mutable Frustum frustum;             // viewProjectionMatrix から取り出した視錐台
+    mutable uint64_t viewProjectionVersion = 0; // viewProjectionMatrix を計算し直した回数
+    mutable unsigned int dirtyFlags = DIRTY_BASIS | DIRTY_VIEW | DIRTY_PROJECTION; // 計算し直しが必要なもの
 
-    // r[s (Matrix) 擾B̓[hWnJWnւ̕ϊss
-    Matrix GetViewMatrix() const;
-    // vWFNVs (Matrix) 擾B̓JWnNbvWnւ̕ϊiejss
-    Matrix GetProjectionMatrix() const;
-
-    // J̃[JWn̊eA݃[hWnłǂĂ邩xNg擾
-    Vector3D GetForwardVector() const; // J̑O (+Z)
-    Vector3D GetRightVector() const;   // J̉E (+X)
-    Vector3D GetUpVector() const;      // J̏ (+Y)
-
-    // fobO擾p̊֐
-    std::string GetDebugInfo() const;         // ʕ\ɓKAZ`̃fobO񕶎Ԃ
-    std::string GetDetailedDebugInfo() const; // Ot@Co͂ȂǂɓKAڍׂȃfobO񕶎Ԃ
-
-private: // NX̓̂݃ANZXł郁o (O͒ڃANZXłȂ)
-    // --- J̎vȏԂ\oϐ ---
-    Vector3D position;      // J݂̌̃[hW (x, y, z)
-    Quaternion orientation; // J݂̌̌i]ԁj\NH[^jI
-
-    // --- vWFNViej֘Ãp[^ (lt) ---
-    // ̒l GetProjectionMatrix() ֐Ŏgp
-    float fovY = 60.0f * ONE_DEGREE;            // ̎p (Field of View Y)BWAPʁB
-    float aspectRatio = WINDOW_WIDTH / WINDOW_HEIGHT; // XN[̃AXyNg ( / )B
-    float nearZ = 0.1f;                         // jANbvʁBO͕`悳ȂB
-    float farZ = 1000.0f;                       // t@[NbvʁB艜͕`悳ȂB
-
-    // --- fobO\pϐ (Update\bhŖt[XV) ---
-    // ̕ϐ́AɃfobO̕\⃍Oo͂̂߂ Update() ŌvZEۑlB
-    int lastMouseMoveX = 0;     // OUpdate()ł̃}EXJ[\Xړ
-    int lastMouseMoveY = 0;     // OUpdate()ł̃}EXJ[\Yړ
-    float lastYawAngle = 0.0f;    // OUpdate()ŌvZꂽ[piE]j̑傫 (WA)
-    float lastPitchAngle = 0.0f;  // OUpdate()ŌvZꂽsb`pi㉺]j̑傫 (WA)
-    float lastRollAngle = 0.0f;   // OUpdate()ŌvZꂽ[piX]j̑傫 (WA)
-    float lastMoveForward = 0.0f; // OUpdate()ł̑Oi/ނ̓͏ (-1.0, 0.0, 1.0)
-    float lastMoveRight = 0.0f;   // OUpdate()ł̉E/ړ̓͏ (-1.0, 0.0, 1.0)
-    float lastMoveUp = 0.0f;      // OUpdate()ł̏㏸/~̓͏ (-1.0, 0.0, 1.0)
-    Vector3D lastWorldMoveOffset = { 0.0f, 0.0f, 0.0f }; // OUpdate()ŎۂɃJړ[hԂł̃xNg
-
-    // ݂̃J̃[JxNgoϐƂĕێ (Update() ̍ŌōXV)
-    // Update()ŌvZŐV̎xNgۑĂƂŁAGetForwardVector()ȂǂĂ΂ꂽ
-    // ČvZԂȂƂłiptH[}X̉\jB
-    Vector3D currentForward = { 0.0f, 0.0f, 1.0f }; // ݂̃J̑OxNg (l̓[hZ+)
-    Vector3D currentRight = { 1.0f, 0.0f, 0.0f };   // ݂̃J̉ExNg (l̓[hX+)
-    Vector3D currentUp = { 0.0f, 1.0f, 0.0f };     // ݂̃J̏xNg (l̓[hY+)
+    // --- 描画用の作業領域 ---
+    // フレームをまたいで使い回すことで、毎フレームのメモリ確保を避ける。
+    WireframePipeline pipeline;                 // 変換・クリッピング処理 (内部に作業用の配列を持つ)
+    std::vector<ScreenSegment> visibleSegments; // pipeline が出力した、画面に描く線分のリスト
+    DrawCommandList drawCommands;               // visibleSegments を色付きで記録した描画コマンド (sink にまとめて渡す)
+    std::vector<SegmentRange> visibleRanges;    // BVH 版の Draw で、視錐台に入った線分の範囲
+    std::vector<uint32_t> visibleNodes;         // シーングラフの、視錐台に入ったノード
+    std::vector<ScreenSegment> objectSegments;  // visibleNodes の形状を pipeline で処理した、画面に描く線分のリスト
+    std::vector<ScreenSegment> nodeSegments;    // 1 ノード分の pipeline の出力 (objectSegments に連結する)
+    std::vector<ScreenSegment> dynamicSegments; // dynamicLines を pipeline で処理した、画面に描く線分のリスト
+    std::vector<ScreenSegment> meshSegments;    // dynamicMesh を pipeline で処理した、画面に描く線分のリスト
+    std::unique_ptr<ThreadPool> drawThreadPool; // 並列処理用のスレッドプール (1 スレッド設定のときは nullptr)
+    // 描画結果の使い回し (drawCommands が drawCacheKey の入力から作ったものなら drawCacheValid が true)
+    DrawCacheKey drawCacheKey = {};
+    bool drawCacheValid = false;
+    bool drawCacheEnabled = true;
+    bool lastDrawReplayed = false;
+    // 描画する線分のブロックごとの、前のフレームの分類 (dynamicLines は毎フレーム作り直すので使わない)
+    BlockVisibilityCache sceneVisibility;
+    bool visibilityCacheEnabled = true;
 };
\ No newline at end of file
@@ -1,143 +1,611 @@
 #pragma once
-#include <cmath>     // fabsf, sinf, cosf Ȃ (<math.h> 萄)
-#include "Vector.h" // Vector3D gp
-#include "Matrix.h" // Matrix gp
-#include <sstream> // fobOOp (stringstream)
-#include <iomanip> // fobOOp (setprecision)
-#include "Logger.h" // fobOOp (LogDebug) (KvȂCN[h)
+#include <cmath>     // fabsf, sinf, cosf など (<math.h> より推奨)
+#include "Vector.h" // Vector3D を使用
+#include "Matrix.h" // Matrix を使用
+#include <sstream> // デバッグログ用 (stringstream)
+#include <iomanip> // デバッグログ用 (setprecision)
+#include "Logger.h" // デバッグログ用 (LogDebug) (必要ならインクルード)
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t (FrustumTest の型)
+#include <vector>   // std::vector (ClipSpacePoints の格納領域)
+#include "AlignedAllocator.h" // 32バイト境界に揃えた配列 (SIMD 用)
+
+// x86/x64 向けにビルドする場合のみ SSE2/AVX2 の組み込み関数 (intrinsics) を使う
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CAMERAMATH_X86 1
+#include <immintrin.h> // SSE2 / AVX2 の組み込み関数
+#if defined(_MSC_VER)
+#include <intrin.h>    // __cpuid, __cpuidex, _xgetbv (CPU 機能の判定用)
+#endif
+#endif
+
+// GCC/Clang では、AVX2 命令を使う関数だけに target 属性を付けてコンパイルする必要がある
+// (MSVC はコンパイルオプションに関係なく組み込み関数を使えるので空定義)
+#if defined(CAMERAMATH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CAMERAMATH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CAMERAMATH_TARGET_AVX2
+#endif
 
 /*
  * CameraMath.h
- * :
- *   ̃wb_[t@ĆAJ֘AAɃxNgƍsp
- *   WϊvZȂǁA3DOtBbNXɂ鐔wIȏs߂
- *   wp[֐\̂`܂B
- *   ȑÕo[W琮EύXĂ܂B
+ * 役割:
+ *   このヘッダーファイルは、カメラ関連、特にベクトルと行列を用いた
+ *   座標変換計算など、3Dグラフィックスにおける数学的な処理を行うための
+ *   ヘルパー関数や構造体を定義します。
+ *   以前のバージョンから整理・変更されています。
  *
- * ̃o[Wł̕ύX_ (ȑO CameraMath.h ):
- * - Vector4D \: 4xNgiWj߂̍\̂`Ă܂B
- *                    3DWϊiɓejŏdvȖʂ܂B
- * - VEC4Transform ֐: 4xNgsŕϊ֐Ă܂B
- *                      RgAEgĂ܂AfobOOo͂̋@\܂܂Ă܂B
- * - TransformCoord ֐: 3́uW_vsŕϊAp[XyNeBuZiwŊj
- *                       sčĂ3Wɖ߂֐Ă܂B
- *                       ́Ar[EvWFNVϊȂǂŎg܂B
- * - VEC3Transform ֐: 3xNgs̍3x3i]EXP[Ojŕϊ֐łB
- *                      ͎ɁuxNgv̕ϊɎg܂isړ̉e͎󂯂܂jB
- *                      i `CameraMath.h` ɂގ̊֐܂j
+ * このバージョンでの変更点 (以前の CameraMath.h から):
+ * - Vector4D 構造体: 4次元ベクトル（同次座標）を扱うための構造体が定義されています。
+ *                    これは3D座標変換（特に透視投影）で重要な役割を果たします。
+ * - VEC4Transform 関数: 4次元ベクトルを行列で変換する関数が実装されています。
+ *                      コメントアウトされていますが、デバッグログ出力の機能も含まれています。
+ * - TransformCoord 関数: 3次元の「座標点」を行列で変換し、パースペクティブ除算（wで割る）を
+ *                       行って再び3次元座標に戻す関数が実装されています。
+ *                       これは、ビュー・プロジェクション変換などで使われます。
+ * - VEC3Transform 関数: 3次元ベクトルを行列の左上3x3部分（回転・スケーリング）で変換する関数です。
+ *                      これは主に「方向ベクトル」の変換に使われます（平行移動の影響は受けません）。
+ *                      （元の `CameraMath.h` にも類似の関数があったかもしれません）
+ * - TransformPointAffine 関数: 16 バイトのベクトル (Vector3DA) の座標点をアフィン変換の行列で変換する関数です。
+ *                      行列の 4 行を SSE で積和するだけで、パースペクティブ除算は行いません
+ *                      (モデルの配置やシーンのノードの変換など、投影前の変換に使います)。
+ * - TransformPointsBatch 関数: N 個の座標点 (w=1) をまとめてクリップ座標に変換する一括変換関数です。
+ *                      SSE2 (4点同時) / AVX2 (8点同時) の実装を実行時に CPU の対応状況から選び、
+ *                      どちらも使えない場合はスカラー版で処理します。
+ *                      どの実装でも、VEC4Transform と同じ順序で乗算・加算するため結果は完全に一致します。
+ * - Frustum 構造体: ビュー・プロジェクション行列から視錐台の 6 平面を取り出し、
+ *                   AABB (軸に平行な箱) や球が視錐台の外・境界・内のどれにあるかを判定します。
+ *                   BVH による視錐台カリング (SegmentBVH.h) や、物体単位のカリングで使います。
+ * - TestSpheresBatch / TestAABBsBatch 関数: 多数の球・AABB をまとめて判定する一括版です。
+ *                   TransformPointsBatch と同じく SSE2 / AVX2 の実装を実行時に選び、
+ *                   どの実装でも Frustum::TestSphere / TestAABB と同じ結果になります。
  *
- * g:
- *   - ̃t@CCN[h (`#include "CameraMath.h"`) ܂B
- *   - Kvɉ `Vector4D` \̂gp܂B
- *   - xNgWsŕϊꍇɁA`VEC3Transform`, `VEC4Transform`, `TransformCoord`
- *     Ƃ֐ĂяoĎgp܂B
+ * 使い方:
+ *   - このファイルをインクルード (`#include "CameraMath.h"`) します。
+ *   - 必要に応じて `Vector4D` 構造体を使用します。
+ *   - ベクトルや座標を行列で変換したい場合に、`VEC3Transform`, `VEC4Transform`, `TransformCoord`
+ *     といった関数を呼び出して使用します。
  *
- * ӓ_:
- * - ̃t@C̊֐́A`Vector.h`  `Matrix.h` Œ`ꂽ\̂A
- *   ꍇɂĂ `Logger.h` ɈˑĂ܂B̃t@C
- *   vWFNgɊ܂܂ĂKv܂B
- * - `VEC3Transform` ͕xNgpA`TransformCoord` ͍W_pƁA
- *   prɉĊ֐g邱ƂdvłB
- * - p[XyNeBuZ (`TransformCoord` ) ł́Aw[ɋ߂ꍇ
- *   [ZȂ悤ɒӂKvłĩR[hł̓`FbNĂ܂jB
+ * 注意点:
+ * - このファイル内の関数は、`Vector.h` や `Matrix.h` で定義された構造体や、
+ *   場合によっては `Logger.h` に依存しています。これらのファイルが正しく
+ *   プロジェクトに含まれている必要があります。
+ * - `VEC3Transform` は方向ベクトル用、`TransformCoord` は座標点用と、
+ *   用途に応じて関数を使い分けることが重要です。
+ * - パースペクティブ除算 (`TransformCoord` 内) では、w成分がゼロに近い場合に
+ *   ゼロ除算が発生しないように注意が必要です（このコードではチェックされています）。
  */
 
- // 4DxNg(W)߂̍\
+ // 4Dベクトル(同次座標)を扱うための構造体
 struct Vector4D {
-    float x, y, z, w; // 4̐
+    float x, y, z, w; // 4つの成分
 
-    // ftHgRXgN^ (lݒ)
+    // デフォルトコンストラクタ (初期値を設定)
     Vector4D(float _x = 0.0f, float _y = 0.0f, float _z = 0.0f, float _w = 0.0f)
         : x(_x), y(_y), z(_z), w(_w) {
     }
-    // Kvł΁AVector3D ̕ϊRXgN^Ȃǂǉł܂
+    // 必要であれば、Vector3D からの変換コンストラクタなども追加できます
     // Vector4D(const Vector3D& v, float _w = 1.0f) : x(v.x), y(v.y), z(v.z), w(_w) {}
 };
 
 
-// 3DxNgsŕϊ֐ (ɕxNgp)
-// s̉]EXP[Oi3x3ĵ݂KpAsړ͖܂B
+// 3Dベクトルを行列で変換する関数 (主に方向ベクトル用)
+// 行列の回転・スケーリング成分（左上3x3）のみを適用し、平行移動成分は無視します。
 inline Vector3D VEC3Transform(const Vector3D& _vec, const Matrix& _mat)
 {
-    // fobOOo͗ (KvȂRgAEgĎgp)
+    // デバッグログ出力例 (必要ならコメントアウト解除して使用)
     // std::stringstream ss_log;
     // ss_log << std::fixed << std::setprecision(4);
     // ss_log << "[VEC3Trans] InVec(" << _vec.x << "," << _vec.y << "," << _vec.z << ")";
-    // // KvȂs̓eOɏo
+    // // 必要なら行列の内容もログに出力
     // LogDebug(ss_log.str());
 
     Vector3D result;
-    // s̍3x3ƃxNg̏Z
+    // 行列の左上3x3部分とベクトルの乗算
     result.x = _vec.x * _mat.m[0][0] + _vec.y * _mat.m[1][0] + _vec.z * _mat.m[2][0];
     result.y = _vec.x * _mat.m[0][1] + _vec.y * _mat.m[1][1] + _vec.z * _mat.m[2][1];
     result.z = _vec.x * _mat.m[0][2] + _vec.y * _mat.m[1][2] + _vec.z * _mat.m[2][2];
 
-    // ss_log.str(""); // Xg[NA
+    // ss_log.str(""); // ストリームをクリア
     // ss_log << "[VEC3Trans] OutVec(" << result.x << "," << result.y << "," << result.z << ")";
     // LogDebug(ss_log.str());
 
-    // : xNgƂĎgꍇAϊɐK(Normalize)Kvȏꍇ܂
+    // 注意: 方向ベクトルとして使う場合、変換後に正規化(Normalize)が必要な場合があります
     return result;
 }
 
 
-// 4DxNg(W)sŕϊ֐
-// xNg4ׂĂsƌvZ܂B
+// 4Dベクトル(同次座標)を行列で変換する関数
+// ベクトルの4成分すべてを行列と計算します。
 inline Vector4D VEC4Transform(const Vector4D& _vec, const Matrix& _mat)
 {
-    // fobOOo͗ (KvȂRgAEgĎgp)
+    // デバッグログ出力例 (必要ならコメントアウト解除して使用)
     // std::stringstream ss_log;
     // ss_log << std::fixed << std::setprecision(4);
     // ss_log << "[VEC4Trans] InVec(" << _vec.x << "," << _vec.y << "," << _vec.z << "," << _vec.w << ")";
-    // LogDebug(ss_log.str()); // seOɏo͂ƒȂ̂Œ
+    // LogDebug(ss_log.str()); // 行列内容もログに出力すると長くなるので注意
 
     Vector4D result;
-    // 4x4s4DxNg̏Z
+    // 4x4行列と4Dベクトルの乗算
     result.x = _vec.x * _mat.m[0][0] + _vec.y * _mat.m[1][0] + _vec.z * _mat.m[2][0] + _vec.w * _mat.m[3][0];
     result.y = _vec.x * _mat.m[0][1] + _vec.y * _mat.m[1][1] + _vec.z * _mat.m[2][1] + _vec.w * _mat.m[3][1];
     result.z = _vec.x * _mat.m[0][2] + _vec.y * _mat.m[1][2] + _vec.z * _mat.m[2][2] + _vec.w * _mat.m[3][2];
     result.w = _vec.x * _mat.m[0][3] + _vec.y * _mat.m[1][3] + _vec.z * _mat.m[2][3] + _vec.w * _mat.m[3][3];
 
-    // ss_log.str(""); // Xg[NA
+    // ss_log.str(""); // ストリームをクリア
     // ss_log << "[VEC4Trans] OutVec(" << result.x << "," << result.y << "," << result.z << "," << result.w << ")";
     // LogDebug(ss_log.str());
 
     return result;
 }
 
-// 3DW_sŕϊAp[XyNeBuZs֐ (ɍW_p)
-// Iɂ (x, y, z, 1) 4DxNgƂĕϊAʂw x, y, z ܂B
-// ɂAsړⓧěʂKpꂽ3DW܂B
+// 座標点 (w = 1) をアフィン変換の行列 (最後の列が (0, 0, 0, 1)) で変換する関数 (Vector3DA 版)
+// 平行移動も適用する。成分の計算順序は VEC4Transform と同じ。
+inline Vector3DA TransformPointAffine(const Vector3DA& _point, const Matrix& _mat)
+{
+#if defined(MATH_SSE)
+    __m128 row = _mm_mul_ps(_mm_set1_ps(_point.x), _mat.LoadRow(0));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(_point.y), _mat.LoadRow(1)));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(_point.z), _mat.LoadRow(2)));
+    row = _mm_add_ps(row, _mat.LoadRow(3));
+    Vector3DA result = Vector3DA::FromRegister(row);
+    result.w = 0.0f; // 4 つ目の成分 (同次座標の w = 1) は捨てる
+    return result;
+#else
+    return Vector3DA(
+        _point.x * _mat.m[0][0] + _point.y * _mat.m[1][0] + _point.z * _mat.m[2][0] + _mat.m[3][0],
+        _point.x * _mat.m[0][1] + _point.y * _mat.m[1][1] + _point.z * _mat.m[2][1] + _mat.m[3][1],
+        _point.x * _mat.m[0][2] + _point.y * _mat.m[1][2] + _point.z * _mat.m[2][2] + _mat.m[3][2]);
+#endif
+}
+
+// --- 座標点の一括変換 (SIMD) ---
+// 変換結果のクリップ座標 (x, y, z, w) を、成分ごとの配列 (SoA) で保持する構造体。
+// 各配列の先頭は 32 バイト境界に揃っているため、SIMD でまとめて読み書きできる。
+struct ClipSpacePoints {
+    typedef std::vector<float, AlignedAllocator<float, 32>> FloatArray;
+    FloatArray x, y, z, w; // クリップ座標の各成分
+
+    // 要素数を count に変更する (毎フレーム呼んでも、容量が足りていれば再確保は起きない)
+    void Resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); w.resize(count); }
+    // 格納されている点の数
+    size_t Size() const { return x.size(); }
+    // i 番目の点を Vector4D として取得する
+    Vector4D Get(size_t i) const { return { x[i], y[i], z[i], w[i] }; }
+};
+
+// 一括変換で使う SIMD 命令セットの種類
+enum class SimdLevel {
+    Scalar, // SIMD を使わない (どの環境でも動作する)
+    SSE2,   // 128 ビット幅 (4 点同時)
+    AVX2    // 256 ビット幅 (8 点同時)
+};
+
+// 実行中の CPU (と OS) が対応している最も幅の広い SIMD 命令セットを返す。
+// 判定は最初の呼び出し時に一度だけ行い、以降はその結果を返す。
+inline SimdLevel DetectSimdLevel()
+{
+#if defined(CAMERAMATH_X86)
+    static const SimdLevel detected = []() {
+#if defined(_MSC_VER)
+        int info[4] = { 0, 0, 0, 0 };
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;    // EDX bit 26: SSE2
+        const bool osxsave = (info[2] & (1 << 27)) != 0; // ECX bit 27: OS が XSAVE を有効にしている
+        const bool avx = (info[2] & (1 << 28)) != 0;     // ECX bit 28: AVX
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && avx) {
+            // OS が YMM レジスタの退避に対応しているか (XCR0 の bit 1, 2) を確認する
+            const bool ymmEnabled = (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0; // EBX bit 5: AVX2
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse2 = __builtin_cpu_supports("sse2") != 0;
+        const bool avx2 = __builtin_cpu_supports("avx2") != 0; // OS 側の対応も含めて判定される
+#endif
+        if (avx2) { return SimdLevel::AVX2; }
+        if (sse2) { return SimdLevel::SSE2; }
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// スカラー版: count 個の座標点 (xs[i], ys[i], zs[i], 1) を行列 _mat で変換し、
+// クリップ座標を outX/outY/outZ/outW に書き込む。VEC4Transform と同じ計算順序。
+inline void TransformPointsBatchScalar(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    float* outX, float* outY, float* outZ, float* outW)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const float px = xs[i], py = ys[i], pz = zs[i];
+        outX[i] = px * _mat.m[0][0] + py * _mat.m[1][0] + pz * _mat.m[2][0] + _mat.m[3][0];
+        outY[i] = px * _mat.m[0][1] + py * _mat.m[1][1] + pz * _mat.m[2][1] + _mat.m[3][1];
+        outZ[i] = px * _mat.m[0][2] + py * _mat.m[1][2] + pz * _mat.m[2][2] + _mat.m[3][2];
+        outW[i] = px * _mat.m[0][3] + py * _mat.m[1][3] + pz * _mat.m[2][3] + _mat.m[3][3];
+    }
+}
+
+#if defined(CAMERAMATH_X86)
+// SSE2 版: 4 点ずつ変換する。端数はスカラー版で処理する。
+// 乗算と加算をスカラー版と同じ順序で行い (FMA は使わない)、結果をビット単位で一致させる。
+inline void TransformPointsBatchSSE2(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    float* outX, float* outY, float* outZ, float* outW)
+{
+    // 行列の各要素を 4 レーンに複製しておく (ループ内で毎回読み込まないため)
+    __m128 m[4][4];
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) { m[r][c] = _mm_set1_ps(_mat.m[r][c]); }
+    }
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(xs + i);
+        const __m128 py = _mm_loadu_ps(ys + i);
+        const __m128 pz = _mm_loadu_ps(zs + i);
+        // out = ((px * m0c + py * m1c) + pz * m2c) + m3c
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m[0][0]), _mm_mul_ps(py, m[1][0])), _mm_mul_ps(pz, m[2][0])), m[3][0]));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m[0][1]), _mm_mul_ps(py, m[1][1])), _mm_mul_ps(pz, m[2][1])), m[3][1]));
+        _mm_storeu_ps(outZ + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m[0][2]), _mm_mul_ps(py, m[1][2])), _mm_mul_ps(pz, m[2][2])), m[3][2]));
+        _mm_storeu_ps(outW + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, m[0][3]), _mm_mul_ps(py, m[1][3])), _mm_mul_ps(pz, m[2][3])), m[3][3]));
+    }
+    // 4 点に満たない残りはスカラー版で処理
+    TransformPointsBatchScalar(xs + i, ys + i, zs + i, count - i, _mat, outX + i, outY + i, outZ + i, outW + i);
+}
+
+// AVX2 版: 8 点ずつ変換する。端数はスカラー版で処理する。
+CAMERAMATH_TARGET_AVX2
+inline void TransformPointsBatchAVX2(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    float* outX, float* outY, float* outZ, float* outW)
+{
+    __m256 m[4][4];
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) { m[r][c] = _mm256_set1_ps(_mat.m[r][c]); }
+    }
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(xs + i);
+        const __m256 py = _mm256_loadu_ps(ys + i);
+        const __m256 pz = _mm256_loadu_ps(zs + i);
+        _mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m[0][0]), _mm256_mul_ps(py, m[1][0])), _mm256_mul_ps(pz, m[2][0])), m[3][0]));
+        _mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m[0][1]), _mm256_mul_ps(py, m[1][1])), _mm256_mul_ps(pz, m[2][1])), m[3][1]));
+        _mm256_storeu_ps(outZ + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m[0][2]), _mm256_mul_ps(py, m[1][2])), _mm256_mul_ps(pz, m[2][2])), m[3][2]));
+        _mm256_storeu_ps(outW + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, m[0][3]), _mm256_mul_ps(py, m[1][3])), _mm256_mul_ps(pz, m[2][3])), m[3][3]));
+    }
+    TransformPointsBatchScalar(xs + i, ys + i, zs + i, count - i, _mat, outX + i, outY + i, outZ + i, outW + i);
+}
+#endif
+
+// 指定した命令セットの実装で一括変換する (ベンチマークや結果の比較用)
+// 実行環境が対応していない命令セットを指定しないこと。
+inline void TransformPointsBatch(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    float* outX, float* outY, float* outZ, float* outW, SimdLevel level)
+{
+    switch (level) {
+#if defined(CAMERAMATH_X86)
+    case SimdLevel::AVX2: TransformPointsBatchAVX2(xs, ys, zs, count, _mat, outX, outY, outZ, outW); return;
+    case SimdLevel::SSE2: TransformPointsBatchSSE2(xs, ys, zs, count, _mat, outX, outY, outZ, outW); return;
+#endif
+    default: TransformPointsBatchScalar(xs, ys, zs, count, _mat, outX, outY, outZ, outW); return;
+    }
+}
+
+// 実行中の CPU で使える最速の実装で一括変換する (通常はこちらを使う)
+inline void TransformPointsBatch(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    float* outX, float* outY, float* outZ, float* outW)
+{
+    TransformPointsBatch(xs, ys, zs, count, _mat, outX, outY, outZ, outW, DetectSimdLevel());
+}
+
+// ClipSpacePoints に書き込む版。out は count 個の大きさに変更される。
+inline void TransformPointsBatch(const float* xs, const float* ys, const float* zs, size_t count, const Matrix& _mat,
+    ClipSpacePoints& out)
+{
+    out.Resize(count);
+    TransformPointsBatch(xs, ys, zs, count, _mat, out.x.data(), out.y.data(), out.z.data(), out.w.data());
+}
+
+// 3D座標点を行列で変換し、パースペクティブ除算を行う関数 (主に座標点用)
+// 内部的には (x, y, z, 1) の4Dベクトルとして変換し、結果のw成分で x, y, z を割ります。
+// これにより、平行移動や透視投影の効果が適用された3D座標が得られます。
 inline Vector3D TransformCoord(const Vector3D& _coord, const Matrix& _mat)
 {
-    Vector4D temp; // (x, y, z, 1) ƂČvZ邽߂̈ꎞϐ
+    Vector4D temp; // (x, y, z, 1) として計算するための一時変数
 
-    // 4x4s (x, y, z, 1) xNg̏Zs
-    temp.x = _coord.x * _mat.m[0][0] + _coord.y * _mat.m[1][0] + _coord.z * _mat.m[2][0] + /* 1.0f * */ _mat.m[3][0]; // w=1 |
+    // 4x4行列と (x, y, z, 1) ベクトルの乗算を実行
+    temp.x = _coord.x * _mat.m[0][0] + _coord.y * _mat.m[1][0] + _coord.z * _mat.m[2][0] + /* 1.0f * */ _mat.m[3][0]; // w=1 を掛ける
     temp.y = _coord.x * _mat.m[0][1] + _coord.y * _mat.m[1][1] + _coord.z * _mat.m[2][1] + /* 1.0f * */ _mat.m[3][1];
     temp.z = _coord.x * _mat.m[0][2] + _coord.y * _mat.m[1][2] + _coord.z * _mat.m[2][2] + /* 1.0f * */ _mat.m[3][2];
     temp.w = _coord.x * _mat.m[0][3] + _coord.y * _mat.m[1][3] + _coord.z * _mat.m[2][3] + /* 1.0f * */ _mat.m[3][3];
 
-    Vector3D result = { 0.0f, 0.0f, 0.0f }; // ʂ3DxNg
+    Vector3D result = { 0.0f, 0.0f, 0.0f }; // 結果の3Dベクトルを初期化
 
-    // p[XyNeBuZ: ʂ w  x, y, z 
-    // Aw [ɋ߂ꍇ̓[ZG[ɂȂ邽߃`FbNs
-    if (std::fabsf(temp.w) > 1e-6f) { // w ̐Βlɏl傫ꍇ̂݌vZ
-        float invW = 1.0f / temp.w; // Z̑ɋt|ivẐ߁j
+    // パースペクティブ除算: 結果の w 成分で x, y, z を割る
+    // ただし、w がゼロに近い場合はゼロ除算エラーになるためチェックを行う
+    if (std::fabs(temp.w) > 1e-6f) { // w の絶対値が非常に小さい値より大きい場合のみ計算
+        float invW = 1.0f / temp.w; // 割り算の代わりに逆数を掛ける（計算効率のため）
         result.x = temp.x * invW;
         result.y = temp.y * invW;
         result.z = temp.z * invW;
     }
     else {
-        // w [ɋ߂ꍇ́AG[ƂĈA邢͓̒lԂB
-        // ł̓[xNgԂĂB
-        // LogWarning("TransformCoord: w component is near zero during perspective divide."); // KvȂxO
+        // w がゼロに近い場合は、エラーとして扱うか、あるいは特定の値を返す。
+        // ここではゼロベクトルを返している。
+        // LogWarning("TransformCoord: w component is near zero during perspective divide."); // 必要なら警告ログ
     }
     return result;
 }
 
-//  CameraMath.h ɂ CameraTransform ֐ (IC[px[X̌Âϊ) 
-// VJ (NH[^jI + s) ł͕svɂȂߍ폜Ă܂B
+// 視錐台と AABB・球の位置関係 (Frustum::TestAABB / TestSphere の戻り値)
+// 一括判定の結果を 1 バイトずつ書き込めるように uint8_t にしている (値の順番も一括判定で使う)
+enum class FrustumTest : uint8_t {
+    Outside,   // 完全に視錐台の外 (描画不要)
+    Intersect, // 視錐台の境界にまたがる (クリッピングが必要)
+    Inside     // 完全に視錐台の内部 (クリッピング不要)
+};
+
+// 視錐台 (カメラに映る範囲) を 6 枚の平面で表す構造体
+// 各平面は a*x + b*y + c*z + d >= 0 の側が視錐台の内側。
+// 平面の係数は法線 (a, b, c) の長さが 1 になるように正規化してあるので、
+// a*x + b*y + c*z + d は点と平面の距離 (内側が正) になる (球の判定で半径と比べるため)。
+struct Frustum {
+    static const int PLANE_COUNT = 6;
+    struct Plane { float a, b, c, d; };
+    Plane planes[PLANE_COUNT]; // 左, 右, 下, 上, Near, Far の順
+
+    // ビュー・プロジェクション行列から視錐台を作る
+    // 点 p (w=1) のクリップ座標は clip[j] = p.x*m[0][j] + p.y*m[1][j] + p.z*m[2][j] + m[3][j] なので、
+    // クリッピングの条件 (-w <= x <= w, -w <= y <= w, 0 <= z <= w) は、行列の列の和・差を係数とする
+    // ワールド空間の平面の式になる (Clipping.h の ComputeOutCode と同じ条件)。
+    static Frustum FromViewProjection(const Matrix& _mat) {
+        Frustum f;
+        const int signs[PLANE_COUNT][2] = { // { 列の番号, 符号 }: w + 符号 * clip[列]
+            { 0, 1 }, { 0, -1 }, // 左 (x >= -w), 右 (x <= w)
+            { 1, 1 }, { 1, -1 }, // 下 (y >= -w), 上 (y <= w)
+        };
+        for (int k = 0; k < 4; ++k) {
+            const int col = signs[k][0];
+            const float s = static_cast<float>(signs[k][1]);
+            f.planes[k] = { _mat.m[0][3] + s * _mat.m[0][col], _mat.m[1][3] + s * _mat.m[1][col],
+                            _mat.m[2][3] + s * _mat.m[2][col], _mat.m[3][3] + s * _mat.m[3][col] };
+        }
+        f.planes[4] = { _mat.m[0][2], _mat.m[1][2], _mat.m[2][2], _mat.m[3][2] }; // Near (z >= 0)
+        f.planes[5] = { _mat.m[0][3] - _mat.m[0][2], _mat.m[1][3] - _mat.m[1][2],  // Far (z <= w)
+                        _mat.m[2][3] - _mat.m[2][2], _mat.m[3][3] - _mat.m[3][2] };
+        // 正の数で割るだけなので、内外の判定 (符号) は変わらない
+        for (Plane& p : f.planes) {
+            const float length = std::sqrt(p.a * p.a + p.b * p.b + p.c * p.c);
+            if (length > 0.0f) { p.a /= length; p.b /= length; p.c /= length; p.d /= length; }
+        }
+        return f;
+    }
+
+    // 中心 (cx, cy, cz)、半径 radius の球と視錐台の位置関係を判定する
+    // (中心と平面の距離が -radius 未満なら外、radius 未満なら平面をまたぐ)
+    FrustumTest TestSphere(float cx, float cy, float cz, float radius) const {
+        FrustumTest result = FrustumTest::Inside;
+        for (int k = 0; k < PLANE_COUNT; ++k) {
+            const Plane& p = planes[k];
+            const float distance = p.a * cx + p.b * cy + p.c * cz + p.d;
+            if (distance < -radius) { return FrustumTest::Outside; }
+            if (distance < radius) { result = FrustumTest::Intersect; }
+        }
+        return result;
+    }
+    FrustumTest TestSphere(const Vector3D& center, float radius) const {
+        return TestSphere(center.x, center.y, center.z, radius);
+    }
+
+    // AABB [min, max] と視錐台の位置関係を判定する
+    // planeMask: 判定する平面のビットマスク (ビット k が平面 k)。親の箱で「内側」と確定した平面を
+    //            子の判定で省くために使う。判定後、箱が完全に内側にある平面のビットは落とされる。
+    FrustumTest TestAABB(float minX, float minY, float minZ, float maxX, float maxY, float maxZ, unsigned int& planeMask) const {
+        FrustumTest result = FrustumTest::Inside;
+        for (int k = 0; k < PLANE_COUNT; ++k) {
+            const unsigned int bit = 1u << k;
+            if (!(planeMask & bit)) { continue; }
+            const Plane& p = planes[k];
+            // 平面の法線方向に最も進んだ頂点 (p-vertex) と最も戻った頂点 (n-vertex)
+            const float px = (p.a >= 0.0f) ? maxX : minX, nx = (p.a >= 0.0f) ? minX : maxX;
+            const float py = (p.b >= 0.0f) ? maxY : minY, ny = (p.b >= 0.0f) ? minY : maxY;
+            const float pz = (p.c >= 0.0f) ? maxZ : minZ, nz = (p.c >= 0.0f) ? minZ : maxZ;
+            if (p.a * px + p.b * py + p.c * pz + p.d < 0.0f) { return FrustumTest::Outside; } // 最も内側の頂点すら外
+            if (p.a * nx + p.b * ny + p.c * nz + p.d < 0.0f) { result = FrustumTest::Intersect; } // 平面をまたぐ
+            else { planeMask &= ~bit; } // この平面については完全に内側
+        }
+        return result;
+    }
+    FrustumTest TestAABB(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) const {
+        unsigned int planeMask = (1u << PLANE_COUNT) - 1;
+        return TestAABB(minX, minY, minZ, maxX, maxY, maxZ, planeMask);
+    }
+};
+
+// --- 球・AABB の一括判定 ---
+// 多数の球 (中心 cxs/cys/czs[i], 半径 radii[i]) や AABB ([minXs[i], maxXs[i]] など) と視錐台の位置関係を
+// out[i] に書き込む。平面の係数は全ての球・箱で共通なので、SIMD 版は平面ごとに 4 / 8 個を同時に判定する。
+// 判定の途中で「外」と分かっても打ち切らずに 6 平面とも計算するが、結果は Frustum::TestSphere / TestAABB と同じ。
+
+// スカラー版 (球)
+inline void TestSpheresBatchScalar(const Frustum& frustum, const float* cxs, const float* cys, const float* czs, const float* radii,
+    size_t count, FrustumTest* out)
+{
+    for (size_t i = 0; i < count; ++i) { out[i] = frustum.TestSphere(cxs[i], cys[i], czs[i], radii[i]); }
+}
+
+// スカラー版 (AABB)
+inline void TestAABBsBatchScalar(const Frustum& frustum, const float* minXs, const float* minYs, const float* minZs,
+    const float* maxXs, const float* maxYs, const float* maxZs, size_t count, FrustumTest* out)
+{
+    for (size_t i = 0; i < count; ++i) { out[i] = frustum.TestAABB(minXs[i], minYs[i], minZs[i], maxXs[i], maxYs[i], maxZs[i]); }
+}
+
+#if defined(CAMERAMATH_X86)
+// SSE2 版 (球): 4 個ずつ判定する。端数はスカラー版で処理する。
+// 結果は FrustumTest の値の順番 (Outside = 0, Intersect = 1, Inside = 2) を使い、
+// 「Inside から、またぐなら 1 を引き、外なら 0 にする」とマスクの演算で求める。
+inline void TestSpheresBatchSSE2(const Frustum& frustum, const float* cxs, const float* cys, const float* czs, const float* radii,
+    size_t count, FrustumTest* out)
+{
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128i insideCode = _mm_set1_epi32(static_cast<int>(FrustumTest::Inside));
+    alignas(16) int32_t codes[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(cxs + i), cy = _mm_loadu_ps(cys + i), cz = _mm_loadu_ps(czs + i);
+        const __m128 r = _mm_loadu_ps(radii + i);
+        const __m128 negR = _mm_xor_ps(r, signMask);
+        __m128 outside = _mm_setzero_ps(), intersect = _mm_setzero_ps();
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            const Frustum::Plane& p = frustum.planes[k];
+            // distance = ((a * cx + b * cy) + c * cz) + d (TestSphere と同じ順序)
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.a), cx), _mm_mul_ps(_mm_set1_ps(p.b), cy)),
+                _mm_mul_ps(_mm_set1_ps(p.c), cz)), _mm_set1_ps(p.d));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negR));
+            intersect = _mm_or_ps(intersect, _mm_cmplt_ps(distance, r));
+        }
+        // 真のレーンは -1 なので、足すと Inside (2) が Intersect (1) になる
+        const __m128i code = _mm_andnot_si128(_mm_castps_si128(outside), _mm_add_epi32(insideCode, _mm_castps_si128(intersect)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes), code);
+        for (int k = 0; k < 4; ++k) { out[i + k] = static_cast<FrustumTest>(codes[k]); }
+    }
+    TestSpheresBatchScalar(frustum, cxs + i, cys + i, czs + i, radii + i, count - i, out + i);
+}
+
+// SSE2 版 (AABB): 4 個ずつ判定する。平面ごとに、法線の向きから p-vertex / n-vertex に使う配列 (min か max か) を選ぶ。
+inline void TestAABBsBatchSSE2(const Frustum& frustum, const float* minXs, const float* minYs, const float* minZs,
+    const float* maxXs, const float* maxYs, const float* maxZs, size_t count, FrustumTest* out)
+{
+    const __m128i insideCode = _mm_set1_epi32(static_cast<int>(FrustumTest::Inside));
+    alignas(16) int32_t codes[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 minX = _mm_loadu_ps(minXs + i), minY = _mm_loadu_ps(minYs + i), minZ = _mm_loadu_ps(minZs + i);
+        const __m128 maxX = _mm_loadu_ps(maxXs + i), maxY = _mm_loadu_ps(maxYs + i), maxZ = _mm_loadu_ps(maxZs + i);
+        __m128 outside = _mm_setzero_ps(), intersect = _mm_setzero_ps();
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            const Frustum::Plane& p = frustum.planes[k];
+            const __m128 a = _mm_set1_ps(p.a), b = _mm_set1_ps(p.b), c = _mm_set1_ps(p.c), d = _mm_set1_ps(p.d);
+            const __m128 px = (p.a >= 0.0f) ? maxX : minX, nx = (p.a >= 0.0f) ? minX : maxX;
+            const __m128 py = (p.b >= 0.0f) ? maxY : minY, ny = (p.b >= 0.0f) ? minY : maxY;
+            const __m128 pz = (p.c >= 0.0f) ? maxZ : minZ, nz = (p.c >= 0.0f) ? minZ : maxZ;
+            const __m128 pDistance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, px), _mm_mul_ps(b, py)), _mm_mul_ps(c, pz)), d);
+            const __m128 nDistance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, nx), _mm_mul_ps(b, ny)), _mm_mul_ps(c, nz)), d);
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(pDistance, _mm_setzero_ps()));
+            intersect = _mm_or_ps(intersect, _mm_cmplt_ps(nDistance, _mm_setzero_ps()));
+        }
+        const __m128i code = _mm_andnot_si128(_mm_castps_si128(outside), _mm_add_epi32(insideCode, _mm_castps_si128(intersect)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes), code);
+        for (int k = 0; k < 4; ++k) { out[i + k] = static_cast<FrustumTest>(codes[k]); }
+    }
+    TestAABBsBatchScalar(frustum, minXs + i, minYs + i, minZs + i, maxXs + i, maxYs + i, maxZs + i, count - i, out + i);
+}
+
+// AVX2 版 (球): 8 個ずつ判定する。
+CAMERAMATH_TARGET_AVX2
+inline void TestSpheresBatchAVX2(const Frustum& frustum, const float* cxs, const float* cys, const float* czs, const float* radii,
+    size_t count, FrustumTest* out)
+{
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256i insideCode = _mm256_set1_epi32(static_cast<int>(FrustumTest::Inside));
+    alignas(32) int32_t codes[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(cxs + i), cy = _mm256_loadu_ps(cys + i), cz = _mm256_loadu_ps(czs + i);
+        const __m256 r = _mm256_loadu_ps(radii + i);
+        const __m256 negR = _mm256_xor_ps(r, signMask);
+        __m256 outside = _mm256_setzero_ps(), intersect = _mm256_setzero_ps();
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            const Frustum::Plane& p = frustum.planes[k];
+            const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.a), cx),
+                _mm256_mul_ps(_mm256_set1_ps(p.b), cy)), _mm256_mul_ps(_mm256_set1_ps(p.c), cz)), _mm256_set1_ps(p.d));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negR, _CMP_LT_OQ));
+            intersect = _mm256_or_ps(intersect, _mm256_cmp_ps(distance, r, _CMP_LT_OQ));
+        }
+        const __m256i code = _mm256_andnot_si256(_mm256_castps_si256(outside), _mm256_add_epi32(insideCode, _mm256_castps_si256(intersect)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(codes), code);
+        for (int k = 0; k < 8; ++k) { out[i + k] = static_cast<FrustumTest>(codes[k]); }
+    }
+    TestSpheresBatchScalar(frustum, cxs + i, cys + i, czs + i, radii + i, count - i, out + i);
+}
+
+// AVX2 版 (AABB): 8 個ずつ判定する。
+CAMERAMATH_TARGET_AVX2
+inline void TestAABBsBatchAVX2(const Frustum& frustum, const float* minXs, const float* minYs, const float* minZs,
+    const float* maxXs, const float* maxYs, const float* maxZs, size_t count, FrustumTest* out)
+{
+    const __m256i insideCode = _mm256_set1_epi32(static_cast<int>(FrustumTest::Inside));
+    alignas(32) int32_t codes[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 minX = _mm256_loadu_ps(minXs + i), minY = _mm256_loadu_ps(minYs + i), minZ = _mm256_loadu_ps(minZs + i);
+        const __m256 maxX = _mm256_loadu_ps(maxXs + i), maxY = _mm256_loadu_ps(maxYs + i), maxZ = _mm256_loadu_ps(maxZs + i);
+        __m256 outside = _mm256_setzero_ps(), intersect = _mm256_setzero_ps();
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            const Frustum::Plane& p = frustum.planes[k];
+            const __m256 a = _mm256_set1_ps(p.a), b = _mm256_set1_ps(p.b), c = _mm256_set1_ps(p.c), d = _mm256_set1_ps(p.d);
+            const __m256 px = (p.a >= 0.0f) ? maxX : minX, nx = (p.a >= 0.0f) ? minX : maxX;
+            const __m256 py = (p.b >= 0.0f) ? maxY : minY, ny = (p.b >= 0.0f) ? minY : maxY;
+            const __m256 pz = (p.c >= 0.0f) ? maxZ : minZ, nz = (p.c >= 0.0f) ? minZ : maxZ;
+            const __m256 pDistance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, px), _mm256_mul_ps(b, py)), _mm256_mul_ps(c, pz)), d);
+            const __m256 nDistance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, nx), _mm256_mul_ps(b, ny)), _mm256_mul_ps(c, nz)), d);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(pDistance, _mm256_setzero_ps(), _CMP_LT_OQ));
+            intersect = _mm256_or_ps(intersect, _mm256_cmp_ps(nDistance, _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        const __m256i code = _mm256_andnot_si256(_mm256_castps_si256(outside), _mm256_add_epi32(insideCode, _mm256_castps_si256(intersect)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(codes), code);
+        for (int k = 0; k < 8; ++k) { out[i + k] = static_cast<FrustumTest>(codes[k]); }
+    }
+    TestAABBsBatchScalar(frustum, minXs + i, minYs + i, minZs + i, maxXs + i, maxYs + i, maxZs + i, count - i, out + i);
+}
+#endif
+
+// 指定した命令セットの実装で球を一括判定する (ベンチマークや結果の比較用)
+inline void TestSpheresBatch(const Frustum& frustum, const float* cxs, const float* cys, const float* czs, const float* radii,
+    size_t count, FrustumTest* out, SimdLevel level)
+{
+    switch (level) {
+#if defined(CAMERAMATH_X86)
+    case SimdLevel::AVX2: TestSpheresBatchAVX2(frustum, cxs, cys, czs, radii, count, out); return;
+    case SimdLevel::SSE2: TestSpheresBatchSSE2(frustum, cxs, cys, czs, radii, count, out); return;
+#endif
+    default: TestSpheresBatchScalar(frustum, cxs, cys, czs, radii, count, out); return;
+    }
+}
+
+// 実行中の CPU で使える最速の実装で球を一括判定する (通常はこちらを使う)
+inline void TestSpheresBatch(const Frustum& frustum, const float* cxs, const float* cys, const float* czs, const float* radii,
+    size_t count, FrustumTest* out)
+{
+    TestSpheresBatch(frustum, cxs, cys, czs, radii, count, out, DetectSimdLevel());
+}
+
+// 指定した命令セットの実装で AABB を一括判定する (ベンチマークや結果の比較用)
+inline void TestAABBsBatch(const Frustum& frustum, const float* minXs, const float* minYs, const float* minZs,
+    const float* maxXs, const float* maxYs, const float* maxZs, size_t count, FrustumTest* out, SimdLevel level)
+{
+    switch (level) {
+#if defined(CAMERAMATH_X86)
+    case SimdLevel::AVX2: TestAABBsBatchAVX2(frustum, minXs, minYs, minZs, maxXs, maxYs, maxZs, count, out); return;
+    case SimdLevel::SSE2: TestAABBsBatchSSE2(frustum, minXs, minYs, minZs, maxXs, maxYs, maxZs, count, out); return;
+#endif
+    default: TestAABBsBatchScalar(frustum, minXs, minYs, minZs, maxXs, maxYs, maxZs, count, out); return;
+    }
+}
+
+// 実行中の CPU で使える最速の実装で AABB を一括判定する (通常はこちらを使う)
+inline void TestAABBsBatch(const Frustum& frustum, const float* minXs, const float* minYs, const float* minZs,
+    const float* maxXs, const float* maxYs, const float* maxZs, size_t count, FrustumTest* out)
+{
+    TestAABBsBatch(frustum, minXs, minYs, minZs, maxXs, maxYs, maxZs, count, out, DetectSimdLevel());
+}
+
+// 元の CameraMath.h にあった CameraTransform 関数 (オイラー角ベースの古い変換) は
+// 新しいカメラ実装 (クォータニオン + 行列) では不要になったため削除されています。
 /*
 static Vector3D CameraTransform(Vector3D& _location, Vector3D& _rotation)
 {
@@ -0,0 +1,94 @@
+#include "CameraSimulation.h" // 対応するヘッダーファイル
+#include <chrono>               // std::chrono::steady_clock (ステップの予定の時刻)
+
+/*
+ * CameraSimulation.cpp
+ * 概要:
+ *   CameraSimulation クラスの実装です。
+ *   スレッドは予定の時刻 (前の予定 + 1 ステップ) まで眠り、起きたら描画のスレッドが公開した最新の入力を受け取り、
+ *   予定の時刻を過ぎた分のステップをまとめて実行して、最後のステップのスナップショットだけを公開します。
+ */
+
+const unsigned int CameraSimulation::DEFAULT_STEPS_PER_SECOND;
+const unsigned int CameraSimulation::MAX_CATCH_UP_STEPS;
+
+// シミュレーションのスレッドを起動する
+void CameraSimulation::Start(const Camera& initial, unsigned int stepsPerSecond)
+{
+    Stop();
+    stepSeconds = 1.0f / static_cast<float>(stepsPerSecond > 0 ? stepsPerSecond : DEFAULT_STEPS_PER_SECOND);
+    const CameraSnapshot snapshot = initial.CaptureSnapshot();
+    simulated.ApplySnapshot(snapshot);
+    simulated.SetLens(initial.GetFovY(), initial.GetAspectRatio(), initial.GetNearZ(), initial.GetFarZ());
+    snapshots.Reset(snapshot);
+    submittedInput = InputState();
+    inputs.Reset(submittedInput);
+    stopRequested.store(false, std::memory_order_relaxed);
+    thread = std::thread(&CameraSimulation::Run, this);
+}
+
+// スレッドを止めて終了を待つ
+void CameraSimulation::Stop()
+{
+    if (!thread.joinable()) { return; }
+    stopRequested.store(true, std::memory_order_relaxed);
+    thread.join();
+}
+
+// 入力をシミュレーションのスレッドに渡す
+void CameraSimulation::SubmitInput(const CameraInput& input)
+{
+    submittedInput.mouseTotalX += input.mouseMoveX;
+    submittedInput.mouseTotalY += input.mouseMoveY;
+    submittedInput.keys = input.keys;
+    inputs.WriteBuffer() = submittedInput;
+    inputs.Publish();
+}
+
+// 最新のスナップショットを target に設定する
+void CameraSimulation::ApplyLatest(Camera& target)
+{
+    snapshots.Acquire();
+    target.ApplySnapshot(snapshots.ReadBuffer());
+}
+
+// シミュレーションのスレッドの処理本体
+void CameraSimulation::Run()
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::duration step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(stepSeconds));
+    Clock::time_point nextStep = Clock::now() + step;
+    uint64_t stepIndex = 0;
+    int64_t usedMouseX = 0, usedMouseY = 0; // 既にステップに渡したマウスの移動量の合計
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_until(nextStep);
+
+        // 予定の時刻を過ぎた分のステップを実行する (遅れすぎていたら予定を合わせ直す)
+        const Clock::time_point now = Clock::now();
+        if (nextStep > now) { continue; } // 予定より早く起きた
+        // 最新の入力を受け取る。マウスの移動量は前に使った分との差を最初のステップにだけ渡す
+        inputs.Acquire();
+        const InputState& latest = inputs.ReadBuffer();
+        CameraInput input;
+        input.mouseMoveX = static_cast<int>(latest.mouseTotalX - usedMouseX);
+        input.mouseMoveY = static_cast<int>(latest.mouseTotalY - usedMouseY);
+        input.keys = latest.keys;
+        usedMouseX = latest.mouseTotalX;
+        usedMouseY = latest.mouseTotalY;
+        unsigned int dueSteps = 0;
+        while (nextStep <= now && dueSteps < MAX_CATCH_UP_STEPS) {
+            simulated.Step(input, stepSeconds);
+            input.mouseMoveX = 0;
+            input.mouseMoveY = 0;
+            ++stepIndex;
+            ++dueSteps;
+            nextStep += step;
+        }
+        if (nextStep <= now) { nextStep = now + step; }
+
+        CameraSnapshot& snapshot = snapshots.WriteBuffer();
+        snapshot = simulated.CaptureSnapshot();
+        snapshot.step = stepIndex;
+        snapshots.Publish();
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Camera.h"       // Camera クラス, CameraSnapshot 構造体, CameraInput 構造体
+#include "TripleBuffer.h" // TripleBuffer (入力とスナップショットの受け渡し)
+#include <atomic>         // std::atomic (停止の指示)
+#include <cstdint>        // uint32_t, uint64_t, int64_t
+#include <thread>         // std::thread (シミュレーションのスレッド)
+
+/*
+ * CameraSimulation.h
+ * 役割:
+ *   カメラの更新 (入力に応じた移動・回転) を、描画とは別のスレッドで決まった間隔 (固定のタイムステップ) で
+ *   行う `CameraSimulation` クラスを定義します。
+ *   以前は WinMain のループの中で camera->Update(), camera->Draw(), topangle->Draw() を順番に呼んでいたため、
+ *   カメラの更新と描画が重ならず、描画が遅いフレームではカメラの動きも遅くなっていました。
+ *
+ * 仕組み:
+ *   - Start で起動したスレッドが、1 ステップ (1 / stepsPerSecond 秒) ごとに内部の Camera を Update し、
+ *     その結果を変更しないスナップショット (CameraSnapshot) として TripleBuffer で公開します。
+ *     Update には常に 1 ステップ分の時間を渡すので、カメラの速さは描画の速さに影響されません。
+ *   - 描画のスレッドは、フレームの初めに `ApplyLatest` で最新のスナップショットを描画用の Camera に設定します。
+ *     受け渡しはロックを使わないので、描画のスレッドがシミュレーションを待つことはありません。
+ *   - スレッドが一時的に止まって予定より大きく遅れた場合 (MAX_CATCH_UP_STEPS を超えた場合) は、
+ *     遅れを取り戻そうとせずに予定の時刻を現在の時刻に合わせ直します。
+ *   - 入力の読み取り (GetMousePoint, SetMousePoint, CheckHitKey) は DxLib の関数なので、描画のスレッドが
+ *     フレームごとに 1 回 Camera::ReadInput で行い、`SubmitInput` でシミュレーションのスレッドに渡します。
+ *     シミュレーションのスレッドは Camera::Step だけを呼び、DxLib の関数は呼びません。
+ *   - 入力の受け渡しにも TripleBuffer を使います。TripleBuffer は最新の値だけを渡すので、マウスの移動量は
+ *     「これまでの合計」として公開し、シミュレーションのスレッドが前に使った合計との差を最初のステップに渡します
+ *     (ステップの数とフレームの数が違っても、マウスの移動量は失われず、二重にも使われません)。
+ *     キーの状態は、公開された最新の状態を全てのステップで使います。
+ *
+ * 使い方:
+ *   CameraSimulation simulation;
+ *   simulation.Start(*camera, CameraSimulation::DEFAULT_STEPS_PER_SECOND); // camera の現在の状態から始める
+ *   // 毎フレーム (描画のスレッド)
+ *   simulation.SubmitInput(Camera::ReadInput());
+ *   simulation.ApplyLatest(*camera);
+ *   camera->Draw(...);
+ *   // 終了時
+ *   simulation.Stop();
+ */
+
+class CameraSimulation
+{
+public:
+    // 1 秒あたりのステップ数の既定値
+    static const unsigned int DEFAULT_STEPS_PER_SECOND = 120;
+    // 遅れを取り戻すために続けて実行するステップの上限 (これより遅れたら予定の時刻を合わせ直す)
+    static const unsigned int MAX_CATCH_UP_STEPS = 8;
+
+    CameraSimulation() = default;
+    ~CameraSimulation() { Stop(); }
+    CameraSimulation(const CameraSimulation&) = delete;
+    CameraSimulation& operator=(const CameraSimulation&) = delete;
+
+    // initial の位置・向きとレンズの設定から、シミュレーションのスレッドを起動する
+    // (既に動いていれば止めてから起動し直す。stepsPerSecond が 0 なら DEFAULT_STEPS_PER_SECOND)
+    void Start(const Camera& initial, unsigned int stepsPerSecond = DEFAULT_STEPS_PER_SECOND);
+    // スレッドを止めて終了を待つ (動いていなければ何もしない)
+    void Stop();
+    bool IsRunning() const { return thread.joinable(); }
+
+    // input (Camera::ReadInput で読み取った入力) をシミュレーションのスレッドに渡す (描画のスレッドから呼ぶ)。
+    // マウスの移動量は、次のステップまでに渡された分が合計される。
+    void SubmitInput(const CameraInput& input);
+    // 最新のスナップショットを target に設定する (描画のスレッドから呼ぶ)。
+    // 前の呼び出しから新しいステップが進んでいなければ、同じスナップショットをもう一度設定する。
+    void ApplyLatest(Camera& target);
+    // 最後に ApplyLatest で設定したスナップショットのステップ番号
+    uint64_t GetAppliedStep() const { return snapshots.ReadBuffer().step; }
+    // 1 ステップの時間 (秒)
+    float GetStepSeconds() const { return stepSeconds; }
+
+private:
+    // 描画のスレッドが公開する入力 (マウスの移動量は Start からの合計)
+    struct InputState {
+        int64_t mouseTotalX = 0;
+        int64_t mouseTotalY = 0;
+        uint32_t keys = 0;
+    };
+
+    // シミュレーションのスレッドの処理本体
+    void Run();
+
+    Camera simulated;                           // シミュレーションのスレッドだけが使う Camera
+    TripleBuffer<CameraSnapshot> snapshots;     // シミュレーションのスレッドから描画のスレッドへの受け渡し
+    TripleBuffer<InputState> inputs;            // 描画のスレッドからシミュレーションのスレッドへの入力の受け渡し
+    InputState submittedInput;                  // 最後に公開した入力 (描画のスレッドだけが使う)
+    float stepSeconds = 1.0f / DEFAULT_STEPS_PER_SECOND; // 1 ステップの時間 (秒)
+    std::atomic<bool> stopRequested{ false };   // Stop で true にしてスレッドを終了させる
+    std::thread thread;                         // シミュレーションのスレッド
+};
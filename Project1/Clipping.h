@@ -0,0 +1,299 @@
+#pragma once
+#include <cmath>        // std::fabs
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t, uint32_t
+#include <vector>       // std::vector (分類結果のリスト)
+#include "CameraMath.h" // Vector4D, ClipSpacePoints, SimdLevel, DetectSimdLevel
+
+/*
+ * Clipping.h
+ * 役割:
+ *   クリップ座標系 (同次座標) での線分クリッピング処理をまとめたヘッダーです。
+ *   以前は Camera.cpp の匿名名前空間にあった Cohen-Sutherland 法の関数群をここへ移し、
+ *   それに加えて、多数の線分をまとめて振り分ける「一括前処理」を追加しました。
+ *
+ * 主な機能:
+ *   - `ComputeOutCode`: 1 点のアウトコード (視錐台の 6 平面のどちら側にあるかを表す 6 ビット) を計算します。
+ *   - `ClipLineCohenSutherland`: 1 本の線分を視錐台でクリッピングします (反復処理)。
+ *   - `ComputeOutCodesBatch`: 多数の点のアウトコードを SSE2/AVX2 の比較命令でまとめて計算します。
+ *   - `ClassifySegments`: 両端点のアウトコードから、線分を
+ *       「そのまま描画 (accept)」「描画不要 (reject)」「クリッピングが必要 (clip)」
+ *     の 3 つのリストに振り分けます。反復的なクリッピング処理は clip リストの線分にだけ行えばよくなります。
+ *
+ * 使い方 (Camera::Draw での流れ):
+ *   1. TransformPointsBatch で全端点をクリップ座標に変換する
+ *   2. ComputeOutCodesBatch で全端点のアウトコードを計算する
+ *   3. ClassifySegments で線分を 3 つのリストに振り分ける
+ *   4. accept リストはそのまま描画し、clip リストだけ ClipLineCohenSutherland に通す
+ */
+
+namespace // 匿名名前空間 (Common.h と同じく、定数をインクルードしたファイル内だけで有効にする)
+{
+    // Cohen-Sutherlandアルゴリズムで使用する領域コード（アウトコード）の定数
+    // (NEAR / FAR は Windows のヘッダーでマクロ定義されているため、OUTCODE_ を付けた名前にしている)
+    const int OUTCODE_INSIDE = 0;  // 000000: 完全に視錐台の内部
+    const int OUTCODE_LEFT = 1;    // 000001: 左境界の外側 (x < -w)
+    const int OUTCODE_RIGHT = 2;   // 000010: 右境界の外側 (x > w)
+    const int OUTCODE_BOTTOM = 4;  // 000100: 下境界の外側 (y < -w)
+    const int OUTCODE_TOP = 8;     // 001000: 上境界の外側 (y > w)
+    const int OUTCODE_NEAR = 16;   // 010000: Near平面より手前 (z < 0)
+    const int OUTCODE_FAR = 32;    // 100000: Far平面より奥 (z > w)
+}
+
+// 4次元ベクトル start から end へ、パラメータ t (0.0～1.0) を使って線形補間するインライン関数
+// クリッピングで交点を計算する際に使用する。w成分も補間することが重要。
+inline Vector4D VectorLerp4D(const Vector4D& start, const Vector4D& end, float t) {
+    return {
+        start.x + (end.x - start.x) * t,
+        start.y + (end.y - start.y) * t,
+        start.z + (end.z - start.z) * t,
+        start.w + (end.w - start.w) * t
+    };
+}
+
+// クリップ座標系の点 p が、視錐台のどの領域にあるかを示すアウトコードを計算する関数
+// 元のコードのロジックを保持。w<=0 の場合の厳密なチェックは含まれていない点に注意。
+inline int ComputeOutCode(const Vector4D& p) {
+    int code = OUTCODE_INSIDE; // まず内部と仮定
+    // 各境界との比較を行い、外側にあれば対応するビットを立てる
+    if (p.x < -p.w) { code |= OUTCODE_LEFT; }
+    else if (p.x > p.w) { code |= OUTCODE_RIGHT; }
+    if (p.y < -p.w) { code |= OUTCODE_BOTTOM; }
+    else if (p.y > p.w) { code |= OUTCODE_TOP; }
+    if (p.z < 0.0f) { code |= OUTCODE_NEAR; }
+    else if (p.z > p.w) { code |= OUTCODE_FAR; }
+    return code; // 計算されたアウトコードを返す
+}
+
+// Cohen-Sutherlandアルゴリズムによる線分クリッピング関数 (両端点のアウトコードが計算済みの場合)
+// 引数: p1_clip, p2_clip (クリップ座標系の線分端点、クリップされると値が変更される)
+//       outcode1, outcode2 (それぞれの端点のアウトコード。ComputeOutCodesBatch の結果をそのまま渡せる)
+// 戻り値: 線分の一部でも視錐台内にあれば true、完全に外部なら false
+// 元のコードのロジックを保持
+inline bool ClipLineCohenSutherland(Vector4D& p1_clip, Vector4D& p2_clip, int outcode1, int outcode2) {
+    const int MAX_ITERATIONS = 10; // 無限ループ防止のための最大反復回数
+    int iterations = 0; // 現在の反復回数
+
+    while (iterations < MAX_ITERATIONS) { // 最大反復回数に達するまでループ
+        iterations++;
+        // Case 1: 両端点が内部にある場合 (Trivial Accept)
+        if ((outcode1 | outcode2) == 0) {
+            return true; // 線分全体が表示されるので true
+        }
+        // Case 2: 両端点が同じ外部領域にある場合 (Trivial Reject)
+        else if ((outcode1 & outcode2) != 0) {
+            return false; // 線分全体が表示されないので false
+        }
+        // Case 3: クリッピングが必要な場合
+        else {
+            // 外部にある方の点のアウトコードを選択
+            int outcode_outside = (outcode1 != 0) ? outcode1 : outcode2;
+            float t = 0.0f; // 交点のパラメータ (0.0 <= t <= 1.0)
+            Vector4D intersection_point; // 交点の座標
+            // 線分の方向ベクトル成分
+            float dx = p2_clip.x - p1_clip.x, dy = p2_clip.y - p1_clip.y;
+            float dz = p2_clip.z - p1_clip.z, dw = p2_clip.w - p1_clip.w;
+            float denominator; // 割り算の分母
+
+            // 外部コードに対応する境界平面との交差パラメータ t を計算
+            if (outcode_outside & OUTCODE_LEFT) {         // 左平面 (x = -w)
+                denominator = dx + dw;
+                if (std::fabs(denominator) < 1e-6f) { return false; } // 平行チェック
+                t = (-p1_clip.x - p1_clip.w) / denominator;
+            }
+            else if (outcode_outside & OUTCODE_RIGHT) {   // 右平面 (x = w)
+                denominator = dx - dw;
+                if (std::fabs(denominator) < 1e-6f) { return false; }
+                t = (p1_clip.w - p1_clip.x) / denominator;
+            }
+            else if (outcode_outside & OUTCODE_BOTTOM) {  // 下平面 (y = -w)
+                denominator = dy + dw;
+                if (std::fabs(denominator) < 1e-6f) { return false; }
+                t = (-p1_clip.y - p1_clip.w) / denominator;
+            }
+            else if (outcode_outside & OUTCODE_TOP) {     // 上平面 (y = w)
+                denominator = dy - dw;
+                if (std::fabs(denominator) < 1e-6f) { return false; }
+                t = (p1_clip.w - p1_clip.y) / denominator;
+            }
+            else if (outcode_outside & OUTCODE_NEAR) { // Near平面 (z = 0)
+                if (std::fabs(dz) < 1e-6f) { return false; } // 平行チェック
+                t = -p1_clip.z / dz;
+            }
+            else if (outcode_outside & OUTCODE_FAR) {  // Far平面 (z = w)
+                denominator = dz - dw;
+                if (std::fabs(denominator) < 1e-6f) { return false; } // 平行チェック
+                t = (p1_clip.w - p1_clip.z) / denominator;
+            }
+            else {
+                return false; // 通常は到達しない
+            }
+
+            // パラメータ t が線分上にない場合は棄却
+            if (t < 0.0f || t > 1.0f) { return false; }
+
+            // 交点の座標を線形補間で計算
+            intersection_point = VectorLerp4D(p1_clip, p2_clip, t);
+
+            // 外部にあった点を交点に置き換え、その点のアウトコードを再計算
+            if (outcode_outside == outcode1) {
+                p1_clip = intersection_point; // 始点を更新
+                outcode1 = ComputeOutCode(p1_clip); // 始点のアウトコードを再計算
+            }
+            else {
+                p2_clip = intersection_point; // 終点を更新
+                outcode2 = ComputeOutCode(p2_clip); // 終点のアウトコードを再計算
+            }
+            // ループの最初に戻り、再度判定を行う
+        }
+    }
+    // 最大反復回数に達した場合 (通常は起こらないが、念のため)
+    return false;
+}
+
+// Cohen-Sutherlandアルゴリズムによる線分クリッピング関数 (アウトコードもこの関数内で計算する版)
+inline bool ClipLineCohenSutherland(Vector4D& p1_clip, Vector4D& p2_clip) {
+    return ClipLineCohenSutherland(p1_clip, p2_clip, ComputeOutCode(p1_clip), ComputeOutCode(p2_clip));
+}
+
+// --- アウトコードの一括計算 ---
+
+// スカラー版: count 個の点 (x[i], y[i], z[i], w[i]) のアウトコードを outCodes[i] に書き込む
+inline void ComputeOutCodesBatchScalar(const float* xs, const float* ys, const float* zs, const float* ws, size_t count, uint8_t* outCodes)
+{
+    for (size_t i = 0; i < count; ++i) {
+        outCodes[i] = static_cast<uint8_t>(ComputeOutCode({ xs[i], ys[i], zs[i], ws[i] }));
+    }
+}
+
+#if defined(CAMERAMATH_X86)
+// SSE2 版: 4 点ずつ比較命令でアウトコードを計算する。
+// ComputeOutCode の else-if (左に該当したら右は判定しない) も、マスクの andnot で再現している。
+inline void ComputeOutCodesBatchSSE2(const float* xs, const float* ys, const float* zs, const float* ws, size_t count, uint8_t* outCodes)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128i bitLeft = _mm_set1_epi32(OUTCODE_LEFT), bitRight = _mm_set1_epi32(OUTCODE_RIGHT);
+    const __m128i bitBottom = _mm_set1_epi32(OUTCODE_BOTTOM), bitTop = _mm_set1_epi32(OUTCODE_TOP);
+    const __m128i bitNear = _mm_set1_epi32(OUTCODE_NEAR), bitFar = _mm_set1_epi32(OUTCODE_FAR);
+    alignas(16) int32_t codes[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i);
+        const __m128 z = _mm_loadu_ps(zs + i), w = _mm_loadu_ps(ws + i);
+        const __m128 negW = _mm_xor_ps(w, signMask); // -w
+        // 各平面の判定結果 (真のレーンは全ビット 1)
+        const __m128i left = _mm_castps_si128(_mm_cmplt_ps(x, negW));
+        const __m128i right = _mm_andnot_si128(left, _mm_castps_si128(_mm_cmpgt_ps(x, w)));
+        const __m128i bottom = _mm_castps_si128(_mm_cmplt_ps(y, negW));
+        const __m128i top = _mm_andnot_si128(bottom, _mm_castps_si128(_mm_cmpgt_ps(y, w)));
+        const __m128i nearM = _mm_castps_si128(_mm_cmplt_ps(z, zero));
+        const __m128i farM = _mm_andnot_si128(nearM, _mm_castps_si128(_mm_cmpgt_ps(z, w)));
+        // マスクを対応するビットに変換して合成
+        __m128i code = _mm_or_si128(_mm_and_si128(left, bitLeft), _mm_and_si128(right, bitRight));
+        code = _mm_or_si128(code, _mm_or_si128(_mm_and_si128(bottom, bitBottom), _mm_and_si128(top, bitTop)));
+        code = _mm_or_si128(code, _mm_or_si128(_mm_and_si128(nearM, bitNear), _mm_and_si128(farM, bitFar)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(codes), code);
+        outCodes[i + 0] = static_cast<uint8_t>(codes[0]);
+        outCodes[i + 1] = static_cast<uint8_t>(codes[1]);
+        outCodes[i + 2] = static_cast<uint8_t>(codes[2]);
+        outCodes[i + 3] = static_cast<uint8_t>(codes[3]);
+    }
+    ComputeOutCodesBatchScalar(xs + i, ys + i, zs + i, ws + i, count - i, outCodes + i);
+}
+
+// AVX2 版: 8 点ずつ比較命令でアウトコードを計算する。
+CAMERAMATH_TARGET_AVX2
+inline void ComputeOutCodesBatchAVX2(const float* xs, const float* ys, const float* zs, const float* ws, size_t count, uint8_t* outCodes)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256i bitLeft = _mm256_set1_epi32(OUTCODE_LEFT), bitRight = _mm256_set1_epi32(OUTCODE_RIGHT);
+    const __m256i bitBottom = _mm256_set1_epi32(OUTCODE_BOTTOM), bitTop = _mm256_set1_epi32(OUTCODE_TOP);
+    const __m256i bitNear = _mm256_set1_epi32(OUTCODE_NEAR), bitFar = _mm256_set1_epi32(OUTCODE_FAR);
+    alignas(32) int32_t codes[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i);
+        const __m256 z = _mm256_loadu_ps(zs + i), w = _mm256_loadu_ps(ws + i);
+        const __m256 negW = _mm256_xor_ps(w, signMask);
+        const __m256i left = _mm256_castps_si256(_mm256_cmp_ps(x, negW, _CMP_LT_OQ));
+        const __m256i right = _mm256_andnot_si256(left, _mm256_castps_si256(_mm256_cmp_ps(x, w, _CMP_GT_OQ)));
+        const __m256i bottom = _mm256_castps_si256(_mm256_cmp_ps(y, negW, _CMP_LT_OQ));
+        const __m256i top = _mm256_andnot_si256(bottom, _mm256_castps_si256(_mm256_cmp_ps(y, w, _CMP_GT_OQ)));
+        const __m256i nearM = _mm256_castps_si256(_mm256_cmp_ps(z, zero, _CMP_LT_OQ));
+        const __m256i farM = _mm256_andnot_si256(nearM, _mm256_castps_si256(_mm256_cmp_ps(z, w, _CMP_GT_OQ)));
+        __m256i code = _mm256_or_si256(_mm256_and_si256(left, bitLeft), _mm256_and_si256(right, bitRight));
+        code = _mm256_or_si256(code, _mm256_or_si256(_mm256_and_si256(bottom, bitBottom), _mm256_and_si256(top, bitTop)));
+        code = _mm256_or_si256(code, _mm256_or_si256(_mm256_and_si256(nearM, bitNear), _mm256_and_si256(farM, bitFar)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(codes), code);
+        for (int k = 0; k < 8; ++k) { outCodes[i + k] = static_cast<uint8_t>(codes[k]); }
+    }
+    ComputeOutCodesBatchScalar(xs + i, ys + i, zs + i, ws + i, count - i, outCodes + i);
+}
+#endif
+
+// 指定した命令セットの実装でアウトコードを一括計算する
+inline void ComputeOutCodesBatch(const float* xs, const float* ys, const float* zs, const float* ws, size_t count, uint8_t* outCodes, SimdLevel level)
+{
+    switch (level) {
+#if defined(CAMERAMATH_X86)
+    case SimdLevel::AVX2: ComputeOutCodesBatchAVX2(xs, ys, zs, ws, count, outCodes); return;
+    case SimdLevel::SSE2: ComputeOutCodesBatchSSE2(xs, ys, zs, ws, count, outCodes); return;
+#endif
+    default: ComputeOutCodesBatchScalar(xs, ys, zs, ws, count, outCodes); return;
+    }
+}
+
+// 実行中の CPU で使える最速の実装でアウトコードを一括計算する
+inline void ComputeOutCodesBatch(const float* xs, const float* ys, const float* zs, const float* ws, size_t count, uint8_t* outCodes)
+{
+    ComputeOutCodesBatch(xs, ys, zs, ws, count, outCodes, DetectSimdLevel());
+}
+
+// --- 線分の振り分け ---
+
+// ClassifySegments の結果。各リストには線分の番号 (SegmentBuffer での添字) が元の順番のまま入る。
+// フレームをまたいで使い回すと、リストの容量が保持されるためメモリ確保が起きない。
+struct SegmentClassification {
+    std::vector<uint32_t> accepted; // 両端点とも視錐台の内部 → クリッピング不要でそのまま描画できる
+    std::vector<uint32_t> rejected; // 両端点が同じ平面の外側 → 描画不要
+    std::vector<uint32_t> clipped;  // それ以外 → ClipLineCohenSutherland で切り取りが必要
+    size_t acceptedCount = 0;       // 各リストの有効な要素数 (リストの size() ではなくこちらを使う)
+    size_t rejectedCount = 0;
+    size_t clippedCount = 0;
+};
+
+// 端点のアウトコード (outCodes[2*i] が線分 i の始点、outCodes[2*i+1] が終点) から、
+// 線分 [firstSegment, firstSegment + segmentCount) を 3 つのリストに振り分ける。
+// 分岐予測の失敗を避けるため、3 つのリスト全てに番号を書き込み、該当するリストの件数だけを進める。
+inline void ClassifySegments(const uint8_t* outCodes, size_t firstSegment, size_t segmentCount, SegmentClassification& result)
+{
+    // 全ての線分が 1 つのリストに入る場合にも足りるだけの大きさを確保しておく
+    if (result.accepted.size() < segmentCount) {
+        result.accepted.resize(segmentCount);
+        result.rejected.resize(segmentCount);
+        result.clipped.resize(segmentCount);
+    }
+    uint32_t* accepted = result.accepted.data();
+    uint32_t* rejected = result.rejected.data();
+    uint32_t* clipped = result.clipped.data();
+    size_t nAccepted = 0, nRejected = 0, nClipped = 0;
+    for (size_t i = 0; i < segmentCount; ++i) {
+        const size_t segment = firstSegment + i;
+        const int code1 = outCodes[2 * segment];
+        const int code2 = outCodes[2 * segment + 1];
+        const size_t isAccepted = ((code1 | code2) == 0) ? 1 : 0;
+        const size_t isRejected = ((code1 & code2) != 0) ? 1 : 0;
+        const size_t isClipped = 1 - isAccepted - isRejected;
+        accepted[nAccepted] = static_cast<uint32_t>(segment);
+        rejected[nRejected] = static_cast<uint32_t>(segment);
+        clipped[nClipped] = static_cast<uint32_t>(segment);
+        nAccepted += isAccepted;
+        nRejected += isRejected;
+        nClipped += isClipped;
+    }
+    result.acceptedCount = nAccepted;
+    result.rejectedCount = nRejected;
+    result.clippedCount = nClipped;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>      // size_t
+#include <vector>       // std::vector
+#include "RenderSink.h" // RenderColor
+
+/*
+ * DrawCommandList.h
+ * 役割:
+ *   1 フレーム分の「線を描く」命令を記録しておく描画コマンドリスト `DrawCommandList` を定義します。
+ *   Camera::Draw や TopAngle::Draw は、線分ごとに描画関数を呼ぶ代わりにこのリストへ線を記録し、
+ *   最後に `RenderSink::Submit` でまとめて描画先に渡します。
+ *
+ * 特徴:
+ *   - 色は記録する時点で決まった値 (RenderColor) を持つため、描画時に線ごとの色変換は行いません。
+ *   - Clear() は要素数を 0 に戻すだけで、確保済みのメモリ (容量) はそのまま残ります。
+ *     毎フレーム同じリストを使い回せば、線分の数が増えない限りメモリ確保は発生しません。
+ *   - 記録した内容はただの配列なので、同じフレームを何度も描き直したり (リプレイ)、
+ *     前のフレームと比較したり (operator==) できます。
+ *
+ * 使い方:
+ *   DrawCommandList commands;              // メンバ変数などで保持して使い回す
+ *   commands.Clear();                      // フレームの最初に空にする
+ *   commands.AddLine(x1, y1, x2, y2, GetRenderColor(255, 255, 255));
+ *   sink.Submit(commands);                 // まとめて描画
+ */
+
+// 線を 1 本描く命令
+struct LineCommand {
+    float x1, y1;      // 始点 (スクリーン座標)
+    float x2, y2;      // 終点 (スクリーン座標)
+    RenderColor color; // 描画色 (記録時に決定済み)
+    bool antialias;    // true ならアンチエイリアス付き (DrawLineAA)、false なら DrawLine
+
+    bool operator==(const LineCommand& other) const {
+        return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2 &&
+               color == other.color && antialias == other.antialias;
+    }
+    bool operator!=(const LineCommand& other) const { return !(*this == other); }
+};
+
+class DrawCommandList
+{
+public:
+    // 全ての命令を削除する (確保済みの容量は残す)
+    void Clear() { lines.clear(); }
+    // 少なくとも lineCount 本分の容量を確保する
+    void Reserve(size_t lineCount) { lines.reserve(lineCount); }
+
+    // 線 (アンチエイリアスなし) の命令を追加する
+    void AddLine(float x1, float y1, float x2, float y2, RenderColor color) {
+        lines.push_back({ x1, y1, x2, y2, color, false });
+    }
+    // 線 (アンチエイリアス付き) の命令を追加する
+    void AddLineAA(float x1, float y1, float x2, float y2, RenderColor color) {
+        lines.push_back({ x1, y1, x2, y2, color, true });
+    }
+
+    size_t Size() const { return lines.size(); }
+    bool Empty() const { return lines.empty(); }
+    size_t Capacity() const { return lines.capacity(); }
+
+    // 記録した順に並んだ命令の配列
+    const LineCommand* Data() const { return lines.data(); }
+    const LineCommand& operator[](size_t i) const { return lines[i]; }
+    std::vector<LineCommand>::const_iterator begin() const { return lines.begin(); }
+    std::vector<LineCommand>::const_iterator end() const { return lines.end(); }
+
+    // 2 つのフレームの命令が完全に一致するか (フレーム間の比較用)
+    bool operator==(const DrawCommandList& other) const { return lines == other.lines; }
+    bool operator!=(const DrawCommandList& other) const { return !(*this == other); }
+
+private:
+    std::vector<LineCommand> lines; // 記録した命令 (記録順)
+};
@@ -0,0 +1,101 @@
+#include "DxLibRenderSink.h" // 対応するヘッダーファイル
+#include "DxLib.h"           // DxLib の描画関数
+#include "DrawCommandList.h" // DrawCommandList, LineCommand
+#include <algorithm>         // std::min
+
+/*
+ * DxLibRenderSink.cpp
+ * 概要:
+ *   DxLibRenderSink クラスの実装です。各メソッドは対応する DxLib の関数を呼ぶだけです。
+ *   描画色 (RenderColor) は、DxLib の GetColor で画面の色形式に合わせた値に変換してから渡します。
+ */
+
+namespace {
+    // RenderColor (0xRRGGBB) を DxLib の色の値に変換する
+    unsigned int ToDxColor(RenderColor color) {
+        return GetColor(GetRenderColorR(color), GetRenderColorG(color), GetRenderColorB(color));
+    }
+
+    // 1 回の DrawPrimitive2D に渡す頂点数の上限 (線 1 本で 2 頂点。大きすぎる呼び出しを避けるため分割する)
+    const size_t MAX_PRIMITIVE_VERTICES = 65536;
+
+    // DrawPrimitive2D 用の頂点を作る
+    VERTEX2D MakeLineVertex(float x, float y, RenderColor color) {
+        VERTEX2D v;
+        v.pos = VGet(x, y, 0.0f);
+        v.rhw = 1.0f;
+        v.dif.r = static_cast<unsigned char>(GetRenderColorR(color));
+        v.dif.g = static_cast<unsigned char>(GetRenderColorG(color));
+        v.dif.b = static_cast<unsigned char>(GetRenderColorB(color));
+        v.dif.a = 255; // 不透明度は SetBlendAlpha (SetDrawBlendMode) の設定に従う
+        v.u = 0.0f;
+        v.v = 0.0f;
+        return v;
+    }
+}
+
+DxLibRenderSink::DxLibRenderSink(int screenWidth, int screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight) {
+}
+
+void DxLibRenderSink::Clear() {
+    ClearDrawScreen();
+}
+
+void DxLibRenderSink::DrawLine(int x1, int y1, int x2, int y2, RenderColor color) {
+    ::DrawLine(x1, y1, x2, y2, ToDxColor(color));
+}
+
+void DxLibRenderSink::DrawLineAA(float x1, float y1, float x2, float y2, RenderColor color) {
+    ::DrawLineAA(x1, y1, x2, y2, ToDxColor(color));
+}
+
+void DxLibRenderSink::DrawBox(int x1, int y1, int x2, int y2, RenderColor color, bool fill) {
+    ::DrawBox(x1, y1, x2, y2, ToDxColor(color), fill ? TRUE : FALSE);
+}
+
+void DxLibRenderSink::DrawCircle(int x, int y, int radius, RenderColor color, bool fill) {
+    ::DrawCircle(x, y, radius, ToDxColor(color), fill ? TRUE : FALSE);
+}
+
+void DxLibRenderSink::DrawString(int x, int y, const char* text, RenderColor color) {
+    ::DrawString(x, y, text, ToDxColor(color));
+}
+
+void DxLibRenderSink::SetBlendAlpha(int alpha) {
+    if (alpha >= 255) { SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0); } // 通常モード
+    else { SetDrawBlendMode(DX_BLENDMODE_ALPHA, alpha); }           // 半透明モード
+}
+
+void DxLibRenderSink::SetClipRect(int x1, int y1, int x2, int y2) {
+    SetDrawArea(x1, y1, x2, y2);
+}
+
+void DxLibRenderSink::ResetClipRect() {
+    SetDrawArea(0, 0, screenWidth, screenHeight);
+}
+
+// 描画コマンドリストをまとめて描画する
+// アンチエイリアスなしの線が続く間は頂点配列に溜めておき、アンチエイリアス付きの線が来たら (描画順を守るため)
+// それまでの分を描画してから DrawLineAA を呼ぶ
+void DxLibRenderSink::Submit(const DrawCommandList& commands) {
+    lineVertices.clear();
+    for (const LineCommand& c : commands) {
+        if (c.antialias) {
+            FlushLineVertices();
+            ::DrawLineAA(c.x1, c.y1, c.x2, c.y2, ToDxColor(c.color));
+            continue;
+        }
+        lineVertices.push_back(MakeLineVertex(c.x1, c.y1, c.color));
+        lineVertices.push_back(MakeLineVertex(c.x2, c.y2, c.color));
+    }
+    FlushLineVertices();
+}
+
+void DxLibRenderSink::FlushLineVertices() {
+    for (size_t first = 0; first < lineVertices.size(); first += MAX_PRIMITIVE_VERTICES) {
+        const size_t count = std::min(MAX_PRIMITIVE_VERTICES, lineVertices.size() - first);
+        DrawPrimitive2D(lineVertices.data() + first, static_cast<int>(count), DX_PRIMTYPE_LINELIST, DX_NONE_GRAPH, TRUE);
+    }
+    lineVertices.clear();
+}
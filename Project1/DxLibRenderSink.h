@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>       // std::vector (頂点の作業用配列)
+#include "DxLib.h"      // VERTEX2D (DrawPrimitive2D の頂点)
+#include "RenderSink.h" // RenderSink インターフェース
+
+/*
+ * DxLibRenderSink.h
+ * 役割:
+ *   `RenderSink` の DxLib 版の実装です。受け取った描画命令を、そのまま DxLib の
+ *   描画関数 (DrawLine, DrawLineAA, DrawBox, DrawCircle, DrawString など) に渡します。
+ *   DxLib の初期化 (DxLib_Init) と描画先の設定 (SetDrawScreen) は、これまで通り WinMain で行います。
+ *
+ *   Submit (描画コマンドリスト) では、アンチエイリアスなしの線を頂点配列に詰め、
+ *   DrawPrimitive2D (DX_PRIMTYPE_LINELIST) の 1 回の呼び出しでまとめて描画します。
+ *   DxLib にはアンチエイリアス付きの線をまとめて描く関数がないため、その線だけは 1 本ずつ DrawLineAA で描きます。
+ *
+ * 使い方:
+ *   DxLibRenderSink sink(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT));
+ *   camera->Draw(worldLine, sink);
+ */
+
+class DxLibRenderSink : public RenderSink
+{
+public:
+    // screenWidth, screenHeight: 画面の大きさ (ResetClipRect で描画範囲を戻すときに使う)
+    DxLibRenderSink(int screenWidth, int screenHeight);
+
+    void Clear() override;
+    void DrawLine(int x1, int y1, int x2, int y2, RenderColor color) override;
+    void DrawLineAA(float x1, float y1, float x2, float y2, RenderColor color) override;
+    void DrawBox(int x1, int y1, int x2, int y2, RenderColor color, bool fill) override;
+    void DrawCircle(int x, int y, int radius, RenderColor color, bool fill) override;
+    void DrawString(int x, int y, const char* text, RenderColor color) override;
+    void SetBlendAlpha(int alpha) override;
+    void SetClipRect(int x1, int y1, int x2, int y2) override;
+    void ResetClipRect() override;
+    void Submit(const DrawCommandList& commands) override;
+
+private:
+    // lineVertices に溜めた線を DrawPrimitive2D で描画し、空にする
+    void FlushLineVertices();
+
+    std::vector<VERTEX2D> lineVertices; // Submit で使う頂点の作業用配列 (容量はフレーム間で使い回す)
+    int screenWidth;  // 画面の幅 (ピクセル)
+    int screenHeight; // 画面の高さ (ピクセル)
+};
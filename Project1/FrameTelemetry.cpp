@@ -0,0 +1,191 @@
+#include "FrameTelemetry.h" // 対応するヘッダーファイル
+#include "MappedFile.h"     // MappedFile (変換時の読み込み)
+#include <cstddef>          // offsetof
+#include <cstring>          // memcmp, memcpy, memset
+#include <iomanip>          // std::setprecision
+
+/*
+ * FrameTelemetry.cpp
+ * 概要:
+ *   フレームの記録ファイル (.wftrace) の書き込みと、CSV / JSON への変換の実装です。
+ *   書き込みは記録をバッファにコピーするだけで、書式化は変換するときにまとめて行います。
+ */
+
+const char FRAME_TELEMETRY_MAGIC[8] = { 'W', 'F', 'T', 'R', 'A', 'C', 'E', '\0' };
+const size_t FrameTelemetryWriter::DEFAULT_PREALLOCATED_FRAMES;
+const size_t FrameTelemetryWriter::WRITE_COMBINE_RECORDS;
+
+namespace {
+    // error が nullptr でなければ message を書き込み、false を返す (エラーで return するときに使う)
+    bool Fail(std::string* error, const std::string& message) {
+        if (error != nullptr) { *error = message; }
+        return false;
+    }
+
+    // ヘッダーの recordCount の位置 (ファイルの先頭からのバイト数)
+    const std::streamoff RECORD_COUNT_OFFSET = offsetof(FrameTelemetryHeader, recordCount);
+    // ラジアンから度への変換 (GetDetailedDebugInfo と同じく、回転角度は度で出力する)
+    const float RADIANS_TO_DEGREES = 57.29577951f;
+
+    // CSV の列名 (WriteCsvRow と同じ順番)
+    const char* const CSV_COLUMNS =
+        "frame,time_us,frame_us,update_us,draw_us,present_us,"
+        "pos_x,pos_y,pos_z,ori_x,ori_y,ori_z,ori_w,mouse_x,mouse_y,"
+        "yaw_deg,pitch_deg,roll_deg,key_forward,key_right,key_up,key_roll,"
+        "axis_f_x,axis_f_y,axis_f_z,axis_r_x,axis_r_y,axis_r_z,axis_u_x,axis_u_y,axis_u_z,"
+        "move_x,move_y,move_z";
+
+    // count 個の float を区切り文字 separator でつないで書く
+    void WriteFloats(std::ostream& out, const float* values, size_t count, const char* separator) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) { out << separator; }
+            out << values[i];
+        }
+    }
+
+    void WriteCsvRow(std::ostream& out, const FrameTelemetryRecord& r) {
+        const float rotationDegrees[3] = {
+            r.rotationRadians[0] * RADIANS_TO_DEGREES, r.rotationRadians[1] * RADIANS_TO_DEGREES, r.rotationRadians[2] * RADIANS_TO_DEGREES };
+        out << r.frameIndex << ',' << r.timeMicros << ',' << r.frameMicros << ',' << r.updateMicros << ','
+            << r.drawMicros << ',' << r.presentMicros << ',';
+        WriteFloats(out, r.position, 3, ","); out << ',';
+        WriteFloats(out, r.orientation, 4, ","); out << ',';
+        out << r.mouseMove[0] << ',' << r.mouseMove[1] << ',';
+        WriteFloats(out, rotationDegrees, 3, ","); out << ',';
+        WriteFloats(out, r.keyInput, 4, ","); out << ',';
+        WriteFloats(out, r.axisForward, 3, ","); out << ',';
+        WriteFloats(out, r.axisRight, 3, ","); out << ',';
+        WriteFloats(out, r.axisUp, 3, ","); out << ',';
+        WriteFloats(out, r.moveOffset, 3, ",");
+        out << '\n';
+    }
+
+    void WriteJsonObject(std::ostream& out, const FrameTelemetryRecord& r) {
+        const float rotationDegrees[3] = {
+            r.rotationRadians[0] * RADIANS_TO_DEGREES, r.rotationRadians[1] * RADIANS_TO_DEGREES, r.rotationRadians[2] * RADIANS_TO_DEGREES };
+        out << "{\"frame\":" << r.frameIndex << ",\"time_us\":" << r.timeMicros
+            << ",\"frame_us\":" << r.frameMicros << ",\"update_us\":" << r.updateMicros
+            << ",\"draw_us\":" << r.drawMicros << ",\"present_us\":" << r.presentMicros;
+        out << ",\"pos\":["; WriteFloats(out, r.position, 3, ",");
+        out << "],\"ori\":["; WriteFloats(out, r.orientation, 4, ",");
+        out << "],\"mouse\":[" << r.mouseMove[0] << ',' << r.mouseMove[1];
+        out << "],\"rot_deg\":["; WriteFloats(out, rotationDegrees, 3, ",");
+        out << "],\"key\":["; WriteFloats(out, r.keyInput, 4, ",");
+        out << "],\"axis_f\":["; WriteFloats(out, r.axisForward, 3, ",");
+        out << "],\"axis_r\":["; WriteFloats(out, r.axisRight, 3, ",");
+        out << "],\"axis_u\":["; WriteFloats(out, r.axisUp, 3, ",");
+        out << "],\"move\":["; WriteFloats(out, r.moveOffset, 3, ",");
+        out << "]}";
+    }
+}
+
+// ファイルを作り直して開く
+bool FrameTelemetryWriter::Open(const std::string& path, size_t preallocatedFrames, std::string* error)
+{
+    Close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) { return Fail(error, "フレームの記録ファイルを書き込み用に開けませんでした: " + path); }
+
+    FrameTelemetryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FRAME_TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version = FRAME_TELEMETRY_VERSION;
+    header.headerSize = sizeof(FrameTelemetryHeader);
+    header.recordSize = sizeof(FrameTelemetryRecord);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // 最後のバイトを書いて、ファイルを preallocatedFrames フレーム分の大きさに伸ばしておく
+    if (preallocatedFrames > 0) {
+        const uint64_t fileSize = sizeof(FrameTelemetryHeader) + static_cast<uint64_t>(preallocatedFrames) * sizeof(FrameTelemetryRecord);
+        file.seekp(static_cast<std::streamoff>(fileSize - 1));
+        file.put('\0');
+        file.seekp(static_cast<std::streamoff>(sizeof(FrameTelemetryHeader)));
+    }
+    if (!file) {
+        file.close();
+        return Fail(error, "フレームの記録ファイルの領域を確保できませんでした: " + path);
+    }
+
+    pending.clear();
+    pending.reserve(WRITE_COMBINE_RECORDS);
+    writtenCount = 0;
+    return true;
+}
+
+// 記録を 1 つ追加する
+void FrameTelemetryWriter::Append(const FrameTelemetryRecord& record)
+{
+    if (!file.is_open()) { return; }
+    pending.push_back(record);
+    if (pending.size() >= WRITE_COMBINE_RECORDS) { Flush(); }
+}
+
+// バッファに溜まった記録を書き出す
+void FrameTelemetryWriter::Flush()
+{
+    if (!file.is_open() || pending.empty()) { return; }
+
+    // 記録をまとめて 1 回で書き出す (書き込み位置は常に最後の記録の直後)
+    file.write(reinterpret_cast<const char*>(pending.data()), static_cast<std::streamsize>(pending.size() * sizeof(FrameTelemetryRecord)));
+    writtenCount += pending.size();
+    pending.clear();
+
+    // ヘッダーの recordCount を更新してから、書き込み位置を戻す
+    const std::streampos end = file.tellp();
+    file.seekp(RECORD_COUNT_OFFSET);
+    file.write(reinterpret_cast<const char*>(&writtenCount), sizeof(writtenCount));
+    file.seekp(end);
+    file.flush();
+}
+
+// 残りを書き出して閉じる
+void FrameTelemetryWriter::Close()
+{
+    if (!file.is_open()) { return; }
+    Flush();
+    file.close();
+}
+
+// .wftrace を CSV / JSON に変換する
+bool DecodeFrameTelemetry(const std::string& path, std::ostream& out, FrameTelemetryFormat format, std::string* error)
+{
+    MappedFile file;
+    if (!file.Open(path)) { return Fail(error, file.GetError()); }
+    const uint8_t* data = file.Data();
+    const uint64_t fileSize = file.Size();
+
+    // --- ヘッダーを確かめる ---
+    if (fileSize < sizeof(FrameTelemetryHeader)) { return Fail(error, "フレームの記録ファイルではありません (小さすぎます): " + path); }
+    FrameTelemetryHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, FRAME_TELEMETRY_MAGIC, sizeof(header.magic)) != 0) {
+        return Fail(error, "フレームの記録ファイルではありません (識別子が違います): " + path);
+    }
+    if (header.version != FRAME_TELEMETRY_VERSION || header.headerSize != sizeof(FrameTelemetryHeader) ||
+        header.recordSize != sizeof(FrameTelemetryRecord)) {
+        return Fail(error, "対応していないバージョンのフレームの記録ファイルです (version " + std::to_string(header.version) + "): " + path);
+    }
+    // ファイルが途中で切れている場合は、収まっている記録だけを変換する
+    const uint64_t storedCount = (fileSize - sizeof(FrameTelemetryHeader)) / sizeof(FrameTelemetryRecord);
+    const uint64_t count = (header.recordCount < storedCount) ? header.recordCount : storedCount;
+
+    // --- 記録を 1 つずつ書式化する ---
+    out << std::fixed << std::setprecision(4); // GetDetailedDebugInfo と同じく小数点以下 4 桁
+    if (format == FrameTelemetryFormat::Csv) { out << CSV_COLUMNS << '\n'; }
+    else { out << "[\n"; }
+    FrameTelemetryRecord record;
+    for (uint64_t i = 0; i < count; ++i) {
+        std::memcpy(&record, data + sizeof(FrameTelemetryHeader) + i * sizeof(FrameTelemetryRecord), sizeof(record));
+        if (format == FrameTelemetryFormat::Csv) {
+            WriteCsvRow(out, record);
+        }
+        else {
+            WriteJsonObject(out, record);
+            out << ((i + 1 < count) ? ",\n" : "\n");
+        }
+    }
+    if (format == FrameTelemetryFormat::Json) { out << "]\n"; }
+
+    if (!out) { return Fail(error, "フレームの記録の変換結果を書き込めませんでした: " + path); }
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t, int32_t
+#include <fstream> // std::ofstream
+#include <ostream> // std::ostream (デコード結果の出力先)
+#include <string>  // std::string
+#include <vector>  // std::vector (書き込み前の記録を溜めるバッファ)
+
+/*
+ * FrameTelemetry.h
+ * 役割:
+ *   毎フレームのカメラの状態とフレーム時間を、固定長のバイナリの記録としてファイル (.wftrace) に
+ *   追記する `FrameTelemetryWriter` と、そのファイルを CSV / JSON に変換する `DecodeFrameTelemetry` を定義します。
+ *   以前は Camera::GetDetailedDebugInfo が毎フレーム約 400 文字の文字列を iostream で組み立てて
+ *   ログに書いていましたが、その書式化の代わりに、値をそのまま 144 バイトの記録にコピーするだけにします。
+ *   長時間の連続運転でもファイルが小さく (1 時間 60fps で約 30MB)、後から表計算ソフトなどで分析できます。
+ *
+ * ファイルの構成 (リトルエンディアン):
+ *   [FrameTelemetryHeader]   先頭の 64 バイト
+ *   [FrameTelemetryRecord]   144 バイトの記録がフレームの数だけ
+ *   - Open で、指定したフレーム数の分だけファイルを先に伸ばしておきます (書き込みのたびにファイルが
+ *     伸びるのを避けるため)。そのため、ファイルの末尾には 0 のままの領域が残ることがあります。
+ *     有効な記録の数はヘッダーの recordCount で表します。
+ *   - 記録はいったんメモリ上のバッファに溜め (ライトコンバイン)、バッファがいっぱいになったら
+ *     1 回の write でまとめて書き出し、同時にヘッダーの recordCount を更新します。
+ *     プログラムが途中で終了しても、最後に書き出したところまでは読み込めます。
+ *
+ * 使い方:
+ *   FrameTelemetryWriter telemetry;
+ *   telemetry.Open("frame_telemetry.wftrace");
+ *   // 毎フレーム
+ *   FrameTelemetryRecord record = {};
+ *   camera->FillTelemetry(record); // カメラの状態
+ *   record.frameMicros = ...;      // フレーム時間
+ *   telemetry.Append(record);
+ *   // 変換 (オフライン)
+ *   std::ofstream csv("trace.csv");
+ *   DecodeFrameTelemetry("frame_telemetry.wftrace", csv, FrameTelemetryFormat::Csv);
+ */
+
+// ファイルの先頭の識別子 ("WFTRACE" と終端の 0)
+extern const char FRAME_TELEMETRY_MAGIC[8];
+// 現在のファイル形式の番号
+const uint32_t FRAME_TELEMETRY_VERSION = 1;
+
+// ファイルの先頭に置くヘッダー (64 バイト)
+struct FrameTelemetryHeader {
+    char magic[8];          // FRAME_TELEMETRY_MAGIC
+    uint32_t version;       // FRAME_TELEMETRY_VERSION
+    uint32_t headerSize;    // sizeof(FrameTelemetryHeader)
+    uint32_t recordSize;    // sizeof(FrameTelemetryRecord)
+    uint32_t flags;         // 予約 (0)
+    uint64_t recordCount;   // 書き込み済みの記録の数 (これより後ろは、先に伸ばしただけの領域)
+    uint8_t reserved[32];   // 予約 (0)。将来の拡張用
+};
+static_assert(sizeof(FrameTelemetryHeader) == 64, "FrameTelemetryHeader は 64 バイトである必要があります。");
+
+// 1 フレーム分の記録 (144 バイト)。GetDetailedDebugInfo と同じ項目に、フレーム時間を加えたもの。
+struct FrameTelemetryRecord {
+    uint64_t frameIndex;        // フレーム番号 (0 から)
+    uint64_t timeMicros;        // 記録を開始してからの時間 (マイクロ秒)
+    uint32_t frameMicros;       // 前のフレームの開始からこのフレームの開始までの時間 (マイクロ秒)
+    uint32_t updateMicros;      // Camera::Update (別スレッドで更新する場合は最新の状態の設定) にかかった時間
+    uint32_t drawMicros;        // 線分の準備と Camera::Draw, TopAngle::Draw にかかった時間
+    uint32_t presentMicros;     // ScreenFlip にかかった時間
+    float position[3];          // カメラの位置 (x, y, z)
+    float orientation[4];       // カメラの向きのクォータニオン (x, y, z, w)
+    int32_t mouseMove[2];       // マウスの移動量 (x, y)
+    float rotationRadians[3];   // このフレームの回転角度 (ヨー, ピッチ, ロール)
+    float keyInput[4];          // キー入力 (前後, 左右, 上下, ロール)。それぞれ -1, 0, 1
+    float axisForward[3];       // カメラの前方ベクトル
+    float axisRight[3];         // カメラの右方ベクトル
+    float axisUp[3];            // カメラの上方ベクトル
+    float moveOffset[3];        // このフレームの移動量 (ワールド座標)
+};
+static_assert(sizeof(FrameTelemetryRecord) == 144, "FrameTelemetryRecord は 144 バイトである必要があります。");
+
+// DecodeFrameTelemetry の出力形式
+enum class FrameTelemetryFormat {
+    Csv,  // 1 行目が列名、以降 1 行 1 フレーム
+    Json  // 記録ごとのオブジェクトの配列
+};
+
+class FrameTelemetryWriter
+{
+public:
+    // Open で先に伸ばしておくフレーム数の既定値 (60fps で約 1 時間分、約 30MB)
+    static const size_t DEFAULT_PREALLOCATED_FRAMES = 60 * 60 * 60;
+    // メモリ上に溜めてからまとめて書き出す記録の数 (約 36KB)
+    static const size_t WRITE_COMBINE_RECORDS = 256;
+
+    FrameTelemetryWriter() = default;
+    ~FrameTelemetryWriter() { Close(); }
+    FrameTelemetryWriter(const FrameTelemetryWriter&) = delete;
+    FrameTelemetryWriter& operator=(const FrameTelemetryWriter&) = delete;
+
+    // path を作り直して開き、preallocatedFrames フレーム分の大きさに伸ばしておく。
+    // 失敗したら false を返し、error があれば理由を書き込む。既に開いていたファイルは閉じられる。
+    bool Open(const std::string& path, size_t preallocatedFrames = DEFAULT_PREALLOCATED_FRAMES, std::string* error = nullptr);
+    // 記録を 1 つ追加する (バッファがいっぱいになったときだけファイルに書き出す)
+    void Append(const FrameTelemetryRecord& record);
+    // バッファに溜まった記録を書き出し、ヘッダーの recordCount を更新する
+    void Flush();
+    // 残りを書き出してファイルを閉じる (開いていなければ何もしない)
+    void Close();
+
+    bool IsOpen() const { return file.is_open(); }
+    // これまでに Append した記録の数 (まだバッファにあるものも含む)
+    uint64_t GetRecordCount() const { return writtenCount + pending.size(); }
+
+private:
+    std::ofstream file;                         // 書き込み先
+    std::vector<FrameTelemetryRecord> pending;  // まだ書き出していない記録 (容量は WRITE_COMBINE_RECORDS)
+    uint64_t writtenCount = 0;                  // ファイルに書き出した記録の数
+};
+
+// path の .wftrace を読み込み、format の形式で out に書き出す。
+// 失敗したら false を返し、error があれば理由を書き込む。
+bool DecodeFrameTelemetry(const std::string& path, std::ostream& out, FrameTelemetryFormat format, std::string* error = nullptr);
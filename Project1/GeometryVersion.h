@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>  // std::atomic (版番号)
+#include <cstdint> // uint64_t
+
+/*
+ * GeometryVersion.h
+ * 役割:
+ *   線分やメッシュの内容が変わったかどうかを、内容を比べずに判定するための版番号 `GeometryVersion` を定義します。
+ *   SegmentBuffer と WireMesh が持ち、Camera::Draw が前のフレームの結果を使い回せるかどうかの判定に使います。
+ *
+ * 仕組み:
+ *   - 内容を変更する関数は `Touch` で版番号を「未発行 (0)」に戻すだけです (ストア 1 回なので、
+ *     線分を 1 本ずつ追加するような処理でもほとんど負担になりません)。
+ *   - `Get` は、未発行ならプログラム全体で一意の新しい番号を発行して返します。
+ *     そのため、別のバッファが同じアドレスに作り直された場合でも、前の番号と一致することはありません。
+ *   - コピーすると同じ番号を引き継ぎます (内容も同じなので)。ムーブした場合は、移動元を未発行に戻します。
+ *   - 複数のスレッドが別々の要素に書き込む処理 (WireMesh::SetVertex など) は要素ごとに Touch せず、
+ *     書き込みが終わった後に 1 回だけ Touch します (WireMesh::MarkChanged)。
+ */
+
+class GeometryVersion
+{
+public:
+    GeometryVersion() = default;
+    GeometryVersion(const GeometryVersion& other) : value(other.value.load(std::memory_order_relaxed)) {}
+    GeometryVersion(GeometryVersion&& other) : value(other.value.exchange(0, std::memory_order_relaxed)) {}
+    GeometryVersion& operator=(const GeometryVersion& other) {
+        value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+    GeometryVersion& operator=(GeometryVersion&& other) {
+        value.store(other.value.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    // 内容が変わったことを記録する (次の Get で新しい番号になる)
+    void Touch() { value.store(0, std::memory_order_relaxed); }
+    // 現在の内容の版番号 (0 にはならない)
+    uint64_t Get() const {
+        uint64_t current = value.load(std::memory_order_relaxed);
+        if (current == 0) {
+            current = NextVersion();
+            value.store(current, std::memory_order_relaxed);
+        }
+        return current;
+    }
+
+private:
+    // プログラム全体で一意の番号を発行する
+    static uint64_t NextVersion() {
+        static std::atomic<uint64_t> counter{ 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    mutable std::atomic<uint64_t> value{ 0 }; // 0 なら未発行
+};
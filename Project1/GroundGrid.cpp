@@ -0,0 +1,108 @@
+#include "GroundGrid.h" // 対応するヘッダーファイル
+#include <algorithm>    // std::min, std::max
+#include <cmath>        // ceilf, floorf, fabsf
+
+/*
+ * GroundGrid.cpp
+ * 概要:
+ *   GroundGrid クラスの実装です。
+ *   グリッド線は地面上の直線 P(t) なので、視錐台の各平面の式 a*x + b*y + c*z + d に代入すると
+ *   t の一次式 k0 + k1 * t になります。全ての平面でこれが 0 以上になる t の区間を求めれば、
+ *   視錐台で切り取った線分が得られます。
+ */
+
+// 静的定数メンバーの定義 (値はヘッダー側で指定)
+const int GroundGrid::LEVEL_SCALE;
+const int GroundGrid::MAX_LEVELS;
+const int GroundGrid::MAX_RECT_LINES;
+
+GroundGrid::GroundGrid(float groundY, float spacing, float fadeCells, float maxDistance)
+    : groundY(groundY), spacing(spacing), fadeCells(fadeCells), maxDistance(maxDistance) {
+}
+
+// 視錐台に入る部分のグリッド線を追加する
+void GroundGrid::AppendVisibleLines(const Frustum& frustum, const Vector3D& eye, SegmentBuffer& out) const
+{
+    if (!(spacing > 0.0f) || !(fadeCells > 0.0f)) { return; }
+
+    float levelSpacing = spacing; // このレベルの線の間隔
+    float innerRange = 0.0f;      // 1 つ内側のレベルが線を引いた範囲 (カメラからの距離。最初のレベルでは 0)
+    for (int level = 0; level < MAX_LEVELS; ++level) {
+        const float range = std::min(levelSpacing * fadeCells, maxDistance); // このレベルの線を引く範囲
+
+        // alongZ が true なら x = 一定 の線 (中心は eye.x)、false なら z = 一定 の線 (中心は eye.z)
+        for (int axis = 0; axis < 2; ++axis) {
+            const bool alongZ = (axis == 0);
+            const float center = alongZ ? eye.x : eye.z;      // 線を並べる方向の中心
+            const float lineCenter = alongZ ? eye.z : eye.x;  // 線が伸びる方向の中心
+            const int first = static_cast<int>(ceilf((center - range) / levelSpacing));
+            const int last = static_cast<int>(floorf((center + range) / levelSpacing));
+            for (int i = first; i <= last; ++i) {
+                const float fixed = static_cast<float>(i) * levelSpacing;
+                if (level > 0 && fabsf(fixed - center) <= innerRange) {
+                    // 内側のレベルの範囲を通る線: 内側の正方形の中は内側のレベルが引いているので、その外の 2 か所だけ引く
+                    AppendClippedLine(frustum, alongZ, fixed, lineCenter - range, lineCenter - innerRange, out);
+                    AppendClippedLine(frustum, alongZ, fixed, lineCenter + innerRange, lineCenter + range, out);
+                }
+                else {
+                    AppendClippedLine(frustum, alongZ, fixed, lineCenter - range, lineCenter + range, out);
+                }
+            }
+        }
+
+        if (range >= maxDistance) { break; } // 最大の距離まで引いたので終わり
+        innerRange = range;
+        levelSpacing *= static_cast<float>(LEVEL_SCALE);
+    }
+}
+
+// XZ 平面の矩形に入る部分のグリッド線を追加する
+void GroundGrid::AppendLinesInRect(float minX, float minZ, float maxX, float maxZ, SegmentBuffer& out) const
+{
+    if (!(spacing > 0.0f) || !(minX <= maxX) || !(minZ <= maxZ)) { return; }
+
+    // 広い矩形で線が多くなりすぎないように、1 方向の本数が MAX_RECT_LINES 以下になるまで間隔を広げる
+    float levelSpacing = spacing;
+    for (int level = 1; level < MAX_LEVELS && std::max(maxX - minX, maxZ - minZ) / levelSpacing > MAX_RECT_LINES; ++level) {
+        levelSpacing *= static_cast<float>(LEVEL_SCALE);
+    }
+
+    // x = 一定 の Z 方向の線
+    const int firstX = static_cast<int>(ceilf(minX / levelSpacing));
+    const int lastX = static_cast<int>(floorf(maxX / levelSpacing));
+    for (int i = firstX; i <= lastX; ++i) {
+        const float x = static_cast<float>(i) * levelSpacing;
+        out.Append({ x, groundY, minZ }, { x, groundY, maxZ });
+    }
+    // z = 一定 の X 方向の線
+    const int firstZ = static_cast<int>(ceilf(minZ / levelSpacing));
+    const int lastZ = static_cast<int>(floorf(maxZ / levelSpacing));
+    for (int i = firstZ; i <= lastZ; ++i) {
+        const float z = static_cast<float>(i) * levelSpacing;
+        out.Append({ minX, groundY, z }, { maxX, groundY, z });
+    }
+}
+
+// 1 本のグリッド線を視錐台で切り取って追加する
+void GroundGrid::AppendClippedLine(const Frustum& frustum, bool alongZ, float fixed, float t0, float t1, SegmentBuffer& out) const
+{
+    for (int k = 0; k < Frustum::PLANE_COUNT && t0 < t1; ++k) {
+        const Frustum::Plane& p = frustum.planes[k];
+        // P(t) を平面の式に代入した k0 + k1 * t (>= 0 が内側)
+        const float k0 = (alongZ ? p.a : p.c) * fixed + p.b * groundY + p.d;
+        const float k1 = alongZ ? p.c : p.a;
+        if (k1 == 0.0f) {
+            if (k0 < 0.0f) { return; } // 線全体が平面の外
+        }
+        else if (k1 > 0.0f) {
+            t0 = std::max(t0, -k0 / k1); // t が大きい側が内側
+        }
+        else {
+            t1 = std::min(t1, -k0 / k1); // t が小さい側が内側
+        }
+    }
+    if (!(t0 < t1)) { return; } // 視錐台に入る部分がない
+
+    if (alongZ) { out.Append({ fixed, groundY, t0 }, { fixed, groundY, t1 }); }
+    else { out.Append({ t0, groundY, fixed }, { t1, groundY, fixed }); }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Vector.h"        // Vector3D
+#include "CameraMath.h"    // Frustum
+#include "SegmentBuffer.h" // SegmentBuffer
+
+/*
+ * GroundGrid.h
+ * 役割:
+ *   高さ y = groundY の水平な地面に、無限に続くグリッド線を表す `GroundGrid` を定義します。
+ *   以前は Main.cpp で ±500 の範囲に 10 間隔で 2×101 本の長い線分を作って静的な線分リストに入れていたため、
+ *   見えていない線も毎フレーム変換・クリッピングされ、グリッドは 500 の所で途切れていました。
+ *
+ * 仕組み:
+ *   - 毎フレーム、カメラの視錐台に入る部分のグリッド線だけを計算で求めて、線分リストに追加します。
+ *   - グリッド線 (例: x = 一定 の Z 方向の線) は直線なので、視錐台の 6 平面それぞれとの交点を
+ *     直接計算して、視錐台の内側にある区間 [t0, t1] だけを切り出します (Liang-Barsky 法と同じ考え方)。
+ *   - 遠くの細かい線は画面上で潰れて見えないため、間隔を距離に応じて広げます (間隔のフェード)。
+ *     レベル k の間隔は spacing × LEVEL_SCALE^k で、カメラから fadeCells × (そのレベルの間隔) の
+ *     正方形の範囲だけに引きます。内側のレベルの範囲と重なる部分は内側のレベルの線に任せて省きます。
+ *   - カメラから maxDistance より遠い線は引きません (レベルもそこで打ち切ります)。
+ *   - トップダウンビューのように XZ 平面の矩形を映す表示には、視錐台ではなくその矩形で切り取った
+ *     グリッド線を AppendLinesInRect で作ります (視錐台の外の線も矩形の中なら引きます)。
+ *
+ * 使い方:
+ *   GroundGrid ground(-25.0f, 10.0f);
+ *   // 毎フレーム
+ *   ground.AppendVisibleLines(frustum, camera->GetPosition(), frameLines);
+ *   ground.AppendLinesInRect(minX, minZ, maxX, maxZ, topLines); // トップダウンビュー用
+ */
+
+class GroundGrid
+{
+public:
+    // 1 つ外側のレベルで、線の間隔を何倍にするか
+    static const int LEVEL_SCALE = 10;
+    // 作るレベルの最大数
+    static const int MAX_LEVELS = 6;
+    // AppendLinesInRect で 1 方向に引く線の最大数 (超えるときは線の間隔を LEVEL_SCALE 倍ずつ広げる)
+    static const int MAX_RECT_LINES = 256;
+
+    // groundY: 地面の高さ, spacing: 最も細かいレベルの線の間隔,
+    // fadeCells: 各レベルの線を引く範囲 (カメラからの距離を、そのレベルの間隔の何倍までにするか),
+    // maxDistance: 線を引く最大の距離 (カメラからの XZ 平面上の距離。通常はカメラのファークリップ距離)
+    GroundGrid(float groundY, float spacing, float fadeCells = 50.0f, float maxDistance = 1000.0f);
+
+    // frustum に入る部分のグリッド線を、視錐台で切り取った線分として out の末尾に追加する
+    // eye はカメラの位置 (線の間隔のレベルを決める中心)
+    void AppendVisibleLines(const Frustum& frustum, const Vector3D& eye, SegmentBuffer& out) const;
+    // XZ 平面の矩形 [minX, maxX] × [minZ, maxZ] に入る部分のグリッド線を、矩形で切り取った線分として out の末尾に追加する
+    // 線の間隔は最も細かいレベル (spacing) で、線が多すぎるときだけ広げる
+    void AppendLinesInRect(float minX, float minZ, float maxX, float maxZ, SegmentBuffer& out) const;
+
+    float GetGroundY() const { return groundY; }
+    float GetSpacing() const { return spacing; }
+
+private:
+    // 1 本のグリッド線 (alongZ が true なら x = fixed の Z 方向の線、false なら z = fixed の X 方向の線) の
+    // 区間 [t0, t1] を視錐台で切り取り、残った部分を out に追加する
+    void AppendClippedLine(const Frustum& frustum, bool alongZ, float fixed, float t0, float t1, SegmentBuffer& out) const;
+
+    float groundY;     // 地面の高さ
+    float spacing;     // 最も細かいレベルの線の間隔
+    float fadeCells;   // 各レベルの線を引く範囲 (そのレベルの間隔の何倍か)
+    float maxDistance; // 線を引く最大の距離
+};
@@ -0,0 +1,257 @@
+#include "Logger.h"     // 対応するヘッダーファイル
+#include <system_error> // std::system_error (スレッドを起動できなかったとき)
+
+/*
+ * Logger.cpp
+ * 概要:
+ *   Logger クラスの実装です。
+ *   非同期モードのリングバッファは、各スロットの通し番号 (sequence) で状態を表す
+ *   固定長のキューです。書き込み元は enqueuePosition を CAS で進めてスロットを確保し、
+ *   記録を入れてから通し番号を進めます。書き込みスレッドは 1 本だけなので、
+ *   読み出し位置 (dequeuePosition) は atomic にする必要がありません。
+ */
+
+const size_t Logger::DEFAULT_ASYNC_CAPACITY = 4096;
+
+namespace {
+    // 書き込みスレッドが 1 回の write でまとめて書き出す量の目安 (バイト)
+    const size_t WRITE_BATCH_BYTES = 64 * 1024;
+}
+
+// ログファイルを開く
+bool Logger::Open(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    // もし既にファイルが開かれていたら、一度閉じる
+    if (logFile.is_open()) {
+        logFile.close();
+        fileOpen.store(false);
+    }
+    // std::ios::trunc を指定すると、ファイルが既に存在する場合、中身を空にしてから開く（上書き）。
+    // もし追記したい場合は std::ios::app を代わりに指定する。
+    logFile.open(filename, std::ios::out | std::ios::trunc);
+    if (!logFile.is_open()) { // ファイルを開けなかった場合
+        return false;
+    }
+    logFile << "--- Log Start ---" << std::endl; // 開始マーカー
+    fileOpen.store(true);
+    return true;
+}
+
+// 非同期モードを開始する
+bool Logger::StartAsync(size_t capacity, LogOverflowPolicy policy)
+{
+    if (asyncEnabled.load()) { return true; }
+
+    // 大きさを 2 のべき乗に切り上げる (位置からスロットの番号を & で求めるため)
+    size_t size = 2;
+    while (size < capacity) { size <<= 1; }
+
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    capacityMask = size - 1;
+    enqueuePosition.store(0);
+    dequeuePosition = 0;
+    writtenPosition.store(0);
+    overflowPolicy.store(static_cast<int>(policy));
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = false;
+    }
+
+    try {
+        writerThread = std::thread(&Logger::WriterLoop, this);
+    }
+    catch (const std::system_error&) {
+        slots.reset();
+        return false; // スレッドを起動できなければ同期モードのまま
+    }
+    asyncEnabled.store(true);
+    return true;
+}
+
+// 非同期モードを終了する
+void Logger::StopAsync()
+{
+    if (!asyncEnabled.exchange(false)) { return; }
+
+    // 既にリングバッファに書き込み中の Write が終わるまで待つ
+    // (これ以降に呼ばれた Write は asyncEnabled が false なので同期モードで書き込む)
+    while (activeProducers.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    // 書き込みスレッドに終了を指示する (残った記録を全て書き出してから終了する)
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = true;
+    }
+    wakeCondition.notify_one();
+    writerThread.join();
+    slots.reset();
+    capacityMask = 0;
+
+    // Flush で待っているスレッドを起こす
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    writtenCondition.notify_all();
+}
+
+// これまでに Write した記録がファイルに書き込まれるまで待つ
+void Logger::Flush()
+{
+    if (asyncEnabled.load()) {
+        const size_t target = enqueuePosition.load();
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+        writtenCondition.wait(lock, [&]() {
+            return !asyncEnabled.load() || writtenPosition.load() >= target;
+        });
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (logFile.is_open()) { logFile.flush(); }
+}
+
+// ログファイルにメッセージを書き込む
+void Logger::Write(std::string message)
+{
+    if (asyncEnabled.load()) {
+        // StopAsync が終了を待てるように、リングバッファを使っている間は activeProducers を増やしておく
+        activeProducers.fetch_add(1);
+        if (asyncEnabled.load()) {
+            bool queued = TryEnqueue(message);
+            while (!queued && static_cast<LogOverflowPolicy>(overflowPolicy.load()) == LogOverflowPolicy::Block) {
+                // いっぱいなら書き込みスレッドを起こし、空きができるまで待つ
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                }
+                wakeCondition.notify_one();
+                std::this_thread::yield();
+                queued = TryEnqueue(message);
+            }
+            if (!queued) {
+                droppedCount.fetch_add(1);
+            }
+            else {
+                // 記録を入れたことと writerSleeping の読み出しの順番を保証する
+                // (書き込みスレッドが眠る直前に記録を確かめるのと対になる)
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (writerSleeping.load()) {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                    wakeCondition.notify_one();
+                }
+            }
+            activeProducers.fetch_sub(1);
+            return;
+        }
+        activeProducers.fetch_sub(1);
+    }
+
+    // 同期モード: その場で書き込み、1 行ごとにフラッシュする
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (logFile.is_open()) {
+        logFile << message << std::endl; // メッセージをファイルに書き込み、最後に改行を追加
+    }
+}
+
+// ログファイルを閉じる
+void Logger::Close()
+{
+    StopAsync(); // 残った記録を書き出してから書き込みスレッドを止める
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (logFile.is_open()) { // ファイルが開いている場合
+        logFile << "--- Log End ---" << std::endl; // 終了マーカーを書き込む
+        logFile.close(); // ファイルを閉じる
+        fileOpen.store(false);
+    }
+}
+
+// リングバッファに記録を入れる
+bool Logger::TryEnqueue(std::string& message)
+{
+    size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[position & capacityMask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            // スロットが空いている: 位置を 1 つ進められたら、このスロットはこのスレッドのもの
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.message = std::move(message);
+                slot.sequence.store(position + 1, std::memory_order_release); // 書き込み済みにする
+                return true;
+            }
+            // CAS に失敗したときは position が最新の値に更新されているので、そのままやり直す
+        }
+        else if (difference < 0) {
+            return false; // 一周前の記録がまだ読み出されていない (いっぱい)
+        }
+        else {
+            position = enqueuePosition.load(std::memory_order_relaxed); // 他のスレッドに先を越された
+        }
+    }
+}
+
+// 書き込みスレッドが次に読み出すスロットに、書き込み済みの記録があれば true
+bool Logger::HasPendingRecord() const
+{
+    const Slot& slot = slots[dequeuePosition & capacityMask];
+    return slot.sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+}
+
+// 書き込みスレッドの処理本体
+void Logger::WriterLoop()
+{
+    std::string batch;        // まとめて書き出す記録 (改行区切り)
+    batch.reserve(WRITE_BATCH_BYTES * 2);
+    uint64_t reportedDrops = 0; // ログに書いた「捨てた記録の数」
+
+    for (;;) {
+        // 書き込み済みの記録を、目安の量まで batch に集める
+        while (batch.size() < WRITE_BATCH_BYTES && HasPendingRecord()) {
+            Slot& slot = slots[dequeuePosition & capacityMask];
+            batch += slot.message;
+            batch += '\n';
+            slot.message.clear();
+            // 次の周回でこのスロットに書き込めるようにする
+            slot.sequence.store(dequeuePosition + capacityMask + 1, std::memory_order_release);
+            ++dequeuePosition;
+        }
+
+        if (!batch.empty()) {
+            const uint64_t drops = droppedCount.load();
+            if (drops != reportedDrops) {
+                batch += "--- リングバッファがいっぱいのため " + std::to_string(drops - reportedDrops) + " 件のログを捨てました ---\n";
+                reportedDrops = drops;
+            }
+            {
+                std::lock_guard<std::mutex> lock(fileMutex);
+                if (logFile.is_open()) {
+                    logFile.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                    if (!HasPendingRecord()) { logFile.flush(); } // 続きがないときだけフラッシュする
+                }
+            }
+            batch.clear();
+            writtenPosition.store(dequeuePosition);
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+            }
+            writtenCondition.notify_all();
+            continue;
+        }
+
+        // 記録がなければ、次の記録か終了の指示が来るまで待つ
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Write のフェンスと対になる
+        wakeCondition.wait(lock, [this]() { return stopRequested || HasPendingRecord(); });
+        writerSleeping.store(false);
+        if (stopRequested && !HasPendingRecord()) { return; }
+    }
+}
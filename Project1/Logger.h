@@ -1,139 +1,275 @@
 #pragma once
-#include <fstream> // t@Co (ofstream) ̂߂ɕKv
-#include <string>  //  (std::string) ̂߂ɕKv
-#include <chrono>  // ݎ擾邽߂ɕKv (Õ^CX^v)
-#include <iomanip> // ̃tH[}bgo (std::put_time) ̂߂ɕKv (݊ɒ)
-#include <sstream> // Xg[ (͒ڂ͎gĂȂAO`ł肦)
+#include <fstream> // ファイル入出力 (ofstream) のために必要
+#include <string>  // 文字列 (std::string) のために必要
+#include <chrono>  // 現在時刻を取得するために必要 (ログのタイムスタンプ等)
+#include <iomanip> // 時刻のフォーマット出力 (std::put_time) のために必要 (ただし互換性に注意)
+#include <sstream> // 文字列ストリーム (LOG_* マクロでのメッセージの組み立て)
+#include <atomic>  // std::atomic (非同期モードのリングバッファ)
+#include <condition_variable> // std::condition_variable (書き込みスレッドの待機)
+#include <cstdint> // uint64_t
+#include <memory>  // std::unique_ptr
+#include <mutex>   // std::mutex (ファイルの保護)
+#include <thread>  // std::thread (書き込みスレッド)
 
 /*
  * Logger.h
- * :
- *   ̃t@ĆAvO̓󋵂fobOt@Cɏo߂
- *   VvȁuK[NXv`܂B
- *   vOsɓ̏t@CɋL^ĂƂŁAォ瓮mFA
- *   肪ꍇ̌ɖ𗧂Ă邱Ƃł܂B
+ * 役割:
+ *   このファイルは、プログラムの動作状況やデバッグ情報をファイルに書き出すための
+ *   シンプルな「ロガークラス」を定義します。
+ *   プログラム実行中に特定の情報をファイルに記録しておくことで、後から動作を確認したり、
+ *   問題が発生した場合の原因調査に役立てることができます。
  *
- * ȋ@\:
- *   - VOgp^[: Logger NX̃CX^XvOŜň
- *     ݂悤ɕۏ؂܂ (`GetInstance()` Ŏ擾)BɂAǂł
- *     Ot@CɏނƂł܂B
- *   - t@C: w肳ꂽt@CŃOt@CJ (`Open`)A
- *     bZ[W (`Write`)AvOIɎIɕ (`Close`) @\񋟂܂B
- *   - O[o֐: `LogDebug` ̂悤ȊȒPȊ֐pӂAǂły
- *     O߂悤ɂ܂B
+ * 主な機能:
+ *   - シングルトンパターン: Logger クラスのインスタンスがプログラム全体で一つだけ
+ *     存在するように保証します (`GetInstance()` で取得)。これにより、どこからでも
+ *     同じログファイルに書き込むことができます。
+ *   - ファイル操作: 指定されたファイル名でログファイルを開き (`Open`)、
+ *     メッセージを書き込み (`Write`)、プログラム終了時に自動的に閉じる (`Close`) 機能を提供します。
+ *   - グローバル関数: `LogDebug` のような簡単な関数を用意し、どこからでも手軽に
+ *     ログを書き込めるようにします。
  *
- * ̃R[h̕ύX_ERg ():
- *   -  Logger NX́ȀR[hɂ͂ȂAfobO@\̋̂߂
- *     ォǉꂽ̂łƍl܂B
- *   - VOgp^[̗pARs[⃀[u֎~邱ƂŁAӐ}Ȃ
- *     ̃K[CX^X̂hł܂B
- *   - `Open` ֐ŁAvONɃOt@CNAi㏑j悤
- *     ݒ肳Ă܂ (`std::ios::trunc`)BǋLꍇ `std::ios::app` ɕύX܂B
- *   - O̊Jn/Ȉݕ́A荂xȃ^CX^v@\ǉۂ
- *     QlƂăRgAEgĂ܂ (`std::put_time` ͊ɂĎgȂ\܂)B
+ * 元のコードからの変更点・コメント (推定):
+ *   - この Logger クラスは、元の初期コードにはなく、デバッグ機能の強化のために
+ *     後から追加されたものであると考えられます。
+ *   - シングルトンパターンを採用し、コピーやムーブを禁止することで、意図しない
+ *     複数のロガーインスタンスが作られるのを防いでいます。
+ *   - `Open` 関数で、プログラム起動時にログファイルをクリア（上書き）するように
+ *     設定されています (`std::ios::trunc`)。もし追記したい場合は `std::ios::app` に変更します。
+ *   - ログの開始/終了時刻の書き込み部分は、より高度なタイムスタンプ機能を追加する際の
+ *     参考としてコメントアウトされています (`std::put_time` は環境によって使えない可能性があります)。
  *
- * g:
- *   1. `#include "Logger.h"` CN[h܂B
- *   2. vȌ (: `WinMain` ̊Jn)  `Logger::GetInstance().Open("t@C.txt");`
- *      ĂяoăOt@CJ܂B
- *   3. O݂ꏊ `LogDebug("bZ[W");` ̂悤ɌĂяo܂B
- *   4. vOIɎIɃt@C܂AIɕꍇ
- *      `Logger::GetInstance().Close();` ĂяoƂł܂B
+ * 非同期モード (StartAsync):
+ *   - 同期モード (既定) では、Write を呼んだスレッドがその場でファイルに書き込み、1 行ごとにフラッシュします。
+ *     毎フレームのログで描画スレッドがファイルの入出力を待つため、フレーム時間が乱れる原因になります。
+ *   - `StartAsync` を呼ぶと、Write は記録を固定長のリングバッファに入れるだけで戻ります。
+ *     バックグラウンドの書き込みスレッドが、溜まった記録をまとめて 1 回の write で書き出し、
+ *     バッファが空になったときだけフラッシュします。
+ *   - リングバッファは複数の書き込み元 (どのスレッドからでも Write できる) と 1 つの読み出し先の
+ *     ロックのないキュー (MPSC) です。各スロットが持つ通し番号 (sequence) で、
+ *     スロットが空いているか、書き込み済みかを判断します。
+ *   - バッファがいっぱいのときの動作は `LogOverflowPolicy` で選びます。
+ *       Drop : 記録を捨てて、すぐに戻る (捨てた数は GetDroppedCount で取得でき、ログにも書かれる)
+ *       Block: 書き込みスレッドが空きを作るまで待つ (記録は失われないが、呼び出し元が止まることがある)
+ *   - 同期モードでも非同期モードでも、Write はどのスレッドから呼んでも安全です。
+ *
+ * 使い方:
+ *   1. `#include "Logger.h"` をインクルードします。
+ *   2. プログラムの初期化部分 (例: `WinMain` の開始直後) で `Logger::GetInstance().Open("ファイル名.txt");`
+ *      を呼び出してログファイルを開きます。
+ *      続けて `Logger::GetInstance().StartAsync();` を呼ぶと非同期モードになります。
+ *   3. ログを書き込みたい場所で `LogDebug("メッセージ");` のように呼び出します。
+ *   4. プログラム終了時に自動的にファイルが閉じられますが、明示的に閉じたい場合は
+ *      `Logger::GetInstance().Close();` を呼び出すこともできます。
+ *
+ * ログレベル (LOG_TRACE / LOG_DEBUG / LOG_INFO / LOG_WARN / LOG_ERROR):
+ *   - `LOG_TRACE("[QuatFAA] Angle(" << angle << ")");` のように、ストリームへの出力の形で書きます。
+ *     メッセージは、そのレベルが有効だと分かってから組み立てられます。無効なレベルでは
+ *     引数の式 (文字列の連結や数値の書式化) は一切実行されません。
+ *   - コンパイル時の最低レベル `LOGGER_MIN_LEVEL` より低いレベルのマクロは、何もしない文になり
+ *     コードから完全に消えます。既定はデバッグビルド (_DEBUG) で TRACE、それ以外で INFO です。
+ *     プロジェクトのプリプロセッサ定義で `LOGGER_MIN_LEVEL=LOGGER_LEVEL_OFF` のように変更できます。
+ *   - 実行時の最低レベルは `Logger::GetInstance().SetLevel(LogLevel::Trace)` で変えられます (既定は Debug)。
+ *     ログファイルが開かれていないときは、どのレベルも無効になります。
+ *   - 数値は小数点以下 4 桁の固定小数点で書式化されます。
+ *   - `LogDebug(文字列)` は Debug レベルの書き込みと同じです (文字列は呼び出し前に作られてしまうため、
+ *     毎フレーム呼ぶ場所では LOG_DEBUG を使ってください)。
  */
 
+// ログレベルの値 (プリプロセッサの #if で比べられるように、整数のマクロとしても定義する)
+#define LOGGER_LEVEL_TRACE 0
+#define LOGGER_LEVEL_DEBUG 1
+#define LOGGER_LEVEL_INFO  2
+#define LOGGER_LEVEL_WARN  3
+#define LOGGER_LEVEL_ERROR 4
+#define LOGGER_LEVEL_OFF   5
+
+// コンパイル時の最低レベル (これより低いレベルのログはコードから取り除かれる)
+#ifndef LOGGER_MIN_LEVEL
+#if defined(_DEBUG)
+#define LOGGER_MIN_LEVEL LOGGER_LEVEL_TRACE
+#else
+#define LOGGER_MIN_LEVEL LOGGER_LEVEL_INFO
+#endif
+#endif
+
+// ログレベル (重要度の低い順)
+enum class LogLevel {
+    Trace = LOGGER_LEVEL_TRACE, // 計算の途中経過など、非常に細かい情報 (毎フレーム何度も呼ばれる場所)
+    Debug = LOGGER_LEVEL_DEBUG, // デバッグ用の情報
+    Info = LOGGER_LEVEL_INFO,   // 起動・終了・読み込みなどの通常の情報
+    Warn = LOGGER_LEVEL_WARN,   // 問題はあるが続行できる状態
+    Error = LOGGER_LEVEL_ERROR, // 失敗
+    Off = LOGGER_LEVEL_OFF      // SetLevel に渡すと全てのログを止める
+};
+
+// 非同期モードで、リングバッファがいっぱいのときの動作
+enum class LogOverflowPolicy {
+    Drop,  // 記録を捨てる (呼び出し元を止めない)
+    Block  // 空きができるまで待つ (記録を失わない)
+};
+
 class Logger {
 public:
-    // VOgCX^X擾邽߂̐ÓI\bh
-    // vO Logger::GetInstance() ƌĂяoƂŁA
-    // ɓ Logger IuWFNgւ̎QƂ擾ł܂B
+    // 非同期モードのリングバッファの既定の大きさ (記録の数)
+    static const size_t DEFAULT_ASYNC_CAPACITY;
+
+    // シングルトンインスタンスを取得するための静的メソッド
+    // プログラム中で Logger::GetInstance() と呼び出すことで、
+    // 常に同じ Logger オブジェクトへの参照を取得できます。
     static Logger& GetInstance() {
-        // static [JϐƂăCX^X𐶐邱ƂŁA
-        // ŏɌĂяoꂽƂɈxAȍ~͓CX^XԂB
-        static Logger instance; // VOgCX^X
+        // static ローカル変数としてインスタンスを生成することで、
+        // 最初に呼び出されたときに一度だけ初期化され、以降は同じインスタンスを返す。
+        static Logger instance; // シングルトンインスタンス
         return instance;
     }
 
-    // Ot@CJ\bh
-    // filename: Oރt@C̖O (ftHg "debug_log.txt")
-    // ߂l: t@CĴɐ trueAs false
-    bool Open(const std::string& filename = "debug_log.txt") {
-        // Ƀt@CJĂAx
-        if (logFile.is_open()) {
-            logFile.close();
-        }
-        // t@Co̓[h(std::ios::out)ŊJB
-        // std::ios::trunc w肷ƁAt@Cɑ݂ꍇAgɂĂJi㏑jB
-        // ǋLꍇ std::ios::app Ɏw肷B
-        logFile.open(filename, std::ios::out | std::ios::trunc);
-        if (!logFile.is_open()) { // t@CJȂꍇ
-            // DxLibς݂ȂAʂɃG[bZ[W\邱Ƃ\
-            // printfDx("G[: Ot@C '%s' J܂łB\n", filename.c_str());
-            return false; // sƂĂяoɓ`
-        }
-        // t@CJƂɁAJnȂǂL^iCӁj
-        // auto now = std::chrono::system_clock::now();
-        // auto now_c = std::chrono::system_clock::to_time_t(now);
-        // std::put_time  C++11 Wł͂Ȃ߁AɂĂ͎gȂB
-        // ֈ: #include <ctime>  localtime_s  strftime gB
-        // logFile << "--- Log Start: " << std::put_time(std::localtime(&now_c), "%Y-%m-%d %H:%M:%S") << " ---\n";
-        logFile << "--- Log Start ---" << std::endl; // ȒPȊJn}[J[
-
-        return true; // Ƃ`
-    }
+    // ログファイルを開くメソッド
+    // filename: ログを書き込むファイルの名前 (デフォルトは "debug_log.txt")
+    // 戻り値: ファイルを開くのに成功したら true、失敗したら false
+    bool Open(const std::string& filename = "debug_log.txt");
 
-    // Ot@CɃbZ[Wރ\bh
-    // message: ݂
-    void Write(const std::string& message) {
-        // t@CɊJĂꍇ̂ݏ
-        if (logFile.is_open()) {
-            logFile << message << std::endl; // bZ[Wt@Cɏ݁AŌɉsǉ
-        }
-    }
+    // 非同期モードを開始する (書き込みスレッドを起動する)。既に非同期モードなら何もしない。
+    // capacity: リングバッファに入る記録の数 (2 のべき乗に切り上げる)
+    // policy: リングバッファがいっぱいのときの動作
+    // 戻り値: 書き込みスレッドを起動できたら true
+    bool StartAsync(size_t capacity = DEFAULT_ASYNC_CAPACITY, LogOverflowPolicy policy = LogOverflowPolicy::Drop);
+    // 非同期モードを終了する (リングバッファに残った記録を全て書き出してから、書き込みスレッドを止める)
+    void StopAsync();
+    // 非同期モードなら true
+    bool IsAsync() const { return asyncEnabled.load(); }
+    // リングバッファがいっぱいのときの動作を変える (非同期モードの途中でも変えられる)
+    void SetOverflowPolicy(LogOverflowPolicy policy) { overflowPolicy.store(static_cast<int>(policy)); }
+    // 非同期モードで、リングバッファがいっぱいだったために捨てた記録の数 (累計)
+    uint64_t GetDroppedCount() const { return droppedCount.load(); }
+    // これまでに Write した記録がファイルに書き込まれるまで待つ
+    void Flush();
 
-    // Ot@C郁\bh
-    // ʏ̓fXgN^ŎIɌĂ΂̂ŁAIɌĂԕKv͏ȂB
-    void Close() {
-        if (logFile.is_open()) { // t@CJĂꍇ
-            logFile << "--- Log End ---" << std::endl; // I}[J[
-            logFile.close(); // t@C
-        }
+    // 実行時の最低レベルを設定する (これより低いレベルのログは書き込まれない)
+    void SetLevel(LogLevel level) { minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel GetLevel() const { return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed)); }
+    // level のログを書き込むなら true (ログファイルが開かれていなければ false)
+    // LOG_* マクロは、メッセージを組み立てる前にこれを確かめる
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed)
+            && fileOpen.load(std::memory_order_relaxed);
     }
 
-    // fXgN^: LoggerIuWFNgjƂɎIɌĂяo
-    // Ńt@Cmɕ邱ƂŁAݓêhB
+    // ログファイルにメッセージを書き込むメソッド
+    // message: 書き込みたい文字列 (非同期モードでは、リングバッファに移して書き込みスレッドに任せる)
+    void Write(std::string message);
+
+    // ログファイルを閉じるメソッド (非同期モードなら、残った記録を書き出してから終了する)
+    // 通常はデストラクタで自動的に呼ばれるので、明示的に呼ぶ必要は少ない。
+    void Close();
+
+    // デストラクタ: Loggerオブジェクトが破棄されるときに自動的に呼び出される
+    // ここでファイルを確実に閉じることで、書き込み内容が失われるのを防ぐ。
     ~Logger() {
-        Close(); // t@C鏈Ă
+        Close(); // ファイルを閉じる処理を呼ぶ
     }
 
-private: // NX̂݃ANZX\ȃo
-    // t@Co̓Xg[IuWFNgBۂ̃t@C݂sB
+private: // クラス内部からのみアクセス可能なメンバ
+    // リングバッファの 1 つのスロット
+    struct Slot {
+        // 通し番号: 位置 pos に書き込める状態なら pos、書き込み済み (読み出せる状態) なら pos + 1
+        std::atomic<size_t> sequence;
+        std::string message; // 記録の本文
+    };
+
+    // リングバッファに記録を入れる (いっぱいなら false を返し、message はそのまま残る)
+    bool TryEnqueue(std::string& message);
+    // 書き込みスレッドが次に読み出すスロットに、書き込み済みの記録があれば true
+    bool HasPendingRecord() const;
+    // 書き込みスレッドの処理本体
+    void WriterLoop();
+
+    // ファイル出力ストリームオブジェクト。実際のファイル書き込みを行う。
     std::ofstream logFile;
+    // logFile を保護する (同期モードの Write、書き込みスレッドの書き出し、Open / Close)
+    std::mutex fileMutex;
+    std::atomic<bool> fileOpen{ false };        // logFile が開いていれば true (IsEnabled が fileMutex なしで見る)
+    std::atomic<int> minimumLevel{ static_cast<int>(LogLevel::Debug) }; // 実行時の最低レベル (LogLevel)
+
+    // --- 非同期モード ---
+    std::unique_ptr<Slot[]> slots;              // リングバッファ
+    size_t capacityMask = 0;                    // リングバッファの大きさ - 1 (大きさは 2 のべき乗)
+    std::atomic<size_t> enqueuePosition{ 0 };   // 次に書き込む位置 (書き込み元のスレッドが CAS で取り合う)
+    size_t dequeuePosition = 0;                 // 次に読み出す位置 (書き込みスレッドだけが使う)
+    std::atomic<size_t> writtenPosition{ 0 };   // ファイルへの書き込みとフラッシュが済んだ位置
+    std::atomic<bool> asyncEnabled{ false };    // 非同期モードなら true (Write がリングバッファを使う)
+    std::atomic<int> activeProducers{ 0 };      // リングバッファに書き込み中の Write の数 (StopAsync で待つ)
+    std::atomic<int> overflowPolicy{ static_cast<int>(LogOverflowPolicy::Drop) }; // LogOverflowPolicy
+    std::atomic<uint64_t> droppedCount{ 0 };    // 捨てた記録の数 (累計)
+    std::atomic<bool> writerSleeping{ false };  // 書き込みスレッドが待機中なら true
+    bool stopRequested = false;                 // 書き込みスレッドの終了の指示 (wakeMutex で保護)
+    std::thread writerThread;                   // 書き込みスレッド
+    std::mutex wakeMutex;                       // 以下の条件変数と stopRequested を保護する
+    std::condition_variable wakeCondition;      // 書き込みスレッドを起こす
+    std::condition_variable writtenCondition;   // 書き込みが進んだことを Flush に知らせる
 
-    // vCx[gRXgN^: VOgp^[邽߁AO璼
-    // Logger IuWFNg쐬łȂ悤ɂBGetInstance() ʂĂ̂ݎ擾\B
-    Logger() = default; // ftHgRXgN^Lɂ
+    // プライベートコンストラクタ: シングルトンパターンを実現するため、外部から直接
+    // Logger オブジェクトを作成できないようにする。GetInstance() を通してのみ取得可能。
+    Logger() = default; // デフォルトコンストラクタを有効にする
 
-    // Rs[RXgN^ƃRs[Zq֎~ (deletew)
-    // ɂALogger IuWFNgăRs[̂hA
-    // VOgiB̃CX^Xjł邱Ƃۏ؂B
+    // コピーコンストラクタとコピー代入演算子を禁止 (delete指定)
+    // これにより、Logger オブジェクトが誤ってコピーされるのを防ぎ、
+    // シングルトン（唯一のインスタンス）であることを保証する。
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    // [uRXgN^ƃ[uZq֎~ (deletew)
-    // lɁAӐ}ȂL̈ړhB
+    // ムーブコンストラクタとムーブ代入演算子も禁止 (delete指定)
+    // 同様に、意図しない所有権の移動を防ぐ。
     Logger(Logger&&) = delete;
     Logger& operator=(Logger&&) = delete;
 };
 
-// O[oȃO֐ (ȈՃANZXp)
-// gƂŁALogger::GetInstance().Write(...) Ə
-// LogDebug(...) ƊȌɏB
-inline void LogDebug(const std::string& message) {
-    // VOgCX^X擾AWrite\bhĂяo
-    Logger::GetInstance().Write(message);
+// グローバルなログ関数 (簡易アクセス用)
+// これを使うことで、Logger::GetInstance().Write(...) と書く代わりに
+// LogDebug(...) と簡潔に書ける。
+// message は値で受け取り、そのまま Logger に移す (一時的な文字列をコピーしないため)。
+inline void LogDebug(std::string message) {
+    // シングルトンインスタンスを取得し、Debug レベルが有効ならWriteメソッドを呼び出す
+    Logger& logger = Logger::GetInstance();
+    if (logger.IsEnabled(LogLevel::Debug)) {
+        logger.Write(std::move(message));
+    }
 }
 
-// KvɉāÃOxp̃O[o֐`ł
-// inline void LogInfo(const std::string& message) { /* ... */ }
-// inline void LogWarning(const std::string& message) { /* ... */ }
-// inline void LogError(const std::string& message) { /* ... */ }
\ No newline at end of file
+// レベルが有効なときだけ、stream_expr (ストリームへの出力の並び) からメッセージを組み立てて書き込む
+// 例: LOGGER_WRITE(LogLevel::Trace, "x=" << x << " y=" << y);
+#define LOGGER_WRITE(level, stream_expr) \
+    do { \
+        Logger& loggerInstance_ = Logger::GetInstance(); \
+        if (loggerInstance_.IsEnabled(level)) { \
+            std::ostringstream loggerStream_; \
+            loggerStream_ << std::fixed << std::setprecision(4) << stream_expr; \
+            loggerInstance_.Write(loggerStream_.str()); \
+        } \
+    } while (0)
+
+// レベルごとのログマクロ (LOGGER_MIN_LEVEL より低いものは何もしない文になる)
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_TRACE
+#define LOG_TRACE(stream_expr) LOGGER_WRITE(LogLevel::Trace, stream_expr)
+#else
+#define LOG_TRACE(stream_expr) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_DEBUG
+#define LOG_DEBUG(stream_expr) LOGGER_WRITE(LogLevel::Debug, stream_expr)
+#else
+#define LOG_DEBUG(stream_expr) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_INFO
+#define LOG_INFO(stream_expr) LOGGER_WRITE(LogLevel::Info, stream_expr)
+#else
+#define LOG_INFO(stream_expr) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_WARN
+#define LOG_WARN(stream_expr) LOGGER_WRITE(LogLevel::Warn, stream_expr)
+#else
+#define LOG_WARN(stream_expr) ((void)0)
+#endif
+#if LOGGER_MIN_LEVEL <= LOGGER_LEVEL_ERROR
+#define LOG_ERROR(stream_expr) LOGGER_WRITE(LogLevel::Error, stream_expr)
+#else
+#define LOG_ERROR(stream_expr) ((void)0)
+#endif
@@ -1,209 +1,438 @@
-// !! NOMINMAX ̓t@C̐擪 !!
+// !! NOMINMAX はファイルの先頭 !!
 #define NOMINMAX
-#include "Common.h"     // ʒ萔
-#include "DxLib.h"      // DxLib Cu
-#include "Camera.h"     // Camera NX
-#include "TopAngle.h"   // TopAngle NX
-#include "Vector.h"     // Vector3D \
+#include "Common.h"     // 共通定数
+#include "DxLib.h"      // DxLib ライブラリ
+#include "Camera.h"     // Camera クラス
+#include "TopAngle.h"   // TopAngle クラス
+#include "Vector.h"     // Vector3D 構造体
+#include "SegmentBuffer.h" // SegmentBuffer クラス (線分データの格納)
+#include "DxLibRenderSink.h" // DxLibRenderSink クラス (DxLib への描画先)
+#include "SegmentBVH.h" // SegmentBVH クラス (視錐台カリング用の BVH)
+#include "SegmentGrid2D.h" // SegmentGrid2D クラス (トップダウンビュー用の 2D 空間インデックス)
+#include "WireSphere.h" // WireSphere クラス (LOD 付きの球)
+#include "GroundGrid.h" // GroundGrid クラス (視錐台で切り取る無限の地面グリッド)
+#include "WireMesh.h"   // WireMesh クラス (インデックス付きのワイヤーフレーム)
+#include "SceneGraph.h" // SceneGraph クラス (ノードごとの変換行列を持つ物体)
+#include "SceneFile.h"  // シーンファイル (.wfscene) の読み書き
+#include "MeshImporter.h" // OBJ / PLY の取り込み
+#include "ThreadPool.h" // ThreadPool (書き出しツールでの並列な取り込み)
+#include "FrameTelemetry.h" // FrameTelemetryWriter (毎フレームの記録)
+#include "Profiler.h"   // Profiler (段階ごとの処理時間)
+#include "CameraSimulation.h" // CameraSimulation (カメラの更新を別スレッドで固定のタイムステップで行う)
+#include <algorithm>    // std::max, std::min
+#include <thread>       // std::thread::hardware_concurrency
 #include <vector>       // std::vector
 #include <string>       // std::string
-#include "Logger.h"     // Logger NX (Oo͗p)
-#include <cmath>        // sinf, cosf (<math.h> 萄)
+#include <sstream>      // std::istringstream (起動時の引数の解析)
+#include <iomanip>      // std::quoted (引用符で囲んだ引数)
+#include "Logger.h"     // Logger クラス (ログ出力用)
+#include <cmath>        // sinf, cosf (<math.h> より推奨)
+#include <chrono>       // std::chrono::steady_clock (フレーム時間の計測)
+#include <fstream>      // std::ofstream (フレームの記録の変換結果)
 
 /*
  * Main.cpp
- * :
- *   ̃t@C̓vOŜ̊Jn_ƂȂ WinMain֐ ܂ł܂B
- *   AvP[V̋NI܂ł̗Ǘ܂B
- *   ȏe͈ȉ̒ʂłB
- *   - DxLibCȕƃEBhEݒ
- *   - Oo͋@\(Logger)̏
- *   - 3DԂɕ\IuWFNgíAnʃObhÁj̐f[^쐬
- *   - J(`Camera`)ƃgbv_Er[(`TopAngle`)̃IuWFNg
- *   - C[vFvOI܂ŌJԂs镔
- *     - ͏ (DxLibProcessMessage)
- *     - JƃIuWFNg̏ԍXV (camera->Update)
- *     - Oo (LogDebug)
- *     - ʂւ̕` (camera->Draw, topangle->Draw, fobO\)
- *     - ʂ̍XV (ScreenFlip)
- *   - vOǏЕt (IuWFNg̉ADxLibI)
+ * 役割:
+ *   このファイルはプログラム全体の開始点となる WinMain関数 を含んでいます。
+ *   アプリケーションの起動から終了までの流れを管理します。
+ *   主な処理内容は以下の通りです。
+ *   - DxLibライブラリの初期化とウィンドウ設定
+ *   - ログ出力機能(Logger)の準備
+ *   - 3D空間に表示するオブジェクト（立方体、地面グリッド、球体）の線データ作成
+ *   - カメラ(`Camera`)とトップダウンビュー(`TopAngle`)のオブジェクト生成
+ *   - メインループ：プログラムが終了するまで繰り返し実行される部分
+ *     - 入力処理 (DxLibのProcessMessage)
+ *     - カメラの状態更新 (CameraSimulation のスレッドが更新した最新の状態を camera に設定する)
+ *     - ログ出力 (LOG_INFO / LOG_WARN など) と、毎フレームの記録 (FrameTelemetryWriter)
+ *     - 画面への描画 (camera->Draw, topangle->Draw, デバッグ表示。すべて DxLibRenderSink 経由)
+ *     - 画面の更新 (ScreenFlip)
+ *   - プログラム終了時の後片付け (オブジェクトの解放、DxLib終了処理)
  *
- * ̃o[Wł̎ȕύX_Eǉ_ ( Main.cpp ̕ύX_):
- * 1. Oo͋@\̗p (LoggerNX):
- *    - vO̓󋵂t@C("debug_log.txt")ɋL^ Logger NX𗘗p܂B
- *    - vO̊JnEIbZ[WAt[̃J̏ڍׂȏԂȂǂL^邱ƂŁA
- *      mF蔭̌ɖ𗧂܂B
+ * このバージョンでの主な変更点・追加点 (元の Main.cpp からの変更点):
+ * 1. ログ出力機能の利用 (Loggerクラス):
+ *    - プログラムの動作状況をファイル("debug_log.txt")に記録する Logger クラスを利用します。
+ *    - プログラムの開始・終了メッセージなどを記録することで (毎フレームのカメラの詳細な状態は 6. の記録に書きます)、
+ *      動作確認や問題発生時の原因究明に役立ちます。
  *
- * 2. `悷3DIuWFNg̒ǉEύX:
- *    - nʃObh: \͈͂LAYW𒲐đ̃IuWFNgƂ̈ʒu֌W𕪂₷܂B
- *    - ̃IuWFNg: VɃC[t[̋̂ǉ܂BɂAJ猩Ƃ
- *                    Ȗʂ̕\A蕡GȃV[ł̓mFł܂B
+ * 2. 描画する3Dオブジェクトの追加・変更:
+ *    - 地面グリッド: 表示範囲を広げ、Y座標を調整して他のオブジェクトとの位置関係を分かりやすくしました。
+ *                    現在は `GroundGrid` (GroundGrid.h) で、毎フレーム視錐台に入る部分の線だけを作ります
+ *                    (範囲の制限はなく、遠くなるほど線の間隔が広がります)。
+ *                    トップダウンビューには、視錐台ではなくビューの表示範囲で切り取った線を別に作って渡します。
+ *    - 球体オブジェクト: 新たにワイヤーフレームの球体を追加しました。これにより、カメラから見たときの
+ *                    曲面の表示や、より複雑なシーンでの動作を確認できます。
+ *                    球は `WireSphere` (WireSphere.h) で表し、毎フレーム画面上の大きさに合った
+ *                    分割数 (LOD) の線分を作ります。
  *
- * 3. gbv_Er[\̗L (TopAngleNX):
- *    - `TopAngle` NX̃IuWFNg𐶐At[`悷悤ɂ܂B
- *    - ɂAʍɃ[hォ猩2D}bv\A
- *      CJ̈ʒuAIuWFNg̔zuqϓIɔcł܂B
+ * 3. トップダウンビュー表示の有効化 (TopAngleクラス):
+ *    - `TopAngle` クラスのオブジェクトを生成し、毎フレーム描画するようにしました。
+ *    - これにより、画面左上にワールドを上から見た2Dマップが表示され、
+ *      メインカメラの位置や向き、オブジェクトの配置を客観的に把握できます。
  *
- * 4. fobOp\̋:
- *    - ʒɏ\}[N\AJ̒Si_j𕪂₷܂B
- *    - ʍɃJ̊{IȏiWA͏ԂȂǁjA^Cŕ\悤ɂ܂B
- *      ɂA삪fĂ邩ȂǂfmFł܂B
+ * 4. デバッグ用表示の強化:
+ *    - 画面中央に十字マークを表示し、カメラの中心（注視点）を分かりやすくしました。
+ *    - 画面左下にカメラの基本的な情報（座標、入力状態など）をリアルタイムで表示するようにしました。
+ *      これにより、操作が正しく反映されているかなどを素早く確認できます。
  *
- * ̕ύX́AɃJ@\̊JeXgAfobOs₷邱ƂړIƂĂ܂B
+ * 5. シーンファイルの読み書き (SceneFile.h):
+ *    - 起動時の引数でシーンファイル (.wfscene) を指定すると、組み込みの立方体の代わりにその線分を表示します。
+ *      ファイルはメモリにマップしてそのまま使うため、巨大なモデルでも起動時の読み込みはほぼ一瞬です。
+ *        Project1.exe --scene site.wfscene        … シーンファイルを読み込んで表示
+ *        Project1.exe --write-scene out.wfscene   … 組み込みのシーンを BVH ごと書き出して終了 (書き出しツール)
+ *    - OBJ / PLY のモデルを取り込んで、組み込みの立方体の代わりに表示することもできます (MeshImporter.h)。
+ *      取り込みは全てのコアで並列に行い、2 つの面が共有する辺は 1 本にまとめます。
+ *        Project1.exe --import site.obj                                  … モデルを取り込んで表示
+ *        Project1.exe --import site.ply --write-scene site.wfscene       … モデルをシーンファイルに変換して終了
  *
- * ӓ_:
- * - ̃vOsɂ́A`Camera`, `TopAngle`, `Logger`, `Vector`, `Matrix`, `Quaternion`,
- *   `CameraMath`, `Common` ƂA֘ASẴNXwb_[t@C
- *   AvWFNgɊ܂܂ĂKv܂B
+ * 6. フレームの記録 (FrameTelemetry.h):
+ *    - --telemetry でファイルを指定したときだけ、毎フレームのカメラの詳細な状態とフレーム時間
+ *      (Update / 描画 / ScreenFlip) を、文字列にせずに固定長のバイナリの記録としてそのファイルに追記します
+ *      (以前はログに文字列で書いていました)。指定しなければ記録しません。
+ *        Project1.exe --telemetry soak.wftrace                           … soak.wftrace に記録する
+ *        Project1.exe --decode-telemetry soak.wftrace soak.csv           … 記録を CSV に変換して終了 (.json なら JSON)
+ *    - 処理の段階ごと (Update / Draw とその中の変換・クリッピング・描画 / TopAngle / ScreenFlip) の時間を
+ *      Profiler.h で測り、終了時に p50 / p99 / 最大値をログに書きます。
+ *        Project1.exe --profile-trace trace.json                         … 直近の記録を Chrome のトレース形式でも書き出す
+ *
+ * 7. カメラの更新と描画の分離 (CameraSimulation.h):
+ *    - カメラの更新 (移動・回転) は別のスレッドで 1 秒に 120 回 (固定のタイムステップ) 行い、
+ *      メインループは毎フレーム入力を読み取って渡し、最新のカメラの状態を受け取って描画するだけにしました
+ *      (DxLib の入力関数はメインループのスレッドだけで呼びます)。
+ *      カメラの更新と描画が並行して進み、描画が遅いフレームがあってもカメラの速さは変わりません。
+ *    - カメラが止まっている間は、球と地面の線分を作り直さず、camera->Draw も前のフレームの
+ *      描画コマンドを描くだけになります (Camera.h の「描画結果の使い回し」)。
+ *        Project1.exe --sim-rate 240                                     … 1 秒あたりのステップ数を変える
+ *        Project1.exe --sim-rate 0                                       … 以前のように毎フレーム Update する
+ *                                                                          (フレーム時間を経過時間として渡す)
+ *
+ * 8. シーングラフ (SceneGraph.h):
+ *    - 組み込みの立方体は、ワールド座標の線分に焼き込まず、原点を中心とする形状をシーングラフのノードで
+ *      (0, 0, 50) に置くようにしました。camera->Draw と topangle->Draw はシーングラフを境界球でカリングし、
+ *      ノードの変換行列で形状を配置して描画します。物体を動かすときはノードの変換行列を変えるだけです。
+ *    - シーンファイルや取り込んだモデルは、これまでどおりワールド座標の線分 (BVH) として表示します。
+ *      シーンファイルへの書き出しでは、シーングラフの物体もワールド座標の線分に展開して書き出します。
+ *    - 球と地面は、カメラに合わせて毎フレーム線分を作り直すので、シーングラフには入れていません。
+ *
+ * これらの変更は、主にカメラ機能の開発やテスト、デバッグを行いやすくすることを目的としています。
+ *
+ * 注意点:
+ * - このプログラムを実行するには、`Camera`, `TopAngle`, `Logger`, `Vector`, `Matrix`, `Quaternion`,
+ *   `CameraMath`, `Common` といった、関連する全てのクラスやヘッダーファイルが
+ *   正しく実装され、プロジェクトに含まれている必要があります。
  */
 
- // C[t[̗̂̒_f[^𐶐wp[֐
-std::vector<std::vector<Vector3D>> CreateCubeLines(float size, const Vector3D& center) {
-    std::vector<std::vector<Vector3D>> lines;
-    float halfSize = size * 0.5f;
-    Vector3D vertices[8] = {
-        center + Vector3D{-halfSize, -halfSize, -halfSize}, center + Vector3D{ halfSize, -halfSize, -halfSize},
-        center + Vector3D{ halfSize,  halfSize, -halfSize}, center + Vector3D{-halfSize,  halfSize, -halfSize},
-        center + Vector3D{-halfSize, -halfSize,  halfSize}, center + Vector3D{ halfSize, -halfSize,  halfSize},
-        center + Vector3D{ halfSize,  halfSize,  halfSize}, center + Vector3D{-halfSize,  halfSize,  halfSize}
-    };
-    int edges[12][2] = {
-        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4},
-        {0, 4}, {1, 5}, {2, 6}, {3, 7}
-    };
-    for (const auto& edge : edges) {
-        lines.push_back({ vertices[edge[0]], vertices[edge[1]] });
+// シーンファイルを指定しなかったときに表示する物体を作る。
+// importPath が空でなければそのモデル (OBJ / PLY) を取り込んで worldLine に追加し、
+// 空なら (または取り込みに失敗したら) 組み込みの立方体を objects のノードとして追加する。
+// 取り込みに失敗したら false を返し、error に理由を書き込む。
+bool CreateDefaultScene(SegmentBuffer& worldLine, SceneGraph& objects, const std::string& importPath, ThreadPool* pool, std::string* error) {
+    // 静的な線分は BVH と 2D グリッドで線分単位に扱うため、メッシュを線分に展開して追加する
+    if (!importPath.empty()) {
+        WireMesh importedMesh;
+        if (ImportWireMesh(importPath, importedMesh, pool, error)) {
+            importedMesh.AppendSegments(worldLine);
+            return true;
+        }
     }
-    return lines;
+    // --- 立方体の作成 ---
+    // 形状は原点を中心に作り、ノードの変換行列で (0, 0, 50) に置く
+    const uint32_t cubeGeometry = objects.AddGeometry(CreateCubeMesh(50.0f, { 0.0f, 0.0f, 0.0f })); // サイズ50
+    objects.AddNode(SceneGraph::NO_NODE, GetMatrixTranslation(0.0f, 0.0f, 50.0f), cubeGeometry);   // 中心(0,0,50)
+    return importPath.empty();
 }
 
-// ̂̃C[t[f[^𐶐wp[֐
-std::vector<std::vector<Vector3D>> CreateSphereLines(const Vector3D& center, float radius, int latDivs, int lonDivs) {
-    std::vector<std::vector<Vector3D>> lines;
-    // ܐ
-    for (int i = 1; i < latDivs; ++i) {
-        float phi = PI * ((float)i / latDivs - 0.5f);
-        float y = center.y + radius * sinf(phi);
-        float r = radius * cosf(phi);
-        Vector3D prevPoint;
-        for (int j = 0; j <= lonDivs; ++j) {
-            float theta = 2.0f * PI * (float)j / lonDivs;
-            float x = center.x + r * cosf(theta);
-            float z = center.z + r * sinf(theta);
-            Vector3D currentPoint = { x, y, z };
-            if (j > 0) { lines.push_back({ prevPoint, currentPoint }); }
-            prevPoint = currentPoint;
-        }
+// 起動時の引数を解析する (パスに空白を含む場合は "..." で囲む)
+//   --scene <ファイル>       : 表示するシーンファイル
+//   --import <ファイル>      : 組み込みの立方体の代わりに取り込むモデル (.obj / .ply)
+//   --write-scene <ファイル> : 組み込みのシーン (または取り込んだモデル) を書き出すファイル
+//   --telemetry <ファイル>   : 毎フレームの記録を書き込むファイル (省略時は記録しない)
+//   --decode-telemetry <記録ファイル> <出力ファイル> : 記録を CSV (出力ファイルが .json なら JSON) に変換する
+//   --profile-trace <ファイル> : 終了時に、段階ごとの処理時間の記録を Chrome のトレースイベント形式で書き出す
+//   --fov <度>               : カメラの垂直方向の視野角 (省略時は 60 度)
+//   --clip <near> <far>      : カメラのニア / ファークリップ面までの距離 (省略時は 0.1, 1000)
+//   --sim-rate <回数>        : カメラの更新の 1 秒あたりのステップ数 (省略時は 120。0 なら描画と同じスレッドで毎フレーム更新)
+struct CommandLineOptions {
+    std::string scenePath, importPath, writeScenePath;
+    std::string telemetryPath;       // 空なら毎フレームの記録はしない
+    std::string decodeTelemetryPath, decodeOutputPath;
+    std::string profileTracePath;
+    float fovDegrees = 0.0f;         // 0 なら Camera の既定のまま
+    float nearZ = 0.0f, farZ = 0.0f; // farZ が 0 なら Camera の既定のまま
+    int simulationRate = static_cast<int>(CameraSimulation::DEFAULT_STEPS_PER_SECOND);
+};
+void ParseCommandLine(const char* commandLine, CommandLineOptions& options) {
+    std::istringstream args(commandLine != nullptr ? commandLine : "");
+    std::string arg;
+    while (args >> std::quoted(arg)) {
+        if (arg == "--scene") { args >> std::quoted(options.scenePath); }
+        else if (arg == "--import") { args >> std::quoted(options.importPath); }
+        else if (arg == "--write-scene") { args >> std::quoted(options.writeScenePath); }
+        else if (arg == "--telemetry") { args >> std::quoted(options.telemetryPath); }
+        else if (arg == "--decode-telemetry") { args >> std::quoted(options.decodeTelemetryPath) >> std::quoted(options.decodeOutputPath); }
+        else if (arg == "--profile-trace") { args >> std::quoted(options.profileTracePath); }
+        else if (arg == "--fov") { args >> options.fovDegrees; }
+        else if (arg == "--clip") { args >> options.nearZ >> options.farZ; }
+        else if (arg == "--sim-rate") { args >> options.simulationRate; }
     }
-    // o
-    for (int j = 0; j < lonDivs; ++j) {
-        float theta = 2.0f * PI * (float)j / lonDivs;
-        Vector3D prevPoint;
-        for (int i = 0; i <= latDivs; ++i) {
-            float phi = PI * ((float)i / latDivs - 0.5f);
-            float x = center.x + radius * cosf(phi) * cosf(theta);
-            float y = center.y + radius * sinf(phi);
-            float z = center.z + radius * cosf(phi) * sinf(theta);
-            Vector3D currentPoint = { x, y, z };
-            if (i > 0) { lines.push_back({ prevPoint, currentPoint }); }
-            prevPoint = currentPoint;
-        }
-    }
-    return lines;
 }
 
-
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
-    // --- DxLib tF[Y ---
-    ChangeWindowMode(TRUE); // EBhE[h
-    SetWindowSizeChangeEnableFlag(FALSE); // TCYύXs
-    SetGraphMode(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT), 32); // ʃ[hݒ
-    if (DxLib_Init() < 0) { // DxLib
-        MessageBox(NULL, TEXT("DxLib ̏Ɏs܂B"), TEXT("G["), MB_OK); // G[\
+    // --- 起動時の引数の解析 ---
+    CommandLineOptions options;
+    ParseCommandLine(lpCmdLine, options);
+    const std::string& scenePath = options.scenePath;
+    const std::string& importPath = options.importPath;
+    const std::string& writeScenePath = options.writeScenePath;
+
+    // --- フレームの記録の変換 (変換ツールとして起動された場合は、ウィンドウを作らずに終了する) ---
+    if (!options.decodeTelemetryPath.empty()) {
+        const std::string& outPath = options.decodeOutputPath;
+        const bool json = outPath.size() >= 5 && outPath.compare(outPath.size() - 5, 5, ".json") == 0;
+        std::ofstream out(outPath);
+        std::string error;
+        if (!out) { error = "変換結果のファイルを開けませんでした: " + outPath; }
+        else if (DecodeFrameTelemetry(options.decodeTelemetryPath, out, json ? FrameTelemetryFormat::Json : FrameTelemetryFormat::Csv, &error)) { return 0; }
+        MessageBox(NULL, error.c_str(), TEXT("エラー"), MB_OK);
+        return -1;
+    }
+
+    // --- シーンファイルの書き出し (書き出しツールとして起動された場合は、ウィンドウを作らずに終了する) ---
+    if (!writeScenePath.empty()) {
+        ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1); // 取り込みと BVH の構築を全てのコアで行う
+        SegmentBuffer defaultScene;
+        SceneGraph defaultObjects;
+        std::string error;
+        if (!CreateDefaultScene(defaultScene, defaultObjects, importPath, &pool, &error)) {
+            MessageBox(NULL, error.c_str(), TEXT("エラー"), MB_OK);
+            return -1;
+        }
+        // シーンファイルは線分だけを持つので、シーングラフの物体はワールド座標の線分に展開して書き出す
+        defaultObjects.AppendSegments(defaultScene);
+        SegmentBVH defaultSceneBVH;
+        defaultSceneBVH.Build(defaultScene, &pool);
+        if (!SaveSceneFile(writeScenePath, defaultSceneBVH, &error)) {
+            MessageBox(NULL, error.c_str(), TEXT("エラー"), MB_OK);
+            return -1;
+        }
+        return 0;
+    }
+
+    // --- DxLib 初期化フェーズ ---
+    ChangeWindowMode(TRUE); // ウィンドウモード
+    SetWindowSizeChangeEnableFlag(FALSE); // サイズ変更不可
+    SetGraphMode(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT), 32); // 画面モード設定
+    if (DxLib_Init() < 0) { // DxLib初期化
+        MessageBox(NULL, TEXT("DxLib の初期化に失敗しました。"), TEXT("エラー"), MB_OK); // エラー表示
         return -1;
     }
-    SetMouseDispFlag(FALSE);       // }EXJ[\\
-    SetDrawScreen(DX_SCREEN_BACK); // `𗠉ʂɐݒ
+    SetMouseDispFlag(FALSE);       // マウスカーソル非表示
+    SetDrawScreen(DX_SCREEN_BACK); // 描画先を裏画面に設定
 
-    // --- K[̏ ---
-    if (!Logger::GetInstance().Open("debug_log.txt")) { // Ot@CJ
-        printfDx("x: fobOOt@CJ܂łB\n"); // sx
+    // --- ロガーの初期化 ---
+    if (!Logger::GetInstance().Open("debug_log.txt")) { // ログファイルを開く
+        printfDx("警告: デバッグログファイルを開けませんでした。\n"); // 失敗したら警告
     }
-    LogDebug("AvP[VJn܂B"); // JnOo
+    // 毎フレームのログでファイルの書き込みを待たないように、非同期モードで書き込む
+    // (リングバッファがいっぱいのときは捨てる。描画を止めないことを優先する)
+    Logger::GetInstance().StartAsync(Logger::DEFAULT_ASYNC_CAPACITY, LogOverflowPolicy::Drop);
+    LOG_INFO("アプリケーションを開始しました。"); // 開始ログを出力
 
-    // --- IuWFNgf[^̏ ---
-    std::vector<std::vector<Vector3D>> worldLine; // `悷i[郊Xg
+    // --- オブジェクトデータの準備 ---
+    SegmentBuffer worldLine; // 描画する線分を格納するバッファ
+    SceneGraph sceneObjects; // ノードの変換行列で配置する物体 (組み込みの立方体)
 
-    // --- ̂̕Ӄf[^쐬 ---
-    auto cubeLines = CreateCubeLines(50.0f, { 0.0f, 0.0f, 50.0f }); // TCY50, S(0,0,50)
-    worldLine.insert(worldLine.end(), cubeLines.begin(), cubeLines.end());
+    // --- 地面グリッドの作成 ---
+    // 地面のグリッド線は静的な線分にはせず、毎フレーム視錐台に入る部分だけを計算で作る (GroundGrid.h)。
+    // 範囲の制限がなく、遠くなるほど線の間隔が広がる。
+    GroundGrid ground(-25.0f, 10.0f); // 地面のY座標 -25, 線の間隔 10
 
-    // --- nʃObhf[^쐬 ---
-    {
-        float groundY = -25.0f; // nʂYW
-        float groundExtent = 500.0f;
-        float gridSize = 10.0f;
-        int lineCount = static_cast<int>(groundExtent / gridSize);
-        for (int i = -lineCount; i <= lineCount; ++i) { // Xs
-            worldLine.push_back({ { (float)i * gridSize, groundY, -groundExtent }, { (float)i * gridSize, groundY,  groundExtent } });
+    // --- 球体の作成 ---
+    // 球は決まった分割数の線分にはせず、毎フレーム画面上の大きさに合った LOD の線分を作る (WireSphere.h)
+    std::vector<WireSphere> spheres;
+    spheres.push_back(WireSphere({ 80.0f, 0.0f, 80.0f }, 30.0f)); // 中心(80,0,80), 半径30
+    SegmentBuffer frameLines; // 毎フレーム作り直す線分 (容量はフレームをまたいで使い回す)
+    WireMesh frameMesh;       // 毎フレーム作り直すメッシュ (球。頂点を共有するので線分より変換が少ない)
+    SegmentBuffer topLines;   // トップダウンビュー用の地面の線分 (ビューの表示範囲で切り取る)
+    WireMesh topMesh;         // トップダウンビュー用の球のメッシュ (メインカメラの視錐台では省かない)
+    uint64_t frameGeometryVersion = 0; // frameLines, frameMesh, topLines, topMesh を作ったときのカメラの版番号 (GetViewProjectionVersion)
+
+    // --- カメラとトップダウンビューの生成 ---
+    Camera* camera = new Camera(); // Cameraオブジェクト生成
+    camera->SetDrawThreadCount(0); // 描画処理を CPU の論理コア数で並列化 (線分が少ないうちは自動的に 1 スレッド)
+    if (options.fovDegrees != 0.0f && !camera->SetFovY(options.fovDegrees * ONE_DEGREE)) {
+        LOG_WARN("--fov の値が不正なため、既定の視野角を使います: " << options.fovDegrees);
+    }
+    if (options.farZ != 0.0f && !camera->SetClipPlanes(options.nearZ, options.farZ)) {
+        LOG_WARN("--clip の値が不正なため、既定のクリップ面を使います: " << options.nearZ << ", " << options.farZ);
+    }
+    TopAngle* topangle = new TopAngle(camera); // TopAngleオブジェクト生成
+
+    // --- 静的な線分と、視錐台カリング用の BVH の準備 ---
+    // 線分は動かないので起動時に 1 回だけ作る (線分を動かす場合は毎フレーム sceneBVH.Refit(worldLine) を呼ぶ)
+    SegmentBVH sceneBVH;
+    bool sceneLoaded = false;
+    if (!scenePath.empty()) {
+        // シーンファイル: 線分はマップしたファイルを直接参照し、BVH もファイルのものをそのまま使う
+        std::string error;
+        sceneLoaded = LoadSceneFile(scenePath, worldLine, sceneBVH, camera->GetDrawThreadPool(), &error);
+        if (sceneLoaded) {
+            LOG_INFO("シーンファイルを読み込みました: " << scenePath << " (線分 " << worldLine.Size() << " 本)");
+        }
+        else {
+            LOG_WARN(error);
+            printfDx("警告: シーンファイルを読み込めませんでした。組み込みのシーンを表示します。\n");
+        }
+    }
+    if (!sceneLoaded) {
+        std::string error;
+        if (CreateDefaultScene(worldLine, sceneObjects, importPath, camera->GetDrawThreadPool(), &error)) {
+            if (!importPath.empty()) {
+                LOG_INFO("モデルを取り込みました: " << importPath << " (線分 " << worldLine.Size() << " 本)");
+            }
         }
-        for (int i = -lineCount; i <= lineCount; ++i) { // Zs
-            worldLine.push_back({ { -groundExtent, groundY, (float)i * gridSize }, {  groundExtent, groundY, (float)i * gridSize } });
+        else {
+            LOG_WARN(error);
+            printfDx("警告: モデルを取り込めませんでした。組み込みのシーンを表示します。\n");
         }
+        sceneBVH.Build(worldLine, camera->GetDrawThreadPool()); // 描画用のスレッドプールで並列に構築
     }
 
-    // --- ̂̃C[t[f[^쐬 ---
+    // --- トップダウンビュー用の 2D 空間インデックスの構築 ---
+    // トップダウンビューは XZ 平面しか使わないので、BVH ではなく XZ 平面のグリッドで表示範囲の線分を探す
+    SegmentGrid2D sceneGrid;
+    sceneGrid.Build(worldLine);
+    DxLibRenderSink sink(static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT)); // 描画先 (DxLib の裏画面)
+
+    // --- フレームの記録の準備 ---
+    FrameTelemetryWriter telemetry;
     {
-        auto sphereLines = CreateSphereLines({ 80.0f, 0.0f, 80.0f }, 30.0f, 12, 24); // S(80,0,80), a30
-        worldLine.insert(worldLine.end(), sphereLines.begin(), sphereLines.end());
+        std::string error;
+        if (!options.telemetryPath.empty() && !telemetry.Open(options.telemetryPath, FrameTelemetryWriter::DEFAULT_PREALLOCATED_FRAMES, &error)) {
+            LOG_WARN(error);
+        }
     }
+    typedef std::chrono::steady_clock Clock;
+    // 2 つの時刻の差をマイクロ秒で返す
+    auto elapsedMicros = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+    };
+    const Clock::time_point telemetryStart = Clock::now();
+    Clock::time_point previousFrameStart = telemetryStart;
+    uint64_t frameIndex = 0;
+    Profiler::GetInstance().SetTraceCapture(!options.profileTracePath.empty()); // 書き出すときだけトレースを残す
 
-    // --- Jƃgbv_Er[̐ ---
-    Camera* camera = new Camera(); // CameraIuWFNg
-    TopAngle* topangle = new TopAngle(camera); // TopAngleIuWFNg
+    // --- カメラの更新を行うスレッドの起動 (--sim-rate 0 なら起動せず、メインループで毎フレーム更新する) ---
+    CameraSimulation simulation;
+    if (options.simulationRate > 0) {
+        simulation.Start(*camera, static_cast<unsigned int>(options.simulationRate));
+        LOG_INFO("カメラの更新を 1 秒あたり " << options.simulationRate << " ステップで別スレッドで行います。");
+    }
 
-    // --- C[v ---
-    while (ProcessMessage() == 0 && CheckHitKey(KEY_INPUT_ESCAPE) == 0) // EBhE邩ESC܂
+    // --- メインループ ---
+    while (ProcessMessage() == 0 && CheckHitKey(KEY_INPUT_ESCAPE) == 0) // ウィンドウが閉じられるかESCが押されるまで
     {
-        // 1. ʃNA
-        ClearDrawScreen();
+        const Clock::time_point frameStart = Clock::now();
 
-        // 2. XV
-        camera->Update(); // J̏ԍXV
-        LogDebug(camera->GetDetailedDebugInfo()); // Jڍ׏O
+        // 1. 画面クリア
+        sink.Clear();
 
-        // 3. `揈
-        camera->Draw(worldLine);   // CJ_`
-        topangle->Draw(worldLine); // gbv_Er[`
+        // 2. 更新処理
+        if (simulation.IsRunning()) {
+            // 入力の読み取りは DxLib の関数なのでこのスレッドで行い、シミュレーションのスレッドに渡す
+            simulation.SubmitInput(Camera::ReadInput());
+            simulation.ApplyLatest(*camera); // シミュレーションのスレッドが公開した最新のカメラの状態
+        }
+        else {
+            // 前のフレームからの経過時間だけ進める (止まっていた後に大きく動かないように 0.1 秒までにする)
+            const float frameSeconds = (frameIndex == 0) ? Camera::DEFAULT_UPDATE_SECONDS
+                : std::min(0.1f, static_cast<float>(elapsedMicros(previousFrameStart, frameStart)) * 1e-6f);
+            camera->Update(frameSeconds); // カメラの状態更新
+        }
+        const Clock::time_point updateEnd = Clock::now();
+
+        // 3. 毎フレーム作る線分の準備
+        //    球はカメラから見た大きさに合った LOD で、地面のグリッドは視錐台に入る部分だけを作る。
+        //    どちらもカメラの位置・向き・レンズだけで決まるので、カメラが変わらなければ作り直さない
+        //    (作り直さなければ線分の版番号も変わらず、camera->Draw が前のフレームの結果をそのまま使える)。
+        const uint64_t viewVersion = camera->GetViewProjectionVersion();
+        if (viewVersion != frameGeometryVersion) {
+            frameLines.Clear();
+            frameMesh.Clear();
+            topLines.Clear();
+            topMesh.Clear();
+            AppendSphereLines(spheres, camera->GetFrustum(), camera->GetPosition(), camera->GetFovY(), WINDOW_HEIGHT, frameMesh);
+            // トップダウンビューは視錐台の外も映すので、視錐台で省かない球を別に作る
+            AppendSphereLines(spheres, camera->GetPosition(), camera->GetFovY(), WINDOW_HEIGHT, topMesh);
+            ground.AppendVisibleLines(camera->GetFrustum(), camera->GetPosition(), frameLines);
+            // 地面のグリッドも、トップダウンビューには視錐台ではなくビューの表示範囲で切り取ったものを渡す
+            float topMinX, topMinZ, topMaxX, topMaxZ;
+            topangle->GetViewRectXZ(topMinX, topMinZ, topMaxX, topMaxZ);
+            ground.AppendLinesInRect(topMinX, topMinZ, topMaxX, topMaxZ, topLines);
+            frameGeometryVersion = viewVersion;
+        }
 
-        // 4. UIEfobO\`
-        // ʒɏ\}[N`
+        // 4. 描画処理
+        // メインカメラ視点描画 (BVH で視錐台の外の線分を省く。カメラも線分も前のフレームと同じなら、前の結果を描くだけ)
+        camera->Draw(sceneBVH, sceneObjects, frameLines, frameMesh, sink);
+        topangle->Draw(worldLine, sceneGrid, sceneObjects, topLines, topMesh, sink); // トップダウンビュー描画 (表示範囲と重なる線分・物体だけ)
+
+        // 5. UI・デバッグ表示描画
+        // 画面中央に十字マーク描画
         {
             int cX = static_cast<int>(WINDOW_WIDTH / 2), cY = static_cast<int>(WINDOW_HEIGHT / 2), sz = 10;
-            unsigned int color = GetColor(255, 255, 0); // F
-            DrawLine(cX - sz, cY, cX + sz, cY, color);
-            DrawLine(cX, cY - sz, cX, cY + sz, color);
+            RenderColor color = GetRenderColor(255, 255, 0); // 黄色
+            sink.DrawLine(cX - sz, cY, cX + sz, cY, color);
+            sink.DrawLine(cX, cY - sz, cX, cY + sz, color);
+        }
+
+        // 画面左下にカメラの簡易デバッグ情報を表示
+        {
+            std::string dt = camera->GetDebugInfo(); // カメラ情報取得
+            sink.DrawString(10, static_cast<int>(WINDOW_HEIGHT) - 40, dt.c_str(), GetRenderColor(255, 255, 255));
         }
 
-        // ʍɃJ̊ȈՃfobO\
+        // 6. 画面更新
+        const Clock::time_point drawEnd = Clock::now();
         {
-            std::string dt = camera->GetDebugInfo(); // J擾
-            DrawFormatString(10, static_cast<int>(WINDOW_HEIGHT) - 40, GetColor(255, 255, 255), dt.c_str());
+            PROFILE_SCOPE(ProfileStage::ScreenFlip);
+            ScreenFlip(); // 裏画面を表画面に表示
         }
+        const Clock::time_point presentEnd = Clock::now();
+
+        // 7. フレームの記録 (カメラの詳細な状態とフレーム時間。書式化はせず、値をそのまま記録する)
+        if (telemetry.IsOpen()) {
+            FrameTelemetryRecord record = {};
+            camera->FillTelemetry(record);
+            record.frameIndex = frameIndex;
+            record.timeMicros = static_cast<uint64_t>(elapsedMicros(telemetryStart, frameStart));
+            record.frameMicros = static_cast<uint32_t>(elapsedMicros(previousFrameStart, frameStart));
+            record.updateMicros = static_cast<uint32_t>(elapsedMicros(frameStart, updateEnd));
+            record.drawMicros = static_cast<uint32_t>(elapsedMicros(updateEnd, drawEnd));
+            record.presentMicros = static_cast<uint32_t>(elapsedMicros(drawEnd, presentEnd));
+            telemetry.Append(record);
+        }
+        previousFrameStart = frameStart;
+        ++frameIndex;
+    }
+    simulation.Stop(); // カメラの更新を行うスレッドを止める
+    telemetry.Close(); // 残りの記録を書き出す
 
-        // 5. ʍXV
-        ScreenFlip(); // ʂ\ʂɕ\
+    // --- 段階ごとの処理時間 ---
+    LOG_INFO("段階ごとの処理時間:\n" << Profiler::GetInstance().FormatReport());
+    if (!options.profileTracePath.empty()) {
+        std::string error;
+        if (!Profiler::GetInstance().ExportChromeTrace(options.profileTracePath, &error)) { LOG_WARN(error); }
     }
 
-    // --- I ---
-    LogDebug("AvP[VI܂B");
-    Logger::GetInstance().Close(); // K[I
+    // --- 終了処理 ---
+    LOG_INFO("アプリケーションを終了します。");
+    Logger::GetInstance().Close(); // ロガー終了
 
-    // new Ŋmۂ
+    // new で確保したメモリを解放
     delete topangle;
     delete camera;
 
-    DxLib_End(); // DxLibI
+    DxLib_End(); // DxLib終了
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "MappedFile.h" // 対応するヘッダーファイル
+
+#if defined(_WIN32)
+#include <windows.h>    // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close
+#include <cerrno>       // errno
+#include <cstring>      // strerror
+#endif
+
+/*
+ * MappedFile.cpp
+ * 概要:
+ *   MappedFile クラスの実装です。OS ごとのメモリマップの API を呼び分けます。
+ *   大きさ 0 のファイルはマップできない (Windows では失敗する) ため、エラーとして扱います。
+ */
+
+#if defined(_WIN32)
+
+// ファイルを読み取り専用でマップする (Windows 版)
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    error.clear();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "ファイルを開けませんでした: " + path;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+        CloseHandle(file);
+        error = "ファイルの大きさを取得できないか、空のファイルです: " + path;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        error = "ファイルのマッピングを作成できませんでした: " + path;
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        error = "ファイルをメモリにマップできませんでした: " + path;
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+// マップを解除してファイルを閉じる (Windows 版)
+void MappedFile::Close()
+{
+    if (data != nullptr) { UnmapViewOfFile(data); }
+    if (mappingHandle != nullptr) { CloseHandle(static_cast<HANDLE>(mappingHandle)); }
+    if (fileHandle != nullptr) { CloseHandle(static_cast<HANDLE>(fileHandle)); }
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+// ファイルを読み取り専用でマップする (POSIX 版)
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    error.clear();
+
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "ファイルを開けませんでした: " + path + " (" + strerror(errno) + ")";
+        return false;
+    }
+    struct stat st;
+    if (fstat(file, &st) != 0 || st.st_size <= 0) {
+        close(file);
+        error = "ファイルの大きさを取得できないか、空のファイルです: " + path;
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED) {
+        close(file);
+        error = "ファイルをメモリにマップできませんでした: " + path + " (" + strerror(errno) + ")";
+        return false;
+    }
+
+    fd = file;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+// マップを解除してファイルを閉じる (POSIX 版)
+void MappedFile::Close()
+{
+    if (data != nullptr) { munmap(const_cast<uint8_t*>(data), size); }
+    if (fd >= 0) { close(fd); }
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+
+#endif
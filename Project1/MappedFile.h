@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t
+#include <string>  // std::string
+
+/*
+ * MappedFile.h
+ * 役割:
+ *   ファイルを読み取り専用でメモリにマップする (メモリマップドファイル) `MappedFile` クラスを定義します。
+ *   ファイルの内容を read で配列に読み込む代わりに、OS にファイルをアドレス空間へ割り当てさせるため、
+ *   開くだけではファイルの内容は読まれず、実際に触ったページだけが必要になったときに読み込まれます。
+ *   巨大なシーンファイル (SceneFile.h) を、読み込み (パース) せずにそのまま使うために使います。
+ *
+ * 実装:
+ *   - Windows: CreateFile → CreateFileMapping → MapViewOfFile
+ *   - それ以外 (Linux など): open → fstat → mmap
+ *   - マップした領域の先頭はページ境界 (4KB 以上) に揃っているため、ファイル内の位置を
+ *     32 バイト単位に揃えておけば、その位置のデータも SIMD 用に 32 バイト境界に揃います。
+ *
+ * 使い方:
+ *   MappedFile file;
+ *   if (file.Open("scene.wfscene")) {
+ *       const uint8_t* data = file.Data(); // ファイル全体 (file.Size() バイト)
+ *   }
+ */
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    // マップした領域を 2 つのオブジェクトで解放しないように、コピーは禁止する
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // path のファイルを読み取り専用でマップする。失敗したら false を返す (理由は GetError で取得できる)。
+    // 既に開いていたファイルは閉じられる。
+    bool Open(const std::string& path);
+    // マップを解除してファイルを閉じる (開いていなければ何もしない)
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+    // 直前の Open が失敗した理由
+    const std::string& GetError() const { return error; }
+
+private:
+    const uint8_t* data = nullptr; // マップした領域の先頭
+    size_t size = 0;               // ファイルの大きさ (バイト)
+    std::string error;             // 直前の Open が失敗した理由
+#if defined(_WIN32)
+    void* fileHandle = nullptr;    // CreateFile のハンドル (HANDLE)
+    void* mappingHandle = nullptr; // CreateFileMapping のハンドル (HANDLE)
+#else
+    int fd = -1;                   // open のファイル記述子
+#endif
+};
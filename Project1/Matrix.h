@@ -1,165 +1,224 @@
 #pragma once
-#include <cmath>      // sinf, cosf, tanf Ȃ (<math.h> 萄)
-#include <stdexcept> // O (std::invalid_argument) ̂߂ɕKv
-#include <cstring>   // memset Ȃ (gꍇ)
+#include <cmath>      // sinf, cosf, tanf など (<math.h> より推奨)
+#include <stdexcept> // 例外処理 (std::invalid_argument) のために必要
+#include <cstring>   // memset など (もし使う場合)
+#include "Vector.h"  // MATH_SSE (SSE の組み込み関数を使えるかどうか)
 
 /*
  * Matrix.h
- * :
- *   ̃wb_[t@ĆA3DOtBbNXŔɏdvȖʂ
- *   4x4s (`Matrix` \) ̒`ƁAɊ֘A{IȊ֐񋟂܂B
- *   ȋ@\͈ȉ̒ʂłB
- *   - `Matrix` \: 4x4̕_(float)i[f[^\B
- *   - `Matrix::Identity()`: ϊȂuPʍsv쐬ÓI\bhB
- *   - ẻ]s𐶐֐ (`GetMatrixAxisXLH`, `GetMatrixAxisYLH`, `GetMatrixAxisZLH`)B
- *     ́uWn (Left-Handed, LH)vɊÂĂ܂B
- *   - `MatrixMultiply`: 2̍s|킹֐Bϊ̍Ɏg܂B
- *   - `PerspectiveFovLH`: eiߊj^vWFNVs𐶐֐B
+ * 役割:
+ *   このヘッダーファイルは、3Dグラフィックスで非常に重要な役割を果たす
+ *   4x4行列 (`Matrix` 構造体) の定義と、それに関連する基本的な関数を提供します。
+ *   主な機能は以下の通りです。
+ *   - `Matrix` 構造体: 4x4の浮動小数点数(float)を格納するデータ構造。
+ *   - `Matrix::Identity()`: 何も変換しない「単位行列」を作成する静的メソッド。
+ *   - 各軸周りの回転行列を生成する関数 (`GetMatrixAxisXLH`, `GetMatrixAxisYLH`, `GetMatrixAxisZLH`)。
+ *     これらは「左手座標系 (Left-Handed, LH)」に基づいています。
+ *   - 平行移動・拡大縮小の行列を生成する関数 (`GetMatrixTranslation`, `GetMatrixScaling`)。
+ *     シーングラフ (SceneGraph.h) のノードの配置に使います。
+ *   - `MatrixMultiply`: 2つの行列を掛け合わせる関数。変換の合成に使います。
+ *     `MatrixMultiply<MatrixShape::Affine>` は、両方がアフィン変換 (最後の列が (0, 0, 0, 1)) の
+ *     場合の特殊化で、定数の最後の列の計算を省きます (回転 × 平行移動の合成など)。
+ *   - `PerspectiveFovLH`: 透視投影（遠近感）を与えるプロジェクション行列を生成する関数。
  *
- * ̃o[Wł̕ύX_ ( Matrix.h ):
- * - ]s񐶐֐:  `GetMatrixAxisX`, `GetMatrixAxisY` Wn(LH)
- *   `ɊÂĂ邱ƂmɂȂ悤ɁA֐ `LH` ǉA
- *   ̌vZWn̕WIȒ`ɍ킹ďCĂ܂B
- *   Z̉]s `GetMatrixAxisZLH` QlƂĒǉĂ܂B
- * - @\ǉ: s̏Z (`MatrixMultiply`)APʍs (`Identity`)A
- *   es (`PerspectiveFovLH`) 𐶐֐ǉĂ܂B
- *   ͌I3DJVXe̎ɕsȗvfłB
- * - G[`FbN: `PerspectiveFovLH` Ɋ֐̈sȏꍇɗO𓊂
- *   {IȃG[`FbNǉ܂B
+ * このバージョンでの変更点 (元の Matrix.h から):
+ * - 回転行列生成関数: 元の `GetMatrixAxisX`, `GetMatrixAxisY` が左手座標系(LH)の
+ *   定義に基づいていることが明確になるように、関数名に `LH` が追加され、
+ *   内部の計算式も左手座標系の標準的な定義に合わせて修正されています。
+ *   Z軸周りの回転行列 `GetMatrixAxisZLH` も参考として追加されています。
+ * - 機能追加: 行列の乗算 (`MatrixMultiply`)、単位行列 (`Identity`)、
+ *   透視投影行列 (`PerspectiveFovLH`) を生成する関数が追加されています。
+ *   これらは現代的な3Dカメラシステムの実装に不可欠な要素です。
+ * - エラーチェック: `PerspectiveFovLH` に関数の引数が不正な場合に例外を投げる
+ *   基本的なエラーチェックが追加されました。
+ * - SIMD 化: `Matrix` を 16 バイト境界に揃え、各行を SSE の 1 レジスタで扱えるようにしました。
+ *   `MatrixMultiply` は結果の 1 行を「A の行の各要素 × B の各行」の 4 回の積和で 4 列同時に求めます。
+ *   加算の順序はスカラー版と同じなので、SSE を使えない環境でも結果は完全に一致します。
  *
- * g:
- *   - ̃wb_[t@CCN[h (`#include "Matrix.h"`) ܂B
- *   - `Matrix` ^̕ϐ쐬čsf[^܂B
- *   - `Matrix::Identity()` ŒPʍs쐬A`GetMatrixAxisYLH(angle)` Ȃǂ
- *     ]s쐬肵܂B
- *   - `MatrixMultiply(matA, matB)` ōsAƍsB|킹ʂ𓾂܂B
- *   - `PerspectiveFovLH(...)` ŃvWFNVs쐬܂B
+ * 使い方:
+ *   - このヘッダーファイルをインクルード (`#include "Matrix.h"`) します。
+ *   - `Matrix` 型の変数を作成して行列データを扱います。
+ *   - `Matrix::Identity()` で単位行列を作成したり、`GetMatrixAxisYLH(angle)` などで
+ *     回転行列を作成したりします。
+ *   - `MatrixMultiply(matA, matB)` で行列Aと行列Bを掛け合わせた結果を得ます。
+ *   - `PerspectiveFovLH(...)` でプロジェクション行列を作成します。
  *
- * ӓ_:
- * - s̗vfANZX: `m[s][]` ̌`iRow-major orderjŃANZX܂B
- * - Wn(LH): ̃wb_[̉]svWFNVśA
- *   DirectXȂǂŕWIɎg鍶WnɂĂ܂B
- *   OpenGLȂǂŎgEWnƂ͈ꕔ̕ȂǂقȂ܂B
- * - s̏Z: `MatrixMultiply(A, B)`  A * B vZ܂A
- *   WϊKpۂ́AϊKpƋt̏
- *   s|̂ʓIłi: ړ * ] Ȃ `matRot * matTrans`jB
+ * 注意点:
+ * - 行列の要素アクセス: `m[行][列]` の形式（Row-major order）でアクセスします。
+ * - 左手座標系(LH): このヘッダー内の回転行列やプロジェクション行列は、
+ *   DirectXなどで標準的に使われる左手座標系を基準にしています。
+ *   OpenGLなどで使われる右手座標系とは一部の符号などが異なります。
+ * - 行列の乗算順序: `MatrixMultiply(A, B)` は A * B を計算しますが、
+ *   座標変換を適用する際は、変換を適用したい順序と逆の順序で
+ *   行列を掛けるのが一般的です（例: 移動 * 回転 なら `matRot * matTrans`）。
  */
 
- // 4x4 s\\
-struct Matrix
+ // 4x4 行列を表す構造体
+// (16 バイト境界に揃え、各行 m[i] を SSE の 1 レジスタで読み書きできるようにする)
+struct alignas(16) Matrix
 {
-    float m[4][4]; // 4x4  float ^vf
+    float m[4][4]; // 4x4 の float 型要素
 
-    // ftHgRXgN^: Svf 0.0f ŏ
+    // デフォルトコンストラクタ: 全要素を 0.0f で初期化
     Matrix() {
-        for (int i = 0; i < 4; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                m[i][j] = 0.0f;
-            }
-        }
-        // 邢 <cstring> CN[h: std::memset(m, 0, sizeof(float) * 16);
+        std::memset(m, 0, sizeof(m));
     }
 
-    // ÓI\bh: Pʍs (Ίp1ő0̍s) 쐬ĕԂ
+    // 静的メソッド: 単位行列 (対角成分が1で他が0の行列) を作成して返す
     static Matrix Identity() {
-        Matrix result; // [sŏ
+        Matrix result; // ゼロ行列で初期化される
         result.m[0][0] = 1.0f;
         result.m[1][1] = 1.0f;
         result.m[2][2] = 1.0f;
         result.m[3][3] = 1.0f;
         return result;
     }
+
+    // アフィン変換 (最後の列が (0, 0, 0, 1)) かどうか
+    bool IsAffine() const {
+        return m[0][3] == 0.0f && m[1][3] == 0.0f && m[2][3] == 0.0f && m[3][3] == 1.0f;
+    }
+
+#if defined(MATH_SSE)
+    // 行 row の 4 要素をまとめて読み書きする
+    // (32 ビットのヒープは 8 バイト境界しか保証しないので、境界を仮定しない命令を使う)
+    __m128 LoadRow(int row) const { return _mm_loadu_ps(m[row]); }
+    void StoreRow(int row, __m128 value) { _mm_storeu_ps(m[row], value); }
+#endif
 };
 
-// X̉]s𐶐֐ (Wn / LH)
-// XAxisRotation: ]px (WAP)B̒lŔv (YZ֌)B
-// (: DxLib ̃ftHgƂ͉]t̉\܂)
+// X軸周りの回転行列を生成する関数 (左手座標系 / LH)
+// XAxisRotation: 回転角度 (ラジアン単位)。正の値で反時計回り (Y軸からZ軸へ向かう向き)。
+// (注意: DxLib のデフォルトとは回転方向が逆の可能性があります)
 static Matrix GetMatrixAxisXLH(float XAxisRotation)
 {
     float sin_val = sinf(XAxisRotation);
     float cos_val = cosf(XAxisRotation);
-    Matrix result = Matrix::Identity(); // Pʍs񂩂n߂
-    // X]̐ݒ (Wn̒`ɊÂ)
-    result.m[1][1] = cos_val;  result.m[1][2] = sin_val;  // C: LHł (1,2)  sin
-    result.m[2][1] = -sin_val; result.m[2][2] = cos_val;  // C: LHł (2,1)  -sin
+    Matrix result = Matrix::Identity(); // 単位行列から始める
+    // X軸回転の成分を設定 (左手座標系の定義に基づく)
+    result.m[1][1] = cos_val;  result.m[1][2] = sin_val;  // 修正: LHでは (1,2) が sin
+    result.m[2][1] = -sin_val; result.m[2][2] = cos_val;  // 修正: LHでは (2,1) が -sin
     return result;
 }
 
-// Ỷ]s𐶐֐ (Wn / LH)
-// YAxisRotation: ]px (WAP)B̒lŔv (ZX֌)B
+// Y軸周りの回転行列を生成する関数 (左手座標系 / LH)
+// YAxisRotation: 回転角度 (ラジアン単位)。正の値で反時計回り (Z軸からX軸へ向かう向き)。
 static Matrix GetMatrixAxisYLH(float YAxisRotation)
 {
     float sin_val = sinf(YAxisRotation);
     float cos_val = cosf(YAxisRotation);
     Matrix result = Matrix::Identity();
-    // Y]̐ݒ (Wn̒`ɊÂ)
-    result.m[0][0] = cos_val;  result.m[0][2] = -sin_val; // C: LHł (0,2)  -sin
-    result.m[2][0] = sin_val;  result.m[2][2] = cos_val;  // C: LHł (2,0)  sin
+    // Y軸回転の成分を設定 (左手座標系の定義に基づく)
+    result.m[0][0] = cos_val;  result.m[0][2] = -sin_val; // 修正: LHでは (0,2) が -sin
+    result.m[2][0] = sin_val;  result.m[2][2] = cos_val;  // 修正: LHでは (2,0) が sin
     return result;
 }
 
-// Z̉]s𐶐֐ (Wn / LH) - QlƂĒǉ
-// ZAxisRotation: ]px (WAP)B̒lŔv (XY֌)B
+// Z軸周りの回転行列を生成する関数 (左手座標系 / LH) - 参考として追加
+// ZAxisRotation: 回転角度 (ラジアン単位)。正の値で反時計回り (X軸からY軸へ向かう向き)。
 static Matrix GetMatrixAxisZLH(float ZAxisRotation)
 {
     float sin_val = sinf(ZAxisRotation);
     float cos_val = cosf(ZAxisRotation);
     Matrix result = Matrix::Identity();
-    // Z]̐ݒ (Wn̒`ɊÂ)
-    result.m[0][0] = cos_val;  result.m[0][1] = sin_val;  // C: LHł (0,1)  sin
-    result.m[1][0] = -sin_val; result.m[1][1] = cos_val;  // C: LHł (1,0)  -sin
+    // Z軸回転の成分を設定 (左手座標系の定義に基づく)
+    result.m[0][0] = cos_val;  result.m[0][1] = sin_val;  // 修正: LHでは (0,1) が sin
+    result.m[1][0] = -sin_val; result.m[1][1] = cos_val;  // 修正: LHでは (1,0) が -sin
     return result;
 }
 
+// 平行移動の行列を生成する関数 (行ベクトルに右から掛けるので、移動量は 4 行目に入る)
+static Matrix GetMatrixTranslation(float x, float y, float z)
+{
+    Matrix result = Matrix::Identity();
+    result.m[3][0] = x; result.m[3][1] = y; result.m[3][2] = z;
+    return result;
+}
 
-// s̏Z C = A * B vZ֐
-static Matrix MatrixMultiply(const Matrix& a, const Matrix& b)
+// 各軸方向の拡大縮小の行列を生成する関数
+static Matrix GetMatrixScaling(float x, float y, float z)
 {
-    Matrix c; // ʂi[s (RXgN^Ń[)
-    // sZ̒`ɏ]ČvZ
-    for (int i = 0; i < 4; i++) {       // ʂ̍sCfbNX
-        for (int j = 0; j < 4; j++) {   // ʂ̗CfbNX
-            // c.m[i][j] = 0; // RXgN^ŏς݂Ȃ̂ŕsv
-            for (int k = 0; k < 4; k++) { // ̃[v (avZ)
-                c.m[i][j] += a.m[i][k] * b.m[k][j];
-            }
+    Matrix result = Matrix::Identity();
+    result.m[0][0] = x; result.m[1][1] = y; result.m[2][2] = z;
+    return result;
+}
+
+
+// MatrixMultiply に渡す行列の形 (コンパイル時に計算を選ぶ)
+enum class MatrixShape {
+    General, // 一般の 4x4 行列
+    Affine   // 両方ともアフィン変換 (最後の列が (0, 0, 0, 1))。3x4 の部分だけを計算する
+};
+
+// 行列の乗算 C = A * B を計算する関数
+// Shape が MatrixShape::Affine のときは、a と b がアフィン変換であることを呼び出し側が保証する
+// (結果もアフィン変換になる)。c.m[i][j] は a.m[i][0] * b.m[0][j] から k の順に加算する。
+template <MatrixShape Shape = MatrixShape::General>
+inline Matrix MatrixMultiply(const Matrix& a, const Matrix& b)
+{
+    const bool affine = (Shape == MatrixShape::Affine); // コンパイル時に決まる
+    Matrix c; // 結果を格納する行列
+#if defined(MATH_SSE)
+    const __m128 b0 = b.LoadRow(0), b1 = b.LoadRow(1), b2 = b.LoadRow(2), b3 = b.LoadRow(3);
+    for (int i = 0; i < 4; i++) { // 結果の行インデックス (4 列を同時に計算)
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a.m[i][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[i][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[i][2]), b2));
+        if (!affine) {
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.m[i][3]), b3));
+        }
+        else if (i == 3) {
+            row = _mm_add_ps(row, b3); // アフィン変換では a.m[3][3] = 1、他の行の a.m[i][3] = 0
+        }
+        c.StoreRow(i, row);
+    }
+#else
+    const int columns = affine ? 3 : 4; // アフィン変換では最後の列は (0, 0, 0, 1) に決まっている
+    for (int i = 0; i < 4; i++) {           // 結果の行インデックス
+        for (int j = 0; j < columns; j++) { // 結果の列インデックス
+            float sum = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j];
+            if (!affine) { sum += a.m[i][3] * b.m[3][j]; }
+            else if (i == 3) { sum += b.m[3][j]; }
+            c.m[i][j] = sum;
         }
     }
+    if (affine) { c.m[3][3] = 1.0f; }
+#endif
     return c;
 }
 
 
-// WnApx[X̓es (Perspective Projection Matrix) 쐬֐
-// fovY: ̎p (WAP)
-// aspectRatio: XN[̃AXyNg ( / )
-// zn: jANbvʂ܂ł̋ (Near Plane Distance) > 0
-// zf: t@[Nbvʂ܂ł̋ (Far Plane Distance) > zn
+// 左手座標系、視野角ベースの透視投影行列 (Perspective Projection Matrix) を作成する関数
+// fovY: 垂直方向の視野角 (ラジアン単位)
+// aspectRatio: スクリーンのアスペクト比 (幅 / 高さ)
+// zn: ニアクリップ面までの距離 (Near Plane Distance) > 0
+// zf: ファークリップ面までの距離 (Far Plane Distance) > zn
 static Matrix PerspectiveFovLH(float fovY, float aspectRatio, float zn, float zf)
 {
-    // ̑Ó`FbN
+    // 引数の妥当性をチェック
     if (aspectRatio <= 0.0f || zn <= 0.0f || zf <= zn) {
-        // sȈnꂽꍇ́AG[O𓊂
-        throw std::invalid_argument("PerspectiveFovLH ɕsȈn܂B");
-        // ܂́AG[bZ[W\ĒPʍsԂȂǂ̑֏l
-        // DxLib ς݂Ȃ printfDx(...) ȂǂŃG[\
+        // 不正な引数が渡された場合は、エラーを示す例外を投げる
+        throw std::invalid_argument("PerspectiveFovLH に不正な引数が渡されました。");
+        // または、エラーメッセージを表示して単位行列を返すなどの代替処理も考えられる
+        // DxLib が初期化済みなら printfDx(...) などでエラー表示
         // return Matrix::Identity();
     }
 
-    Matrix result; // [sŏ
-    // ỸXP[ (pvZ)
+    Matrix result; // ゼロ行列で初期化される
+    // Y方向のスケール (視野角から計算)
     float yScale = 1.0f / tanf(fovY / 2.0f);
-    // X̃XP[ (YXP[ƃAXyNg䂩vZ)
+    // X方向のスケール (Yスケールとアスペクト比から計算)
     float xScale = yScale / aspectRatio;
-    // Z̕ϊW (Wn̒`)
+    // Z方向の変換係数 (左手座標系の定義)
     float zRange = zf / (zf - zn); // LH
 
-    // s̗vfݒ
+    // 行列の要素を設定
     result.m[0][0] = xScale;
     result.m[1][1] = yScale;
-    result.m[2][2] = zRange;        // Zl [0, 1] ͈̔͂ɋ߂Â邽߂̃XP[ (LH)
-    result.m[2][3] = 1.0f;          // W' ɌZlRs[邽߂̐ݒ (LH)
-    result.m[3][2] = -zn * zRange;  // Zl̃ItZbg (LH)
-    // result.m[3][3]  0.0f ̂܂
+    result.m[2][2] = zRange;        // Z値を [0, 1] の範囲に近づけるためのスケール (LH)
+    result.m[2][3] = 1.0f;          // W' に元のZ値をコピーするための設定 (LH)
+    result.m[3][2] = -zn * zRange;  // Z値のオフセット (LH)
+    // result.m[3][3] は 0.0f のまま
 
     return result;
 }
\ No newline at end of file
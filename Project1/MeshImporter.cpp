@@ -0,0 +1,807 @@
+#include "MeshImporter.h" // 対応するヘッダーファイル
+#include "MappedFile.h"   // MappedFile (ファイルのメモリマップ)
+#include "ThreadPool.h"   // ThreadPool (並列解析)
+#include <algorithm>      // std::sort, std::unique, std::min
+#include <cmath>          // pow
+#include <cstdint>        // uint64_t
+#include <cstring>        // memchr, memcpy
+#include <sstream>        // std::istringstream (PLY のヘッダーの解析)
+#include <vector>         // std::vector
+
+/*
+ * MeshImporter.cpp
+ * 概要:
+ *   OBJ / PLY の取り込みの実装です。
+ *   どちらの形式も「塊に区切る → 塊ごとに並列に数える → 累積和で位置を決める → 塊ごとに並列に解析する →
+ *   辺の重複を除く (MergeEdges)」の順に処理します。
+ *   辺は解析中は 64 ビットの値 (小さい頂点番号 << 32 | 大きい頂点番号) で持ち、重複の判定と並べ替えに使います。
+ */
+
+namespace {
+    // 1 つの塊 (並列に解析する単位) のおよその大きさ (バイト)
+    const size_t IMPORT_CHUNK_BYTES = 1 << 20;
+    // バイナリの PLY で、1 つの仕事で処理する要素の数
+    const size_t PLY_BINARY_CHUNK_ELEMENTS = 65536;
+    // 辺の重複を除くときの、ワーカー 1 つあたりのバケットの数
+    const size_t EDGE_BUCKETS_PER_WORKER = 8;
+
+    // error が nullptr でなければ message を書き込み、false を返す
+    bool Fail(std::string* error, const std::string& message) {
+        if (error != nullptr) { *error = message; }
+        return false;
+    }
+
+    // taskCount 個の仕事を、pool があれば並列に、なければ順番に処理する
+    template <typename Func>
+    void RunTasks(ThreadPool* pool, size_t taskCount, Func func) {
+        if (pool != nullptr && pool->GetWorkerCount() > 1 && taskCount > 1) {
+            pool->ParallelFor(taskCount, [&](size_t task, unsigned int) { func(task); });
+        }
+        else {
+            for (size_t task = 0; task < taskCount; ++task) { func(task); }
+        }
+    }
+
+    // --- 文字列の解析 ---
+
+    // テキストの塊 [begin, end) (行の途中で区切らない)
+    struct TextChunk {
+        const char* begin;
+        const char* end;
+    };
+
+    // [begin, end) を、行の境目でおよそ IMPORT_CHUNK_BYTES ずつの塊に区切る
+    std::vector<TextChunk> SplitIntoChunks(const char* begin, const char* end) {
+        std::vector<TextChunk> chunks;
+        const char* p = begin;
+        while (p < end) {
+            const char* q = (static_cast<size_t>(end - p) > IMPORT_CHUNK_BYTES) ? p + IMPORT_CHUNK_BYTES : end;
+            if (q < end) {
+                const void* newline = memchr(q, '\n', static_cast<size_t>(end - q));
+                q = (newline != nullptr) ? static_cast<const char*>(newline) + 1 : end;
+            }
+            chunks.push_back({ p, q });
+            p = q;
+        }
+        return chunks;
+    }
+
+    // p から始まる行の終わり ('\n' の位置、なければ end)
+    inline const char* FindLineEnd(const char* p, const char* end) {
+        const void* newline = memchr(p, '\n', static_cast<size_t>(end - p));
+        return (newline != nullptr) ? static_cast<const char*>(newline) : end;
+    }
+    inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; }
+    inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+    inline const char* SkipSpaces(const char* p, const char* end) {
+        while (p < end && IsSpace(*p)) { ++p; }
+        return p;
+    }
+    inline const char* SkipToken(const char* p, const char* end) {
+        while (p < end && !IsSpace(*p)) { ++p; }
+        return p;
+    }
+
+    // 10 の e 乗 (e >= 0)。double で正確に表せる 1e22 までは表を使う
+    inline double Pow10(int e) {
+        static const double table[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        return (e <= 22) ? table[e] : pow(10.0, static_cast<double>(e));
+    }
+
+    // p から数値 ("1", "-2.5", "3e-4", ".5" など) を読み、p を数値の直後に進める。数値でなければ false。
+    // 有効数字 19 桁までを整数として集めてから 10 のべき乗で 1 回だけ割る (掛ける) ので、
+    // ロケールに依存せず、float に丸めた結果は strtod とほぼ同じになる。
+    inline bool ParseNumber(const char*& p, const char* end, double& out) {
+        const char* s = p;
+        bool negative = false;
+        if (s < end && (*s == '-' || *s == '+')) { negative = (*s == '-'); ++s; }
+        uint64_t mantissa = 0; // 有効数字 (19 桁まで)
+        int digits = 0;        // mantissa に入れた有効数字の桁数
+        int exponent = 0;      // 10 の指数
+        bool any = false;      // 数字が 1 つでもあったか
+        for (; s < end && IsDigit(*s); ++s, any = true) {
+            if (digits < 19) { mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0'); if (mantissa != 0) { ++digits; } }
+            else { ++exponent; } // 入りきらない整数部の桁は指数で数える
+        }
+        if (s < end && *s == '.') {
+            for (++s; s < end && IsDigit(*s); ++s, any = true) {
+                if (digits < 19) { mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0'); if (mantissa != 0) { ++digits; } --exponent; }
+            }
+        }
+        if (!any) { return false; }
+        if (s < end && (*s == 'e' || *s == 'E')) {
+            const char* t = s + 1;
+            bool expNegative = false;
+            if (t < end && (*t == '-' || *t == '+')) { expNegative = (*t == '-'); ++t; }
+            if (t < end && IsDigit(*t)) {
+                int e = 0;
+                for (; t < end && IsDigit(*t); ++t) { if (e < 10000) { e = e * 10 + (*t - '0'); } }
+                exponent += expNegative ? -e : e;
+                s = t;
+            }
+        }
+        double value = static_cast<double>(mantissa);
+        if (mantissa != 0 && exponent != 0) {
+            value = (exponent < 0) ? value / Pow10(-exponent) : value * Pow10(exponent);
+        }
+        out = negative ? -value : value;
+        p = s;
+        return true;
+    }
+
+    // p から整数を読み、p を整数の直後に進める。整数でなければ false。
+    inline bool ParseInteger(const char*& p, const char* end, long long& out) {
+        const char* s = p;
+        bool negative = false;
+        if (s < end && (*s == '-' || *s == '+')) { negative = (*s == '-'); ++s; }
+        if (!(s < end && IsDigit(*s))) { return false; }
+        long long value = 0;
+        for (; s < end && IsDigit(*s); ++s) {
+            if (value < (1LL << 40)) { value = value * 10 + (*s - '0'); } // 頂点番号としてありえない大きさで止める
+        }
+        out = negative ? -value : value;
+        p = s;
+        return true;
+    }
+
+    // --- 辺 ---
+
+    // 頂点 a, b の辺を、小さい番号を上位に入れた 64 ビットの値にして edges に追加する (長さ 0 の辺は除く)
+    inline void AddEdgeKey(std::vector<uint64_t>& edges, uint64_t a, uint64_t b) {
+        if (a == b) { return; }
+        edges.push_back((a < b) ? ((a << 32) | b) : ((b << 32) | a));
+    }
+
+    // 全てのリストの辺を、重複を除いて out の辺にする (処理したリストは空になる)
+    void MergeEdges(std::vector<std::vector<uint64_t>*>& lists, size_t vertexCount, ThreadPool* pool, WireMesh& out) {
+        const size_t workerCount = (pool != nullptr) ? pool->GetWorkerCount() : 1;
+        const size_t bucketCount = (workerCount > 1) ? workerCount * EDGE_BUCKETS_PER_WORKER : 1;
+        // 小さい方の頂点番号の範囲でバケットを決める (バケットの順に並べれば、全体が頂点番号の順になる)
+        const uint64_t verticesPerBucket = vertexCount / bucketCount + 1;
+        auto bucketOf = [&](uint64_t key) { return static_cast<size_t>((key >> 32) / verticesPerBucket); };
+
+        // 1. リストごと・バケットごとの本数を数える
+        const size_t listCount = lists.size();
+        std::vector<size_t> counts(listCount * bucketCount, 0);
+        RunTasks(pool, listCount, [&](size_t l) {
+            for (uint64_t key : *lists[l]) { ++counts[l * bucketCount + bucketOf(key)]; }
+        });
+
+        // 2. 書き込む位置を決める (バケットの順。同じバケットの中はリストの順)
+        std::vector<size_t> offsets(listCount * bucketCount);
+        std::vector<size_t> bucketStart(bucketCount + 1);
+        size_t total = 0;
+        for (size_t b = 0; b < bucketCount; ++b) {
+            bucketStart[b] = total;
+            for (size_t l = 0; l < listCount; ++l) {
+                offsets[l * bucketCount + b] = total;
+                total += counts[l * bucketCount + b];
+            }
+        }
+        bucketStart[bucketCount] = total;
+
+        // 3. バケットに振り分ける (振り分けたリストはメモリを解放する)
+        std::vector<uint64_t> keys(total);
+        RunTasks(pool, listCount, [&](size_t l) {
+            size_t* position = &offsets[l * bucketCount];
+            for (uint64_t key : *lists[l]) { keys[position[bucketOf(key)]++] = key; }
+            std::vector<uint64_t>().swap(*lists[l]);
+        });
+
+        // 4. バケットごとに並べ替えて、重複を除く
+        std::vector<size_t> uniqueCounts(bucketCount);
+        RunTasks(pool, bucketCount, [&](size_t b) {
+            uint64_t* first = keys.data() + bucketStart[b];
+            uint64_t* last = keys.data() + bucketStart[b + 1];
+            std::sort(first, last);
+            uniqueCounts[b] = static_cast<size_t>(std::unique(first, last) - first);
+        });
+
+        // 5. 重複を除いた辺を、バケットの順に out に書き込む
+        std::vector<size_t> outStart(bucketCount + 1, 0);
+        for (size_t b = 0; b < bucketCount; ++b) { outStart[b + 1] = outStart[b] + uniqueCounts[b]; }
+        out.ResizeEdges(outStart[bucketCount]);
+        RunTasks(pool, bucketCount, [&](size_t b) {
+            const uint64_t* src = keys.data() + bucketStart[b];
+            for (size_t i = 0; i < uniqueCounts[b]; ++i) {
+                out.SetEdge(outStart[b] + i, static_cast<uint32_t>(src[i] >> 32), static_cast<uint32_t>(src[i] & 0xffffffffu));
+            }
+        });
+
+        // 6. 頂点と辺を書き終えたので、版番号に反映する (SetVertex, SetEdge は要素ごとには反映しない)
+        out.MarkChanged();
+    }
+
+    // 解析に失敗した場所とその理由 (塊ごとに最初の 1 つだけ記録する)
+    struct ParseError {
+        const char* at = nullptr;      // 失敗した位置 (nullptr なら失敗していない)
+        const char* message = nullptr; // 理由
+        void Set(const char* position, const char* reason) { if (at == nullptr) { at = position; message = reason; } }
+    };
+
+    // 塊ごとのエラーのうち、ファイルの先頭に最も近いものを error に書き込んで false を返す (エラーがなければ true)
+    template <typename Chunk>
+    bool CheckChunkErrors(const std::vector<Chunk>& chunks, const char* data, std::string* error) {
+        for (const Chunk& chunk : chunks) {
+            if (chunk.error.at != nullptr) {
+                return Fail(error, std::string(chunk.error.message) + " (ファイルの先頭から " +
+                    std::to_string(chunk.error.at - data) + " バイト目)");
+            }
+        }
+        return true;
+    }
+
+    // --- OBJ ---
+
+    // OBJ の塊ごとの解析結果
+    struct ObjChunk {
+        TextChunk text;
+        size_t vertexCount = 0;      // 塊の中の頂点 (v 行) の数
+        size_t vertexBase = 0;       // 塊の最初の頂点の番号
+        std::vector<uint64_t> edges; // 塊の中の辺
+        ParseError error;
+    };
+
+    // 行の先頭 (空白を除く) が「keyword + 空白」なら true
+    inline bool StartsWithKeyword(const char* p, const char* lineEnd, char keyword) {
+        return lineEnd - p >= 2 && p[0] == keyword && IsSpace(p[1]);
+    }
+
+    // OBJ の塊の v 行を数える
+    void CountObjVertices(ObjChunk& chunk) {
+        const char* end = chunk.text.end;
+        for (const char* line = chunk.text.begin; line < end;) {
+            const char* lineEnd = FindLineEnd(line, end);
+            const char* p = SkipSpaces(line, lineEnd);
+            if (StartsWithKeyword(p, lineEnd, 'v')) { ++chunk.vertexCount; }
+            line = lineEnd + 1;
+        }
+    }
+
+    // OBJ の塊を解析し、頂点を out に直接書き込み、辺を chunk.edges に集める
+    void ParseObjChunk(ObjChunk& chunk, size_t totalVertexCount, WireMesh& out) {
+        const char* end = chunk.text.end;
+        size_t vertexIndex = chunk.vertexBase; // 次の v 行の頂点番号
+        for (const char* line = chunk.text.begin; line < end && chunk.error.at == nullptr;) {
+            const char* lineEnd = FindLineEnd(line, end);
+            const char* p = SkipSpaces(line, lineEnd);
+            if (StartsWithKeyword(p, lineEnd, 'v')) {
+                // 頂点: v x y z [w]
+                double xyz[3];
+                p += 2;
+                for (int a = 0; a < 3; ++a) {
+                    p = SkipSpaces(p, lineEnd);
+                    if (!ParseNumber(p, lineEnd, xyz[a])) { chunk.error.Set(p, "OBJ の頂点の座標を読めませんでした"); break; }
+                }
+                if (chunk.error.at != nullptr) { break; } // 座標を読めなかった頂点は書き込まない
+                out.SetVertex(vertexIndex++, { static_cast<float>(xyz[0]), static_cast<float>(xyz[1]), static_cast<float>(xyz[2]) });
+            }
+            else if (StartsWithKeyword(p, lineEnd, 'f') || StartsWithKeyword(p, lineEnd, 'l')) {
+                // 面: f v1 v2 v3 ... (閉じた多角形)、折れ線: l v1 v2 ... (閉じない)
+                const bool closed = (p[0] == 'f');
+                uint64_t first = 0, previous = 0;
+                size_t count = 0;
+                for (p += 2;;) {
+                    p = SkipSpaces(p, lineEnd);
+                    if (p >= lineEnd || *p == '#') { break; }
+                    long long index;
+                    if (!ParseInteger(p, lineEnd, index)) { chunk.error.Set(p, "OBJ の頂点番号を読めませんでした"); break; }
+                    // 1 から始まる番号、または負の番号 (この行より前の頂点から数えた相対位置) を 0 から始まる番号にする
+                    const long long resolved = (index > 0) ? index - 1 : static_cast<long long>(vertexIndex) + index;
+                    if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(totalVertexCount)) {
+                        chunk.error.Set(p, "OBJ の頂点番号が範囲外です");
+                        break;
+                    }
+                    p = SkipToken(p, lineEnd); // "/テクスチャ番号/法線番号" の部分は使わない
+                    const uint64_t v = static_cast<uint64_t>(resolved);
+                    if (count == 0) { first = v; }
+                    else { AddEdgeKey(chunk.edges, previous, v); }
+                    previous = v;
+                    ++count;
+                }
+                if (closed && count > 2) { AddEdgeKey(chunk.edges, previous, first); }
+            }
+            // それ以外の行 (コメント、vn, vt, o, g, usemtl など) は使わない
+            line = lineEnd + 1;
+        }
+    }
+
+    // --- PLY ---
+
+    // PLY のプロパティの型
+    enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid };
+
+    PlyType ParsePlyType(const std::string& name) {
+        if (name == "char" || name == "int8") { return PlyType::Int8; }
+        if (name == "uchar" || name == "uint8") { return PlyType::UInt8; }
+        if (name == "short" || name == "int16") { return PlyType::Int16; }
+        if (name == "ushort" || name == "uint16") { return PlyType::UInt16; }
+        if (name == "int" || name == "int32") { return PlyType::Int32; }
+        if (name == "uint" || name == "uint32") { return PlyType::UInt32; }
+        if (name == "float" || name == "float32") { return PlyType::Float32; }
+        if (name == "double" || name == "float64") { return PlyType::Float64; }
+        return PlyType::Invalid;
+    }
+
+    size_t PlyTypeSize(PlyType type) {
+        switch (type) {
+        case PlyType::Int8: case PlyType::UInt8: return 1;
+        case PlyType::Int16: case PlyType::UInt16: return 2;
+        case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+        case PlyType::Float64: return 8;
+        default: return 0;
+        }
+    }
+
+    // バイナリ (リトルエンディアン) の値を 1 つ読む
+    inline double ReadPlyBinary(const char* p, PlyType type) {
+        switch (type) {
+        case PlyType::Int8: { int8_t v; memcpy(&v, p, 1); return v; }
+        case PlyType::UInt8: { uint8_t v; memcpy(&v, p, 1); return v; }
+        case PlyType::Int16: { int16_t v; memcpy(&v, p, 2); return v; }
+        case PlyType::UInt16: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case PlyType::Int32: { int32_t v; memcpy(&v, p, 4); return v; }
+        case PlyType::UInt32: { uint32_t v; memcpy(&v, p, 4); return v; }
+        case PlyType::Float32: { float v; memcpy(&v, p, 4); return v; }
+        case PlyType::Float64: { double v; memcpy(&v, p, 8); return v; }
+        default: return 0.0;
+        }
+    }
+
+    // PLY のプロパティ
+    struct PlyProperty {
+        std::string name;
+        PlyType type = PlyType::Invalid;      // 値の型 (リストなら要素の型)
+        bool isList = false;                  // リスト (要素の数 + 要素) なら true
+        PlyType countType = PlyType::Invalid; // リストの要素の数の型
+    };
+
+    // PLY の要素 (vertex, face, edge など)
+    struct PlyElement {
+        std::string name;
+        size_t count = 0;
+        std::vector<PlyProperty> properties;
+        size_t firstInstance = 0; // ファイル全体の中での最初の要素の通し番号 (ascii の行番号)
+        int role = 0;             // PLY_ROLE_*
+        int x = -1, y = -1, z = -1;      // vertex: 座標のプロパティの番号
+        int indices = -1;                // face: 頂点番号のリストのプロパティの番号
+        int vertex1 = -1, vertex2 = -1;  // edge: 両端の頂点番号のプロパティの番号
+        bool HasList() const {
+            for (const PlyProperty& property : properties) { if (property.isList) { return true; } }
+            return false;
+        }
+    };
+    const int PLY_ROLE_OTHER = 0;  // 使わない要素
+    const int PLY_ROLE_VERTEX = 1; // 頂点
+    const int PLY_ROLE_FACE = 2;   // 面
+    const int PLY_ROLE_EDGE = 3;   // 辺
+
+    // 要素の 1 つのインスタンス (1 行、またはバイナリの 1 要素分) から取り出した値を、頂点・辺として書き込む
+    struct PlyInstanceSink {
+        WireMesh& out;
+        size_t vertexCount;
+        std::vector<uint64_t>& edges;
+        ParseError& error;
+
+        // 頂点番号 value を確かめる (範囲外なら false)
+        bool CheckIndex(double value, const char* at) {
+            if (!(value >= 0.0 && value < static_cast<double>(vertexCount))) {
+                error.Set(at, "PLY の頂点番号が範囲外です");
+                return false;
+            }
+            return true;
+        }
+    };
+
+    // ascii の PLY の塊ごとの解析結果
+    struct PlyChunk {
+        TextChunk text;
+        size_t lineCount = 0; // 塊の中の (空でない) 行の数
+        size_t firstLine = 0; // 塊の最初の行の通し番号
+        std::vector<uint64_t> edges;
+        ParseError error;
+    };
+
+    // ascii の PLY の塊を解析する
+    void ParsePlyAsciiChunk(PlyChunk& chunk, const std::vector<PlyElement>& elements, WireMesh& out, size_t vertexCount) {
+        PlyInstanceSink sink{ out, vertexCount, chunk.edges, chunk.error };
+        const char* end = chunk.text.end;
+        size_t lineNumber = chunk.firstLine;
+        size_t e = 0; // 現在の行が属する要素 (行番号は増える一方なので、前から順に進めるだけでよい)
+        std::vector<uint64_t> polygon;
+        for (const char* line = chunk.text.begin; line < end && chunk.error.at == nullptr;) {
+            const char* lineEnd = FindLineEnd(line, end);
+            const char* p = SkipSpaces(line, lineEnd);
+            line = lineEnd + 1;
+            if (p >= lineEnd) { continue; } // 空行
+            const size_t number = lineNumber++;
+            while (e < elements.size() && number >= elements[e].firstInstance + elements[e].count) { ++e; }
+            if (e >= elements.size()) { break; } // 全ての要素より後ろの行は使わない
+            const PlyElement& element = elements[e];
+            if (element.role == PLY_ROLE_OTHER) { continue; }
+
+            double xyz[3] = { 0.0, 0.0, 0.0 };
+            double v1 = 0.0, v2 = 0.0;
+            polygon.clear();
+            for (size_t k = 0; k < element.properties.size() && chunk.error.at == nullptr; ++k) {
+                const PlyProperty& property = element.properties[k];
+                const int index = static_cast<int>(k);
+                p = SkipSpaces(p, lineEnd);
+                double value;
+                if (!ParseNumber(p, lineEnd, value)) { chunk.error.Set(p, "PLY の値を読めませんでした"); break; }
+                if (!property.isList) {
+                    if (index == element.x) { xyz[0] = value; }
+                    else if (index == element.y) { xyz[1] = value; }
+                    else if (index == element.z) { xyz[2] = value; }
+                    else if (index == element.vertex1) { v1 = value; }
+                    else if (index == element.vertex2) { v2 = value; }
+                    continue;
+                }
+                // リスト: 要素の数に続いて要素
+                const long long itemCount = static_cast<long long>(value);
+                for (long long i = 0; i < itemCount; ++i) {
+                    p = SkipSpaces(p, lineEnd);
+                    const char* at = p;
+                    if (!ParseNumber(p, lineEnd, value)) { chunk.error.Set(p, "PLY のリストの値を読めませんでした"); break; }
+                    if (index == element.indices) {
+                        if (!sink.CheckIndex(value, at)) { break; }
+                        polygon.push_back(static_cast<uint64_t>(value));
+                    }
+                }
+            }
+            if (chunk.error.at != nullptr) { break; }
+
+            if (element.role == PLY_ROLE_VERTEX) {
+                out.SetVertex(number - element.firstInstance, { static_cast<float>(xyz[0]), static_cast<float>(xyz[1]), static_cast<float>(xyz[2]) });
+            }
+            else if (element.role == PLY_ROLE_FACE) {
+                for (size_t i = 0; i + 1 < polygon.size(); ++i) { AddEdgeKey(chunk.edges, polygon[i], polygon[i + 1]); }
+                if (polygon.size() > 2) { AddEdgeKey(chunk.edges, polygon.back(), polygon.front()); }
+            }
+            else if (element.role == PLY_ROLE_EDGE) {
+                if (sink.CheckIndex(v1, p) && sink.CheckIndex(v2, p)) {
+                    AddEdgeKey(chunk.edges, static_cast<uint64_t>(v1), static_cast<uint64_t>(v2));
+                }
+            }
+        }
+    }
+
+    // バイナリの PLY の、リストを含まない要素の範囲ごとの解析結果
+    struct PlyBinaryChunk {
+        const PlyElement* element = nullptr;
+        const char* begin = nullptr; // 最初のインスタンスの位置
+        size_t first = 0;            // 最初のインスタンスの番号 (要素の中での番号)
+        size_t count = 0;            // インスタンスの数
+        size_t stride = 0;           // 1 インスタンスの大きさ (バイト)
+        std::vector<uint64_t> edges;
+        ParseError error;
+    };
+
+    // バイナリの PLY の、リストを含まない要素 (vertex, edge) の範囲を解析する
+    void ParsePlyBinaryChunk(PlyBinaryChunk& chunk, WireMesh& out, size_t vertexCount) {
+        const PlyElement& element = *chunk.element;
+        PlyInstanceSink sink{ out, vertexCount, chunk.edges, chunk.error };
+        // 使うプロパティの、インスタンスの先頭からの位置
+        std::vector<size_t> offsets(element.properties.size());
+        size_t offset = 0;
+        for (size_t k = 0; k < element.properties.size(); ++k) { offsets[k] = offset; offset += PlyTypeSize(element.properties[k].type); }
+        auto read = [&](const char* instance, int k) { return ReadPlyBinary(instance + offsets[k], element.properties[k].type); };
+
+        for (size_t i = 0; i < chunk.count && chunk.error.at == nullptr; ++i) {
+            const char* instance = chunk.begin + i * chunk.stride;
+            if (element.role == PLY_ROLE_VERTEX) {
+                out.SetVertex(chunk.first + i, { static_cast<float>(read(instance, element.x)),
+                    static_cast<float>(read(instance, element.y)), static_cast<float>(read(instance, element.z)) });
+            }
+            else {
+                const double v1 = read(instance, element.vertex1), v2 = read(instance, element.vertex2);
+                if (sink.CheckIndex(v1, instance) && sink.CheckIndex(v2, instance)) {
+                    AddEdgeKey(chunk.edges, static_cast<uint64_t>(v1), static_cast<uint64_t>(v2));
+                }
+            }
+        }
+    }
+
+    // PLY のヘッダーを解析する。body に本体の先頭を書き込む
+    bool ParsePlyHeader(const char* data, size_t size, std::vector<PlyElement>& elements, bool& binary,
+        const char*& body, std::string* error) {
+        const char* end = data + size;
+        const char* line = data;
+        bool first = true, formatFound = false;
+        while (line < end) {
+            const char* lineEnd = FindLineEnd(line, end);
+            std::string text(line, lineEnd);
+            if (!text.empty() && text.back() == '\r') { text.pop_back(); }
+            line = lineEnd + 1;
+            if (first) {
+                if (text != "ply") { return Fail(error, "PLY ファイルではありません (先頭が ply ではありません)"); }
+                first = false;
+                continue;
+            }
+            std::istringstream words(text);
+            std::string keyword;
+            words >> keyword;
+            if (keyword == "format") {
+                std::string format;
+                words >> format;
+                if (format == "ascii") { binary = false; }
+                else if (format == "binary_little_endian") { binary = true; }
+                else { return Fail(error, "対応していない PLY の形式です: " + format); }
+                formatFound = true;
+            }
+            else if (keyword == "element") {
+                PlyElement element;
+                words >> element.name >> element.count;
+                if (!words) { return Fail(error, "PLY の element 行を読めませんでした: " + text); }
+                elements.push_back(element);
+            }
+            else if (keyword == "property") {
+                if (elements.empty()) { return Fail(error, "PLY の property 行が element 行より前にあります"); }
+                PlyProperty property;
+                std::string type;
+                words >> type;
+                if (type == "list") {
+                    std::string countType, itemType;
+                    words >> countType >> itemType;
+                    property.isList = true;
+                    property.countType = ParsePlyType(countType);
+                    property.type = ParsePlyType(itemType);
+                    if (property.countType == PlyType::Invalid) { return Fail(error, "PLY の型が不正です: " + text); }
+                }
+                else {
+                    property.type = ParsePlyType(type);
+                }
+                words >> property.name;
+                if (!words || property.type == PlyType::Invalid) { return Fail(error, "PLY の property 行を読めませんでした: " + text); }
+                elements.back().properties.push_back(property);
+            }
+            else if (keyword == "end_header") {
+                body = std::min(line, end); // end_header の後に改行がなければ、本体は空 (end を越えない)
+                if (!formatFound) { return Fail(error, "PLY の format 行がありません"); }
+                return true;
+            }
+            // comment, obj_info などは使わない
+        }
+        return Fail(error, "PLY のヘッダーが end_header で終わっていません");
+    }
+
+    // 要素の役割と、使うプロパティの番号を決める
+    bool AssignPlyRoles(std::vector<PlyElement>& elements, size_t& vertexCount, std::string* error) {
+        vertexCount = 0;
+        bool vertexFound = false;
+        size_t instance = 0;
+        for (PlyElement& element : elements) {
+            element.firstInstance = instance;
+            instance += element.count;
+            for (size_t k = 0; k < element.properties.size(); ++k) {
+                const PlyProperty& property = element.properties[k];
+                const int index = static_cast<int>(k);
+                if (!property.isList) {
+                    if (property.name == "x") { element.x = index; }
+                    else if (property.name == "y") { element.y = index; }
+                    else if (property.name == "z") { element.z = index; }
+                    else if (property.name == "vertex1") { element.vertex1 = index; }
+                    else if (property.name == "vertex2") { element.vertex2 = index; }
+                }
+                else if (property.name == "vertex_indices" || property.name == "vertex_index") {
+                    element.indices = index;
+                }
+            }
+            if (element.name == "vertex" && !vertexFound) {
+                if (element.x < 0 || element.y < 0 || element.z < 0) { return Fail(error, "PLY の vertex 要素に x, y, z がありません"); }
+                element.role = PLY_ROLE_VERTEX;
+                vertexCount = element.count;
+                vertexFound = true;
+            }
+            else if (element.name == "face" && element.indices >= 0) { element.role = PLY_ROLE_FACE; }
+            else if (element.name == "edge" && element.vertex1 >= 0 && element.vertex2 >= 0) { element.role = PLY_ROLE_EDGE; }
+        }
+        if (!vertexFound) { return Fail(error, "PLY に vertex 要素がありません"); }
+        if (vertexCount > 0xffffffffu) { return Fail(error, "PLY の頂点が多すぎます"); }
+        return true;
+    }
+
+    // バイナリの PLY の本体を解析する
+    bool ParsePlyBinary(const char* data, const char* body, const char* end, const std::vector<PlyElement>& elements,
+        size_t vertexCount, WireMesh& out, ThreadPool* pool, std::vector<std::vector<uint64_t>>& sequentialEdges,
+        std::vector<PlyBinaryChunk>& chunks, std::string* error) {
+        // リストを含む要素 (面など) はインスタンスごとに大きさが違うため、先頭から順に読む。
+        // リストを含まない要素 (頂点、辺) はインスタンスの大きさが一定なので、範囲に区切って並列に読む。
+        const char* p = body;
+        if (p == end) {
+            for (const PlyElement& element : elements) {
+                if (element.count > 0) { return Fail(error, "PLY ファイルの本体がありません (" + element.name + " 要素)"); }
+            }
+        }
+        sequentialEdges.emplace_back();
+        std::vector<uint64_t>& edges = sequentialEdges.back();
+        ParseError sequentialError;
+        PlyInstanceSink sink{ out, vertexCount, edges, sequentialError };
+        std::vector<uint64_t> polygon;
+        for (const PlyElement& element : elements) {
+            if (!element.HasList()) {
+                size_t stride = 0;
+                for (const PlyProperty& property : element.properties) { stride += PlyTypeSize(property.type); }
+                if (element.count > 0 && (stride == 0 || static_cast<size_t>(end - p) / stride < element.count)) {
+                    return Fail(error, "PLY ファイルが途中で切れています (" + element.name + " 要素)");
+                }
+                if (element.role != PLY_ROLE_OTHER) {
+                    for (size_t first = 0; first < element.count; first += PLY_BINARY_CHUNK_ELEMENTS) {
+                        PlyBinaryChunk chunk;
+                        chunk.element = &element;
+                        chunk.begin = p + first * stride;
+                        chunk.first = first;
+                        chunk.count = std::min(PLY_BINARY_CHUNK_ELEMENTS, element.count - first);
+                        chunk.stride = stride;
+                        chunks.push_back(std::move(chunk));
+                    }
+                }
+                p += element.count * stride;
+                continue;
+            }
+            // リストを含む要素を順に読む
+            for (size_t i = 0; i < element.count; ++i) {
+                polygon.clear();
+                for (size_t k = 0; k < element.properties.size(); ++k) {
+                    const PlyProperty& property = element.properties[k];
+                    if (!property.isList) {
+                        const size_t size = PlyTypeSize(property.type);
+                        if (static_cast<size_t>(end - p) < size) { return Fail(error, "PLY ファイルが途中で切れています (" + element.name + " 要素)"); }
+                        p += size;
+                        continue;
+                    }
+                    const size_t countSize = PlyTypeSize(property.countType), itemSize = PlyTypeSize(property.type);
+                    if (static_cast<size_t>(end - p) < countSize) { return Fail(error, "PLY ファイルが途中で切れています (" + element.name + " 要素)"); }
+                    const double itemCountValue = ReadPlyBinary(p, property.countType);
+                    p += countSize;
+                    const size_t itemCount = (itemCountValue > 0.0) ? static_cast<size_t>(itemCountValue) : 0;
+                    if (static_cast<size_t>(end - p) / itemSize < itemCount) { return Fail(error, "PLY ファイルが途中で切れています (" + element.name + " 要素)"); }
+                    if (element.role == PLY_ROLE_FACE && static_cast<int>(k) == element.indices) {
+                        for (size_t j = 0; j < itemCount; ++j) {
+                            const double value = ReadPlyBinary(p + j * itemSize, property.type);
+                            if (!sink.CheckIndex(value, p)) {
+                                return Fail(error, std::string(sequentialError.message) + " (ファイルの先頭から " + std::to_string(p - data) + " バイト目)");
+                            }
+                            polygon.push_back(static_cast<uint64_t>(value));
+                        }
+                    }
+                    p += itemCount * itemSize;
+                }
+                if (element.role == PLY_ROLE_FACE) {
+                    for (size_t j = 0; j + 1 < polygon.size(); ++j) { AddEdgeKey(edges, polygon[j], polygon[j + 1]); }
+                    if (polygon.size() > 2) { AddEdgeKey(edges, polygon.back(), polygon.front()); }
+                }
+            }
+        }
+
+        // リストを含まない要素の範囲を並列に読む
+        RunTasks(pool, chunks.size(), [&](size_t c) { ParsePlyBinaryChunk(chunks[c], out, vertexCount); });
+        return CheckChunkErrors(chunks, data, error);
+    }
+
+    // path の拡張子 (小文字) を返す
+    std::string GetLowerExtension(const std::string& path) {
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos) { return ""; }
+        std::string extension = path.substr(dot + 1);
+        for (char& c : extension) { if (c >= 'A' && c <= 'Z') { c = static_cast<char>(c - 'A' + 'a'); } }
+        return extension;
+    }
+}
+
+// OBJ を取り込む
+bool ImportObjWireMesh(const char* data, size_t size, WireMesh& out, ThreadPool* pool, std::string* error)
+{
+    out.Clear();
+    const char* end = data + size;
+
+    // 1. 塊に区切り、塊ごとの頂点の数を並列に数える
+    const std::vector<TextChunk> texts = SplitIntoChunks(data, end);
+    std::vector<ObjChunk> chunks(texts.size());
+    for (size_t c = 0; c < texts.size(); ++c) { chunks[c].text = texts[c]; }
+    RunTasks(pool, chunks.size(), [&](size_t c) { CountObjVertices(chunks[c]); });
+
+    // 2. 累積和から、各塊の最初の頂点の番号を決める
+    size_t vertexCount = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.vertexBase = vertexCount;
+        vertexCount += chunk.vertexCount;
+    }
+    if (vertexCount > 0xffffffffu) { return Fail(error, "OBJ の頂点が多すぎます"); }
+
+    // 3. 塊ごとに並列に解析する (頂点は out に直接書き込む)
+    out.ResizeVertices(vertexCount);
+    RunTasks(pool, chunks.size(), [&](size_t c) { ParseObjChunk(chunks[c], vertexCount, out); });
+    if (!CheckChunkErrors(chunks, data, error)) { out.Clear(); return false; }
+
+    // 4. 辺の重複を除いてまとめる
+    std::vector<std::vector<uint64_t>*> lists;
+    for (ObjChunk& chunk : chunks) { lists.push_back(&chunk.edges); }
+    MergeEdges(lists, vertexCount, pool, out);
+    return true;
+}
+
+// PLY を取り込む
+bool ImportPlyWireMesh(const char* data, size_t size, WireMesh& out, ThreadPool* pool, std::string* error)
+{
+    out.Clear();
+    const char* end = data + size;
+
+    // 1. ヘッダーを読み、使う要素とプロパティを決める
+    std::vector<PlyElement> elements;
+    bool binary = false;
+    const char* body = nullptr;
+    size_t vertexCount = 0;
+    if (!ParsePlyHeader(data, size, elements, binary, body, error) || !AssignPlyRoles(elements, vertexCount, error)) {
+        return false;
+    }
+    out.ResizeVertices(vertexCount);
+
+    std::vector<std::vector<uint64_t>*> lists;
+    if (binary) {
+        // 2. バイナリ: 要素ごとに読む (大きさが一定の要素は並列に)
+        std::vector<std::vector<uint64_t>> sequentialEdges;
+        std::vector<PlyBinaryChunk> chunks;
+        if (!ParsePlyBinary(data, body, end, elements, vertexCount, out, pool, sequentialEdges, chunks, error)) {
+            out.Clear();
+            return false;
+        }
+        for (std::vector<uint64_t>& edges : sequentialEdges) { lists.push_back(&edges); }
+        for (PlyBinaryChunk& chunk : chunks) { lists.push_back(&chunk.edges); }
+        MergeEdges(lists, vertexCount, pool, out);
+        return true;
+    }
+
+    // 2. ascii: 塊に区切り、塊ごとの行の数を並列に数えて、累積和から各塊の最初の行の番号を決める
+    const std::vector<TextChunk> texts = SplitIntoChunks(body, end);
+    std::vector<PlyChunk> chunks(texts.size());
+    for (size_t c = 0; c < texts.size(); ++c) { chunks[c].text = texts[c]; }
+    RunTasks(pool, chunks.size(), [&](size_t c) {
+        PlyChunk& chunk = chunks[c];
+        for (const char* line = chunk.text.begin; line < chunk.text.end;) {
+            const char* lineEnd = FindLineEnd(line, chunk.text.end);
+            if (SkipSpaces(line, lineEnd) < lineEnd) { ++chunk.lineCount; }
+            line = lineEnd + 1;
+        }
+    });
+    size_t lineCount = 0;
+    for (PlyChunk& chunk : chunks) {
+        chunk.firstLine = lineCount;
+        lineCount += chunk.lineCount;
+    }
+    const PlyElement* vertexElement = nullptr;
+    for (const PlyElement& element : elements) { if (element.role == PLY_ROLE_VERTEX) { vertexElement = &element; } }
+    if (lineCount < vertexElement->firstInstance + vertexElement->count) {
+        out.Clear();
+        return Fail(error, "PLY ファイルが途中で切れています (vertex 要素)");
+    }
+
+    // 3. 塊ごとに並列に解析する
+    RunTasks(pool, chunks.size(), [&](size_t c) { ParsePlyAsciiChunk(chunks[c], elements, out, vertexCount); });
+    if (!CheckChunkErrors(chunks, data, error)) { out.Clear(); return false; }
+
+    // 4. 辺の重複を除いてまとめる
+    for (PlyChunk& chunk : chunks) { lists.push_back(&chunk.edges); }
+    MergeEdges(lists, vertexCount, pool, out);
+    return true;
+}
+
+// ファイルを取り込む (拡張子で形式を判断する)
+bool ImportWireMesh(const std::string& path, WireMesh& out, ThreadPool* pool, std::string* error)
+{
+    out.Clear();
+    const std::string extension = GetLowerExtension(path);
+    if (extension != "obj" && extension != "ply") {
+        return Fail(error, "対応していない形式のファイルです (.obj または .ply): " + path);
+    }
+    MappedFile file;
+    if (!file.Open(path)) { return Fail(error, file.GetError()); }
+    const char* data = reinterpret_cast<const char*>(file.Data());
+    const bool ok = (extension == "obj") ? ImportObjWireMesh(data, file.Size(), out, pool, error)
+                                         : ImportPlyWireMesh(data, file.Size(), out, pool, error);
+    if (!ok && error != nullptr) { *error += " (" + path + ")"; }
+    return ok;
+}
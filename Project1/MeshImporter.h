@@ -0,0 +1,42 @@
+#pragma once
+#include <string>     // std::string
+#include "WireMesh.h" // WireMesh
+
+class ThreadPool;
+
+/*
+ * MeshImporter.h
+ * 役割:
+ *   外部のファイル (OBJ, PLY) からワイヤーフレームを取り込み、WireMesh (頂点 + 辺) に変換する関数を定義します。
+ *   CreateCubeMesh / CreateSphereMesh で作る図形と同じように、シーンの線分として使えます。
+ *
+ * 対応する形式:
+ *   - OBJ: `v` (頂点)、`f` (面。多角形の周囲の辺になる)、`l` (折れ線)。
+ *          頂点番号は 1 から始まる番号と、負の番号 (直前の頂点からの相対位置) に対応します。
+ *          `f 1/2/3` のような形式では、最初の番号 (頂点) だけを使います。
+ *   - PLY: ascii と binary_little_endian。`vertex` 要素の x, y, z と、
+ *          `face` 要素の頂点番号のリスト (vertex_indices / vertex_index)、`edge` 要素の vertex1, vertex2。
+ *
+ * 仕組み (大きなファイルを速く読むため):
+ *   - ファイルはメモリにマップし (MappedFile.h)、iostream を使わずに文字列を直接解析します。
+ *     数値は専用の解析関数で読みます (ロケールに依存せず、strtod などより速い)。
+ *   - テキストは行の境目でおよそ 1MB ずつの塊に区切り、塊ごとにスレッドプールで並列に解析します。
+ *     1 回目の走査で塊ごとの頂点の数 (PLY では行の数) を数え、その累積和から、
+ *     各塊の頂点を書き込む位置と負の頂点番号の基準を決めます。2 回目の走査で頂点を直接 WireMesh に書き込みます。
+ *   - 隣り合う 2 つの面が共有する辺は 1 本にまとめます。辺を (小さい番号, 大きい番号) の組にして、
+ *     小さい番号の範囲ごとのバケットに振り分け、バケットごとに並列に並べ替えて重複を除きます。
+ *     結果の辺は頂点番号の順に並ぶため、描画時の頂点のキャッシュ (WireMesh) の局所性も良くなります。
+ *   - 両端が同じ頂点の辺 (長さ 0) は取り込みません。範囲外の頂点番号があるファイルはエラーにします。
+ *
+ * 使い方:
+ *   WireMesh mesh; std::string error;
+ *   if (ImportWireMesh("site.obj", mesh, pool, &error)) { mesh.AppendSegments(worldLines); }
+ */
+
+// path のファイル (拡張子 .obj / .ply で形式を判断する) を out に取り込む (out の以前の内容は消去される)。
+// pool が nullptr でなければ並列に解析する。失敗したら false を返し、error があれば理由を書き込む。
+bool ImportWireMesh(const std::string& path, WireMesh& out, ThreadPool* pool = nullptr, std::string* error = nullptr);
+
+// OBJ / PLY の形式を指定して取り込む (data はファイルの内容全体、size はその大きさ)
+bool ImportObjWireMesh(const char* data, size_t size, WireMesh& out, ThreadPool* pool = nullptr, std::string* error = nullptr);
+bool ImportPlyWireMesh(const char* data, size_t size, WireMesh& out, ThreadPool* pool = nullptr, std::string* error = nullptr);
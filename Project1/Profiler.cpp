@@ -0,0 +1,219 @@
+#include "Profiler.h" // 対応するヘッダーファイル
+#include <algorithm>  // std::min, std::sort
+#include <cstdio>     // snprintf
+#include <fstream>    // std::ofstream (トレースの書き出し)
+
+/*
+ * Profiler.cpp
+ * 概要:
+ *   Profiler クラスの実装です。
+ *   各スレッドは thread_local のポインタで自分の ThreadData を持ち、記録はそこに加算するだけです。
+ *   ThreadData の登録 (スレッドごとに 1 回) と、集計時の一覧の走査だけが threadsMutex を使います。
+ */
+
+const size_t Profiler::HISTOGRAM_BUCKETS;
+const size_t Profiler::TRACE_EVENTS_PER_THREAD;
+
+namespace {
+    const size_t STAGE_COUNT = static_cast<size_t>(ProfileStage::Count);
+
+    const char* const STAGE_NAMES[STAGE_COUNT] = {
+        "Camera::Update", "Camera::Draw", "Draw.Cull", "Draw.Transform", "Draw.Clip", "Draw.Raster",
+        "TopAngle::Draw", "ScreenFlip" };
+
+    // 最上位のビットの位置 (value > 0)
+    int HighestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) { ++bit; }
+        return bit;
+    }
+
+    // 時間 (ナノ秒) が入るヒストグラムの区間の番号
+    // 8 未満はそのまま、それ以上は 2 のべき乗の区間を上位 3 ビットで 8 等分する
+    size_t BucketIndex(uint64_t ns) {
+        if (ns < 8) { return static_cast<size_t>(ns); }
+        const int exponent = HighestBit(ns); // 3 以上
+        const size_t mantissa = static_cast<size_t>((ns >> (exponent - 3)) & 7);
+        return static_cast<size_t>(exponent - 2) * 8 + mantissa;
+    }
+
+    // 区間の中央の時間 (ナノ秒)
+    uint64_t BucketMidpoint(size_t bucket) {
+        if (bucket < 8) { return bucket; }
+        const int exponent = static_cast<int>(bucket / 8) + 2;
+        const uint64_t lower = (8 + static_cast<uint64_t>(bucket % 8)) << (exponent - 3);
+        const uint64_t width = uint64_t(1) << (exponent - 3);
+        return lower + width / 2;
+    }
+
+    // 書き込むのは所有スレッドだけなので、fetch_add ではなく読んで書くだけで足りる (ロック命令を使わない)
+    void AddRelaxed(std::atomic<uint64_t>& target, uint64_t value) {
+        target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+}
+
+// 段階の名前
+const char* GetProfileStageName(ProfileStage stage)
+{
+    const size_t index = static_cast<size_t>(stage);
+    return index < STAGE_COUNT ? STAGE_NAMES[index] : "?";
+}
+
+// スレッド 1 本分の記録を 0 で初期化する
+Profiler::ThreadData::ThreadData()
+{
+    for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+        for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            buckets[stage][bucket].store(0, std::memory_order_relaxed);
+        }
+        totalNs[stage].store(0, std::memory_order_relaxed);
+        maxNs[stage].store(0, std::memory_order_relaxed);
+    }
+}
+
+// 現在のスレッドの記録
+Profiler::ThreadData& Profiler::GetThreadData()
+{
+    thread_local ThreadData* data = nullptr;
+    if (data == nullptr) {
+        std::unique_ptr<ThreadData> created(new ThreadData());
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        created->threadIndex = static_cast<uint32_t>(threads.size());
+        data = created.get();
+        threads.push_back(std::move(created));
+    }
+    return *data;
+}
+
+// 記録を追加する
+void Profiler::Record(ProfileStage stage, uint64_t startNs, uint64_t durationNs)
+{
+    ThreadData& data = GetThreadData();
+    const size_t index = static_cast<size_t>(stage);
+    AddRelaxed(data.buckets[index][std::min(BucketIndex(durationNs), HISTOGRAM_BUCKETS - 1)], 1);
+    AddRelaxed(data.totalNs[index], durationNs);
+    if (durationNs > data.maxNs[index].load(std::memory_order_relaxed)) {
+        data.maxNs[index].store(durationNs, std::memory_order_relaxed);
+    }
+
+    if (traceCapture.load(std::memory_order_relaxed)) {
+        if (!data.eventStart) {
+            // トレースを有効にしてから初めての記録で領域を確保する (所有スレッドだけが確保する)
+            data.eventStart.reset(new std::atomic<uint64_t>[TRACE_EVENTS_PER_THREAD]);
+            data.eventPacked.reset(new std::atomic<uint64_t>[TRACE_EVENTS_PER_THREAD]);
+        }
+        const uint64_t count = data.eventCount.load(std::memory_order_relaxed);
+        const size_t slot = static_cast<size_t>(count % TRACE_EVENTS_PER_THREAD);
+        data.eventStart[slot].store(startNs, std::memory_order_relaxed);
+        data.eventPacked[slot].store((durationNs << 8) | index, std::memory_order_relaxed);
+        data.eventCount.store(count + 1, std::memory_order_release); // 書き込んだイベントを公開する
+    }
+}
+
+// 全スレッドのヒストグラムを合わせて集計する
+ProfileStageSummary Profiler::Summarize(ProfileStage stage) const
+{
+    const size_t index = static_cast<size_t>(stage);
+    std::vector<uint64_t> merged(HISTOGRAM_BUCKETS, 0);
+    ProfileStageSummary summary;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto& data : threads) {
+            for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+                const uint64_t n = data->buckets[index][bucket].load(std::memory_order_relaxed);
+                merged[bucket] += n;
+                summary.count += n;
+            }
+            summary.totalNs += data->totalNs[index].load(std::memory_order_relaxed);
+            summary.maxNs = std::max(summary.maxNs, data->maxNs[index].load(std::memory_order_relaxed));
+        }
+    }
+    if (summary.count == 0) { return summary; }
+
+    // 小さい区間から数えて、全体の 50% / 99% に達した区間の中央の値をパーセンタイルとする
+    const uint64_t p50Rank = (summary.count * 50 + 99) / 100;
+    const uint64_t p99Rank = (summary.count * 99 + 99) / 100;
+    uint64_t seen = 0;
+    bool p50Found = false;
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        seen += merged[bucket];
+        if (!p50Found && seen >= p50Rank) { summary.p50Ns = BucketMidpoint(bucket); p50Found = true; }
+        if (seen >= p99Rank) { summary.p99Ns = BucketMidpoint(bucket); break; }
+    }
+    // 区間の中央の値が実際の最大値を超えないようにする
+    summary.p50Ns = std::min(summary.p50Ns, summary.maxNs);
+    summary.p99Ns = std::min(summary.p99Ns, summary.maxNs);
+    return summary;
+}
+
+// 全段階の集計結果を表形式の文字列にする
+std::string Profiler::FormatReport() const
+{
+    std::string report = "stage              count      mean(us)   p50(us)    p99(us)    max(us)\n";
+    char line[160];
+    for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+        const ProfileStageSummary s = Summarize(static_cast<ProfileStage>(stage));
+        if (s.count == 0) { continue; }
+        snprintf(line, sizeof(line), "%-18s %-10llu %-10.1f %-10.1f %-10.1f %.1f\n", STAGE_NAMES[stage],
+            static_cast<unsigned long long>(s.count), s.totalNs / 1000.0 / s.count,
+            s.p50Ns / 1000.0, s.p99Ns / 1000.0, s.maxNs / 1000.0);
+        report += line;
+    }
+    return report;
+}
+
+// Chrome のトレースイベント形式で書き出す
+bool Profiler::ExportChromeTrace(const std::string& path, std::string* error) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        if (error != nullptr) { *error = "トレースファイルを書き込み用に開けませんでした: " + path; }
+        return false;
+    }
+
+    // 完了イベント ("ph":"X") を時刻の順に並べる必要はない (ビューアーが並べ替える)
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    char event[256];
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (const auto& data : threads) {
+        if (!data->eventStart) { continue; }
+        const uint64_t count = data->eventCount.load(std::memory_order_acquire);
+        const uint64_t begin = (count > TRACE_EVENTS_PER_THREAD) ? count - TRACE_EVENTS_PER_THREAD : 0;
+        for (uint64_t i = begin; i < count; ++i) {
+            const size_t slot = static_cast<size_t>(i % TRACE_EVENTS_PER_THREAD);
+            const uint64_t startNs = data->eventStart[slot].load(std::memory_order_relaxed);
+            const uint64_t packed = data->eventPacked[slot].load(std::memory_order_relaxed);
+            const size_t stage = static_cast<size_t>(packed & 0xFF);
+            if (stage >= STAGE_COUNT) { continue; }
+            // 時刻はマイクロ秒 (小数で ns まで)
+            snprintf(event, sizeof(event), "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", STAGE_NAMES[stage], data->threadIndex, startNs / 1000.0, (packed >> 8) / 1000.0);
+            out << event;
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        if (error != nullptr) { *error = "トレースファイルの書き込みに失敗しました: " + path; }
+        return false;
+    }
+    return true;
+}
+
+// 全スレッドの記録を消す
+void Profiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (const auto& data : threads) {
+        for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+            for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+                data->buckets[stage][bucket].store(0, std::memory_order_relaxed);
+            }
+            data->totalNs[stage].store(0, std::memory_order_relaxed);
+            data->maxNs[stage].store(0, std::memory_order_relaxed);
+        }
+        data->eventCount.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <atomic>  // std::atomic (スレッドごとのヒストグラムと記録)
+#include <chrono>  // std::chrono::steady_clock
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <memory>  // std::unique_ptr
+#include <mutex>   // std::mutex (スレッドの登録)
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+/*
+ * Profiler.h
+ * 役割:
+ *   フレームの処理の段階 (Camera::Update, Camera::Draw とその中の変換・クリッピング・描画, TopAngle::Draw,
+ *   ScreenFlip) ごとにかかった時間を測り、段階ごとのヒストグラムから p50 / p99 / 最大値を求める
+ *   軽量なプロファイラです。フレームが予定の時間を超えたときに、どの段階が原因かを調べるために使います。
+ *
+ * 仕組み:
+ *   - 測りたい範囲の先頭に `PROFILE_SCOPE(ProfileStage::CameraDraw);` と書くと、その範囲 (スコープ) を
+ *     抜けるまでの時間が記録されます。
+ *   - 記録は、記録したスレッド専用のヒストグラムに加算されます。スレッドごとに別の領域なので、
+ *     ThreadPool のワーカーから同時に記録してもロックは不要です。値は atomic (relaxed) で書き込むため、
+ *     集計 (Summarize) はいつでも、どのスレッドからでも行えます。
+ *   - ヒストグラムは、2 のべき乗の区間をさらに 8 等分した区間 (誤差 12.5% 以内) で時間 (ナノ秒) を数えます。
+ *   - `SetTraceCapture(true)` にすると、各スレッドの直近 TRACE_EVENTS_PER_THREAD 件の記録 (開始時刻と長さ) も残し、
+ *     `ExportChromeTrace` で Chrome のトレースイベント形式 (chrome://tracing や Perfetto で開ける JSON) に書き出せます。
+ *
+ * コンパイル時の無効化:
+ *   プリプロセッサ定義で `PROFILER_ENABLED=0` にすると、PROFILE_SCOPE は何もしない文になり、
+ *   時刻の取得も記録もコードから完全に取り除かれます (既定は 1)。
+ *
+ * 使い方:
+ *   { PROFILE_SCOPE(ProfileStage::CameraUpdate); camera->Update(); }
+ *   // 終了時
+ *   LOG_INFO(Profiler::GetInstance().FormatReport());
+ *   Profiler::GetInstance().ExportChromeTrace("profile_trace.json");
+ */
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// 時間を測る処理の段階
+enum class ProfileStage {
+    CameraUpdate,   // Camera::Update
+    CameraDraw,     // Camera::Draw 全体
+    DrawCull,       // Camera::Draw: BVH の視錐台カリング
+    DrawTransform,  // Camera::Draw: クリップ座標への変換 (ブロックごと。ワーカースレッドでも記録される)
+    DrawClip,       // Camera::Draw: アウトコード・クリッピング・スクリーン座標への変換 (同上)
+    DrawRaster,     // Camera::Draw: 描画コマンドの記録と描画先への描画
+    TopAngleDraw,   // TopAngle::Draw
+    ScreenFlip,     // ScreenFlip
+    Count           // 段階の数 (段階ではない)
+};
+
+// 段階の名前 (レポートとトレースの出力に使う)
+const char* GetProfileStageName(ProfileStage stage);
+
+// 1 つの段階の集計結果 (時間はナノ秒。p50 / p99 はヒストグラムの区間の中央の値)
+struct ProfileStageSummary {
+    uint64_t count = 0;   // 記録の数
+    uint64_t totalNs = 0; // 合計
+    uint64_t p50Ns = 0;   // 中央値
+    uint64_t p99Ns = 0;   // 99 パーセンタイル
+    uint64_t maxNs = 0;   // 最大値
+};
+
+class Profiler
+{
+public:
+    // ヒストグラムの区間の数 (2 のべき乗の区間 64 個 × 8 分割)
+    static const size_t HISTOGRAM_BUCKETS = 64 * 8;
+    // スレッドごとに残すトレースイベントの数 (古いものから上書きされる)
+    static const size_t TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+    static Profiler& GetInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    // 現在のスレッドで、stage に startNs から durationNs かかった記録を追加する (時刻は NowNs の値)
+    void Record(ProfileStage stage, uint64_t startNs, uint64_t durationNs);
+    // プロファイラの基準時刻からの経過時間 (ナノ秒)
+    uint64_t NowNs() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    // トレースイベントを残すかどうか (既定は false。true にするとスレッドごとに約 1MB の領域を使う)
+    void SetTraceCapture(bool enabled) { traceCapture.store(enabled, std::memory_order_relaxed); }
+    bool IsTraceCapture() const { return traceCapture.load(std::memory_order_relaxed); }
+
+    // 全スレッドのヒストグラムを合わせて、stage の集計結果を返す
+    ProfileStageSummary Summarize(ProfileStage stage) const;
+    // 全段階の集計結果を表形式の文字列にする (時間はマイクロ秒)
+    std::string FormatReport() const;
+    // 残っているトレースイベントを Chrome のトレースイベント形式で path に書き出す
+    // (トレースの領域は各スレッドが最初の記録で確保するので、記録が止まってから呼ぶこと)。
+    // 失敗したら false を返し、error があれば理由を書き込む。
+    bool ExportChromeTrace(const std::string& path, std::string* error = nullptr) const;
+    // 全スレッドの記録を消す (記録中のスレッドがない状態で呼ぶこと)
+    void Reset();
+
+private:
+    // スレッド 1 本分の記録 (そのスレッドだけが書き込み、集計は他のスレッドからも読む)
+    struct ThreadData {
+        uint32_t threadIndex = 0; // 登録順の番号 (トレースの tid)
+        std::atomic<uint64_t> buckets[static_cast<size_t>(ProfileStage::Count)][HISTOGRAM_BUCKETS];
+        std::atomic<uint64_t> totalNs[static_cast<size_t>(ProfileStage::Count)];
+        std::atomic<uint64_t> maxNs[static_cast<size_t>(ProfileStage::Count)];
+        // トレースイベント (開始時刻と「長さ << 8 | 段階」の組。eventCount が書き込んだ数)
+        std::unique_ptr<std::atomic<uint64_t>[]> eventStart;
+        std::unique_ptr<std::atomic<uint64_t>[]> eventPacked;
+        std::atomic<uint64_t> eventCount{ 0 };
+        ThreadData();
+    };
+
+    // 現在のスレッドの記録 (初めて呼ばれたときに登録する)
+    ThreadData& GetThreadData();
+
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now(); // NowNs の基準
+    std::atomic<bool> traceCapture{ false };
+    mutable std::mutex threadsMutex;                 // threads の追加と走査を保護する (記録の加算では使わない)
+    std::vector<std::unique_ptr<ThreadData>> threads; // 登録された全スレッドの記録 (プログラム終了まで残す)
+
+    Profiler() = default;
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+};
+
+// スコープに入ってから抜けるまでの時間を記録するクラス (PROFILE_SCOPE から使う)
+class ScopedProfileTimer
+{
+public:
+    explicit ScopedProfileTimer(ProfileStage stage) : stage(stage), startNs(Profiler::GetInstance().NowNs()) {}
+    ~ScopedProfileTimer() {
+        Profiler& profiler = Profiler::GetInstance();
+        profiler.Record(stage, startNs, profiler.NowNs() - startNs);
+    }
+
+private:
+    ProfileStage stage;
+    uint64_t startNs;
+    ScopedProfileTimer(const ScopedProfileTimer&) = delete;
+    ScopedProfileTimer& operator=(const ScopedProfileTimer&) = delete;
+};
+
+// スコープの終わりまでの時間を stage として記録する (PROFILER_ENABLED が 0 なら何もしない)
+#if PROFILER_ENABLED
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(stage) ScopedProfileTimer PROFILER_CONCAT(profileScope_, __LINE__)(stage)
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#endif
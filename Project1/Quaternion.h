@@ -1,132 +1,120 @@
 #pragma once
-#include <cmath>     // sqrtf, sinf, cosf Ȃ (<math.h> 萄)
-#include "Vector.h" // Vector3D gp
-#include "Matrix.h" // Matrix gp
-#include <sstream> // fobOOp (stringstream)
-#include <iomanip> // fobOOp (setprecision)
-#include "Logger.h" // fobOOp (LogDebug) (KvȂCN[h)
+#include <cmath>     // sqrtf, sinf, cosf など (<math.h> より推奨)
+#include "Vector.h" // Vector3D を使用
+#include "Matrix.h" // Matrix を使用
+#include "Logger.h" // デバッグログ用 (LOG_TRACE)
 
 /*
  * Quaternion.h
- * :
- *   3DԂɂu]v\A삷邽߂̃NH[^jIiljNX`܂B
- *   IC[piXYZ̉]pxjWobN̖肪ȂA]̍eՂł邽߁A
- *   3DQ[V~[ṼJAIuWFNg̎pȂǂōLp܂B
+ * 役割:
+ *   3D空間における「回転」を表現し、操作するためのクォータニオン（四元数）クラスを定義します。
+ *   オイラー角（XYZ軸周りの回転角度）よりもジンバルロックの問題がなく、回転の合成が容易であるため、
+ *   3Dゲームやシミュレーションのカメラ制御、オブジェクトの姿勢制御などで広く利用されます。
  *
- * ȋ@\:
- *   - `Quaternion` \: NH[^jI4̗vf (x, y, z, w) ێ܂B
- *   - PʃNH[^jI (`Identity`) AƊpx̐ (`FromAxisAngle`) ȂǁA
- *     {IȃNH[^jI쐬֐񋟂܂B
- *   - NH[^jIm̏Z (`operator*`) ɂA]ł܂B
- *   - ̌vZ (`Length`), K (`Normalize`),  (`Conjugate`) ȂǁA
- *     NH[^jI̊{Iȑ񋟂܂B
- *   - ]sւ̕ϊ (`ToRotationMatrix`) @\񋟂܂B
- *   - (RgAEgĂ܂) xNgNH[^jIŉ] `RotateVector` @\B
+ * 主な機能:
+ *   - `Quaternion` 構造体: クォータニオンの4つの要素 (x, y, z, w) を保持します。
+ *   - 単位クォータニオン (`Identity`) や、軸と角度からの生成 (`FromAxisAngle`) など、
+ *     基本的なクォータニオンを作成する関数を提供します。
+ *   - クォータニオン同士の乗算 (`operator*`) により、回転を合成できます。
+ *   - 長さの計算 (`Length`), 正規化 (`Normalize`), 共役 (`Conjugate`) など、
+ *     クォータニオンの基本的な操作を提供します。
+ *   - 回転行列への変換 (`ToRotationMatrix`) 機能を提供します。
+ *   - (コメントアウトされていますが) ベクトルをクォータニオンで回転させる `RotateVector` 機能。
  *
- * ̃o[Wł̕ύX_ (ȑO Quaternion.h ):
- * - oOC: `ToRotationMatrix` ֐ňꎞϐ `yw` ̌vZĂ̂C܂ (`qy * qz` -> `qy * qw`)B
- * - fobOO̒ǉ: `FromAxisAngle`, `ToRotationMatrix` ֐ɁA
- *   ͒lvZʂOt@Cɏo͂邽߂ `LogDebug` Ăяoǉ܂B
- * - `ToRotationMatrix` ł̐K: ]sɕϊOɁANH[^jIŐK鏈ǉĂ܂B
+ * このバージョンでの変更点 (以前の Quaternion.h から):
+ * - バグ修正: `ToRotationMatrix` 関数内で一時変数 `yw` の計算式が誤っていたのを修正しました (`qy * qz` -> `qy * qw`)。
+ * - デバッグログの追加: `FromAxisAngle`, `ToRotationMatrix` 関数内に、
+ *   入力値や計算結果をログファイルに出力するための `LogDebug` 呼び出しが追加されました。
+ *   - 毎フレーム何度も呼ばれるため、現在は Trace レベルの `LOG_TRACE` で出力しています。
+ *     リリースビルドではコードから取り除かれ、実行時に Trace が無効ならメッセージは組み立てられません。
+ * - `ToRotationMatrix` での正規化: 回転行列に変換する前に、クォータニオンを内部で正規化する処理が追加されています。
  */
 
 struct Quaternion
 {
-    float x, y, z, w; // NH[^jI̐ (x, y, z: xNg, w: XJ[)
+    float x, y, z, w; // クォータニオンの成分 (x, y, z: ベクトル部, w: スカラー部)
 
-    // ftHgRXgN^ (PʃNH[^jIŏ)
+    // デフォルトコンストラクタ (単位クォータニオンで初期化)
     Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
-    // ew肵ďRXgN^
+    // 各成分を指定して初期化するコンストラクタ
     Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
 
-    // ÓI\bh: PʃNH[^jI (]Ȃ) Ԃ
+    // 静的メソッド: 単位クォータニオン (回転なし) を返す
     static Quaternion Identity() { return Quaternion(0.0f, 0.0f, 0.0f, 1.0f); }
 
-    // ÓI\bh: w肳ꂽ `axis`  `angle` (WA) ]NH[^jI𐶐
+    // 静的メソッド: 指定された軸 `axis` 周りに `angle` (ラジアン) 回転するクォータニオンを生成
     static Quaternion FromAxisAngle(const Vector3D& axis, float angle) {
-        // --- fobOOo͊Jn ---
-        std::stringstream ss_log;
-        ss_log << std::fixed << std::setprecision(4); // _ȉ4\
-        ss_log << "[QuatFAA] Input Axis(" << axis.x << "," << axis.y << "," << axis.z
-            << ") Angle(" << angle * 180.0f / PI << " deg)"; // PICommon.hŒ`Ăz
-
         float halfAngle = angle * 0.5f;
         float s = sinf(halfAngle);
         float c = cosf(halfAngle);
-        Vector3D normalizedAxis = axis.Normalized(); // ]͕KK
-
-        ss_log << " NormAxis(" << normalizedAxis.x << "," << normalizedAxis.y << "," << normalizedAxis.z << ")";
+        Vector3D normalizedAxis = axis.Normalized(); // 回転軸は必ず正規化する
 
         Quaternion result(normalizedAxis.x * s, normalizedAxis.y * s, normalizedAxis.z * s, c);
 
-        ss_log << " Result(" << result.x << "," << result.y << "," << result.z << "," << result.w << ")";
-        LogDebug(ss_log.str()); // ObZ[W Logger ɏ
-        // --- fobOOo͏I ---
+        // デバッグログ (Trace レベルが無効なら、メッセージは組み立てられない)
+        LOG_TRACE("[QuatFAA] Input Axis(" << axis.x << "," << axis.y << "," << axis.z
+            << ") Angle(" << angle * 180.0f / PI << " deg)" // PIはCommon.hで定義されている想定
+            << " NormAxis(" << normalizedAxis.x << "," << normalizedAxis.y << "," << normalizedAxis.z << ")"
+            << " Result(" << result.x << "," << result.y << "," << result.z << "," << result.w << ")");
 
         return result;
     }
 
-    // NH[^jȈZ (]̍: result = this * q2)
+    // クォータニオンの乗算 (回転の合成: result = this * q2)
     Quaternion operator*(const Quaternion& q2) const {
-        /* ȗ: ̃R[h̏ڍ׎ */
+        /* 省略: 元のコードの詳細実装 */
         Quaternion result; result.w = w * q2.w - x * q2.x - y * q2.y - z * q2.z; result.x = w * q2.x + x * q2.w + y * q2.z - z * q2.y; result.y = w * q2.y - x * q2.z + y * q2.w + z * q2.x; result.z = w * q2.z + x * q2.y - y * q2.x + z * q2.w; return result;
     }
-    // ZĎgɑ (this = this * q2)
+    // 乗算して自身に代入 (this = this * q2)
     Quaternion& operator*=(const Quaternion& q2) {
         *this = *this * q2;
         return *this;
     }
 
-    // NH[^jI̒2vZ
+    // クォータニオンの長さの2乗を計算
     float LengthSq() const { return x * x + y * y + z * z + w * w; }
-    // NH[^jI̒vZ
+    // クォータニオンの長さを計算
     float Length() const { return sqrtf(LengthSq()); }
 
-    // NH[^jI𐳋K (1ɂ)
+    // クォータニオンを正規化する (長さを1にする)
     void Normalize() {
-        /* ȗ: ̃R[h̏ڍ׎ */
+        /* 省略: 元のコードの詳細実装 */
         float len = Length(); if (len > 1e-6f) { float invLen = 1.0f / len; x *= invLen; y *= invLen; z *= invLen; w *= invLen; }
         else { *this = Identity(); }
     }
-    // KꂽVNH[^jIԂ
+    // 正規化された新しいクォータニオンを返す
     Quaternion Normalized() const { Quaternion result = *this; result.Normalize(); return result; }
-    // NH[^jI (xNg̕𔽓]) Ԃ
+    // 共役クォータニオン (ベクトル部の符号を反転) を返す
     Quaternion Conjugate() const { return Quaternion(-x, -y, -z, w); }
 
-    // ̃NH[^jI\]4x4̉]sɕϊ
+    // このクォータニオンが表す回転を4x4の回転行列に変換する
     Matrix ToRotationMatrix() const {
-        // --- fobOOo͊Jn ---
-        std::stringstream ss_log;
-        ss_log << std::fixed << std::setprecision(4);
-        ss_log << "[QuatToMat] Input Quat(" << x << "," << y << "," << z << "," << w << ")";
-
         Matrix result = Matrix::Identity();
-        Quaternion q = this->Normalized(); // vZOɐK
-
-        ss_log << " NormQuat(" << q.x << "," << q.y << "," << q.z << "," << q.w << ")";
+        Quaternion q = this->Normalized(); // 計算前に正規化
 
         float qx = q.x, qy = q.y, qz = q.z, qw = q.w;
         float xx = qx * qx; float yy = qy * qy; float zz = qz * qz;
         float xy = qx * qy; float xz = qx * qz; float xw = qx * qw;
-        //  oOC: yw ̌vZC 
-        float yz = qy * qz; float yw = qy * qw; float zw = qz * qw; //  yw = qy * qz 
+        // ★★ バグ修正: yw の計算式を修正 ★★
+        float yz = qy * qz; float yw = qy * qw; float zw = qz * qw; // 元は yw = qy * qz だった
 
-        // NH[^jI]sւ̕ϊ
+        // クォータニオンから回転行列への変換公式
         result.m[0][0] = 1.0f - 2.0f * (yy + zz); result.m[0][1] = 2.0f * (xy + zw); result.m[0][2] = 2.0f * (xz - yw);
         result.m[1][0] = 2.0f * (xy - zw); result.m[1][1] = 1.0f - 2.0f * (xx + zz); result.m[1][2] = 2.0f * (yz + xw);
         result.m[2][0] = 2.0f * (xz + yw); result.m[2][1] = 2.0f * (yz - xw); result.m[2][2] = 1.0f - 2.0f * (xx + yy);
 
-        ss_log << " ResultMat[0](" << result.m[0][0] << "," << result.m[0][1] << "," << result.m[0][2] << ")";
-        LogDebug(ss_log.str());
-        // --- fobOOo͏I ---
+        // デバッグログ (Trace レベルが無効なら、メッセージは組み立てられない)
+        LOG_TRACE("[QuatToMat] Input Quat(" << x << "," << y << "," << z << "," << w << ")"
+            << " NormQuat(" << q.x << "," << q.y << "," << q.z << "," << q.w << ")"
+            << " ResultMat[0](" << result.m[0][0] << "," << result.m[0][1] << "," << result.m[0][2] << ")");
 
         return result;
     }
 
-    // xNg̃NH[^jIŉ]֐ (RgAEg)
+    // ベクトルをこのクォータニオンで回転させる関数 (コメントアウト中)
     /*
     Vector3D RotateVector(const Vector3D& v) const {
-        // :
+        // 実装例:
         // Quaternion p(v.x, v.y, v.z, 0.0f);
         // Quaternion q_inv = this->Conjugate();
         // Quaternion rotated_p = (*this) * p * q_inv;
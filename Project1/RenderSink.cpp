@@ -0,0 +1,17 @@
+#include "RenderSink.h"      // 対応するヘッダーファイル
+#include "DrawCommandList.h" // DrawCommandList, LineCommand
+
+/*
+ * RenderSink.cpp
+ * 概要:
+ *   RenderSink の既定の Submit の実装です。
+ *   描画コマンドリストの線を記録順に 1 本ずつ DrawLine / DrawLineAA に渡します。
+ *   DrawLine の座標は、以前 Camera::Draw で行っていたのと同じく int への切り捨てで変換します。
+ */
+
+void RenderSink::Submit(const DrawCommandList& commands) {
+    for (const LineCommand& c : commands) {
+        if (c.antialias) { DrawLineAA(c.x1, c.y1, c.x2, c.y2, c.color); }
+        else { DrawLine(static_cast<int>(c.x1), static_cast<int>(c.y1), static_cast<int>(c.x2), static_cast<int>(c.y2), c.color); }
+    }
+}
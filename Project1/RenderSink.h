@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint> // uint32_t
+
+/*
+ * RenderSink.h
+ * 役割:
+ *   画面への描画命令 (線、ボックス、円、文字列など) を受け取る「描画先」のインターフェース
+ *   `RenderSink` を定義します。
+ *   以前は Camera::Draw、TopAngle::Draw、Main.cpp から DxLib の関数 (DrawLine, DrawLineAA,
+ *   DrawBox, DrawCircle など) を直接呼んでいたため、Windows のウィンドウがないと描画処理を
+ *   動かせませんでした。描画をこのインターフェース経由にすることで、描画先を差し替えられます。
+ *
+ * 実装クラス:
+ *   - `DxLibRenderSink` (DxLibRenderSink.h): これまで通り DxLib の関数で画面に描画します。
+ *   - `SoftwareRenderSink` (SoftwareRenderSink.h): メモリ上の RGBA フレームバッファに自前で描画し、
+ *     PPM 画像として保存できます。ウィンドウのない環境 (Linux のサーバーなど) でも動作します。
+ *
+ * 座標と色:
+ *   - 座標はスクリーン座標 (ピクセル単位、左上が原点、Y は下向き) です。
+ *   - 色は `GetRenderColor(r, g, b)` で作る 0xRRGGBB 形式の値です (DxLib の GetColor に相当)。
+ *   - ボックスとクリップ範囲は、DxLib と同じく右端・下端の座標を含みません。
+ *
+ * まとめて描画:
+ *   - 大量の線は、`DrawCommandList` に記録してから `Submit` で一度に渡します。
+ *     DxLib 版は 1 回の DrawPrimitive2D にまとめ、ソフトウェア版は 1 回のループでラスタライズします。
+ *
+ * 使い方:
+ *   void DrawSomething(RenderSink& sink) {
+ *       sink.DrawLine(0, 0, 100, 100, GetRenderColor(255, 255, 255));
+ *   }
+ */
+
+// 描画色 (0xRRGGBB 形式)
+typedef uint32_t RenderColor;
+
+// R, G, B (各 0～255) から描画色を作る (DxLib の GetColor に相当)
+inline RenderColor GetRenderColor(int r, int g, int b) {
+    return (static_cast<RenderColor>(r & 0xFF) << 16) | (static_cast<RenderColor>(g & 0xFF) << 8) | static_cast<RenderColor>(b & 0xFF);
+}
+// 描画色から R, G, B の各成分を取り出す
+inline int GetRenderColorR(RenderColor color) { return static_cast<int>((color >> 16) & 0xFF); }
+inline int GetRenderColorG(RenderColor color) { return static_cast<int>((color >> 8) & 0xFF); }
+inline int GetRenderColorB(RenderColor color) { return static_cast<int>(color & 0xFF); }
+
+class DrawCommandList; // 前方宣言 (描画コマンドリスト。定義は DrawCommandList.h)
+
+class RenderSink
+{
+public:
+    virtual ~RenderSink() {}
+
+    // 描画先全体を背景色で塗りつぶす (DxLib の ClearDrawScreen に相当)
+    virtual void Clear() = 0;
+
+    // 線を描画する (アンチエイリアスなし。DxLib の DrawLine に相当)
+    virtual void DrawLine(int x1, int y1, int x2, int y2, RenderColor color) = 0;
+    // 線を描画する (アンチエイリアス付き、座標は小数で指定。DxLib の DrawLineAA に相当)
+    virtual void DrawLineAA(float x1, float y1, float x2, float y2, RenderColor color) = 0;
+    // ボックスを描画する。fill が true なら塗りつぶし、false なら枠線のみ (DxLib の DrawBox に相当)
+    virtual void DrawBox(int x1, int y1, int x2, int y2, RenderColor color, bool fill) = 0;
+    // 円を描画する。fill が true なら塗りつぶし、false なら円周のみ (DxLib の DrawCircle に相当)
+    virtual void DrawCircle(int x, int y, int radius, RenderColor color, bool fill) = 0;
+    // 文字列を描画する (DxLib の DrawString に相当。フォントを持たない描画先では何もしない)
+    virtual void DrawString(int x, int y, const char* text, RenderColor color) = 0;
+
+    // 以降の描画の不透明度を設定する (0～255)。255 で通常の上書き描画に戻る
+    // (DxLib の SetDrawBlendMode(DX_BLENDMODE_ALPHA, alpha) / DX_BLENDMODE_NOBLEND に相当)
+    virtual void SetBlendAlpha(int alpha) = 0;
+    // 以降の描画を、矩形 [x1, x2) × [y1, y2) の範囲内に限定する (DxLib の SetDrawArea に相当)
+    virtual void SetClipRect(int x1, int y1, int x2, int y2) = 0;
+    // 描画範囲の限定を解除し、描画先全体に戻す
+    virtual void ResetClipRect() = 0;
+
+    // 描画コマンドリストの線を、記録された順にまとめて描画する (DrawCommandList.h)
+    // 既定の実装 (RenderSink.cpp) は 1 本ずつ DrawLine / DrawLineAA を呼ぶだけなので、
+    // まとめて描く手段を持つ描画先はこれをオーバーライドする
+    virtual void Submit(const DrawCommandList& commands);
+};
+
@@ -0,0 +1,146 @@
+#include "SceneFile.h"  // 対応するヘッダーファイル
+#include "MappedFile.h" // MappedFile (読み込み時のメモリマップ)
+#include <cstring>      // memcmp, memcpy
+#include <fstream>      // std::ofstream
+#include <memory>       // std::shared_ptr, std::make_shared
+#include <vector>       // std::vector
+
+/*
+ * SceneFile.cpp
+ * 概要:
+ *   シーンファイル (.wfscene) の書き出しと読み込みの実装です。
+ *   書き出しは配列をそのままファイルに書くだけで、読み込みはヘッダーの値を確かめてから
+ *   マップした領域を指すポインタを作るだけです。どちらも線分 1 本ずつの変換は行いません。
+ */
+
+const char SCENE_FILE_MAGIC[8] = { 'W', 'F', 'S', 'C', 'E', 'N', 'E', '\0' };
+
+namespace {
+    // offset を SCENE_FILE_ALIGNMENT の倍数に切り上げる
+    uint64_t AlignOffset(uint64_t offset) {
+        return (offset + SCENE_FILE_ALIGNMENT - 1) / SCENE_FILE_ALIGNMENT * SCENE_FILE_ALIGNMENT;
+    }
+
+    // error が nullptr でなければ message を書き込み、false を返す (エラーで return するときに使う)
+    bool Fail(std::string* error, const std::string& message) {
+        if (error != nullptr) { *error = message; }
+        return false;
+    }
+
+    // 線分の座標配列と、(あれば) BVH のノードをファイルに書き出す
+    bool WriteScene(const std::string& path, const SegmentBuffer& segments, const std::vector<BVHNode>* nodes, std::string* error) {
+        const uint64_t pointCount = segments.PointCount();
+        const uint64_t arrayBytes = pointCount * sizeof(float);
+        const uint64_t nodeCount = (nodes != nullptr) ? nodes->size() : 0;
+
+        // 各配列の位置を決める
+        SceneFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+        header.version = SCENE_FILE_VERSION;
+        header.headerSize = sizeof(SceneFileHeader);
+        header.segmentCount = segments.Size();
+        header.xOffset = AlignOffset(sizeof(SceneFileHeader));
+        header.yOffset = AlignOffset(header.xOffset + arrayBytes);
+        header.zOffset = AlignOffset(header.yOffset + arrayBytes);
+        header.nodeCount = nodeCount;
+        header.nodeOffset = (nodeCount > 0) ? AlignOffset(header.zOffset + arrayBytes) : 0;
+        header.nodeSize = sizeof(BVHNode);
+        header.fileSize = (nodeCount > 0) ? header.nodeOffset + nodeCount * sizeof(BVHNode) : header.zOffset + arrayBytes;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) { return Fail(error, "シーンファイルを書き込み用に開けませんでした: " + path); }
+
+        // 現在の位置から offset まで 0 で埋めて、data を size バイト書く
+        uint64_t position = 0;
+        auto writeAt = [&](uint64_t offset, const void* data, uint64_t size) {
+            static const char zeros[SCENE_FILE_ALIGNMENT] = {};
+            file.write(zeros, static_cast<std::streamsize>(offset - position));
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            position = offset + size;
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.xOffset, segments.X(), arrayBytes);
+        writeAt(header.yOffset, segments.Y(), arrayBytes);
+        writeAt(header.zOffset, segments.Z(), arrayBytes);
+        if (nodeCount > 0) { writeAt(header.nodeOffset, nodes->data(), nodeCount * sizeof(BVHNode)); }
+
+        file.close();
+        if (!file) { return Fail(error, "シーンファイルの書き込みに失敗しました: " + path); }
+        return true;
+    }
+
+    // [offset, offset + size) がファイルの中に収まり、offset が揃っているか
+    bool IsValidSection(uint64_t offset, uint64_t size, uint64_t fileSize) {
+        return offset % SCENE_FILE_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+    }
+}
+
+// 線分だけを保存する
+bool SaveSceneFile(const std::string& path, const SegmentBuffer& segments, std::string* error)
+{
+    return WriteScene(path, segments, nullptr, error);
+}
+
+// BVH ごと保存する
+bool SaveSceneFile(const std::string& path, const SegmentBVH& bvh, std::string* error)
+{
+    return WriteScene(path, bvh.GetSegments(), &bvh.GetNodes(), error);
+}
+
+// シーンを読み込む
+bool LoadSceneFile(const std::string& path, SegmentBuffer& segments, SegmentBVH& bvh, ThreadPool* pool, std::string* error)
+{
+    segments.Clear();
+    bvh.Build(segments); // 空にする
+
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->Open(path)) { return Fail(error, file->GetError()); }
+    const uint8_t* data = file->Data();
+    const uint64_t fileSize = file->Size();
+
+    // --- ヘッダーを確かめる ---
+    if (fileSize < sizeof(SceneFileHeader)) { return Fail(error, "シーンファイルではありません (小さすぎます): " + path); }
+    SceneFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        return Fail(error, "シーンファイルではありません (識別子が違います): " + path);
+    }
+    if (header.version != SCENE_FILE_VERSION || header.headerSize != sizeof(SceneFileHeader)) {
+        return Fail(error, "対応していないバージョンのシーンファイルです (version " + std::to_string(header.version) + "): " + path);
+    }
+    if (header.fileSize != fileSize) { return Fail(error, "シーンファイルが途中で切れているか、壊れています: " + path); }
+
+    // --- 各配列がファイルの中に収まっているか確かめる ---
+    if (header.segmentCount > fileSize / (6 * sizeof(float))) { return Fail(error, "シーンファイルの線分の本数が不正です: " + path); }
+    const uint64_t pointCount = header.segmentCount * 2;
+    const uint64_t arrayBytes = pointCount * sizeof(float);
+    if (!IsValidSection(header.xOffset, arrayBytes, fileSize) || !IsValidSection(header.yOffset, arrayBytes, fileSize) ||
+        !IsValidSection(header.zOffset, arrayBytes, fileSize)) {
+        return Fail(error, "シーンファイルの座標配列の位置が不正です: " + path);
+    }
+    if (header.nodeCount > 0) {
+        if (header.nodeSize != sizeof(BVHNode) || header.nodeCount > fileSize / sizeof(BVHNode) ||
+            !IsValidSection(header.nodeOffset, header.nodeCount * sizeof(BVHNode), fileSize)) {
+            return Fail(error, "シーンファイルの BVH の位置が不正です: " + path);
+        }
+    }
+
+    // --- マップした領域をそのまま参照する (座標はコピーしない) ---
+    // file は SegmentBuffer が持つ shared_ptr で保持され、最後の参照がなくなったときにマップが解除される
+    segments = SegmentBuffer::FromExternal(reinterpret_cast<const float*>(data + header.xOffset),
+        reinterpret_cast<const float*>(data + header.yOffset), reinterpret_cast<const float*>(data + header.zOffset),
+        static_cast<size_t>(pointCount), file);
+
+    // --- BVH ---
+    if (header.nodeCount > 0) {
+        if (!bvh.Assign(reinterpret_cast<const BVHNode*>(data + header.nodeOffset), static_cast<size_t>(header.nodeCount), segments)) {
+            segments.Clear();
+            return Fail(error, "シーンファイルの BVH が壊れています: " + path);
+        }
+    }
+    else {
+        bvh.Build(segments, pool);
+    }
+    return true;
+}
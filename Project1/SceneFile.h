@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>         // size_t
+#include <cstdint>         // uint32_t, uint64_t
+#include <string>          // std::string
+#include "SegmentBuffer.h" // SegmentBuffer
+#include "SegmentBVH.h"    // SegmentBVH, BVHNode
+
+class ThreadPool;
+
+/*
+ * SceneFile.h
+ * 役割:
+ *   ワイヤーフレームのシーン (線分の集まりと、その BVH) を保存するバイナリ形式 (.wfscene) の
+ *   書き出し (SaveSceneFile) と読み込み (LoadSceneFile) を定義します。
+ *   以前はシーンが WinMain の中で直接作られていたため、大きなモデルを表示するには再コンパイルが必要でした。
+ *
+ * ファイルの構成 (リトルエンディアン):
+ *   [SceneFileHeader]                  先頭の 128 バイト
+ *   [X 座標の配列] [Y 座標の配列] [Z 座標の配列]
+ *                                      float がそれぞれ 2 × 線分の本数 個 (点 2*i が始点、2*i+1 が終点)
+ *   [BVH のノードの配列] (省略可)      BVHNode がノードの数だけ
+ *   各配列のファイル内の位置は SCENE_FILE_ALIGNMENT (64) バイト単位に揃えます。
+ *
+ * 読み込み (ゼロコピー):
+ *   - ファイルをメモリにマップし (MappedFile.h)、ヘッダーと各配列の位置・大きさを確かめるだけで、
+ *     座標配列は SegmentBuffer::FromExternal でマップした領域をそのまま参照します (パースもコピーもしない)。
+ *     ファイルの内容は、描画で実際に触ったページだけが OS によって読み込まれます。
+ *   - BVH のノードがあれば、SegmentBVH::Assign でそのまま使います (コピーするのはノードだけ)。
+ *     ノードがなければ、読み込んだ線分から BVH を構築します。
+ *   - マップした領域は、読み込んだ SegmentBuffer (とそのコピー) がなくなると自動で解放されます。
+ *
+ * バージョン:
+ *   ヘッダーの version が SCENE_FILE_VERSION と違うファイルは読み込みません。形式を変えたら番号を上げます。
+ *
+ * 使い方:
+ *   SaveSceneFile("scene.wfscene", bvh);             // BVH ごと保存 (線分は木の順番で保存される)
+ *   SegmentBuffer lines; SegmentBVH bvh; std::string error;
+ *   if (!LoadSceneFile("scene.wfscene", lines, bvh, pool, &error)) { LogDebug(error); }
+ */
+
+// ファイルの先頭の識別子 ("WFSCENE" と終端の 0)
+extern const char SCENE_FILE_MAGIC[8];
+// 現在のファイル形式の番号
+const uint32_t SCENE_FILE_VERSION = 1;
+// ファイル内の各配列の位置を揃えるバイト数 (SegmentBuffer::ALIGNMENT の倍数)
+const uint64_t SCENE_FILE_ALIGNMENT = 64;
+
+// ファイルの先頭に置くヘッダー (128 バイト)
+struct SceneFileHeader {
+    char magic[8];          // SCENE_FILE_MAGIC
+    uint32_t version;       // SCENE_FILE_VERSION
+    uint32_t headerSize;    // sizeof(SceneFileHeader)
+    uint64_t fileSize;      // ファイル全体の大きさ (途中で切れたファイルを見つけるため)
+    uint64_t segmentCount;  // 線分の本数
+    uint64_t xOffset;       // X 座標の配列の位置 (ファイルの先頭からのバイト数)
+    uint64_t yOffset;       // Y 座標の配列の位置
+    uint64_t zOffset;       // Z 座標の配列の位置
+    uint64_t nodeCount;     // BVH のノードの数 (0 なら BVH なし)
+    uint64_t nodeOffset;    // BVH のノードの配列の位置
+    uint32_t nodeSize;      // sizeof(BVHNode) (ノードの形式が変わっていないか確かめるため)
+    uint32_t flags;         // 予約 (0)
+    uint8_t reserved[48];   // 予約 (0)。将来の拡張用
+};
+static_assert(sizeof(SceneFileHeader) == 128, "SceneFileHeader は 128 バイトである必要があります。");
+
+// segments を BVH なしで path に保存する。失敗したら false を返し、error があれば理由を書き込む。
+bool SaveSceneFile(const std::string& path, const SegmentBuffer& segments, std::string* error = nullptr);
+// bvh の線分 (木の順番) とノードを path に保存する。
+bool SaveSceneFile(const std::string& path, const SegmentBVH& bvh, std::string* error = nullptr);
+
+// path のシーンを読み込む。segments はマップしたファイルを直接参照するバッファになる。
+// ファイルに BVH があればそれを bvh に設定し、なければ segments から bvh を構築する (pool は構築に使う。nullptr でもよい)。
+// 失敗したら false を返し (segments, bvh は空になる)、error があれば理由を書き込む。
+bool LoadSceneFile(const std::string& path, SegmentBuffer& segments, SegmentBVH& bvh,
+    ThreadPool* pool = nullptr, std::string* error = nullptr);
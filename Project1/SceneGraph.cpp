@@ -0,0 +1,271 @@
+#include "SceneGraph.h" // 対応するヘッダーファイル
+#include <algorithm>    // std::min, std::max, std::reverse
+#include <cmath>        // std::sqrt, std::fabs
+#include <stdexcept>    // std::invalid_argument
+#include <utility>      // std::move
+
+/*
+ * SceneGraph.cpp
+ * 概要:
+ *   SceneGraph クラスの実装です。
+ *   ワールド座標の変換行列と境界球は、変換行列が変わった後に最初に参照したときにまとめて計算し直します。
+ */
+
+namespace {
+
+// 行ベクトルを m の左上 3x3 の部分で変換したときに、長さが最大で何倍になるか (の上限)
+float MaxScale(const Matrix& m)
+{
+    float rowLengthSq[3];
+    for (int i = 0; i < 3; ++i) {
+        rowLengthSq[i] = m.m[i][0] * m.m[i][0] + m.m[i][1] * m.m[i][1] + m.m[i][2] * m.m[i][2];
+    }
+    // 行どうしが直交していれば (回転と各軸方向の拡大縮小の組み合わせ)、最も長い行の長さがちょうど最大の拡大率
+    const float maxLengthSq = std::max(rowLengthSq[0], std::max(rowLengthSq[1], rowLengthSq[2]));
+    bool orthogonal = true;
+    for (int i = 0; i < 3 && orthogonal; ++i) {
+        for (int j = i + 1; j < 3; ++j) {
+            const float dot = m.m[i][0] * m.m[j][0] + m.m[i][1] * m.m[j][1] + m.m[i][2] * m.m[j][2];
+            if (std::fabs(dot) > 1e-5f * maxLengthSq) { orthogonal = false; break; }
+        }
+    }
+    if (orthogonal) { return std::sqrt(maxLengthSq); }
+    // せん断を含む場合は、3 行の長さの 2 乗和の平方根 (フロベニウスノルム。最大の拡大率以上になる)
+    return std::sqrt(rowLengthSq[0] + rowLengthSq[1] + rowLengthSq[2]);
+}
+
+// 球 (center, radius) を、球 (otherCenter, otherRadius) も囲むように広げる (半径が負の球は空とみなす)
+void MergeSphere(Vector3D& center, float& radius, const Vector3D& otherCenter, float otherRadius)
+{
+    if (otherRadius < 0.0f) { return; }
+    if (radius < 0.0f) { center = otherCenter; radius = otherRadius; return; }
+    const Vector3D offset = otherCenter - center;
+    const float distance = offset.Length();
+    if (distance + otherRadius <= radius) { return; }               // もう一方を含んでいる
+    if (distance + radius <= otherRadius) { center = otherCenter; radius = otherRadius; return; } // もう一方に含まれる
+    const float merged = (distance + radius + otherRadius) * 0.5f;
+    center = center + offset * ((merged - radius) / distance);
+    radius = merged;
+}
+
+} // namespace
+
+// 形状を登録する
+uint32_t SceneGraph::AddGeometry(WireMesh mesh)
+{
+    Geometry geometry;
+    geometry.center = { 0.0f, 0.0f, 0.0f };
+    geometry.radius = -1.0f;
+    const size_t vertexCount = mesh.VertexCount();
+    if (vertexCount > 0) {
+        // AABB の中心を球の中心にし、そこから最も遠い頂点までの距離を半径にする
+        const float* xs = mesh.X();
+        const float* ys = mesh.Y();
+        const float* zs = mesh.Z();
+        float minX = xs[0], minY = ys[0], minZ = zs[0], maxX = xs[0], maxY = ys[0], maxZ = zs[0];
+        for (size_t i = 1; i < vertexCount; ++i) {
+            minX = std::min(minX, xs[i]); maxX = std::max(maxX, xs[i]);
+            minY = std::min(minY, ys[i]); maxY = std::max(maxY, ys[i]);
+            minZ = std::min(minZ, zs[i]); maxZ = std::max(maxZ, zs[i]);
+        }
+        geometry.center = { (minX + maxX) * 0.5f, (minY + maxY) * 0.5f, (minZ + maxZ) * 0.5f };
+        float maxDistanceSq = 0.0f;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            const float dx = xs[i] - geometry.center.x, dy = ys[i] - geometry.center.y, dz = zs[i] - geometry.center.z;
+            maxDistanceSq = std::max(maxDistanceSq, dx * dx + dy * dy + dz * dz);
+        }
+        geometry.radius = std::sqrt(maxDistanceSq);
+    }
+    geometry.mesh = std::move(mesh);
+    geometries.push_back(std::move(geometry));
+    version.Touch();
+    return static_cast<uint32_t>(geometries.size() - 1);
+}
+
+// ノードを追加する
+uint32_t SceneGraph::AddNode(uint32_t parent, const Matrix& localTransform, uint32_t geometry)
+{
+    if (parent != NO_NODE && parent >= nodes.size()) {
+        throw std::invalid_argument("SceneGraph::AddNode に存在しない親ノードが渡されました。");
+    }
+    if (geometry != NO_GEOMETRY && geometry >= geometries.size()) {
+        throw std::invalid_argument("SceneGraph::AddNode に存在しない形状が渡されました。");
+    }
+    if (!localTransform.IsAffine()) {
+        throw std::invalid_argument("SceneGraph::AddNode にアフィン変換でない行列が渡されました。");
+    }
+
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    Node node;
+    node.local = localTransform;
+    node.world = localTransform;
+    node.parent = parent;
+    node.firstChild = NO_NODE;
+    node.lastChild = NO_NODE;
+    node.nextSibling = NO_NODE;
+    node.geometry = geometry;
+    node.ownCenter = node.subtreeCenter = { 0.0f, 0.0f, 0.0f };
+    node.ownRadius = node.subtreeRadius = -1.0f;
+    nodes.push_back(node);
+
+    // 親の子の並び (または根の並び) の末尾につなぐ
+    if (parent == NO_NODE) {
+        roots.push_back(index);
+    }
+    else {
+        Node& parentNode = nodes[parent];
+        if (parentNode.lastChild == NO_NODE) { parentNode.firstChild = index; }
+        else { nodes[parentNode.lastChild].nextSibling = index; }
+        parentNode.lastChild = index;
+    }
+    transformsDirty = true;
+    version.Touch();
+    return index;
+}
+
+// ノードのローカル座標の変換行列を変更する
+void SceneGraph::SetLocalTransform(uint32_t node, const Matrix& localTransform)
+{
+    if (node >= nodes.size()) {
+        throw std::invalid_argument("SceneGraph::SetLocalTransform に存在しないノードが渡されました。");
+    }
+    if (!localTransform.IsAffine()) {
+        throw std::invalid_argument("SceneGraph::SetLocalTransform にアフィン変換でない行列が渡されました。");
+    }
+    nodes[node].local = localTransform;
+    transformsDirty = true;
+    version.Touch();
+}
+
+// 全てのノードと形状を削除する
+void SceneGraph::Clear()
+{
+    geometries.clear();
+    nodes.clear();
+    roots.clear();
+    transformsDirty = false;
+    version.Touch();
+}
+
+// ワールド座標の変換行列と境界球を計算し直す
+void SceneGraph::RefreshTransforms() const
+{
+    if (!transformsDirty) { return; }
+
+    // 親は子より前にあるので、先頭から順に「ローカル × 親のワールド」を求めれば、親は計算済み
+    // (ローカルの行列は AddNode / SetLocalTransform でアフィン変換に限っているので、ワールドの行列もアフィン変換)
+    for (Node& node : nodes) {
+        if (node.parent == NO_NODE) {
+            node.world = node.local;
+        }
+        else {
+            node.world = MatrixMultiply<MatrixShape::Affine>(node.local, nodes[node.parent].world);
+        }
+        // 自分の形状の境界球 (中心を変換し、半径は最大の拡大率で広げる。アフィン変換なので球は形状を囲んだまま)
+        node.ownRadius = -1.0f;
+        if (node.geometry != NO_GEOMETRY && geometries[node.geometry].radius >= 0.0f) {
+            const Geometry& geometry = geometries[node.geometry];
+            node.ownCenter = TransformPointAffine(Vector3DA(geometry.center), node.world).ToVector3D();
+            node.ownRadius = geometry.radius * MaxScale(node.world);
+        }
+        node.subtreeCenter = node.ownCenter;
+        node.subtreeRadius = node.ownRadius;
+    }
+    // 子は親より後ろにあるので、末尾から順に子の部分木の球を親に足していけば、足す時点で子の部分木は完成している
+    for (size_t i = nodes.size(); i-- > 0;) {
+        const Node& node = nodes[i];
+        if (node.parent != NO_NODE) {
+            Node& parentNode = nodes[node.parent];
+            MergeSphere(parentNode.subtreeCenter, parentNode.subtreeRadius, node.subtreeCenter, node.subtreeRadius);
+        }
+    }
+    transformsDirty = false;
+}
+
+// 視錐台カリング
+void SceneGraph::Cull(const Frustum& frustum, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    RefreshTransforms();
+
+    // 深さ優先でたどる。inside は祖先の部分木の球が視錐台の完全に内側と分かっていること (判定を省く)
+    struct Entry { uint32_t node; bool inside; };
+    std::vector<Entry> stack;
+    stack.reserve(64);
+    // スタックなので、最初に処理したい根 (追加順の先頭) が最後に積まれるように逆順で積む
+    for (size_t i = roots.size(); i-- > 0;) { stack.push_back({ roots[i], false }); }
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[entry.node];
+        if (node.subtreeRadius < 0.0f) { continue; } // 形状が 1 つもない部分木
+
+        bool inside = entry.inside;
+        if (!inside) {
+            const FrustumTest subtree = frustum.TestSphere(node.subtreeCenter, node.subtreeRadius);
+            if (subtree == FrustumTest::Outside) { continue; }
+            inside = (subtree == FrustumTest::Inside);
+        }
+        // 部分木の球が境界をまたぐ場合は、自分の形状だけの (より小さい) 球で判定し直す
+        // (子がなければ部分木の球と同じなので判定済み)
+        if (node.ownRadius >= 0.0f && (inside || node.firstChild == NO_NODE ||
+            frustum.TestSphere(node.ownCenter, node.ownRadius) != FrustumTest::Outside)) {
+            out.push_back(entry.node);
+        }
+
+        // 子を追加順に処理するため、いったん積んでから並びを逆にする (兄弟の並びは単方向のリストなので)
+        const size_t childrenBegin = stack.size();
+        for (uint32_t child = node.firstChild; child != NO_NODE; child = nodes[child].nextSibling) {
+            stack.push_back({ child, inside });
+        }
+        std::reverse(stack.begin() + childrenBegin, stack.end());
+    }
+}
+
+// XZ 平面の矩形と重なり得るノードを探す
+void SceneGraph::CullRectXZ(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    RefreshTransforms();
+
+    // 球を XZ 平面に投影した円の外接矩形で判定する (真上から見た図なので、Y は判定に使わない)
+    auto overlaps = [=](const Vector3D& center, float radius) {
+        return radius >= 0.0f &&
+            center.x + radius >= minX && center.x - radius <= maxX &&
+            center.z + radius >= minZ && center.z - radius <= maxZ;
+    };
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    for (size_t i = roots.size(); i-- > 0;) { stack.push_back(roots[i]); }
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes[index];
+        if (!overlaps(node.subtreeCenter, node.subtreeRadius)) { continue; }
+        if (overlaps(node.ownCenter, node.ownRadius)) { out.push_back(index); }
+
+        const size_t childrenBegin = stack.size();
+        for (uint32_t child = node.firstChild; child != NO_NODE; child = nodes[child].nextSibling) {
+            stack.push_back(child);
+        }
+        std::reverse(stack.begin() + childrenBegin, stack.end());
+    }
+}
+
+// 全てのノードの形状をワールド座標の線分に展開する
+void SceneGraph::AppendSegments(SegmentBuffer& out) const
+{
+    RefreshTransforms();
+    std::vector<Vector3D> worldVertices; // 形状の頂点をワールド座標に変換したもの (ノードごとに作り直す)
+    for (const Node& node : nodes) {
+        if (node.geometry == NO_GEOMETRY) { continue; }
+        const WireMesh& mesh = geometries[node.geometry].mesh;
+        worldVertices.resize(mesh.VertexCount());
+        for (size_t i = 0; i < worldVertices.size(); ++i) { // 変換行列はアフィン変換なので、w での除算は要らない
+            worldVertices[i] = TransformPointAffine(Vector3DA(mesh.GetVertex(i)), node.world).ToVector3D();
+        }
+        for (const MeshEdge& e : mesh.GetEdges()) {
+            out.Append(worldVertices[e.a], worldVertices[e.b]);
+        }
+    }
+}
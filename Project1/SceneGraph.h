@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>           // size_t
+#include <cstdint>           // uint32_t, uint64_t
+#include <vector>            // std::vector
+#include "Vector.h"          // Vector3D
+#include "Matrix.h"          // Matrix
+#include "CameraMath.h"      // Frustum
+#include "WireMesh.h"        // WireMesh (ノードが参照する形状)
+#include "SegmentBuffer.h"   // SegmentBuffer (ワールド座標の線分への展開)
+#include "GeometryVersion.h" // GeometryVersion (内容の版番号)
+
+/*
+ * SceneGraph.h
+ * 役割:
+ *   ローカル座標の変換行列を持つノードの木 (シーングラフ) `SceneGraph` を定義します。
+ *   これまでは全ての物体をワールド座標の線分として SegmentBuffer に焼き込んでいたため、
+ *   同じ形の物体を何個も置くとその分だけ線分が増え、物体を動かすには線分を全て書き換える必要がありました。
+ *   シーングラフでは、形状 (WireMesh) はローカル座標で 1 つだけ持ち、ノードは「どの形状を、どの変換で置くか」
+ *   だけを持ちます。物体を動かすときは、ノードの変換行列を 1 つ書き換えるだけです。
+ *
+ * 仕組み:
+ *   - 形状は AddGeometry で登録します。登録時にローカル座標の境界球 (AABB の中心と、そこから最も遠い頂点までの距離) を求めます。
+ *   - ノードは親ノード・ローカル座標の変換行列・形状 (なくてもよい。グループのノードになる) を持ちます。
+ *     ワールド座標の変換行列は「ローカル × 親のワールド」です (行ベクトルに右から掛けるので、自分の変換が先)。
+ *   - ノードは追加順に配列に並び、親は必ず子より前にあります。そのため、ワールド座標の変換行列は
+ *     配列を先頭から 1 回たどるだけで、境界球は末尾から 1 回たどるだけで求まります。
+ *   - 各ノードは 2 つの境界球 (ワールド座標) を持ちます。自分の形状だけを囲む球と、自分と全ての子孫の形状を囲む球です。
+ *   - 変換行列を変更すると「計算し直しが必要」という印を付けるだけで、次に Cull などで参照したときに
+ *     まとめて計算し直します (Camera の行列のキャッシュと同じ考え方)。
+ *
+ * 視錐台カリング (Cull):
+ *   - 部分木の境界球が視錐台の完全に外: 子孫ごと読み飛ばす
+ *   - 部分木の境界球が視錐台の完全に内側: 子孫は判定せずに全て出力する
+ *   - 境界をまたぐ: 自分の形状の境界球を判定し、子をたどる
+ *   (形状は WireframePipeline の WireMesh 版で描くので、クリッピングの要否は頂点のアウトコードで決まります)
+ *   出力したノードは、Camera::Draw がノードのワールド座標の変換行列とビュー・プロジェクション行列を
+ *   ノードごとに 1 回だけ掛け合わせ、形状の頂点をローカル座標から直接クリップ座標に変換して描画します。
+ *
+ * 注意点:
+ *   - 計算し直しは const の関数の中でも行うので、複数のスレッドから同時に参照しないでください。
+ *   - ノードの変換行列はアフィン変換 (最後の列が (0, 0, 0, 1)) に限ります。境界球は中心を変換し、半径を
+ *     左上 3x3 の部分の拡大率で広げて求めるので、射影を含む行列では球が形状を囲まなくなり、
+ *     カリングで見えるノードを落としてしまうためです。アフィン変換でない行列を渡すと例外を投げます。
+ *
+ * 使い方:
+ *   SceneGraph objects;
+ *   uint32_t cube = objects.AddGeometry(CreateCubeMesh(10.0f, { 0, 0, 0 }));
+ *   uint32_t group = objects.AddNode(SceneGraph::NO_NODE, GetMatrixTranslation(0, 0, 100));
+ *   objects.AddNode(group, GetMatrixTranslation(-20, 0, 0), cube);
+ *   objects.AddNode(group, GetMatrixTranslation(20, 0, 0), cube); // 同じ形状を別の位置に置く
+ *   camera->Draw(sceneBVH, objects, frameLines, frameMesh, sink);
+ */
+
+class SceneGraph
+{
+public:
+    // 親がないことを表すノードの番号
+    static const uint32_t NO_NODE = 0xFFFFFFFFu;
+    // 形状がないことを表す形状の番号 (グループのノード)
+    static const uint32_t NO_GEOMETRY = 0xFFFFFFFFu;
+
+    // --- 構築 ---
+    // 形状 (ローカル座標) を登録し、その番号を返す。同じ形状を複数のノードから参照できる
+    uint32_t AddGeometry(WireMesh mesh);
+    // parent (NO_NODE なら根) の子としてノードを追加し、その番号を返す (localTransform はアフィン変換に限る)
+    uint32_t AddNode(uint32_t parent, const Matrix& localTransform, uint32_t geometry = NO_GEOMETRY);
+    // ノードのローカル座標の変換行列を変更する (子孫のワールド座標の変換も、次に参照したときに計算し直す)
+    // node が存在しないか、localTransform がアフィン変換でなければ std::invalid_argument を投げる (ノードは変更しない)
+    void SetLocalTransform(uint32_t node, const Matrix& localTransform);
+    // 全てのノードと形状を削除する
+    void Clear();
+
+    // --- 参照 ---
+    size_t NodeCount() const { return nodes.size(); }
+    size_t GeometryCount() const { return geometries.size(); }
+    bool Empty() const { return nodes.empty(); }
+    const WireMesh& GetGeometry(uint32_t geometry) const { return geometries[geometry].mesh; }
+    // ノードの形状の番号 (なければ NO_GEOMETRY)
+    uint32_t GetNodeGeometry(uint32_t node) const { return nodes[node].geometry; }
+    const Matrix& GetLocalTransform(uint32_t node) const { return nodes[node].local; }
+    // ノードのワールド座標の変換行列 (ローカル × 親のワールド)
+    const Matrix& GetWorldTransform(uint32_t node) const { RefreshTransforms(); return nodes[node].world; }
+    // 内容の版番号 (ノード・形状・変換行列を変更するたびに変わる。プログラム全体で一意)
+    uint64_t GetVersion() const { return version.Get(); }
+
+    // --- カリング ---
+    // frustum に入る形状を持つノードを、木の深さ優先の順番 (子は追加順) で out に書き込む
+    void Cull(const Frustum& frustum, std::vector<uint32_t>& out) const;
+    // 境界球が XZ 平面の矩形 [minX, maxX] x [minZ, maxZ] と重なり得る、形状を持つノードを out に書き込む (TopAngle 用)
+    void CullRectXZ(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& out) const;
+
+    // 全てのノードの形状をワールド座標の線分に展開して out の末尾に追加する (シーンファイルへの書き出しなどに使う)
+    void AppendSegments(SegmentBuffer& out) const;
+
+private:
+    // 登録した形状
+    struct Geometry {
+        WireMesh mesh;        // ローカル座標の頂点と辺
+        Vector3D center;      // ローカル座標の境界球の中心
+        float radius;         // その半径 (頂点がなければ負)
+    };
+    // ノード
+    struct Node {
+        Matrix local;                // ローカル座標の変換行列
+        Matrix world;                // ワールド座標の変換行列 (RefreshTransforms で計算する)
+        uint32_t parent;             // 親 (根なら NO_NODE)
+        uint32_t firstChild;         // 最初の子 (なければ NO_NODE)
+        uint32_t lastChild;          // 最後の子 (子を追加順に並べるため)
+        uint32_t nextSibling;        // 次の兄弟 (なければ NO_NODE)
+        uint32_t geometry;           // 形状 (なければ NO_GEOMETRY)
+        Vector3D ownCenter;          // 自分の形状の境界球 (ワールド座標。形状がなければ半径は負)
+        float ownRadius;
+        Vector3D subtreeCenter;      // 自分と全ての子孫の形状を囲む境界球 (ワールド座標。形状が 1 つもなければ半径は負)
+        float subtreeRadius;
+    };
+
+    // 変換行列が変わっていたら、全ノードのワールド座標の変換行列と境界球を計算し直す
+    void RefreshTransforms() const;
+
+    std::vector<Geometry> geometries;
+    mutable std::vector<Node> nodes;          // 追加順 (親は必ず子より前)
+    std::vector<uint32_t> roots;              // 根のノード (追加順)
+    mutable bool transformsDirty = false;     // ワールド座標の変換行列と境界球の計算し直しが必要か
+    GeometryVersion version;                  // 内容の版番号
+};
@@ -0,0 +1,374 @@
+#include "SegmentBVH.h" // 対応するヘッダーファイル
+#include "ThreadPool.h" // ThreadPool (並列構築)
+#include <algorithm>    // std::min, std::max, std::partition
+#include <cfloat>       // FLT_MAX
+
+/*
+ * SegmentBVH.cpp
+ * 概要:
+ *   SegmentBVH クラスの実装です。
+ *   木は配列 (nodes) に格納し、子は 2 つ並べて (左 = left, 右 = left + 1) 親より後ろに追加します。
+ *   そのため、配列を後ろから順にたどれば、親より先に子の箱が計算済みになります (Refit で使う)。
+ */
+
+// 静的定数メンバーの定義 (値はヘッダー側で指定。std::max などで参照として使うために必要)
+const size_t SegmentBVH::LEAF_SEGMENTS;
+const int SegmentBVH::BIN_COUNT;
+const size_t SegmentBVH::PARALLEL_BUILD_MIN_SEGMENTS;
+
+namespace {
+    // AABB の表面積の半分 (SAH のコスト計算では比だけが意味を持つので半分で十分)
+    inline float HalfSurfaceArea(float dx, float dy, float dz) {
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    // AABB (SAH の bin で使う)
+    struct Bounds {
+        float mn[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float mx[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        void Grow(const float p[3]) {
+            for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], p[a]); mx[a] = std::max(mx[a], p[a]); }
+        }
+        void Grow(const Bounds& b) {
+            for (int a = 0; a < 3; ++a) { mn[a] = std::min(mn[a], b.mn[a]); mx[a] = std::max(mx[a], b.mx[a]); }
+        }
+        float Area() const {
+            if (mn[0] > mx[0]) { return 0.0f; } // 空
+            return HalfSurfaceArea(mx[0] - mn[0], mx[1] - mn[1], mx[2] - mn[2]);
+        }
+    };
+
+    // 並列処理で 1 つの仕事にまとめる要素数
+    const size_t PARALLEL_CHUNK = 4096;
+}
+
+// 木を作り直す
+void SegmentBVH::Build(const SegmentBuffer& segments, ThreadPool* pool)
+{
+    nodes.clear();
+    orderedSegments.Clear();
+    const size_t segmentCount = segments.Size();
+    order.resize(segmentCount);
+    if (segmentCount == 0) { return; }
+
+    const bool parallel = pool != nullptr && pool->GetWorkerCount() > 1 && segmentCount >= 2 * PARALLEL_BUILD_MIN_SEGMENTS;
+
+    // 1. 線分ごとの AABB の中心を計算する (並べ替えの順番 order も初期化する)
+    for (int a = 0; a < 3; ++a) { centers[a].resize(segmentCount); }
+    auto computeCenters = [&](size_t begin, size_t end) {
+        const float* xs = segments.X();
+        const float* ys = segments.Y();
+        const float* zs = segments.Z();
+        for (size_t i = begin; i < end; ++i) {
+            // 線分の AABB の中心 = 両端点の中点
+            centers[0][i] = (xs[2 * i] + xs[2 * i + 1]) * 0.5f;
+            centers[1][i] = (ys[2 * i] + ys[2 * i + 1]) * 0.5f;
+            centers[2][i] = (zs[2 * i] + zs[2 * i + 1]) * 0.5f;
+            order[i] = static_cast<uint32_t>(i);
+        }
+    };
+    if (parallel) {
+        pool->ParallelFor((segmentCount + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK, [&](size_t task, unsigned int) {
+            computeCenters(task * PARALLEL_CHUNK, std::min(segmentCount, (task + 1) * PARALLEL_CHUNK));
+        });
+    }
+    else {
+        computeCenters(0, segmentCount);
+    }
+    const BuildContext context = { &segments, { centers[0].data(), centers[1].data(), centers[2].data() } };
+
+    // 2. 根を作る
+    BVHNode root = {};
+    root.first = 0;
+    root.count = static_cast<uint32_t>(segmentCount);
+    ComputeNodeBounds(root, segments);
+    nodes.push_back(root);
+
+    // 3. 分割する
+    if (!parallel) {
+        BuildSubtree(nodes, 0, context, 0, nullptr);
+    }
+    else {
+        // 3-1. 木の上の方をスレッド 1 本で分割し、ワーカー数の数倍の部分木に分ける
+        //      (部分木の大きさにばらつきがあっても、早く終わったワーカーが次の部分木を取るので偏りにくい)
+        const size_t stopSegments = std::max(PARALLEL_BUILD_MIN_SEGMENTS, segmentCount / (pool->GetWorkerCount() * 4));
+        std::vector<uint32_t> subtreeRoots;
+        BuildSubtree(nodes, 0, context, stopSegments, &subtreeRoots);
+
+        // 3-2. 部分木ごとに別々の配列で並列に構築する (各部分木の線分の範囲は重ならないので、order を同時に並べ替えてもよい)
+        std::vector<std::vector<BVHNode>> subtrees(subtreeRoots.size());
+        pool->ParallelFor(subtreeRoots.size(), [&](size_t task, unsigned int) {
+            subtrees[task].assign(1, nodes[subtreeRoots[task]]); // 部分木の根を添字 0 に置く
+            BuildSubtree(subtrees[task], 0, context, 0, nullptr);
+        });
+
+        // 3-3. 部分木を決まった順番で nodes の末尾に連結し、子の添字を付け替える
+        //      (部分木の中の添字 j (>= 1) は、nodes の中では offset + j になる)
+        for (size_t t = 0; t < subtrees.size(); ++t) {
+            const uint32_t offset = static_cast<uint32_t>(nodes.size()) - 1;
+            const std::vector<BVHNode>& subtree = subtrees[t];
+            BVHNode subtreeRoot = subtree[0];
+            if (!subtreeRoot.IsLeaf()) { subtreeRoot.left += offset; }
+            nodes[subtreeRoots[t]] = subtreeRoot;
+            for (size_t j = 1; j < subtree.size(); ++j) {
+                BVHNode node = subtree[j];
+                if (!node.IsLeaf()) { node.left += offset; }
+                nodes.push_back(node);
+            }
+        }
+    }
+
+    // 4. 線分を木の順番に並べ替えたコピーを作る
+    orderedSegments.Reserve(segmentCount);
+    for (size_t i = 0; i < segmentCount; ++i) {
+        orderedSegments.Append(segments.GetStart(order[i]), segments.GetEnd(order[i]));
+    }
+}
+
+// treeNodes[rootIndex] 以下の部分木を構築する
+void SegmentBVH::BuildSubtree(std::vector<BVHNode>& treeNodes, uint32_t rootIndex, const BuildContext& context,
+    size_t stopSegments, std::vector<uint32_t>* stopped)
+{
+    std::vector<uint32_t> stack(1, rootIndex); // これから分割するノード
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const BVHNode node = treeNodes[index]; // push_back で配列が移動するのでコピーしておく
+        if (node.count <= LEAF_SEGMENTS) { continue; } // 十分に小さいので葉にする
+
+        const size_t leftCount = Partition(node, context);
+        if (leftCount == 0) { continue; } // 分けられないので葉にする
+
+        // 左右の子を作って並べて追加する
+        BVHNode children[2] = {};
+        children[0].first = node.first;
+        children[0].count = static_cast<uint32_t>(leftCount);
+        children[1].first = node.first + static_cast<uint32_t>(leftCount);
+        children[1].count = node.count - static_cast<uint32_t>(leftCount);
+        const uint32_t leftIndex = static_cast<uint32_t>(treeNodes.size());
+        for (int c = 0; c < 2; ++c) {
+            ComputeNodeBounds(children[c], *context.segments);
+            treeNodes.push_back(children[c]);
+        }
+        treeNodes[index].left = leftIndex;
+
+        // 子を分割待ちに積む (stopSegments 以下の子は、呼び出し元に任せる)
+        for (uint32_t c = leftIndex + 2; c-- > leftIndex;) {
+            if (stopped != nullptr && treeNodes[c].count <= stopSegments) { stopped->push_back(c); }
+            else { stack.push_back(c); }
+        }
+    }
+}
+
+// binned SAH で分割位置を探し、order を左右に並べ替える
+size_t SegmentBVH::Partition(const BVHNode& node, const BuildContext& context)
+{
+    uint32_t* const begin = order.data() + node.first;
+    uint32_t* const end = begin + node.count;
+    const float* xs = context.segments->X();
+    const float* ys = context.segments->Y();
+    const float* zs = context.segments->Z();
+
+    // 1. 中心点の範囲を求める (bin はこの範囲を等分する)
+    Bounds centerBounds;
+    for (const uint32_t* it = begin; it != end; ++it) {
+        const float c[3] = { context.centers[0][*it], context.centers[1][*it], context.centers[2][*it] };
+        centerBounds.Grow(c);
+    }
+
+    // 2. 全ての軸について同時に bin に振り分ける (線分の座標を読むのは 1 回で済む)
+    float scales[3];
+    bool splittable[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent = centerBounds.mx[axis] - centerBounds.mn[axis];
+        splittable[axis] = extent > 0.0f; // false なら、この軸では全ての中心が同じ位置
+        scales[axis] = splittable[axis] ? static_cast<float>(BIN_COUNT) / extent : 0.0f;
+    }
+    Bounds binBounds[3][BIN_COUNT];
+    uint32_t binCounts[3][BIN_COUNT] = {};
+    for (const uint32_t* it = begin; it != end; ++it) {
+        const uint32_t s = *it;
+        const float p1[3] = { xs[2 * s], ys[2 * s], zs[2 * s] };
+        const float p2[3] = { xs[2 * s + 1], ys[2 * s + 1], zs[2 * s + 1] };
+        for (int axis = 0; axis < 3; ++axis) {
+            const int bin = std::min(BIN_COUNT - 1, static_cast<int>((context.centers[axis][s] - centerBounds.mn[axis]) * scales[axis]));
+            binBounds[axis][bin].Grow(p1);
+            binBounds[axis][bin].Grow(p2);
+            ++binCounts[axis][bin];
+        }
+    }
+
+    // 3. 各軸の bin の境目ごとのコストを求めて、最小のものを選ぶ
+    int bestAxis = -1, bestSplit = 0;
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!splittable[axis]) { continue; }
+        // 左から累積した箱の面積と本数 (境目 k の左側 = bin 0 ～ k-1)
+        float leftArea[BIN_COUNT];
+        uint32_t leftCount[BIN_COUNT];
+        Bounds acc;
+        uint32_t count = 0;
+        for (int k = 1; k < BIN_COUNT; ++k) {
+            acc.Grow(binBounds[axis][k - 1]);
+            count += binCounts[axis][k - 1];
+            leftArea[k] = acc.Area();
+            leftCount[k] = count;
+        }
+        // 右から累積しながらコストを評価する (境目 k の右側 = bin k ～ BIN_COUNT-1)
+        acc = Bounds();
+        count = 0;
+        for (int k = BIN_COUNT - 1; k >= 1; --k) {
+            acc.Grow(binBounds[axis][k]);
+            count += binCounts[axis][k];
+            if (leftCount[k] == 0 || count == 0) { continue; } // 片側が空になる分け方は無効
+            const float cost = leftArea[k] * static_cast<float>(leftCount[k]) + acc.Area() * static_cast<float>(count);
+            if (cost < bestCost) { bestCost = cost; bestAxis = axis; bestSplit = k; }
+        }
+    }
+    if (bestAxis < 0) { return 0; }
+
+    // 4. 選んだ境目より左の bin に入る線分を前に、残りを後ろに並べ替える
+    //    (bin の計算式は 2 と同じなので、左側の本数は 2 で数えた本数と一致する)
+    const float cmin = centerBounds.mn[bestAxis];
+    const float scale = scales[bestAxis];
+    const float* axisCenters = context.centers[bestAxis];
+    uint32_t* middle = std::partition(begin, end, [&](uint32_t s) {
+        return std::min(BIN_COUNT - 1, static_cast<int>((axisCenters[s] - cmin) * scale)) < bestSplit;
+    });
+    return static_cast<size_t>(middle - begin);
+}
+
+// ノードの AABB を、ノードの範囲の線分から計算する
+void SegmentBVH::ComputeNodeBounds(BVHNode& node, const SegmentBuffer& segments) const
+{
+    const float* xs = segments.X();
+    const float* ys = segments.Y();
+    const float* zs = segments.Z();
+    float mnX = FLT_MAX, mnY = FLT_MAX, mnZ = FLT_MAX;
+    float mxX = -FLT_MAX, mxY = -FLT_MAX, mxZ = -FLT_MAX;
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+        const size_t p = 2 * static_cast<size_t>(order[i]); // 始点の添字 (終点は p + 1)
+        mnX = std::min(mnX, std::min(xs[p], xs[p + 1])); mxX = std::max(mxX, std::max(xs[p], xs[p + 1]));
+        mnY = std::min(mnY, std::min(ys[p], ys[p + 1])); mxY = std::max(mxY, std::max(ys[p], ys[p + 1]));
+        mnZ = std::min(mnZ, std::min(zs[p], zs[p + 1])); mxZ = std::max(mxZ, std::max(zs[p], zs[p + 1]));
+    }
+    node.minX = mnX; node.minY = mnY; node.minZ = mnZ;
+    node.maxX = mxX; node.maxY = mxY; node.maxZ = mxZ;
+}
+
+// 箱の大きさだけを計算し直す
+void SegmentBVH::Refit(const SegmentBuffer& segments, ThreadPool* pool)
+{
+    // 線分の本数が変わっていたら木の形を使い回せないので、作り直す
+    if (nodes.empty() || segments.Size() != orderedSegments.Size()) {
+        Build(segments, pool);
+        return;
+    }
+    // Assign で読み込んだ木は元の並び = 木の順番なので、ここで初めて order を作る
+    if (order.empty()) {
+        order.resize(orderedSegments.Size());
+        for (size_t i = 0; i < order.size(); ++i) { order[i] = static_cast<uint32_t>(i); }
+    }
+
+    // 1. 葉の箱を線分から計算する (葉同士は独立しているので並列に処理できる)
+    const size_t nodeCount = nodes.size();
+    auto refitLeaves = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (nodes[i].IsLeaf()) { ComputeNodeBounds(nodes[i], segments); }
+        }
+    };
+    if (pool != nullptr && pool->GetWorkerCount() > 1 && segments.Size() >= 2 * PARALLEL_BUILD_MIN_SEGMENTS) {
+        pool->ParallelFor((nodeCount + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK, [&](size_t task, unsigned int) {
+            refitLeaves(task * PARALLEL_CHUNK, std::min(nodeCount, (task + 1) * PARALLEL_CHUNK));
+        });
+    }
+    else {
+        refitLeaves(0, nodeCount);
+    }
+
+    // 2. 内部ノードの箱を子の箱から計算する (子は親より後ろにあるので、後ろから順に処理する)
+    for (size_t i = nodeCount; i-- > 0;) {
+        BVHNode& node = nodes[i];
+        if (node.IsLeaf()) { continue; }
+        const BVHNode& l = nodes[node.left];
+        const BVHNode& r = nodes[node.left + 1];
+        node.minX = std::min(l.minX, r.minX); node.maxX = std::max(l.maxX, r.maxX);
+        node.minY = std::min(l.minY, r.minY); node.maxY = std::max(l.maxY, r.maxY);
+        node.minZ = std::min(l.minZ, r.minZ); node.maxZ = std::max(l.maxZ, r.maxZ);
+    }
+
+    // 3. 並べ替えたコピーの座標を更新する
+    orderedSegments.Clear(); // 容量はそのまま
+    for (size_t i = 0; i < order.size(); ++i) {
+        orderedSegments.Append(segments.GetStart(order[i]), segments.GetEnd(order[i]));
+    }
+}
+
+// 構築済みの木をそのまま使う
+bool SegmentBVH::Assign(const BVHNode* treeNodes, size_t nodeCount, const SegmentBuffer& treeOrderedSegments)
+{
+    nodes.clear();
+    order.clear();
+    orderedSegments.Clear();
+    for (int a = 0; a < 3; ++a) { centers[a].clear(); }
+    if (nodeCount == 0) { return treeOrderedSegments.Empty(); }
+
+    // 木が壊れていないか確かめる (Cull がノードや線分の配列の外を読まないように)
+    // - 根は全線分を持つ
+    // - 子は親より後ろにあり、2 つの子の範囲は親の範囲をちょうど左右に分けたものになっている
+    const size_t segmentCount = treeOrderedSegments.Size();
+    if (treeNodes[0].first != 0 || treeNodes[0].count != segmentCount) { return false; }
+    for (size_t i = 0; i < nodeCount; ++i) {
+        const BVHNode& node = treeNodes[i];
+        if (static_cast<size_t>(node.first) + node.count > segmentCount) { return false; }
+        if (node.IsLeaf()) { continue; }
+        if (node.left <= i || static_cast<size_t>(node.left) + 1 >= nodeCount) { return false; }
+        const BVHNode& l = treeNodes[node.left];
+        const BVHNode& r = treeNodes[node.left + 1];
+        if (l.first != node.first || static_cast<size_t>(l.first) + l.count != r.first || static_cast<size_t>(l.count) + r.count != node.count) { return false; }
+    }
+
+    nodes.assign(treeNodes, treeNodes + nodeCount);
+    orderedSegments = treeOrderedSegments; // 外部のメモリを参照するバッファなら、参照だけがコピーされる
+    return true;
+}
+
+// 視錐台に入る線分の範囲を求める
+void SegmentBVH::Cull(const Frustum& frustum, std::vector<SegmentRange>& out) const
+{
+    out.clear();
+    if (nodes.empty()) { return; }
+
+    // 範囲を出力する (直前の範囲と隣り合っていて種類も同じなら、1 つにまとめる)
+    auto emit = [&out](size_t first, size_t count, bool needsClipping) {
+        if (!out.empty() && out.back().needsClipping == needsClipping && out.back().first + out.back().count == first) {
+            out.back().count += count;
+        }
+        else {
+            out.push_back({ first, count, needsClipping });
+        }
+    };
+
+    // 深さ優先でたどる (左の子を先に処理するので、範囲は先頭から順に出力される)
+    // planeMask は、祖先の箱で「完全に内側」と分かった平面を除いた、判定が必要な平面
+    struct Entry { uint32_t node; unsigned int planeMask; };
+    std::vector<Entry> stack;
+    stack.reserve(64);
+    stack.push_back({ 0, (1u << Frustum::PLANE_COUNT) - 1 });
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+
+        const BVHNode& node = nodes[entry.node];
+        unsigned int planeMask = entry.planeMask;
+        const FrustumTest test = frustum.TestAABB(node.minX, node.minY, node.minZ, node.maxX, node.maxY, node.maxZ, planeMask);
+        if (test == FrustumTest::Outside) { continue; }
+        if (test == FrustumTest::Inside || node.IsLeaf()) {
+            emit(node.first, node.count, test != FrustumTest::Inside);
+            continue;
+        }
+        // 右の子を先に積む (左の子が先に取り出される)
+        stack.push_back({ node.left + 1, planeMask });
+        stack.push_back({ node.left, planeMask });
+    }
+}
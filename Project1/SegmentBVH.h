@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>         // size_t
+#include <cstdint>         // uint32_t
+#include <vector>          // std::vector
+#include "CameraMath.h"    // Frustum
+#include "SegmentBuffer.h" // SegmentBuffer, SegmentRange
+
+class ThreadPool;
+
+/*
+ * SegmentBVH.h
+ * 役割:
+ *   線分の集まり (SegmentBuffer) に対する BVH (Bounding Volume Hierarchy: 境界ボリューム階層) を定義します。
+ *   線分を空間的に近いもの同士でまとめ、各まとまりを AABB (軸に平行な箱) で囲んだ二分木を作ります。
+ *   描画時に木を上からたどり、視錐台の外にある箱は中身ごと読み飛ばすことで、
+ *   カメラに映らない線分を変換・クリッピングせずに済ませます (視錐台カリング)。
+ *
+ * 構築 (Build):
+ *   - 各ノードの線分を、中心点の位置で 2 つに分けます。分け方は「binned SAH」で選びます。
+ *     x, y, z の各軸について中心点の範囲を BIN_COUNT 個の区間 (bin) に分け、bin の境目で分けた場合の
+ *     コスト (左右の箱の表面積 × 線分の本数の和、Surface Area Heuristic) が最小になる所で分けます。
+ *   - 線分が LEAF_SEGMENTS 本以下になったノードは葉にします。
+ *   - 木の上の方はスレッド 1 本で分割し、ある程度小さくなった部分木をスレッドプールで並列に構築します。
+ *     部分木を連結する順番は固定なので、スレッド数に関係なく同じ木ができます。
+ *   - 線分は木の順番 (葉を左から並べた順) に並べ替えたコピー (GetSegments) を持ちます。
+ *     どのノードの線分も、このコピーの中で連続した範囲 [first, first + count) になります。
+ *
+ * 視錐台カリング (Cull):
+ *   - 視錐台の完全に外の箱: 中身ごと読み飛ばす
+ *   - 視錐台の完全に内側の箱: 子をたどらず、部分木の全線分を「クリッピング不要」な範囲として出力する
+ *   - 境界をまたぐ箱: 子をたどる (葉なら「クリッピングが必要」な範囲として出力する)
+ *   出力した範囲は WireframePipeline::Run にそのまま渡せます。
+ *
+ * 更新 (Refit):
+ *   - 線分の本数と並びが同じまま座標だけが変わった場合 (アニメーションなど) は、木の形をそのままにして
+ *     箱の大きさだけを葉から根に向かって計算し直せます。Build よりずっと速いですが、
+ *     線分が大きく動くと箱が重なって効率が落ちるので、その場合は Build し直してください。
+ *
+ * 構築済みの木の読み込み (Assign):
+ *   - シーンファイル (SceneFile.h) に保存したノードと、木の順番に並んだ線分をそのまま使います。
+ *     線分は SegmentBuffer::FromExternal で参照したもの (マップしたファイルの中) でもよく、コピーされません。
+ *   - このとき「元の並び」はファイルの並び (= 木の順番) とみなします。
+ *
+ * 使い方:
+ *   SegmentBVH bvh;
+ *   bvh.Build(worldLines, pool);                 // 起動時などに 1 回 (pool は nullptr でもよい)
+ *   std::vector<SegmentRange> visible;
+ *   bvh.Cull(Frustum::FromViewProjection(viewProj), visible);
+ *   pipeline.Run(bvh.GetSegments(), visible, viewProj, W, H, pool, out);
+ */
+
+// BVH のノード
+struct BVHNode {
+    float minX, minY, minZ; // AABB の最小の角
+    uint32_t first;         // このノードの線分の先頭 (GetSegments の中の添字)
+    float maxX, maxY, maxZ; // AABB の最大の角
+    uint32_t count;         // このノードの線分の本数
+    uint32_t left;          // 左の子の添字 (右の子は left + 1)。葉なら 0
+    bool IsLeaf() const { return left == 0; } // 根 (添字 0) は誰の子にもならないので、0 を「子なし」に使える
+};
+
+class SegmentBVH
+{
+public:
+    // 葉に入れる線分の最大本数
+    static const size_t LEAF_SEGMENTS = 16;
+    // SAH で分割位置を探すときの区間 (bin) の数
+    static const int BIN_COUNT = 16;
+    // 並列に構築する部分木の最小の大きさ (これより小さい木はスレッド 1 本で構築する)
+    static const size_t PARALLEL_BUILD_MIN_SEGMENTS = 4096;
+
+    // segments から木を作り直す。pool が nullptr でなければ並列に構築する。
+    void Build(const SegmentBuffer& segments, ThreadPool* pool = nullptr);
+    // segments の座標で箱の大きさだけを計算し直す (木の形は変えない)。
+    // segments は Build に渡したものと同じ本数・同じ並びでなければならない (違う場合は Build し直す)。
+    void Refit(const SegmentBuffer& segments, ThreadPool* pool = nullptr);
+    // 構築済みの木 (nodeCount 個のノードと、木の順番に並んだ線分 orderedSegments) をそのまま使う。
+    // ノードの範囲や子の番号が壊れている場合は何もせずに false を返す (木は空になる)。
+    bool Assign(const BVHNode* treeNodes, size_t nodeCount, const SegmentBuffer& treeOrderedSegments);
+
+    // 視錐台に (一部でも) 入る線分の範囲を out に書き込む (out の以前の内容は消去される)。
+    // 範囲は GetSegments() の中の添字で、先頭から順に並び、隣り合う同じ種類の範囲は 1 つにまとめられる。
+    void Cull(const Frustum& frustum, std::vector<SegmentRange>& out) const;
+
+    // 木の順番に並べ替えた線分 (Cull が返す範囲はこの中の添字)
+    const SegmentBuffer& GetSegments() const { return orderedSegments; }
+    // GetSegments() の i 番目の線分が、Build に渡した線分の何番目だったか
+    // (Assign で読み込んだ木では i そのもの)
+    uint32_t GetOriginalIndex(size_t i) const { return order.empty() ? static_cast<uint32_t>(i) : order[i]; }
+    const std::vector<BVHNode>& GetNodes() const { return nodes; }
+    size_t Size() const { return orderedSegments.Size(); }
+    bool Empty() const { return nodes.empty(); }
+
+private:
+    // 構築中に参照するデータ (Build の間だけ使う)
+    struct BuildContext {
+        const SegmentBuffer* segments; // Build に渡された線分 (元の並び)
+        const float* centers[3];       // 線分ごとの AABB の中心 (x, y, z)
+    };
+
+    // node の AABB を、node の範囲の線分 (order を通して元の並びの segments を参照する) から計算する
+    void ComputeNodeBounds(BVHNode& node, const SegmentBuffer& segments) const;
+    // node を 2 つに分ける位置を binned SAH で探し、node の範囲の order を左右に並べ替える。
+    // 分けられたら左の子の本数 (1 ～ count-1) を返す。全ての中心が同じ位置で分けられない場合は 0 を返す。
+    size_t Partition(const BVHNode& node, const BuildContext& context);
+    // treeNodes[rootIndex] 以下の部分木を、treeNodes の末尾に子を追加しながら構築する。
+    // 子の本数が stopSegments 以下になったノードは分割せずに stopped に追加する (stopped が nullptr なら最後まで分割する)。
+    void BuildSubtree(std::vector<BVHNode>& treeNodes, uint32_t rootIndex, const BuildContext& context,
+        size_t stopSegments, std::vector<uint32_t>* stopped);
+
+    std::vector<BVHNode> nodes;    // 全ノード (添字 0 が根。子は必ず親より後ろにある)
+    std::vector<uint32_t> order;   // 木の順番 → 元の線分の添字 (Assign で読み込んだ木では空 = 同じ添字)
+    SegmentBuffer orderedSegments; // 木の順番に並べ替えた線分
+    std::vector<float> centers[3]; // 構築用: 線分ごとの AABB の中心 (x, y, z)
+};
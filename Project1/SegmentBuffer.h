@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>           // std::copy, std::max
+#include <cstddef>             // std::size_t
+#include <memory>              // std::shared_ptr (外部のメモリの寿命管理)
+#include <utility>             // std::move
+#include <vector>              // std::vector (内部の格納領域)
+#include "Vector.h"            // Vector3D 構造体
+#include "AlignedAllocator.h"  // 32バイト境界に揃えたメモリ確保
+#include "GeometryVersion.h"   // GeometryVersion (内容の版番号)
+
+/*
+ * SegmentBuffer.h
+ * 役割:
+ *   ワールド空間の線分 (始点と終点のペア) をまとめて格納するコンテナ `SegmentBuffer` を定義します。
+ *   以前は `std::vector<std::vector<Vector3D>>` で 1 本の線ごとに別々の vector を作っていましたが、
+ *   線分が増えると、線ごとのメモリ確保とポインタのたどり直し (キャッシュミス) が
+ *   描画時間の大半を占めるようになるため、このコンテナに置き換えました。
+ *
+ * データの持ち方 (SoA: Structure of Arrays):
+ *   - 端点の X, Y, Z 座標を、それぞれ別の連続した float 配列 (`xs`, `ys`, `zs`) に格納します。
+ *   - i 番目の線分の始点は配列の `2*i` 番目、終点は `2*i+1` 番目の要素です。
+ *   - 各配列の先頭は 32 バイト境界に揃えてあるため、SSE/AVX で一度に複数の点を処理できます。
+ *   - 線分 1 本あたりのメモリは float 6 個分 (24バイト) だけで、vector のヘッダーなどの無駄がありません。
+ *
+ * 外部のメモリの参照 (ゼロコピー):
+ *   - `FromExternal` で、ファイルをメモリにマップした領域 (SceneFile.h) などにある座標配列を、
+ *     コピーせずにそのままこのバッファの内容として参照できます。参照中は読み取り専用として扱います。
+ *   - 参照中のバッファに線分を追加するなど内容を変更すると、その時点で自前の配列にコピーしてから変更します。
+ *   - 外部のメモリの寿命は owner (shared_ptr) で管理し、バッファやそのコピーが残っている間は解放されません。
+ *
+ * 版番号:
+ *   - 線分を追加・削除するたびに版番号 (`GetVersion`) が変わります。Camera::Draw は、前のフレームと
+ *     同じバッファの同じ版番号なら、変換とクリッピングをせずに前のフレームの結果を使い回します。
+ *
+ * 使い方:
+ *   SegmentBuffer lines;
+ *   lines.Reserve(1000);                        // 事前に容量を確保 (任意)
+ *   lines.Append({ 0, 0, 0 }, { 10, 0, 0 });    // 線分を 1 本追加
+ *   lines.Append(otherLines);                   // 別のバッファの線分をまとめて追加
+ *   for (size_t i = 0; i < lines.Size(); ++i) { // 添字で走査
+ *       Vector3D a = lines.GetStart(i), b = lines.GetEnd(i);
+ *   }
+ *   lines.ForEach([](const Vector3D& a, const Vector3D& b) { ... }); // 関数オブジェクトで走査
+ */
+
+class SegmentBuffer
+{
+public:
+    // 各座標配列の先頭を揃えるバイト境界 (AVX の 256 ビット = 32 バイト)
+    static const std::size_t ALIGNMENT = 32;
+    // 座標配列の型 (32 バイト境界に揃った float の vector)
+    typedef std::vector<float, AlignedAllocator<float, ALIGNMENT>> FloatArray;
+
+    SegmentBuffer() = default;
+
+    // 外部の座標配列 (各 pointCount 個。点 2*i が i 番目の線分の始点、2*i+1 が終点) を、コピーせずに参照するバッファを作る。
+    // owner は配列の寿命を管理するオブジェクト (マップしたファイルなど) で、バッファが使われている間は保持される。
+    static SegmentBuffer FromExternal(const float* xs, const float* ys, const float* zs, std::size_t pointCount,
+        std::shared_ptr<const void> owner) {
+        SegmentBuffer buffer;
+        buffer.extX = xs; buffer.extY = ys; buffer.extZ = zs;
+        buffer.extPointCount = pointCount & ~static_cast<std::size_t>(1); // 偶数に切り下げ
+        buffer.extOwner = std::move(owner);
+        buffer.external = true;
+        return buffer;
+    }
+    // 外部のメモリを参照している (まだ自前の配列にコピーしていない) なら true
+    bool IsExternal() const { return external; }
+
+    // --- 容量・サイズ関連 ---
+    // 線分 segmentCount 本分の容量を事前に確保する (再確保の回数を減らすため)
+    void Reserve(std::size_t segmentCount) {
+        Detach();
+        xs.reserve(segmentCount * 2);
+        ys.reserve(segmentCount * 2);
+        zs.reserve(segmentCount * 2);
+    }
+    // 全ての線分を削除する (確保済みの容量は保持される)
+    // (外部のメモリを参照していた場合は、コピーせずに参照をやめる)
+    void Clear() { ReleaseExternal(); xs.clear(); ys.clear(); zs.clear(); version.Touch(); }
+    // 格納されている線分の本数
+    std::size_t Size() const { return PointCount() / 2; }
+    // 格納されている端点の個数 (= 線分の本数 * 2)
+    std::size_t PointCount() const { return external ? extPointCount : xs.size(); }
+    // 線分が 1 本もなければ true
+    bool Empty() const { return PointCount() == 0; }
+
+    // --- 追加 ---
+    // 線分を 1 本追加する
+    void Append(const Vector3D& start, const Vector3D& end) {
+        Detach();
+        version.Touch();
+        xs.push_back(start.x); xs.push_back(end.x);
+        ys.push_back(start.y); ys.push_back(end.y);
+        zs.push_back(start.z); zs.push_back(end.z);
+    }
+    // 別のバッファに格納されている線分を、まとめて末尾に追加する
+    // (other が自分自身でもよい。その場合は追加前の線分をもう 1 組追加する)
+    void Append(const SegmentBuffer& other) {
+        const std::size_t n = other.PointCount(); // other が自分自身なら、追加前の端点の数
+        const std::size_t oldCount = PointCount();
+        // 先に容量を確保してから大きさを変えるので、コピーの途中で配列が再確保されることはない
+        // (自分自身からコピーする場合も、読み出す [0, n) と書き込む [oldCount, oldCount + n) は重ならない)
+        GrowFor(n);
+        version.Touch();
+        xs.resize(oldCount + n); ys.resize(oldCount + n); zs.resize(oldCount + n);
+        std::copy(other.X(), other.X() + n, xs.begin() + oldCount);
+        std::copy(other.Y(), other.Y() + n, ys.begin() + oldCount);
+        std::copy(other.Z(), other.Z() + n, zs.begin() + oldCount);
+    }
+    // (始点, 終点, 始点, 終点, ...) の順に並んだ点の配列から、pointCount / 2 本の線分を追加する
+    // pointCount が奇数の場合、最後の 1 点は無視される
+    void AppendPoints(const Vector3D* points, std::size_t pointCount) {
+        std::size_t usable = pointCount & ~static_cast<std::size_t>(1); // 偶数に切り下げ
+        GrowFor(usable);
+        version.Touch();
+        for (std::size_t i = 0; i < usable; ++i) {
+            xs.push_back(points[i].x);
+            ys.push_back(points[i].y);
+            zs.push_back(points[i].z);
+        }
+    }
+
+    // --- 参照 ---
+    // i 番目の線分の始点・終点を Vector3D として取得する
+    Vector3D GetStart(std::size_t i) const { return { X()[2 * i], Y()[2 * i], Z()[2 * i] }; }
+    Vector3D GetEnd(std::size_t i) const { return { X()[2 * i + 1], Y()[2 * i + 1], Z()[2 * i + 1] }; }
+
+    // 座標配列の先頭ポインタ (SIMD などで直接まとめて処理する場合に使う)
+    // 要素数は PointCount() で、点 2*i が i 番目の線分の始点、点 2*i+1 が終点
+    const float* X() const { return external ? extX : xs.data(); }
+    const float* Y() const { return external ? extY : ys.data(); }
+    const float* Z() const { return external ? extZ : zs.data(); }
+
+    // 内容の版番号 (線分を追加・削除するたびに変わる。プログラム全体で一意)
+    uint64_t GetVersion() const { return version.Get(); }
+
+    // 全ての線分について、func(始点, 終点) を順番に呼び出す
+    template <typename Func>
+    void ForEach(Func func) const {
+        const std::size_t count = Size();
+        for (std::size_t i = 0; i < count; ++i) {
+            func(GetStart(i), GetEnd(i));
+        }
+    }
+
+private:
+    // 外部のメモリを参照していれば、内容を自前の配列にコピーして参照をやめる (内容を変更する前に呼ぶ)
+    void Detach() {
+        if (!external) { return; }
+        xs.assign(extX, extX + extPointCount);
+        ys.assign(extY, extY + extPointCount);
+        zs.assign(extZ, extZ + extPointCount);
+        ReleaseExternal();
+    }
+    // 外部のメモリの参照をやめる (内容はコピーしない)
+    void ReleaseExternal() {
+        external = false;
+        extX = extY = extZ = nullptr;
+        extPointCount = 0;
+        extOwner.reset();
+    }
+    // 端点を pointCount 個追加できるように容量を確保する (内容を変更する前に呼ぶ)
+    // 足りないときは今の容量の 2 倍以上に広げるので、少しずつ何度も追加しても再確保は対数回で済む
+    void GrowFor(std::size_t pointCount) {
+        Detach();
+        const std::size_t required = xs.size() + pointCount;
+        if (required <= xs.capacity()) { return; }
+        const std::size_t newCapacity = std::max(required, xs.capacity() * 2);
+        xs.reserve(newCapacity);
+        ys.reserve(newCapacity);
+        zs.reserve(newCapacity);
+    }
+
+    FloatArray xs; // 全端点の X 座標
+    FloatArray ys; // 全端点の Y 座標
+    FloatArray zs; // 全端点の Z 座標
+
+    // 外部のメモリを参照している場合 (external が true) の座標配列。このときは xs, ys, zs は使わない。
+    bool external = false;
+    const float* extX = nullptr;
+    const float* extY = nullptr;
+    const float* extZ = nullptr;
+    std::size_t extPointCount = 0;
+    std::shared_ptr<const void> extOwner; // 外部のメモリの寿命を管理するオブジェクト
+    GeometryVersion version;              // 内容の版番号
+};
+
+// SegmentBuffer 内の連続した線分の範囲 [first, first + count)
+// BVH による視錐台カリング (SegmentBVH.h) の結果として、描画する範囲を WireframePipeline に渡すのに使う。
+struct SegmentRange {
+    std::size_t first;  // 先頭の線分の添字
+    std::size_t count;  // 線分の本数
+    bool needsClipping; // false なら範囲内の全線分が視錐台の内部にあり、クリッピングを省略できる
+};
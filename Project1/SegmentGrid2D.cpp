@@ -0,0 +1,154 @@
+#include "SegmentGrid2D.h" // 対応するヘッダーファイル
+#include <algorithm>       // std::min, std::max, std::sort
+#include <cfloat>          // FLT_MAX
+#include <cmath>           // sqrtf, floorf
+
+/*
+ * SegmentGrid2D.cpp
+ * 概要:
+ *   SegmentGrid2D クラスの実装です。
+ *   Build は 2 回に分けて線分を走査します (1 回目でセルごとの本数を数え、2 回目で添字を書き込む)。
+ *   線分を添字の順に書き込むため、各セルの中の添字は常に昇順になります。
+ */
+
+// 静的定数メンバーの定義 (値はヘッダー側で指定。std::min などで参照として使うために必要)
+const size_t SegmentGrid2D::MAX_CELLS_PER_SEGMENT;
+const int SegmentGrid2D::MAX_CELLS_PER_AXIS;
+
+namespace {
+    // 自動でセルの大きさを決めるとき、セル 1 つあたりに入れたい線分の本数の目安
+    const float TARGET_SEGMENTS_PER_CELL = 2.0f;
+}
+
+// ワールド座標 x を X 方向のセル番号に変換する
+int SegmentGrid2D::CellX(float x) const {
+    const int c = static_cast<int>(floorf((x - originX) * invCellSize));
+    return std::min(std::max(c, 0), cellCountX - 1);
+}
+
+// ワールド座標 z を Z 方向のセル番号に変換する
+int SegmentGrid2D::CellZ(float z) const {
+    const int c = static_cast<int>(floorf((z - originZ) * invCellSize));
+    return std::min(std::max(c, 0), cellCountZ - 1);
+}
+
+// 全線分をグリッドに登録する
+void SegmentGrid2D::Build(const SegmentBuffer& segments, float requestedCellSize)
+{
+    cellStart.clear();
+    cellSegments.clear();
+    segmentMinCell.clear();
+    largeSegments.clear();
+    largeSegmentRects.clear();
+    cellCountX = cellCountZ = 0;
+
+    const size_t segmentCount = segments.Size();
+    if (segmentCount == 0) { return; }
+    const float* xs = segments.X();
+    const float* zs = segments.Z();
+
+    // 1. シーン全体の XZ の範囲を求める
+    float minX = FLT_MAX, minZ = FLT_MAX, maxX = -FLT_MAX, maxZ = -FLT_MAX;
+    for (size_t p = 0; p < segments.PointCount(); ++p) {
+        minX = std::min(minX, xs[p]); maxX = std::max(maxX, xs[p]);
+        minZ = std::min(minZ, zs[p]); maxZ = std::max(maxZ, zs[p]);
+    }
+    const float extentX = std::max(maxX - minX, 1e-3f);
+    const float extentZ = std::max(maxZ - minZ, 1e-3f);
+
+    // 2. セルの大きさと数を決める
+    //    自動の場合は、セル 1 つあたり TARGET_SEGMENTS_PER_CELL 本程度になる大きさにする
+    if (requestedCellSize > 0.0f) {
+        cellSize = requestedCellSize;
+    }
+    else {
+        const float targetCells = std::max(1.0f, static_cast<float>(segmentCount) / TARGET_SEGMENTS_PER_CELL);
+        cellSize = sqrtf(extentX * extentZ / targetCells);
+    }
+    // 1 軸あたりのセル数の上限を超えないように、必要ならセルを大きくする
+    cellSize = std::max(cellSize, std::max(extentX, extentZ) / static_cast<float>(MAX_CELLS_PER_AXIS));
+    invCellSize = 1.0f / cellSize;
+    originX = minX;
+    originZ = minZ;
+    cellCountX = std::min(MAX_CELLS_PER_AXIS, static_cast<int>(extentX * invCellSize) + 1);
+    cellCountZ = std::min(MAX_CELLS_PER_AXIS, static_cast<int>(extentZ * invCellSize) + 1);
+    const size_t cellCount = static_cast<size_t>(cellCountX) * static_cast<size_t>(cellCountZ);
+
+    // 3. 1 回目の走査: 各線分の AABB が重なるセルの範囲を求め、セルごとの本数を数える
+    segmentMinCell.resize(segmentCount);
+    std::vector<uint32_t> segmentMaxCell(segmentCount); // 線分ごとの AABB の最大セル (Build の間だけ使う)
+    cellStart.assign(cellCount + 1, 0);
+    for (size_t i = 0; i < segmentCount; ++i) {
+        const float x1 = xs[2 * i], x2 = xs[2 * i + 1];
+        const float z1 = zs[2 * i], z2 = zs[2 * i + 1];
+        const int cx0 = CellX(std::min(x1, x2)), cx1 = CellX(std::max(x1, x2));
+        const int cz0 = CellZ(std::min(z1, z2)), cz1 = CellZ(std::max(z1, z2));
+        const size_t cells = static_cast<size_t>(cx1 - cx0 + 1) * static_cast<size_t>(cz1 - cz0 + 1);
+        if (cells > MAX_CELLS_PER_SEGMENT) {
+            // 大きな線分: セルには登録せず、AABB で直接判定する
+            largeSegments.push_back(static_cast<uint32_t>(i));
+            largeSegmentRects.push_back({ std::min(x1, x2), std::min(z1, z2), std::max(x1, x2), std::max(z1, z2) });
+            segmentMinCell[i] = segmentMaxCell[i] = UINT32_MAX; // 目印 (セルには登録しない)
+            continue;
+        }
+        segmentMinCell[i] = static_cast<uint32_t>(cx0) | (static_cast<uint32_t>(cz0) << 16);
+        segmentMaxCell[i] = static_cast<uint32_t>(cx1) | (static_cast<uint32_t>(cz1) << 16);
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            for (int cx = cx0; cx <= cx1; ++cx) { ++cellStart[static_cast<size_t>(cz) * cellCountX + cx + 1]; }
+        }
+    }
+
+    // 4. 本数の累積和から、各セルの開始位置を求める
+    for (size_t c = 0; c < cellCount; ++c) { cellStart[c + 1] += cellStart[c]; }
+
+    // 5. 2 回目の走査: 各セルに線分の添字を書き込む (添字の順に書くので、セルの中は昇順になる)
+    cellSegments.resize(cellStart[cellCount]);
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1); // 各セルの次の書き込み位置
+    for (size_t i = 0; i < segmentCount; ++i) {
+        if (segmentMinCell[i] == UINT32_MAX) { continue; }
+        const int cx0 = static_cast<int>(segmentMinCell[i] & 0xFFFF), cz0 = static_cast<int>(segmentMinCell[i] >> 16);
+        const int cx1 = static_cast<int>(segmentMaxCell[i] & 0xFFFF), cz1 = static_cast<int>(segmentMaxCell[i] >> 16);
+        for (int cz = cz0; cz <= cz1; ++cz) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                cellSegments[cursor[static_cast<size_t>(cz) * cellCountX + cx]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+}
+
+// 矩形と重なる可能性のある線分の添字を求める
+void SegmentGrid2D::Query(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& out) const
+{
+    out.clear();
+    if (cellCountX == 0) { return; }
+
+    // 1. 矩形と重なるセルの線分を集める
+    //    グリッドの外にはみ出した矩形は、CellX/CellZ で端のセルに丸められる。
+    //    矩形がグリッドの完全に外にあるときは、セルの線分は 1 本も重ならないので飛ばす。
+    const float gridMaxX = originX + cellSize * static_cast<float>(cellCountX);
+    const float gridMaxZ = originZ + cellSize * static_cast<float>(cellCountZ);
+    if (maxX >= originX && minX <= gridMaxX && maxZ >= originZ && minZ <= gridMaxZ) {
+        const int qx0 = CellX(minX), qx1 = CellX(maxX);
+        const int qz0 = CellZ(minZ), qz1 = CellZ(maxZ);
+        for (int cz = qz0; cz <= qz1; ++cz) {
+            for (int cx = qx0; cx <= qx1; ++cx) {
+                const size_t c = static_cast<size_t>(cz) * cellCountX + cx;
+                for (uint32_t k = cellStart[c]; k < cellStart[c + 1]; ++k) {
+                    const uint32_t i = cellSegments[k];
+                    // 線分のセル範囲と矩形のセル範囲が重なる部分のうち、最も左上のセルでだけ出力する (重複防止)
+                    const int sx0 = static_cast<int>(segmentMinCell[i] & 0xFFFF), sz0 = static_cast<int>(segmentMinCell[i] >> 16);
+                    if (cx == std::max(sx0, qx0) && cz == std::max(sz0, qz0)) { out.push_back(i); }
+                }
+            }
+        }
+    }
+
+    // 2. 大きな線分は AABB で直接判定する
+    for (size_t k = 0; k < largeSegments.size(); ++k) {
+        const Rect& r = largeSegmentRects[k];
+        if (r.maxX >= minX && r.minX <= maxX && r.maxZ >= minZ && r.minZ <= maxZ) { out.push_back(largeSegments[k]); }
+    }
+
+    // 3. 元の線分の順番 (添字の昇順) に並べる (描画の順番を、インデックスを使わない場合と同じにするため)
+    std::sort(out.begin(), out.end());
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>         // size_t
+#include <cstdint>         // uint32_t
+#include <vector>          // std::vector
+#include "SegmentBuffer.h" // SegmentBuffer
+
+/*
+ * SegmentGrid2D.h
+ * 役割:
+ *   線分を XZ 平面 (真上から見た平面) に投影し、等間隔の格子 (一様グリッド) に登録する
+ *   2D 空間インデックス `SegmentGrid2D` を定義します。
+ *   トップダウンビュー (TopAngle) は、表示範囲 (カメラの周りの小さな矩形) と重なるセルの線分だけを
+ *   問い合わせることで、シーン全体の線分を毎フレーム変換せずに済みます。
+ *
+ * 仕組み:
+ *   - 線分の XZ の AABB が重なる全てのセルに、その線分の添字を登録します。
+ *     登録先は CSR 形式 (セルごとの開始位置 cellStart と、全セル分を連結した添字の配列 cellSegments) で持ちます。
+ *   - 1 本の線分が複数のセルに登録されるため、問い合わせでは「線分の AABB と問い合わせ矩形が重なる
+ *     セルのうち、最も左上 (x, z が最小) のセル」でだけその線分を出力し、重複を防ぎます。
+ *     この判定は線分ごとに記録した最小セルだけで行えるため、作業用の配列は要りません。
+ *   - 地面のグリッド線のように非常に長い線分は、登録先のセルが多くなりすぎるため、
+ *     セルには登録せず「大きな線分」のリストに入れ、問い合わせのたびに AABB で直接判定します。
+ *   - セルの大きさは、省略するとシーンの広さと線分の本数から自動で決めます。
+ *
+ * 使い方:
+ *   SegmentGrid2D grid;
+ *   grid.Build(worldLines);                         // 起動時などに 1 回 (線分が変わったら作り直す)
+ *   std::vector<uint32_t> hits;
+ *   grid.Query(minX, minZ, maxX, maxZ, hits);       // 矩形と重なる可能性のある線分の添字 (昇順)
+ *   for (uint32_t i : hits) { worldLines.GetStart(i); ... }
+ */
+
+class SegmentGrid2D
+{
+public:
+    // 1 本の線分を登録するセルの最大数 (これより多くのセルにまたがる線分は「大きな線分」として別に扱う)
+    static const size_t MAX_CELLS_PER_SEGMENT = 64;
+    // 1 軸あたりのセルの最大数
+    static const int MAX_CELLS_PER_AXIS = 1024;
+
+    // segments の全線分を登録する (以前の内容は消去される)。
+    // cellSize: セルの一辺の長さ (ワールド単位)。0 以下なら自動で決める。
+    void Build(const SegmentBuffer& segments, float cellSize = 0.0f);
+
+    // XZ 平面の矩形 [minX, maxX] × [minZ, maxZ] と重なる可能性のある線分の添字を、昇順に out に書き込む
+    // (out の以前の内容は消去される)。セル単位で判定するため、矩形の少し外の線分も含まれることがある。
+    void Query(float minX, float minZ, float maxX, float maxZ, std::vector<uint32_t>& out) const;
+
+    float GetCellSize() const { return cellSize; }
+    int GetCellCountX() const { return cellCountX; }
+    int GetCellCountZ() const { return cellCountZ; }
+    size_t GetLargeSegmentCount() const { return largeSegments.size(); }
+
+private:
+    // ワールド座標をセルの番号に変換する (グリッドの外はグリッドの端のセルに丸める)
+    int CellX(float x) const;
+    int CellZ(float z) const;
+
+    // XZ 平面の AABB (大きな線分の判定用)
+    struct Rect { float minX, minZ, maxX, maxZ; };
+
+    float originX = 0.0f, originZ = 0.0f; // グリッドの左上 (x, z が最小) の角のワールド座標
+    float cellSize = 1.0f;                // セルの一辺の長さ
+    float invCellSize = 1.0f;             // 1 / cellSize
+    int cellCountX = 0, cellCountZ = 0;   // X, Z 方向のセルの数
+
+    std::vector<uint32_t> cellStart;      // セル c の線分は cellSegments[cellStart[c] .. cellStart[c+1]) (セルの数 + 1 個)
+    std::vector<uint32_t> cellSegments;   // 全セルの線分の添字を連結したもの (各セルの中は昇順)
+    std::vector<uint32_t> segmentMinCell; // 線分ごとの AABB の最小セル (下位 16 ビットが X、上位 16 ビットが Z)
+    std::vector<uint32_t> largeSegments;  // セルに登録しない大きな線分の添字 (昇順)
+    std::vector<Rect> largeSegmentRects;  // 大きな線分の XZ の AABB
+};
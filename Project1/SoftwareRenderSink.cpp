@@ -0,0 +1,326 @@
+#include "SoftwareRenderSink.h" // 対応するヘッダーファイル
+#include "DrawCommandList.h"    // DrawCommandList, LineCommand
+#include <algorithm>            // std::min, std::max, std::swap
+#include <cmath>                // floor, floorf, fabsf, sqrtf, std::isfinite
+#include <cstdio>               // fopen, fwrite, fprintf (PPM の書き出し)
+#include <cstdint>              // int64_t
+#include <cstdlib>              // std::abs
+
+/*
+ * SoftwareRenderSink.cpp
+ * 概要:
+ *   SoftwareRenderSink クラスの実装です。
+ *   全ての描画は最終的に BlendPixel (1 ピクセルへの合成) を通り、そこでクリップ範囲の判定と
+ *   不透明度による合成 (dst + (src - dst) * alpha / 255) を行います。
+ *   線はクリップ範囲に入る部分だけをたどるので、DrawLine はピクセルごとの範囲の判定も省きます (BlendPixelInside)。
+ */
+
+namespace {
+    // 小数部分を返す (Xiaolin Wu のアルゴリズム用)
+    inline float FractionalPart(float v) { return v - floorf(v); }
+
+    // RasterizeLine が 64 ビットの整数演算で正確にクリップできる座標の大きさの上限
+    // (これを超える座標や NaN は、先に ClipLineToRect で小数のまま切り詰める)
+    const double MAX_EXACT_COORDINATE = 1 << 28;
+    inline bool IsExactCoordinate(double v) { return v >= -MAX_EXACT_COORDINATE && v <= MAX_EXACT_COORDINATE; }
+
+    // Liang-Barsky のアルゴリズムで、線分 (x1, y1)-(x2, y2) を矩形 [minX, maxX] x [minY, maxY] の内側の部分に切り詰める
+    // 戻り値: 矩形と重なる部分があれば true (座標が有限でない場合は false)。重ならなければ座標は変更しない
+    // (線分のパラメータ t (0～1) のうち、4 つの境界の内側にある範囲 [t0, t1] を求める。
+    //  両端が矩形内にある線分は t0 = 0, t1 = 1 のままなので、座標は全く変わらない)
+    bool ClipLineToRect(double& x1, double& y1, double& x2, double& y2, double minX, double minY, double maxX, double maxY) {
+        if (!(std::isfinite(x1) && std::isfinite(y1) && std::isfinite(x2) && std::isfinite(y2))) { return false; }
+        const double dx = x2 - x1, dy = y2 - y1;
+        // 各境界について「p * t <= q なら内側」となる p, q (左, 右, 上, 下)
+        const double p[4] = { -dx, dx, -dy, dy };
+        const double q[4] = { x1 - minX, maxX - x1, y1 - minY, maxY - y1 };
+        double t0 = 0.0, t1 = 1.0;
+        for (int i = 0; i < 4; ++i) {
+            if (p[i] == 0.0) { // 境界と平行
+                if (q[i] < 0.0) { return false; } // 境界の外側を平行に通る
+                continue;
+            }
+            const double t = q[i] / p[i];
+            if (p[i] < 0.0) { if (t > t1) { return false; } t0 = std::max(t0, t); } // 外側から入る
+            else { if (t < t0) { return false; } t1 = std::min(t1, t); }           // 内側から出る
+        }
+        const double startX = x1, startY = y1;
+        if (t1 < 1.0) { x2 = startX + dx * t1; y2 = startY + dy * t1; }
+        if (t0 > 0.0) { x1 = startX + dx * t0; y1 = startY + dy * t0; }
+        // 交点の計算の丸め誤差で矩形をわずかにはみ出さないように収める
+        x1 = std::min(std::max(x1, minX), maxX); y1 = std::min(std::max(y1, minY), maxY);
+        x2 = std::min(std::max(x2, minX), maxX); y2 = std::min(std::max(y2, minY), maxY);
+        return true;
+    }
+}
+
+// コンストラクタ: フレームバッファを確保し、背景色で塗りつぶす
+SoftwareRenderSink::SoftwareRenderSink(int width, int height)
+    : width(std::max(width, 0)), height(std::max(height, 0)),
+      pixels(static_cast<size_t>(std::max(width, 0)) * static_cast<size_t>(std::max(height, 0)) * 4) {
+    ResetClipRect();
+    Clear();
+}
+
+// フレームバッファ全体を背景色で塗りつぶす (クリップ範囲や不透明度の影響は受けない)
+void SoftwareRenderSink::Clear() {
+    const uint8_t r = static_cast<uint8_t>(GetRenderColorR(clearColor));
+    const uint8_t g = static_cast<uint8_t>(GetRenderColorG(clearColor));
+    const uint8_t b = static_cast<uint8_t>(GetRenderColorB(clearColor));
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i + 0] = r;
+        pixels[i + 1] = g;
+        pixels[i + 2] = b;
+        pixels[i + 3] = 255;
+    }
+}
+
+// 1 ピクセルに色を合成する (クリップ範囲の判定は呼び出し側で済んでいる)
+void SoftwareRenderSink::BlendPixelInside(int x, int y, RenderColor color, int alpha) {
+    uint8_t* p = &pixels[(static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4];
+    const int src[3] = { GetRenderColorR(color), GetRenderColorG(color), GetRenderColorB(color) };
+    if (alpha >= 255) { // 不透明なら上書き
+        p[0] = static_cast<uint8_t>(src[0]);
+        p[1] = static_cast<uint8_t>(src[1]);
+        p[2] = static_cast<uint8_t>(src[2]);
+        return;
+    }
+    for (int c = 0; c < 3; ++c) { // 半透明なら dst + (src - dst) * alpha / 255
+        p[c] = static_cast<uint8_t>(p[c] + (src[c] - p[c]) * alpha / 255);
+    }
+}
+
+// 1 行の区間を塗る
+void SoftwareRenderSink::FillSpan(int x1, int x2, int y, RenderColor color) {
+    if (y < clipY1 || y >= clipY2) { return; }
+    if (x1 > x2) { std::swap(x1, x2); }
+    x1 = std::max(x1, clipX1);
+    x2 = std::min(x2, clipX2 - 1);
+    for (int x = x1; x <= x2; ++x) { PlotPixel(x, y, color); }
+}
+
+// 線の描画 (両端のピクセルを含む)
+void SoftwareRenderSink::DrawLine(int x1, int y1, int x2, int y2, RenderColor color) {
+    if (clipX1 >= clipX2 || clipY1 >= clipY2) { return; } // クリップ範囲が空
+    if (!IsExactCoordinate(x1) || !IsExactCoordinate(y1) || !IsExactCoordinate(x2) || !IsExactCoordinate(y2)) {
+        // 極端に大きな座標は、先にクリップ範囲のピクセルの中心を結ぶ矩形に切り詰め、最も近いピクセルに丸める
+        double fx1 = x1, fy1 = y1, fx2 = x2, fy2 = y2;
+        if (!ClipLineToRect(fx1, fy1, fx2, fy2, clipX1, clipY1, clipX2 - 1, clipY2 - 1)) { return; }
+        x1 = static_cast<int>(floor(fx1 + 0.5)); y1 = static_cast<int>(floor(fy1 + 0.5));
+        x2 = static_cast<int>(floor(fx2 + 0.5)); y2 = static_cast<int>(floor(fy2 + 0.5));
+    }
+    RasterizeLine(x1, y1, x2, y2, color);
+}
+
+// Bresenham のアルゴリズムによる線の描画 (両端のピクセルを含む)
+// 長い方の軸 (主軸) に 1 ピクセルずつ進む。主軸の長さを L、もう一方 (副軸) の長さを M とすると、
+// k 番目 (0～L) のピクセルは 主軸 = 始点 + k、副軸 = 始点 + floor((2Mk + L) / 2L) (向きの符号は省略) になる。
+// そこから、クリップ範囲に入る k の区間 [k0, k1] を先に求め、その区間のピクセルだけをたどる
+// (クリップしない場合と全く同じピクセルを塗り、ピクセルごとの範囲の判定もしない)。
+void SoftwareRenderSink::RasterizeLine(int x1, int y1, int x2, int y2, RenderColor color) {
+    if (blendAlpha <= 0 || clipX1 >= clipX2 || clipY1 >= clipY2) { return; } // 完全に透明、またはクリップ範囲が空
+    const bool xMajor = std::abs(x2 - x1) >= std::abs(y2 - y1);
+    const int major1 = xMajor ? x1 : y1, major2 = xMajor ? x2 : y2;
+    const int minor1 = xMajor ? y1 : x1, minor2 = xMajor ? y2 : x2;
+    const int majorStep = (major1 < major2) ? 1 : -1, minorStep = (minor1 < minor2) ? 1 : -1;
+    const int64_t length = std::abs(major2 - major1), minorLength = std::abs(minor2 - minor1);
+    // 各軸のクリップ範囲を、始点からの進んだ量 (向きを正にした値) の範囲 [low, high] に直す
+    auto toOffsets = [](int start, int step, int clip1, int clip2, int64_t& low, int64_t& high) {
+        low = (step > 0) ? static_cast<int64_t>(clip1) - start : static_cast<int64_t>(start) - (clip2 - 1);
+        high = (step > 0) ? static_cast<int64_t>(clip2 - 1) - start : static_cast<int64_t>(start) - clip1;
+    };
+    int64_t majorLow, majorHigh, minorLow, minorHigh;
+    toOffsets(major1, majorStep, xMajor ? clipX1 : clipY1, xMajor ? clipX2 : clipY2, majorLow, majorHigh);
+    toOffsets(minor1, minorStep, xMajor ? clipY1 : clipX1, xMajor ? clipY2 : clipX2, minorLow, minorHigh);
+    // 主軸: k 自体が進んだ量
+    int64_t k0 = std::max<int64_t>(0, majorLow), k1 = std::min(length, majorHigh);
+    // 副軸: floor((2Mk + L) / 2L) が [minorLow, minorHigh] に入る k (長さ 0 の線は始点の 1 ピクセルだけ)
+    minorLow = std::max<int64_t>(minorLow, 0);
+    minorHigh = std::min(minorHigh, minorLength);
+    if (minorLow > minorHigh) { return; }
+    if (minorLength > 0) {
+        const int64_t twoL = 2 * length, twoM = 2 * minorLength;
+        if (minorLow > 0) { k0 = std::max(k0, (twoL * minorLow - length + twoM - 1) / twoM); }
+        k1 = std::min(k1, (twoL * (minorHigh + 1) - length + twoM - 1) / twoM - 1);
+    }
+    if (k0 > k1) { return; }
+
+    // k0 番目のピクセルから、誤差項を整数で更新しながら k1 番目まで進む
+    const int64_t twoL = 2 * length, twoM = 2 * minorLength;
+    int64_t minorOffset = (length > 0) ? (twoM * k0 + length) / twoL : 0;
+    int64_t remainder = (length > 0) ? (twoM * k0 + length) - minorOffset * twoL : 0; // 0 <= remainder < 2L
+    int major = major1 + majorStep * static_cast<int>(k0);
+    int minor = minor1 + minorStep * static_cast<int>(minorOffset);
+    for (int64_t k = k0;; ++k) {
+        if (xMajor) { BlendPixelInside(major, minor, color, blendAlpha); }
+        else { BlendPixelInside(minor, major, color, blendAlpha); }
+        if (k == k1) { break; }
+        major += majorStep;
+        remainder += twoM;
+        if (remainder >= twoL) { remainder -= twoL; minor += minorStep; } // 副軸にも 1 ピクセル進む
+    }
+}
+
+// Xiaolin Wu のアルゴリズムによるアンチエイリアス付きの線の描画
+void SoftwareRenderSink::DrawLineAA(float x1, float y1, float x2, float y2, RenderColor color) {
+    // クリップ範囲を 2 ピクセル広げた矩形に切り詰める (端点の減光はその外側で起きるので、範囲内の見た目は変わらない)
+    double cx1 = x1, cy1 = y1, cx2 = x2, cy2 = y2;
+    if (clipX1 >= clipX2 || clipY1 >= clipY2) { return; }
+    if (!ClipLineToRect(cx1, cy1, cx2, cy2, clipX1 - 2.0, clipY1 - 2.0, clipX2 + 1.0, clipY2 + 1.0)) { return; }
+    x1 = static_cast<float>(cx1); y1 = static_cast<float>(cy1);
+    x2 = static_cast<float>(cx2); y2 = static_cast<float>(cy2);
+
+    // 傾きが急な線 (|dy| > |dx|) は x と y を入れ替えて、常に x 方向に進むようにする
+    const bool steep = fabsf(y2 - y1) > fabsf(x2 - x1);
+    if (steep) { std::swap(x1, y1); std::swap(x2, y2); }
+    if (x1 > x2) { std::swap(x1, x2); std::swap(y1, y2); }
+
+    const float dx = x2 - x1, dy = y2 - y1;
+    const float gradient = (dx == 0.0f) ? 1.0f : dy / dx; // x が 1 進むごとの y の増分
+
+    // カバレッジ (0.0～1.0) を不透明度に変換してピクセルに合成する
+    auto plot = [&](int x, int y, float coverage) {
+        const int alpha = static_cast<int>(coverage * static_cast<float>(blendAlpha) + 0.5f);
+        if (steep) { BlendPixel(y, x, color, alpha); }
+        else { BlendPixel(x, y, color, alpha); }
+    };
+
+    // 始点側の端: 端点がピクセルの途中にある分だけカバレッジを減らす
+    float xEnd = floorf(x1 + 0.5f);
+    float yEnd = y1 + gradient * (xEnd - x1);
+    float xGap = 1.0f - FractionalPart(x1 + 0.5f);
+    const int xStart = static_cast<int>(xEnd);
+    plot(xStart, static_cast<int>(floorf(yEnd)), (1.0f - FractionalPart(yEnd)) * xGap);
+    plot(xStart, static_cast<int>(floorf(yEnd)) + 1, FractionalPart(yEnd) * xGap);
+    float intery = yEnd + gradient; // 次の列での線の y 座標
+
+    // 終点側の端
+    xEnd = floorf(x2 + 0.5f);
+    yEnd = y2 + gradient * (xEnd - x2);
+    xGap = FractionalPart(x2 + 0.5f);
+    const int xStop = static_cast<int>(xEnd);
+    plot(xStop, static_cast<int>(floorf(yEnd)), (1.0f - FractionalPart(yEnd)) * xGap);
+    plot(xStop, static_cast<int>(floorf(yEnd)) + 1, FractionalPart(yEnd) * xGap);
+
+    // 中間の列: 線の y 座標をまたぐ上下 2 ピクセルに、距離に応じてカバレッジを振り分ける
+    for (int x = xStart + 1; x < xStop; ++x) {
+        const int y = static_cast<int>(floorf(intery));
+        plot(x, y, 1.0f - FractionalPart(intery));
+        plot(x, y + 1, FractionalPart(intery));
+        intery += gradient;
+    }
+}
+
+// ボックスの描画 (右端 x2・下端 y2 は含まない)
+void SoftwareRenderSink::DrawBox(int x1, int y1, int x2, int y2, RenderColor color, bool fill) {
+    if (x1 > x2) { std::swap(x1, x2); }
+    if (y1 > y2) { std::swap(y1, y2); }
+    if (x1 == x2 || y1 == y2) { return; } // 面積がない
+    if (fill) {
+        for (int y = y1; y < y2; ++y) { FillSpan(x1, x2 - 1, y, color); }
+        return;
+    }
+    // 枠線: 上下の辺と、左右の辺 (角のピクセルを二重に塗らないように上下の辺を除く)
+    FillSpan(x1, x2 - 1, y1, color);
+    if (y2 - 1 != y1) { FillSpan(x1, x2 - 1, y2 - 1, color); }
+    for (int y = y1 + 1; y < y2 - 1; ++y) {
+        PlotPixel(x1, y, color);
+        if (x2 - 1 != x1) { PlotPixel(x2 - 1, y, color); }
+    }
+}
+
+// 円の描画 (円周は中点円アルゴリズム、塗りつぶしは各行の幅を計算して水平線で埋める)
+void SoftwareRenderSink::DrawCircle(int cx, int cy, int radius, RenderColor color, bool fill) {
+    if (radius < 0) { return; }
+    if (fill) {
+        // 中心から dy 行離れた行の半幅は sqrt(r^2 - dy^2)
+        for (int dy = -radius; dy <= radius; ++dy) {
+            const int halfWidth = static_cast<int>(sqrtf(static_cast<float>(radius * radius - dy * dy)));
+            FillSpan(cx - halfWidth, cx + halfWidth, cy + dy, color);
+        }
+        return;
+    }
+    int x = radius, y = 0;
+    int err = 1 - radius; // 判定値 (次の点が円周の内側か外側か)
+    while (x >= y) {
+        // 8 つの対称な点を塗る
+        PlotPixel(cx + x, cy + y, color); PlotPixel(cx - x, cy + y, color);
+        PlotPixel(cx + x, cy - y, color); PlotPixel(cx - x, cy - y, color);
+        PlotPixel(cx + y, cy + x, color); PlotPixel(cx - y, cy + x, color);
+        PlotPixel(cx + y, cy - x, color); PlotPixel(cx - y, cy - x, color);
+        ++y;
+        if (err < 0) { err += 2 * y + 1; }
+        else { --x; err += 2 * (y - x) + 1; }
+    }
+}
+
+// 描画コマンドリストの線を記録順に 1 回のループでラスタライズする
+// (クラス名を付けて呼ぶことで、線ごとの仮想関数呼び出しを避ける)
+void SoftwareRenderSink::Submit(const DrawCommandList& commands) {
+    if (clipX1 >= clipX2 || clipY1 >= clipY2) { return; } // クリップ範囲が空
+    for (const LineCommand& c : commands) {
+        if (c.antialias) { SoftwareRenderSink::DrawLineAA(c.x1, c.y1, c.x2, c.y2, c.color); continue; }
+        // 小数部分を切り捨てて整数にする。極端に大きな座標 (と NaN) は、int に変換する前に
+        // 小数のままクリップ範囲 ([clipX1, clipX2) x [clipY1, clipY2)) に切り詰める
+        double x1 = c.x1, y1 = c.y1, x2 = c.x2, y2 = c.y2;
+        if (!IsExactCoordinate(x1) || !IsExactCoordinate(y1) || !IsExactCoordinate(x2) || !IsExactCoordinate(y2)) {
+            if (!ClipLineToRect(x1, y1, x2, y2, clipX1, clipY1, clipX2 - 0.001, clipY2 - 0.001)) { continue; }
+        }
+        RasterizeLine(static_cast<int>(x1), static_cast<int>(y1), static_cast<int>(x2), static_cast<int>(y2), c.color);
+    }
+}
+
+// 文字列の描画 (フォントを持たないので何もしない)
+void SoftwareRenderSink::DrawString(int, int, const char*, RenderColor) {
+}
+
+// 以降の描画の不透明度を設定する
+void SoftwareRenderSink::SetBlendAlpha(int alpha) {
+    blendAlpha = std::min(std::max(alpha, 0), 255);
+}
+
+// 描画範囲を限定する (フレームバッファの範囲に収める)
+void SoftwareRenderSink::SetClipRect(int x1, int y1, int x2, int y2) {
+    clipX1 = std::max(std::min(x1, x2), 0);
+    clipY1 = std::max(std::min(y1, y2), 0);
+    clipX2 = std::min(std::max(x1, x2), width);
+    clipY2 = std::min(std::max(y1, y2), height);
+}
+
+// 描画範囲をフレームバッファ全体に戻す
+void SoftwareRenderSink::ResetClipRect() {
+    SetClipRect(0, 0, width, height);
+}
+
+// (x, y) のピクセルの色を返す
+RenderColor SoftwareRenderSink::GetPixel(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) { return 0; }
+    const uint8_t* p = &pixels[(static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4];
+    return GetRenderColor(p[0], p[1], p[2]);
+}
+
+// PPM (P6) 形式で保存する
+bool SoftwareRenderSink::WritePPM(const std::string& filename) const {
+    FILE* fp = nullptr;
+#if defined(_MSC_VER)
+    if (fopen_s(&fp, filename.c_str(), "wb") != 0) { fp = nullptr; } // MSVC では fopen_s を使う (SDL チェック対策)
+#else
+    fp = std::fopen(filename.c_str(), "wb");
+#endif
+    if (!fp) { return false; }
+    std::fprintf(fp, "P6\n%d %d\n255\n", width, height); // ヘッダー: 形式, 幅 高さ, 最大値
+    // 1 行ずつ RGBA から RGB に詰め直して書き出す
+    std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+    bool ok = true;
+    for (int y = 0; y < height && ok; ++y) {
+        const uint8_t* src = &pixels[static_cast<size_t>(y) * static_cast<size_t>(width) * 4];
+        for (int x = 0; x < width; ++x) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        ok = std::fwrite(row.data(), 1, row.size(), fp) == row.size();
+    }
+    std::fclose(fp);
+    return ok;
+}
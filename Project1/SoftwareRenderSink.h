@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>      // uint8_t
+#include <string>       // std::string (保存先のファイル名)
+#include <vector>       // std::vector (フレームバッファ)
+#include "RenderSink.h" // RenderSink インターフェース
+
+/*
+ * SoftwareRenderSink.h
+ * 役割:
+ *   `RenderSink` のソフトウェア版の実装です。DxLib やウィンドウを使わず、
+ *   メモリ上の RGBA フレームバッファ (1 ピクセル 4 バイト) に自前のアルゴリズムで描画します。
+ *   描画結果は PPM 画像 (`WritePPM`) として保存できるため、ウィンドウのない環境での
+ *   描画処理の実行・性能測定や、サーバー側での一括レンダリングに使えます。
+ *
+ * 描画アルゴリズム:
+ *   - DrawLine: Bresenham のアルゴリズム (整数演算のみで、線に沿ったピクセルを 1 つずつ塗る)
+ *   - 線はクリップ範囲に入る部分だけをラスタライズします。DrawLine は Bresenham の進み方を式で求めて
+ *     範囲に入るピクセルの区間を先に決め、DrawLineAA は Liang-Barsky のアルゴリズムで線分を切り詰めます。
+ *     そのため、画面から大きくはみ出した線でも範囲外のピクセルをたどらず、範囲外の座標を int に変換することもありません。
+ *   - DrawLineAA: Xiaolin Wu のアルゴリズム (線が各ピクセルを覆う割合 = カバレッジを不透明度として
+ *     隣り合う 2 ピクセルに振り分けることで、ギザギザを目立たなくする)
+ *   - DrawCircle: 中点円アルゴリズム (塗りつぶしの場合は各行の幅を求めて水平な線で埋める)
+ *   - DrawString: フォントを持たないため何もしません。
+ *   - Submit: 描画コマンドリストの線を 1 回のループでラスタライズします (線ごとの仮想関数呼び出しなし)。
+ *
+ * 使い方:
+ *   SoftwareRenderSink sink(800, 600);
+ *   sink.Clear();
+ *   camera->Draw(worldLine, sink);
+ *   sink.WritePPM("frame.ppm");
+ */
+
+class SoftwareRenderSink : public RenderSink
+{
+public:
+    // width × height ピクセルのフレームバッファを作成する (背景色の黒で初期化される)
+    SoftwareRenderSink(int width, int height);
+
+    void Clear() override;
+    void DrawLine(int x1, int y1, int x2, int y2, RenderColor color) override;
+    void DrawLineAA(float x1, float y1, float x2, float y2, RenderColor color) override;
+    void DrawBox(int x1, int y1, int x2, int y2, RenderColor color, bool fill) override;
+    void DrawCircle(int x, int y, int radius, RenderColor color, bool fill) override;
+    void DrawString(int x, int y, const char* text, RenderColor color) override;
+    void SetBlendAlpha(int alpha) override;
+    void SetClipRect(int x1, int y1, int x2, int y2) override;
+    void ResetClipRect() override;
+    void Submit(const DrawCommandList& commands) override;
+
+    // Clear() で塗りつぶす背景色を設定する (初期値は黒)
+    void SetClearColor(RenderColor color) { clearColor = color; }
+
+    // フレームバッファの内容を PPM (P6 形式、バイナリ RGB) 画像として保存する
+    // 戻り値: 保存に成功したら true
+    bool WritePPM(const std::string& filename) const;
+
+    // --- フレームバッファの参照 ---
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    // 先頭ピクセルへのポインタ。1 行は GetWidth() * 4 バイトで、各ピクセルは R, G, B, A の順
+    const uint8_t* GetPixels() const { return pixels.data(); }
+    // (x, y) のピクセルの色を返す (範囲外なら 0)
+    RenderColor GetPixel(int x, int y) const;
+
+private:
+    // (x, y) のピクセルに、不透明度 alpha (0～255) で color を重ねる (クリップ範囲外なら何もしない)
+    void BlendPixel(int x, int y, RenderColor color, int alpha) {
+        if (x < clipX1 || x >= clipX2 || y < clipY1 || y >= clipY2 || alpha <= 0) { return; }
+        BlendPixelInside(x, y, color, alpha);
+    }
+    // BlendPixel の範囲の判定をしない版 ((x, y) はクリップ範囲内、alpha は 1 以上であること)
+    void BlendPixelInside(int x, int y, RenderColor color, int alpha);
+    // (x, y) のピクセルに、現在の不透明度で color を重ねる
+    void PlotPixel(int x, int y, RenderColor color) { BlendPixel(x, y, color, blendAlpha); }
+    // y 行目の [x1, x2] (両端を含む) を color で塗る
+    void FillSpan(int x1, int x2, int y, RenderColor color);
+    // Bresenham のアルゴリズムで、線のうちクリップ範囲に入るピクセルだけを描く
+    // (座標の大きさは MAX_EXACT_COORDINATE (SoftwareRenderSink.cpp) 以下であること)
+    void RasterizeLine(int x1, int y1, int x2, int y2, RenderColor color);
+
+    int width;                   // フレームバッファの幅 (ピクセル)
+    int height;                  // フレームバッファの高さ (ピクセル)
+    std::vector<uint8_t> pixels; // RGBA フレームバッファ (width * height * 4 バイト)
+    RenderColor clearColor = 0;  // Clear() で使う背景色
+    int blendAlpha = 255;        // 現在の不透明度 (255 = 上書き)
+    int clipX1 = 0, clipY1 = 0;  // クリップ範囲の左上 (この座標を含む)
+    int clipX2 = 0, clipY2 = 0;  // クリップ範囲の右下 (この座標を含まない)
+};
@@ -0,0 +1,98 @@
+#include "ThreadPool.h" // 対応するヘッダーファイル
+
+/*
+ * ThreadPool.cpp
+ * 概要:
+ *   ThreadPool クラスの実装です。
+ *   ワーカースレッドは generation (世代番号) が変わるのを条件変数で待ち、
+ *   新しい仕事が来たら共有カウンタから仕事の番号を取り出して処理します。
+ */
+
+// コンストラクタ: ワーカースレッドを起動する
+ThreadPool::ThreadPool(unsigned int workerThreadCount)
+{
+    threads.reserve(workerThreadCount);
+    for (unsigned int i = 0; i < workerThreadCount; ++i) {
+        // ワーカー番号 0 は呼び出し元スレッド用なので、ワーカースレッドは 1 番から
+        threads.emplace_back(&ThreadPool::WorkerLoop, this, i + 1);
+    }
+}
+
+// デストラクタ: 全ワーカースレッドに終了を指示し、終了を待つ
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// 仕事を全ワーカーで分担して処理する
+void ThreadPool::ParallelFor(size_t taskCount, const TaskFunction& func)
+{
+    if (taskCount == 0) { return; }
+
+    // ワーカースレッドがない、または仕事が 1 つだけなら呼び出し元で順番に処理する
+    if (threads.empty() || taskCount == 1) {
+        for (size_t task = 0; task < taskCount; ++task) { func(task, 0); }
+        return;
+    }
+
+    // 新しい仕事を登録してワーカーを起こす
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &func;
+        jobTaskCount = taskCount;
+        nextTask.store(0);
+        busyWorkers = static_cast<unsigned int>(threads.size());
+        ++generation;
+    }
+    wakeCv.notify_all();
+
+    // 呼び出し元スレッドもワーカー 0 番として仕事を処理する
+    RunTasks(0);
+
+    // 全ワーカースレッドが仕事を終えるまで待つ (func を指す job が使われなくなるまで戻れない)
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCv.wait(lock, [this]() { return busyWorkers == 0; });
+    job = nullptr;
+}
+
+// ワーカースレッドの処理本体
+void ThreadPool::WorkerLoop(unsigned int workerIndex)
+{
+    uint64_t seenGeneration = 0; // このスレッドが最後に処理した世代番号
+    for (;;) {
+        {
+            // 新しい仕事が来るか、終了が指示されるまで待つ
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCv.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+            if (stopping) { return; }
+            seenGeneration = generation;
+        }
+
+        RunTasks(workerIndex);
+
+        // 仕事を終えたことを記録し、最後の 1 本なら呼び出し元に知らせる
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = (--busyWorkers == 0);
+        }
+        if (last) { doneCv.notify_one(); }
+    }
+}
+
+// 現在の仕事を、残りがなくなるまで取り出して処理する
+void ThreadPool::RunTasks(unsigned int workerIndex)
+{
+    for (;;) {
+        const size_t task = nextTask.fetch_add(1);
+        if (task >= jobTaskCount) { break; }
+        (*job)(task, workerIndex);
+    }
+}
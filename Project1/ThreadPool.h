@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <vector>             // std::vector
+#include <thread>             // std::thread
+#include <mutex>              // std::mutex
+#include <condition_variable> // std::condition_variable
+#include <atomic>             // std::atomic
+#include <functional>         // std::function
+
+/*
+ * ThreadPool.h
+ * 役割:
+ *   決まった数のワーカースレッドを起動したまま保持し、「番号 0～N-1 の N 個の仕事」を
+ *   全スレッドで分担して処理する `ParallelFor` を提供するクラスです。
+ *   毎フレーム std::thread を作ったり壊したりするコストを避けるために使います。
+ *
+ * 仕組み:
+ *   - コンストラクタで `workerThreadCount` 本のスレッドを起動し、仕事が来るまで待機させます。
+ *   - `ParallelFor` を呼んだスレッド自身もワーカー 0 番として仕事を処理します。
+ *     そのため、同時に動くワーカーの数は `GetWorkerCount()` = workerThreadCount + 1 です。
+ *   - 仕事の番号は共有カウンタ (atomic) から早い者勝ちで取り出されるため、
+ *     どの仕事がどのワーカーで処理されるかは実行ごとに変わります。
+ *     結果の順番を固定したい場合は、仕事の番号ごとに別々の出力先を用意してください。
+ *   - `ParallelFor` は全ての仕事が終わるまで戻りません。
+ *
+ * 使い方:
+ *   ThreadPool pool(3); // 追加のスレッド 3 本 (呼び出し元と合わせて 4 並列)
+ *   pool.ParallelFor(100, [&](size_t task, unsigned int worker) {
+ *       // task: 0～99 の仕事番号, worker: 0～3 のワーカー番号 (ワーカーごとの作業領域の選択に使う)
+ *   });
+ */
+
+class ThreadPool
+{
+public:
+    // 仕事を処理する関数の型 (引数: 仕事の番号, ワーカーの番号)
+    typedef std::function<void(size_t task, unsigned int worker)> TaskFunction;
+
+    // workerThreadCount 本のワーカースレッドを起動する (0 本なら呼び出し元だけで処理する)
+    explicit ThreadPool(unsigned int workerThreadCount);
+    // 全てのワーカースレッドを停止して終了を待つ
+    ~ThreadPool();
+
+    // 同時に仕事を処理するワーカーの数 (ワーカースレッド + 呼び出し元スレッド)
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(threads.size()) + 1; }
+
+    // 番号 0～taskCount-1 の仕事を全ワーカーで分担して処理し、全て終わってから戻る
+    void ParallelFor(size_t taskCount, const TaskFunction& func);
+
+private:
+    // ワーカースレッドの処理本体
+    void WorkerLoop(unsigned int workerIndex);
+    // 現在の仕事を、残りがなくなるまで取り出して処理する
+    void RunTasks(unsigned int workerIndex);
+
+    std::vector<std::thread> threads;   // ワーカースレッド
+    std::mutex mutex;                   // 以下の状態を保護する
+    std::condition_variable wakeCv;     // ワーカーを起こすための条件変数
+    std::condition_variable doneCv;     // 全ワーカーの完了を呼び出し元に知らせるための条件変数
+    const TaskFunction* job = nullptr;  // 現在処理中の仕事 (ParallelFor の引数を指す)
+    size_t jobTaskCount = 0;            // 現在の仕事の総数
+    std::atomic<size_t> nextTask{ 0 };  // 次に取り出す仕事の番号
+    unsigned int busyWorkers = 0;       // まだ仕事を終えていないワーカースレッドの数
+    uint64_t generation = 0;            // ParallelFor が呼ばれるたびに増える番号 (新しい仕事の検出用)
+    bool stopping = false;              // デストラクタで true にしてワーカーを終了させる
+
+    // コピー禁止 (スレッドを所有しているため)
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
@@ -1,168 +1,291 @@
-#include "TopAngle.h" // Ήwb_[t@C
-#include "Camera.h"   // CameraNX̒`QƂ邽 (GetPosition, GetForwardVectorȂǂg)
-#include "DxLib.h"    // DxLib̕`֐g
-#include "Common.h"   // 萔(PI, ONE_DEGREE, WINDOW_WIDTH, WINDOW_HEIGHT) g
-#include <cmath>      // sinf, cosf, atan2f Ȃǂ̐w֐g (<math.h>  <cmath>  C++ ł͐)
-#include <vector>     // std::vector (Draẅ^)
+#include "TopAngle.h" // 対応するヘッダーファイル
+#include "Camera.h"   // Cameraクラスの定義を参照するため (GetPosition, GetForwardVectorなどを使う)
+#include "DxLib.h"    // DxLibの関数 (printfDx) を使うため
+#include "RenderSink.h" // 描画先のインターフェース (描画はすべてこれを経由する)
+#include "Common.h"   // 定数(PI, ONE_DEGREE, WINDOW_WIDTH, WINDOW_HEIGHT) を使うため
+#include <cmath>      // sinf, cosf, atan2f などの数学関数を使うため (<math.h> より <cmath> が C++ では推奨)
+#include "SegmentBuffer.h" // SegmentBuffer (Drawの引数型)
+#include "SegmentGrid2D.h" // SegmentGrid2D (ビュー領域と重なる線分の問い合わせ)
+#include "WireMesh.h" // WireMesh (Drawの引数型)
+#include "SceneGraph.h" // SceneGraph (Drawの引数型。ビュー領域と重なるノードの問い合わせ)
+#include "CameraMath.h" // TransformPointAffine (シーングラフの形状の頂点をワールド座標に変換する)
+#include "Profiler.h" // PROFILE_SCOPE (描画時間の計測)
 
 /*
- * TopAngle.cpp (RgC - R[hێ)
- * Tv:
- *   TopAngleNX̋̓Iȏt@CłB
- *   ʍɕ\gbv_Er[i^ォ̎_j̕`惍WbNS܂B
- *   ȋ@\͈ȉ̒ʂłB
- *   - RXgN^ł̏iĎΏۂCameraIuWFNg󂯎j
- *   - [hԂ̍WAgbv_Er[\̈2DXN[Wɕϊ
- *   - t[Ar[̈̔wiACJ̈ʒuƌApA
- *     ă[h̃IuWFNgij`悷
+ * TopAngle.cpp (コメント修正版 - 元コード保持)
+ * 概要:
+ *   TopAngleクラスの具体的な処理を実装するファイルです。
+ *   画面左上に表示するトップダウンビュー（真上からの視点）の描画ロジックを担当します。
+ *   主な機能は以下の通りです。
+ *   - コンストラクタでの初期化（監視対象のCameraオブジェクトを受け取る）
+ *   - ワールド空間の座標を、トップダウンビュー表示領域内の2Dスクリーン座標に変換する
+ *   - 毎フレーム、ビュー領域の背景、メインカメラの位置と向き、視野角、
+ *     そしてワールド内のオブジェクト（線分）を描画する
  *
- * ̃R[h̎ȕύX_:
- *   - J̌擾@AV `Camera` NXɍ킹ĕύXĂ܂B
- *     ̃R[hł͒ډ]px擾ĂƎv܂AVJł
- *     NH[^jIŌǗĂ邽߁A `GetForwardVector()` 
- *     OxNg擾AXZ `atan2f` gďォ猩Ƃ
- *     ̊pxi[pjvZĂ܂B
+ * 元のコードからの主な変更点:
+ *   - カメラの向きを取得する方法が、新しい `Camera` クラスに合わせて変更されています。
+ *     元のコードでは直接回転角度を取得していたと思われますが、新しいカメラでは
+ *     クォータニオンで向きを管理しているため、代わりに `GetForwardVector()` で
+ *     前方ベクトルを取得し、そのXZ成分から `atan2f` を使って上から見たときの
+ *     向きの角度（ヨー角）を計算しています。
  *
- * ̃t@C̗̏:
- * 1. 萔`: gbv_Er[̕\ʒuATCYAXP[Ȃǂ̐ݒl`܂B
- * 2. RXgN^: `Camera` IuWFNgւ̃|C^󂯎Aێ܂B
- * 3. `ConvertWorldToView`: [hW(X, Z)󂯎AJ̑Έʒu
- *    XP[ɊÂāAr[̈̃XN[W(X, Y)ɕϊ܂B
+ * このファイル内の処理の流れ:
+ * 1. 定数定義: トップダウンビューの表示位置、サイズ、スケールなどの設定値を定義します。
+ * 2. コンストラクタ: `Camera` オブジェクトへのポインタを受け取り、保持します。
+ * 3. `ConvertWorldToView`: ワールド座標(X, Z)を受け取り、カメラからの相対位置と
+ *    スケールに基づいて、ビュー領域内のスクリーン座標(X, Y)に変換します。
  * 4. `Draw`:
- *    - wiƘg`悵܂B
- *    - r[̈̒SɃCJ\~`悵܂B
- *    - `GetForwardVector`  `atan2f` găJ̌pxvZA
- *      ̕ɐ`悵܂B
- *    - ݒ肳ꂽp (`CAMERA_FOV_H`) ɊÂāA͈͂`悵܂B
- *    - `worldLines` œnꂽe `ConvertWorldToView` ŕϊA
- *      r[̈ɐƂĕ`悵܂ (`SetDrawArea` ŕ`͈͂𐧌)B
+ *    - 背景と枠線を描画します。
+ *    - ビュー領域の中心にメインカメラを表す円を描画します。
+ *    - `GetForwardVector` と `atan2f` を使ってカメラの向き角度を計算し、
+ *      その方向に線を描画します。
+ *    - 設定された視野角 (`CAMERA_FOV_H`) に基づいて、視野範囲を示す線を描画します。
+ *    - `worldLines` で渡された各線分を `ConvertWorldToView` で変換し、
+ *      ビュー領域内に線として描画します (`SetClipRect` で描画範囲を制限)。
+ *    - 描画はすべて引数の `RenderSink` (描画先) を経由して行います。
+ *    - `SegmentGrid2D` (XZ 平面のグリッド) を渡す版の `Draw` は、ビュー領域に映るワールドの矩形と
+ *      重なるセルの線分だけを変換するため、シーンが広くても処理量はビュー内の線分の数で決まります。
  */
 
- // --- gbv_Er[̕\ݒl̒` ---
- // TopAngle.h Ő錾ꂽÓI萔o[̒lŒ`܂B
- // (: C++17ȍ~ł̓CCϐƂăwb_[Œ`邱Ƃ\ł)
-const int TopAngle::VIEW_POS_X = 10;      // r[̈̍XW (ʍ10sNZ)
-const int TopAngle::VIEW_POS_Y = 10;      // r[̈̍YW (ʏォ10sNZ)
-const int TopAngle::VIEW_WIDTH = 200;     // r[̈̕ (200sNZ)
-const int TopAngle::VIEW_HEIGHT = 200;    // r[̈̍ (200sNZ)
-const float TopAngle::VIEW_SCALE = 1.5f;  // `XP[ ([h1Pʂ1.5sNZŕ\)
-const float TopAngle::CAMERA_FOV_H = 75.0f * ONE_DEGREE; // J̐p (75x) - p\Ɏgp
-const float TopAngle::VIEW_RANGE = 60.0f; // pJ̌̒ (60sNZ)
-
-// RXgN^:
-//   CJւ̃|C^󂯎Aoϐ `camera` ɕۑ܂B
+ // --- トップダウンビューの表示設定値の定義 ---
+ // TopAngle.h で宣言された静的定数メンバーの値をここで定義します。
+ // (注: C++17以降ではインライン変数としてヘッダー内で定義することも可能です)
+const int TopAngle::VIEW_POS_X = 10;      // ビュー領域の左上のX座標 (画面左から10ピクセル)
+const int TopAngle::VIEW_POS_Y = 10;      // ビュー領域の左上のY座標 (画面上から10ピクセル)
+const int TopAngle::VIEW_WIDTH = 200;     // ビュー領域の幅 (200ピクセル)
+const int TopAngle::VIEW_HEIGHT = 200;    // ビュー領域の高さ (200ピクセル)
+const float TopAngle::VIEW_SCALE = 1.5f;  // 描画スケール (ワールドの1単位を1.5ピクセルで表示)
+const float TopAngle::CAMERA_FOV_H = 75.0f * ONE_DEGREE; // カメラの水平視野角 (約75度) - 視野角表示に使用
+const float TopAngle::VIEW_RANGE = 60.0f; // 視野角やカメラの向きを示す線の長さ (60ピクセル)
+
+// コンストラクタ:
+//   メインカメラへのポインタを受け取り、メンバ変数 `camera` に保存します。
 TopAngle::TopAngle(Camera* cam) : camera(cam)
 {
-    // Ô߁Anꂽ|C^ nullptr (ȃ|C^) łȂ`FbN܂B
+    // 念のため、渡されたポインタが nullptr (無効なポインタ) でないかチェックします。
     if (camera == nullptr) {
-        //  nullptr ȂADxLib ̃fobO\@\gČxbZ[W\܂B
-        printfDx("x: TopAngle ɓnꂽJ|C^ nullptr łB\n");
-        // ̏ꍇAȍ~ Draw ֐Ȃǂ `camera` QƂƃG[ɂȂ\܂B
+        // もし nullptr なら、DxLib のデバッグ表示機能を使って警告メッセージを表示します。
+        printfDx("警告: TopAngle に渡されたカメラポインタが nullptr です。\n");
+        // この場合、以降の Draw 関数などで `camera` を参照するとエラーになる可能性があります。
     }
 }
 
-// fXgN^:
-//   ͓ɌЕt͕Kv܂B
+// デストラクタ:
+//   今回は特に後片付け処理は必要ありません。
 TopAngle::~TopAngle() {}
 
-// wp[֐: [hW(X, Z)gbv_Er[̃XN[Wɕϊ
+// ヘルパー関数: ワールド座標(X, Z)をトップダウンビューのスクリーン座標に変換する
 Vector3D TopAngle::ConvertWorldToView(float worldX, float worldZ) const
 {
-    // J|C^ȂAftHgWir[jԂȂǂăG[h
+    // カメラポインタが無効なら、デフォルト座標（ビュー左上）を返すなどしてエラーを防ぐ
     if (!camera) {
-        // 萔g悤ɏC (ȑỎ񓚂Ńwb_[ constexpr Œ`ꍇ)
+        // 定数を使うように修正 (以前の回答でヘッダーに constexpr で定義した場合)
         // return { (float)TopAngle::VIEW_POS_X, (float)TopAngle::VIEW_POS_Y, 0.0f };
-        // ̃t@CŒ`Ă萔̂܂܎gꍇ:
+        // このファイルで定義している定数をそのまま使う場合:
         return { (float)VIEW_POS_X, (float)VIEW_POS_Y, 0.0f };
     }
 
-    // 1. CJ݂̌̃[hW擾
+    // 1. メインカメラの現在のワールド座標を取得
     Vector3D camPos = camera->GetPosition();
 
-    // 2. `悵_́AJ̑΍W (XZʏ) vZ
+    // 2. 描画したい点の、カメラからの相対座標 (XZ平面上) を計算
     float relativeX = worldX - camPos.x;
-    float relativeZ = worldZ - camPos.z; // [hZWr[YWɑΉ
+    float relativeZ = worldZ - camPos.z; // ワールドZ座標がビューのY座標に対応する
 
-    // 3. r[̈̒S̃XN[WvZ
+    // 3. ビュー領域の中心のスクリーン座標を計算
     float viewCenterX = (float)(VIEW_POS_X + VIEW_WIDTH / 2);
     float viewCenterY = (float)(VIEW_POS_Y + VIEW_HEIGHT / 2);
 
-    // 4. ΍WɃXP[|āAr[S̃ItZbgvZAŏIIȃXN[W߂
+    // 4. 相対座標にスケールを掛けて、ビュー中心からのオフセットを計算し、最終的なスクリーン座標を求める
     float viewX = viewCenterX + relativeX * VIEW_SCALE;
-    float viewY = viewCenterY + relativeZ * VIEW_SCALE; // Z+  Y+ () Ƀ}bsO
+    float viewY = viewCenterY + relativeZ * VIEW_SCALE; // Z+ を Y+ (下向き) にマッピング
 
-    // ʂ Vector3D ŕԂ (Z͎gȂ)
+    // 結果を Vector3D で返す (Z成分は使わない)
     return { viewX, viewY, 0.0f };
 }
 
 
-// gbv_Er[̕`֐ (t[Ăяo)
-void TopAngle::Draw(const std::vector<std::vector<Vector3D>>& worldLines)
+// ビュー領域に映るワールドの XZ 平面の矩形を取得する
+void TopAngle::GetViewRectXZ(float& minX, float& minZ, float& maxX, float& maxZ) const
+{
+    // カメラ位置を中心に、ビューの大きさ / 縮尺 (ワールド単位) の範囲
+    const Vector3D camPos = camera ? camera->GetPosition() : Vector3D{ 0.0f, 0.0f, 0.0f };
+    const float halfWidth = static_cast<float>(VIEW_WIDTH / 2) / VIEW_SCALE;   // ワールド単位
+    const float halfHeight = static_cast<float>(VIEW_HEIGHT / 2) / VIEW_SCALE; // ワールド単位
+    minX = camPos.x - halfWidth;
+    minZ = camPos.z - halfHeight;
+    maxX = camPos.x + halfWidth;
+    maxZ = camPos.z + halfHeight;
+}
+
+
+// トップダウンビューの描画関数 (毎フレーム呼び出される)
+void TopAngle::Draw(const SegmentBuffer& worldLines, RenderSink& sink)
+{
+    PROFILE_SCOPE(ProfileStage::TopAngleDraw);
+    DrawSegments(worldLines, nullptr, nullptr, nullptr, nullptr, sink); // 全ての線分を変換する
+}
+
+// トップダウンビューの描画関数 (空間インデックス版)
+void TopAngle::Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, RenderSink& sink)
+{
+    DrawIndexed(worldLines, index, nullptr, nullptr, nullptr, sink);
+}
+
+// トップダウンビューの描画関数 (空間インデックス版 + 毎フレーム作る線分)
+void TopAngle::Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SegmentBuffer& dynamicLines, RenderSink& sink)
+{
+    DrawIndexed(worldLines, index, nullptr, &dynamicLines, nullptr, sink);
+}
+
+// トップダウンビューの描画関数 (空間インデックス版 + 毎フレーム作る線分とメッシュ)
+void TopAngle::Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SegmentBuffer& dynamicLines,
+    const WireMesh& dynamicMesh, RenderSink& sink)
+{
+    DrawIndexed(worldLines, index, nullptr, &dynamicLines, &dynamicMesh, sink);
+}
+
+// トップダウンビューの描画関数 (空間インデックス版 + シーングラフ + 毎フレーム作る線分とメッシュ)
+void TopAngle::Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SceneGraph& objects,
+    const SegmentBuffer& dynamicLines, const WireMesh& dynamicMesh, RenderSink& sink)
+{
+    DrawIndexed(worldLines, index, &objects, &dynamicLines, &dynamicMesh, sink);
+}
+
+// 空間インデックス版の Draw の本体 (nullptr の入力はなしとして扱う)
+void TopAngle::DrawIndexed(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SceneGraph* objects,
+    const SegmentBuffer* dynamicLines, const WireMesh* dynamicMesh, RenderSink& sink)
 {
-    // J|C^ȂA`悹ɏI
+    PROFILE_SCOPE(ProfileStage::TopAngleDraw);
     if (!camera) {
         return;
     }
+    // ビュー領域に映るワールドの矩形と重なる線分だけを問い合わせる
+    float minX, minZ, maxX, maxZ;
+    GetViewRectXZ(minX, minZ, maxX, maxZ);
+    index.Query(minX, minZ, maxX, maxZ, visibleIndices);
+    // シーングラフも同じ矩形で、境界球が重なるノードだけを選ぶ
+    if (objects) { objects->CullRectXZ(minX, minZ, maxX, maxZ, visibleNodes); } else { visibleNodes.clear(); }
+    DrawSegments(worldLines, &visibleIndices, objects, dynamicLines, dynamicMesh, sink);
+}
 
-    // --- 1. r[̈̔wiƘg̕` ---
-    SetDrawBlendMode(DX_BLENDMODE_ALPHA, 128); // [hݒ
-    DrawBox(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT, GetColor(0, 0, 0), TRUE); // wi`
-    SetDrawBlendMode(DX_BLENDMODE_NOBLEND, 0); // ʏ탂[hɖ߂
-    DrawBox(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT, GetColor(255, 255, 255), FALSE); // g`
+// 描画の本体: indices が nullptr なら全線分、そうでなければ indices の線分だけを描く
+// (objects は visibleNodes のノードだけ、dynamicLines, dynamicMesh は全て描く)
+void TopAngle::DrawSegments(const SegmentBuffer& worldLines, const std::vector<uint32_t>* indices, const SceneGraph* objects,
+    const SegmentBuffer* dynamicLines, const WireMesh* dynamicMesh, RenderSink& sink)
+{
+    // カメラポインタが無効なら、何も描画せずに終了
+    if (!camera) {
+        return;
+    }
 
-    // --- 2. Jg̕` ---
-    int camViewX = VIEW_POS_X + VIEW_WIDTH / 2; // r[SX
-    int camViewY = VIEW_POS_Y + VIEW_HEIGHT / 2; // r[SY
-    unsigned int camColor = GetColor(255, 0, 0); // J̐F()
-    DrawCircle(camViewX, camViewY, 4, camColor, TRUE); // Jʒu~ŕ\
+    // --- 1. ビュー領域の背景と枠線の描画 ---
+    sink.SetBlendAlpha(128); // 半透明モード設定
+    sink.DrawBox(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT, GetRenderColor(0, 0, 0), true); // 背景描画
+    sink.SetBlendAlpha(255); // 通常モードに戻す
+    sink.DrawBox(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT, GetRenderColor(255, 255, 255), false); // 枠線描画
 
-    // --- 3. J̌Ǝp̕` ---
-    // J̑OxNg擾
+    // --- 2. カメラ自身の描画 ---
+    int camViewX = VIEW_POS_X + VIEW_WIDTH / 2; // ビュー中心X
+    int camViewY = VIEW_POS_Y + VIEW_HEIGHT / 2; // ビュー中心Y
+    RenderColor camColor = GetRenderColor(255, 0, 0); // カメラの色(赤)
+    sink.DrawCircle(camViewX, camViewY, 4, camColor, true); // カメラ位置を円で表示
+
+    // --- 3. カメラの向きと視野角の描画 ---
+    // カメラの前方ベクトル取得
     Vector3D forward = camera->GetForwardVector();
-    // XZʏł̌px([p)atan2f(x, z)ŌvZ (ZO)
+    // XZ平面上での向き角度(ヨー角)をatan2f(x, z)で計算 (Z軸前方基準)
     float camRotY = atan2f(forward.x, forward.z);
 
-    // J̌̃ItZbgvZ
+    // カメラの向きを示す線のオフセット計算
     float forwardXOffset = sinf(camRotY) * VIEW_RANGE;
     float forwardYOffset = cosf(camRotY) * VIEW_RANGE;
 
-    // J̌`
-    DrawLine(camViewX, camViewY, camViewX + static_cast<int>(forwardXOffset), camViewY + static_cast<int>(forwardYOffset), camColor);
+    // カメラの向きを示す線を描画
+    sink.DrawLine(camViewX, camViewY, camViewX + static_cast<int>(forwardXOffset), camViewY + static_cast<int>(forwardYOffset), camColor);
 
-    // --- p\ ---
-    float halfFovH = CAMERA_FOV_H / 2.0f; // p̔
-    float leftFovRot = camRotY - halfFovH; // [̊px
-    float rightFovRot = camRotY + halfFovH; // E[̊px
-    // E̐̃ItZbgvZ
+    // --- 視野角表示 ---
+    float halfFovH = CAMERA_FOV_H / 2.0f; // 水平視野角の半分
+    float leftFovRot = camRotY - halfFovH; // 左端の角度
+    float rightFovRot = camRotY + halfFovH; // 右端の角度
+    // 左右の線のオフセット計算
     float leftXOffset = sinf(leftFovRot) * VIEW_RANGE;
     float leftYOffset = cosf(leftFovRot) * VIEW_RANGE;
     float rightXOffset = sinf(rightFovRot) * VIEW_RANGE;
     float rightYOffset = cosf(rightFovRot) * VIEW_RANGE;
 
-    // p`
-    DrawLine(camViewX, camViewY, camViewX + static_cast<int>(leftXOffset), camViewY + static_cast<int>(leftYOffset), camColor); // 
-    DrawLine(camViewX, camViewY, camViewX + static_cast<int>(rightXOffset), camViewY + static_cast<int>(rightYOffset), camColor); // E
-    DrawLine(camViewX + static_cast<int>(leftXOffset), camViewY + static_cast<int>(leftYOffset), // [
-        camViewX + static_cast<int>(rightXOffset), camViewY + static_cast<int>(rightYOffset), camColor);
+    // 視野角を示す線を描画
+    sink.DrawLine(camViewX, camViewY, camViewX + static_cast<int>(leftXOffset), camViewY + static_cast<int>(leftYOffset), camColor); // 左線
+    sink.DrawLine(camViewX, camViewY, camViewX + static_cast<int>(rightXOffset), camViewY + static_cast<int>(rightYOffset), camColor); // 右線
+    sink.DrawLine(camViewX + static_cast<int>(leftXOffset), camViewY + static_cast<int>(leftYOffset), // 先端線
+             camViewX + static_cast<int>(rightXOffset), camViewY + static_cast<int>(rightYOffset), camColor);
 
 
-    // --- 4. [hIuWFNg () ̕` ---
-    unsigned int objectColor = GetColor(0, 255, 0); // IuWFNg̐F()
+    // --- 4. ワールドオブジェクト (線分) の描画 ---
+    RenderColor objectColor = GetRenderColor(0, 255, 0); // オブジェクトの色(緑)
 
-    // `͈͂gbv_Er[̈Ɍ
-    SetDrawArea(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT);
+    // 描画範囲をトップダウンビュー領域内に限定
+    sink.SetClipRect(VIEW_POS_X, VIEW_POS_Y, VIEW_POS_X + VIEW_WIDTH, VIEW_POS_Y + VIEW_HEIGHT);
 
-    // [h̐`
-    for (const auto& line : worldLines)
-    {
-        if (line.size() < 2) { continue; }
-        // ̗[r[Wɕϊ
-        Vector3D viewP1 = ConvertWorldToView(line[0].x, line[0].z);
-        Vector3D viewP2 = ConvertWorldToView(line[1].x, line[1].z);
-        // ` (A`GCAXt)
-        DrawLineAA(viewP1.x, viewP1.y, viewP2.x, viewP2.y, objectColor);
+    // ワールドの線分を描画コマンドとして記録する (X, Z 座標の配列を直接参照する。点 2*i が始点、2*i+1 が終点)
+    auto recordSegment = [&](const float* xs, const float* zs, size_t i) {
+        // 線分の両端をビュー座標に変換
+        Vector3D viewP1 = ConvertWorldToView(xs[2 * i], zs[2 * i]);
+        Vector3D viewP2 = ConvertWorldToView(xs[2 * i + 1], zs[2 * i + 1]);
+        // 線を記録 (アンチエイリアス付き)
+        drawCommands.AddLineAA(viewP1.x, viewP1.y, viewP2.x, viewP2.y, objectColor);
+    };
+    drawCommands.Clear(); // 容量は前のフレームのまま残る
+    if (indices != nullptr) {
+        // 空間インデックスで選んだ線分だけ
+        drawCommands.Reserve(indices->size());
+        for (uint32_t i : *indices) { recordSegment(worldLines.X(), worldLines.Z(), i); }
+    }
+    else {
+        // 全ての線分
+        const size_t segmentCount = worldLines.Size();
+        drawCommands.Reserve(segmentCount);
+        for (size_t i = 0; i < segmentCount; ++i) { recordSegment(worldLines.X(), worldLines.Z(), i); }
+    }
+    if (objects != nullptr) {
+        // シーングラフの物体: 形状の頂点をノードの変換行列でワールド座標にしてからビュー座標に変換し、辺を頂点番号で引いて記録する
+        for (uint32_t node : visibleNodes) {
+            const WireMesh& mesh = objects->GetGeometry(objects->GetNodeGeometry(node));
+            const Matrix& world = objects->GetWorldTransform(node);
+            const size_t vertexCount = mesh.VertexCount();
+            meshViewPoints.resize(vertexCount);
+            for (size_t i = 0; i < vertexCount; ++i) {
+                const Vector3D worldPoint = TransformPointAffine(Vector3DA(mesh.GetVertex(i)), world).ToVector3D(); // ノードの変換行列はアフィン変換
+                meshViewPoints[i] = ConvertWorldToView(worldPoint.x, worldPoint.z);
+            }
+            for (const MeshEdge& edge : mesh.GetEdges()) {
+                const Vector3D& viewP1 = meshViewPoints[edge.a];
+                const Vector3D& viewP2 = meshViewPoints[edge.b];
+                drawCommands.AddLineAA(viewP1.x, viewP1.y, viewP2.x, viewP2.y, objectColor);
+            }
+        }
+    }
+    if (dynamicLines != nullptr) {
+        // 毎フレーム作る線分 (インデックスがないので全て)
+        const size_t segmentCount = dynamicLines->Size();
+        for (size_t i = 0; i < segmentCount; ++i) { recordSegment(dynamicLines->X(), dynamicLines->Z(), i); }
+    }
+    if (dynamicMesh != nullptr) {
+        // 毎フレーム作るメッシュ: 頂点を 1 回ずつビュー座標に変換してから、辺を頂点番号で引いて記録する
+        const size_t vertexCount = dynamicMesh->VertexCount();
+        meshViewPoints.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) {
+            meshViewPoints[i] = ConvertWorldToView(dynamicMesh->X()[i], dynamicMesh->Z()[i]);
+        }
+        for (const MeshEdge& edge : dynamicMesh->GetEdges()) {
+            const Vector3D& viewP1 = meshViewPoints[edge.a];
+            const Vector3D& viewP2 = meshViewPoints[edge.b];
+            drawCommands.AddLineAA(viewP1.x, viewP1.y, viewP2.x, viewP2.y, objectColor);
+        }
     }
+    // 記録した線をまとめて描画
+    sink.Submit(drawCommands);
 
-    // `͈͂̌
-    SetDrawArea(0, 0, static_cast<int>(WINDOW_WIDTH), static_cast<int>(WINDOW_HEIGHT));
+    // 描画範囲の限定を解除
+    sink.ResetClipRect();
 }
\ No newline at end of file
@@ -1,78 +1,120 @@
 #pragma once
-#include "Vector.h" // Vector3D \̂g
-#include <vector>   // std::vector g (Draw ֐̈)
+#include "Vector.h" // Vector3D 構造体を使うため
+#include "SegmentBuffer.h" // SegmentBuffer クラスを使うため (Draw 関数の引数)
+#include "WireMesh.h" // WireMesh クラスを使うため (Draw 関数の引数)
+#include "DrawCommandList.h" // DrawCommandList クラス (線分の描画コマンドの記録)
+#include <cstdint> // uint32_t
+#include <vector>  // std::vector
 
 /*
  * TopAngle.h
- * :
- *   ̃wb_[t@ĆAʂ̍ɕ\ugbv_Er[v
- *   i[h^ォ猩낵悤2D}bvj`悷邽߂ `TopAngle` NX`܂B
- *   ̃r[́ACƂȂ3D_̃J (`Camera` NX̃IuWFNg) 
- *   [ĥǂ̈ʒuɂāAǂ̕Ă邩oIɊmFA
- *   [hŜ̃IuWFNgzuc肷̂ɖ𗧂܂B
+ * 役割:
+ *   このヘッダーファイルは、画面の左上に表示する「トップダウンビュー」
+ *   （ワールドを真上から見下ろしたような2Dマップ）を描画するための `TopAngle` クラスを定義します。
+ *   このビューは、メインとなる3D視点のカメラ (`Camera` クラスのオブジェクト) が
+ *   ワールド内のどの位置にいて、どの方向を向いているかを視覚的に確認したり、
+ *   ワールド全体のオブジェクト配置を把握したりするのに役立ちます。
  *
- * ȋ@\:
- *   - ĎΏۂ `Camera` IuWFNgւ̃|C^ێ܂B
- *   - [hԂ̍W (X, Z) Aʍ̃r[̈2DXN[Wɕϊ܂B
- *   - `Draw` \bhŁAr[̈̔wiAJ̈ʒuEEpA
- *     у[h̃IuWFNgijr[ɕ`悵܂B
+ * 主な機能:
+ *   - 監視対象の `Camera` オブジェクトへのポインタを保持します。
+ *   - ワールド空間の座標 (X, Z) を、画面左上のビュー領域内の2Dスクリーン座標に変換します。
+ *   - `Draw` メソッドで、ビュー領域の背景、カメラの位置・向き・視野角、
+ *     およびワールド内のオブジェクト（線分）をビュー上に描画します。
  *
- * ̃R[h̕ύX_ERg ():
- *   -  `TopAngle` NX́ȀR[hɂ͂ȂAJ̉ߒ
- *     fobO󋵔ĉ߂ɒǉꂽ@\łƍl܂B
- *   - `Camera` NXւ̈ˑ邽߁A`#include "Camera.h"` 𒼐ڋLq
- *     O錾 (`class Camera;`) gpĂ܂B́Awb_[t@Cm
- *     ݂CN[hƂɂ邽߂̈ʓIȃeNjbNłB
- *   - gbv_Er[̕\ʒuATCYAkڂȂǂ̐ݒl萔ƂĐ錾Ă܂B
- *     ̋̓IȒl `TopAngle.cpp` t@CŒ`܂B
- *   - [hWr[W֕ϊ邽߂̕⏕֐ `ConvertWorldToView` 
- *     vCx[goƂĐ錾Ă܂B
+ * 元のコードからの変更点・コメント (推定):
+ *   - この `TopAngle` クラスは、元の初期コードにはなく、開発の過程で
+ *     デバッグや状況把握のために追加された機能であると考えられます。
+ *   - `Camera` クラスへの依存があるため、`#include "Camera.h"` を直接記述する代わりに
+ *     前方宣言 (`class Camera;`) を使用しています。これは、ヘッダーファイル同士が
+ *     互いをインクルードし合うことによる問題を避けるための一般的なテクニックです。
+ *   - トップダウンビューの表示位置、サイズ、縮尺などの設定値が定数として宣言されています。
+ *     これらの具体的な値は `TopAngle.cpp` ファイル内で定義されます。
+ *   - ワールド座標からビュー座標へ変換するための補助関数 `ConvertWorldToView` が
+ *     プライベートメンバとして宣言されています。
  *
- * g:
- *   - `#include "TopAngle.h"` CN[h܂B
- *   - `TopAngle` IuWFNg쐬ۂɁAĎ `Camera` IuWFNgւ̃|C^n܂
- *     (: `TopAngle* topView = new TopAngle(mainCameraPtr);`)B
- *   - C[v̕`揈̒ `topView->Draw(worldLines)` ĂяoƁA
- *     ʍɃgbv_Er[`悳܂B
+ * 使い方:
+ *   - `#include "TopAngle.h"` をインクルードします。
+ *   - `TopAngle` オブジェクトを作成する際に、監視したい `Camera` オブジェクトへのポインタを渡します
+ *     (例: `TopAngle* topView = new TopAngle(mainCameraPtr);`)。
+ *   - メインループの描画処理の中で `topView->Draw(worldLines, sink)` を呼び出すと、
+ *     画面左上にトップダウンビューが描画されます。
  */
 
- // O錾 (Forward Declaration)
- // `Camera` NX̊SȒ`œǂݍޕKv͂ȂA
- // `Camera` ƂÕNX݂邱ƂRpCɓ`܂B
- // ɂARpCԂ̒Zkwb_[Ԃ̈ˑ֌W̐ɖ𗧂܂B
+ // 前方宣言 (Forward Declaration)
+ // `Camera` クラスの完全な定義をここで読み込む必要はなく、
+ // `Camera` という名前のクラスが存在することだけをコンパイラに伝えます。
+ // これにより、コンパイル時間の短縮やヘッダー間の依存関係の整理に役立ちます。
 class Camera;
+class RenderSink; // 描画先のインターフェース (定義は RenderSink.h)
+class SegmentGrid2D; // 線分の 2D 空間インデックス (定義は SegmentGrid2D.h)
+class SceneGraph; // ノードごとの変換行列を持つ物体 (定義は SceneGraph.h)
 
 class TopAngle
 {
-public: // NX̊OANZX\ȃo
-    // RXgN^: ĎΏۂƂȂ `Camera` IuWFNgւ̃|C^ `cam` 󂯎܂B
+public: // クラスの外部からアクセス可能なメンバ
+    // コンストラクタ: 監視対象となる `Camera` オブジェクトへのポインタ `cam` を受け取ります。
     TopAngle(Camera* cam);
-    // fXgN^: `TopAngle` IuWFNgsvɂȂƂɌĂяo܂B
+    // デストラクタ: `TopAngle` オブジェクトが不要になったときに呼び出されます。
     ~TopAngle();
 
-    // `֐:
-    //   C[v疈t[ĂяoAgbv_Er[`悵܂B
-    //   `worldLines` ́A[hԂɑ݂IuWFNg̐f[^łB
-    void Draw(const std::vector<std::vector<Vector3D>>& worldLines);
+    // 描画関数:
+    //   メインループから毎フレーム呼び出され、トップダウンビューを描画します。
+    //   `worldLines` は、ワールド空間に存在するオブジェクトの線分データです。
+    //   `sink` は描画先 (DxLib の画面やソフトウェアのフレームバッファ) です。
+    void Draw(const SegmentBuffer& worldLines, RenderSink& sink);
+    //   `index` は worldLines から作った XZ 平面のグリッドです。ビュー領域と重なる線分だけを変換・描画します。
+    void Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, RenderSink& sink);
+    //   `dynamicLines` はフレームごとに作り直す線分 (LOD を選んだ球など) で、インデックスを使わずに全て描きます。
+    void Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SegmentBuffer& dynamicLines, RenderSink& sink);
+    //   `dynamicMesh` はフレームごとに作り直すインデックス付きメッシュで、頂点を 1 回ずつ変換してから辺を描きます。
+    void Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SegmentBuffer& dynamicLines,
+        const WireMesh& dynamicMesh, RenderSink& sink);
+    //   `objects` はシーングラフの物体です。境界球がビュー領域と重なるノードの形状だけを、ノードの変換行列で配置して描きます。
+    void Draw(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SceneGraph& objects,
+        const SegmentBuffer& dynamicLines, const WireMesh& dynamicMesh, RenderSink& sink);
+    // ビュー領域に映るワールドの XZ 平面の矩形 (カメラ位置を中心に、ビューの大きさ / 縮尺) を取得する
+    // (地面のグリッドなど、ビュー用の線分を表示範囲に合わせて作るため)
+    void GetViewRectXZ(float& minX, float& minZ, float& maxX, float& maxZ) const;
+    // 直前の Draw で記録したオブジェクトの線分の描画コマンドを取得する (フレームの再描画や比較用)
+    const DrawCommandList& GetDrawCommands() const { return drawCommands; }
 
-private: // NX̓ł̂݃ANZX\ȃo
-    // ĎΏۂ̃CJIuWFNgւ̃|C^B
-    // ̃|C^ʂāADraw֐ŃJ̈ʒu擾܂B
+private: // クラスの内部でのみアクセス可能なメンバ
+    // 監視対象のメインカメラオブジェクトへのポインタ。
+    // このポインタを通じて、Draw関数内でカメラの位置や向きを取得します。
     Camera* camera;
 
-    // --- gbv_Er[̕\ݒ (ÓI萔o[) ---
-    //     ̒萔̎ۂ̒l TopAngle.cpp Œ`܂B
-    //     (: C++17ȍ~ł̓CCϐƂăwb_[Œ`邱Ƃ\ł)
-    static const int VIEW_POS_X;     // r[\̈̍XW (XN[W)
-    static const int VIEW_POS_Y;     // r[\̈̍YW (XN[W)
-    static const int VIEW_WIDTH;     // r[\̈̕ (sNZP)
-    static const int VIEW_HEIGHT;    // r[\̈̍ (sNZP)
-    static const float VIEW_SCALE;   // [hԂ̍Wr[\̈̍Wɕϊۂ̊g嗦Ek
-    static const float CAMERA_FOV_H; // CJ̐p (WAP)Br[Ɏ͈͂`悷邽߂ɎgpB
-    static const float VIEW_RANGE;   // r[ŃJ̌⎋p̒ (sNZP)B
+    // ワールドの線分をビュー座標に変換して記録した描画コマンド (フレームをまたいで使い回す)
+    DrawCommandList drawCommands;
+    // 空間インデックスで選んだ、ビュー領域と重なる線分の添字 (フレームをまたいで使い回す)
+    std::vector<uint32_t> visibleIndices;
+    // シーングラフの、ビュー領域と重なるノード (フレームをまたいで使い回す)
+    std::vector<uint32_t> visibleNodes;
+    // dynamicMesh (とシーングラフの形状) の頂点をビュー座標に変換したもの (フレームをまたいで使い回す)
+    std::vector<Vector3D> meshViewPoints;
 
-    // wp[֐ (NXŎg⏕IȊ֐):
-    //   [hԂ̍W (X, Z) Aʍ̃gbv_Er[\̈
-    //   2DXN[W (X, Y) ɕϊ܂B
+    // 空間インデックス版の Draw の本体: index でビュー領域と重なる線分を選び (objects があればノードも選び)、DrawSegments で描く。
+    // 公開している Draw の各版は、足りない入力 (objects, dynamicLines, dynamicMesh) を nullptr にしてここに渡す。
+    void DrawIndexed(const SegmentBuffer& worldLines, const SegmentGrid2D& index, const SceneGraph* objects,
+        const SegmentBuffer* dynamicLines, const WireMesh* dynamicMesh, RenderSink& sink);
+    // 描画の本体: indices が nullptr なら worldLines の全線分、そうでなければ indices の線分だけを描く。
+    // objects が nullptr でなければ、visibleNodes のノードの形状も続けて描く。
+    // dynamicLines, dynamicMesh が nullptr でなければ、その全線分・全ての辺も続けて描く。
+    void DrawSegments(const SegmentBuffer& worldLines, const std::vector<uint32_t>* indices, const SceneGraph* objects,
+        const SegmentBuffer* dynamicLines, const WireMesh* dynamicMesh, RenderSink& sink);
+
+    // --- トップダウンビューの表示設定 (静的定数メンバー) ---
+    //     これらの定数の実際の値は TopAngle.cpp で定義されます。
+    //     (注: C++17以降ではインライン変数としてヘッダー内で定義することも可能です)
+    static const int VIEW_POS_X;     // ビュー表示領域の左上のX座標 (スクリーン座標)
+    static const int VIEW_POS_Y;     // ビュー表示領域の左上のY座標 (スクリーン座標)
+    static const int VIEW_WIDTH;     // ビュー表示領域の幅 (ピクセル単位)
+    static const int VIEW_HEIGHT;    // ビュー表示領域の高さ (ピクセル単位)
+    static const float VIEW_SCALE;   // ワールド空間の座標をビュー表示領域の座標に変換する際の拡大率・縮尺
+    static const float CAMERA_FOV_H; // メインカメラの水平視野角 (ラジアン単位)。ビュー上に視野範囲を描画するために使用。
+    static const float VIEW_RANGE;   // ビュー上でカメラの向きや視野角を示す線の長さ (ピクセル単位)。
+
+    // ヘルパー関数 (クラス内部で使う補助的な関数):
+    //   ワールド空間の座標 (X, Z) を、画面左上のトップダウンビュー表示領域内の
+    //   2Dスクリーン座標 (X, Y) に変換します。
     Vector3D ConvertWorldToView(float worldX, float worldZ) const;
 };
\ No newline at end of file
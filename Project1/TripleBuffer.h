@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>  // std::atomic (受け渡し用のスロットの番号)
+#include <cstdint> // uint32_t
+
+/*
+ * TripleBuffer.h
+ * 役割:
+ *   書き込み側のスレッド 1 本と読み込み側のスレッド 1 本の間で、「最新の値」をロックなしで受け渡す
+ *   トリプルバッファ `TripleBuffer<T>` を定義します。
+ *   シミュレーションのスレッドが毎ステップ作るカメラの状態 (CameraSimulation.h) を、
+ *   描画のスレッドがフレームの初めに受け取るために使います。
+ *
+ * 仕組み:
+ *   - 値を入れるスロットを 3 つ持ち、それぞれ「書き込み側が使用中」「読み込み側が使用中」
+ *     「受け渡し用」のどれか 1 つの役割を持ちます。
+ *   - 書き込み側は自分のスロットに値を書いてから `Publish` で受け渡し用のスロットと交換し、
+ *     読み込み側は `Acquire` で新しい値があれば受け渡し用のスロットと交換します。
+ *     交換は受け渡し用のスロットの番号 (と「新しい」印) を入れた atomic 変数 1 つの exchange だけで行います。
+ *   - どちらの側も相手を待つことはありません。読み込み側が受け取る前に次の値が公開された場合、
+ *     古い値は捨てられます (読み込み側は常に最新の値だけを見る)。
+ *   - 読み込み側が Acquire してから次に Acquire するまで、ReadBuffer の値は変わりません。
+ *
+ * 使い方:
+ *   TripleBuffer<CameraSnapshot> buffer;
+ *   buffer.Reset(initial);                // スレッドを起動する前に 3 つのスロットを初期化する
+ *   // 書き込み側のスレッド
+ *   buffer.WriteBuffer() = snapshot;
+ *   buffer.Publish();
+ *   // 読み込み側のスレッド
+ *   buffer.Acquire();                      // 新しい値があれば受け取る
+ *   const CameraSnapshot& latest = buffer.ReadBuffer();
+ */
+
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 3 つのスロットを value にし、受け渡し用のスロットを「新しい値なし」にする
+    // (書き込み側・読み込み側のどちらのスレッドも使っていないときに呼ぶこと)
+    void Reset(const T& value) {
+        for (int i = 0; i < 3; ++i) { slots[i] = value; }
+        writeIndex = 0;
+        shared.store(1, std::memory_order_relaxed);
+        readIndex = 2;
+    }
+
+    // --- 書き込み側のスレッドだけが呼ぶ ---
+    // 次に公開する値を書き込むスロット (前に公開した値が残っているとは限らない)
+    T& WriteBuffer() { return slots[writeIndex]; }
+    // WriteBuffer に書いた値を公開し、受け渡し用だったスロットを次の書き込み先にする
+    void Publish() {
+        const uint32_t previous = shared.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    // --- 読み込み側のスレッドだけが呼ぶ ---
+    // 前の Acquire 以降に公開された値があれば受け取って true を返す (なければ何もせず false)
+    bool Acquire() {
+        if ((shared.load(std::memory_order_relaxed) & FRESH_BIT) == 0) { return false; }
+        const uint32_t previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+    // 最後に受け取った値 (まだ何も受け取っていなければ Reset の値)
+    const T& ReadBuffer() const { return slots[readIndex]; }
+
+private:
+    static const uint32_t INDEX_MASK = 3; // スロットの番号 (0～2)
+    static const uint32_t FRESH_BIT = 4;  // 受け渡し用のスロットに、まだ受け取られていない値がある印
+
+    T slots[3];
+    // 書き込み側と読み込み側の変数は、互いのキャッシュラインを汚さないように 64 バイト離して置く
+    alignas(64) uint32_t writeIndex = 0;           // 書き込み側が使用中のスロット (書き込み側だけが使う)
+    alignas(64) std::atomic<uint32_t> shared{ 1 }; // 受け渡し用のスロットの番号 | FRESH_BIT
+    alignas(64) uint32_t readIndex = 2;            // 読み込み側が使用中のスロット (読み込み側だけが使う)
+};
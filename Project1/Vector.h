@@ -1,110 +1,169 @@
 #pragma once
-#include <cmath> // sqrtf Ȃ (<math.h> 萄)
+#include <cmath> // sqrtf など (<math.h> より推奨)
+
+// x86/x64 向けにビルドする場合のみ SSE の組み込み関数を使う (Vector3DA と Matrix.h の行列演算用)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MATH_SSE 1
+#include <xmmintrin.h> // SSE の組み込み関数
+#endif
 
 /*
  * Vector.h
- * :
- *   3DԂɂxNgiʒuȂǁj\߂ `Vector3D` \̂ƁA
- *   xNgm̊{IȌvZiZAZAXJ[{Ȃǁjs߂
- *   ZqI[o[[h񋟂܂B
- *   ܂AxNg̒vZ␳KƂA悭g鑀̂߂
- *   o֐`Ă܂B
+ * 役割:
+ *   3D空間におけるベクトル（位置や方向など）を表すための `Vector3D` 構造体と、
+ *   ベクトル同士の基本的な計算（加算、減算、スカラー倍など）を行うための
+ *   演算子オーバーロードを提供します。
+ *   また、ベクトルの長さ計算や正規化といった、よく使われる操作のための
+ *   メンバ関数も定義されています。
  *
- * ̃o[Wł̕ύX_ ( Vector.h ):
- * - RXgN^̒ǉ: ftHglt̃RXgN^ǉA
- *   `Vector3D vec;`  `Vector3D pos(1, 2, 3);` ̂悤ɊȒPɏł悤ɂ܂B
- * - Zq const m: `operator+`, `operator-`, `operator*`  `const` ǉA
- *   ̉ZIuWFNg̏ԂύXȂƂ𖾎܂B
- * - LengthSq() ֐̒ǉ: xNg̒2vZ֐ǉ܂B
- *   ̑召rȂA(`sqrtf`)̌vZsvȂ̕łB
- * - Length() ֐̎ύX: `LengthSq()` 𗘗pĒvZ悤ɂ܂B
- * - Normalize() ֐̉P: [Zmɔ邽߁A2 (`LengthSq`) g
- *   [ɋ߂ǂ𔻒肷悤ɂA臒l (`1e-12f`) gp܂B
- *   [ɋ߂ꍇ̓[xNgɂ悤ɕύX܂B
- * - Normalized() ֐̒ǉ: ̃xNgύXɁAKꂽVxNg
- *   Ԃ֐ǉ܂B
- * - XJ[{̍Zq: `2.0f * vec` ̂悤ȋLq\ɂ鉉Zqǉ܂B
+ * このバージョンでの変更点 (元の Vector.h から):
+ * - コンストラクタの追加: デフォルト値付きのコンストラクタを追加し、
+ *   `Vector3D vec;` や `Vector3D pos(1, 2, 3);` のように簡単に初期化できるようにしました。
+ * - 演算子の const 正確性向上: `operator+`, `operator-`, `operator*` に `const` を追加し、
+ *   これらの演算がオブジェクトの状態を変更しないことを明示しました。
+ * - LengthSq() 関数の追加: ベクトルの長さの2乗を計算する関数を追加しました。
+ *   長さの大小比較だけなら、平方根(`sqrtf`)の計算が不要なこちらの方が高速です。
+ * - Length() 関数の実装変更: `LengthSq()` を利用して長さを計算するようにしました。
+ * - Normalize() 関数の改善: ゼロ除算をより確実に避けるため、長さの2乗 (`LengthSq`) を使って
+ *   ゼロに近いかどうかを判定するようにし、閾値 (`1e-12f`) を使用しました。
+ *   長さがゼロに近い場合はゼロベクトルにするように変更しました。
+ * - Normalized() 関数の追加: 元のベクトルを変更せずに、正規化された新しいベクトルを
+ *   返す関数を追加しました。
+ * - スカラー倍の左側演算子: `2.0f * vec` のような記述を可能にする演算子を追加しました。
+ * - Vector3DA 構造体の追加: Vector3D に使わない 4 つ目の成分を加えて 16 バイト境界に揃えた版です。
+ *   4 成分を 1 命令でまとめて読み書き・計算でき (SSE)、行列との演算 (Matrix.h, CameraMath.h) を
+ *   続けて行う場合や、多数の点を配列で持つ場合に使います。Vector3D とは相互に変換できます。
  *
- * g:
- *   - `#include "Vector.h"` CN[h܂B
- *   - `Vector3D position(10.0f, 0.0f, 5.0f);` ̂悤ɕϐ錾E܂B
- *   - `Vector3D velocity = vec1 + vec2;` ̂悤ɃxNgZs܂B
- *   - `float speed = velocity.Length();` ̂悤ɒ擾܂B
- *   - `Vector3D direction = velocity.Normalized();` ̂悤ɐKixNgj܂B
- *   - `velocity.Normalize();` ̂悤ɃxNgg𐳋K܂B
+ * 使い方:
+ *   - `#include "Vector.h"` をインクルードします。
+ *   - `Vector3D position(10.0f, 0.0f, 5.0f);` のように変数を宣言・初期化します。
+ *   - `Vector3D velocity = vec1 + vec2;` のようにベクトル演算を行います。
+ *   - `float speed = velocity.Length();` のように長さを取得します。
+ *   - `Vector3D direction = velocity.Normalized();` のように正規化（方向ベクトル化）します。
+ *   - `velocity.Normalize();` のようにベクトル自身を正規化します。
  */
 
 struct Vector3D
 {
-    float x, y, z; // xNg3̐
+    float x, y, z; // ベクトルの3つの成分
 
-    // RXgN^: IuWFNgɒl
-    // ȗꍇ 0.0f ŏ
+    // コンストラクタ: オブジェクト生成時に値を初期化
+    // 引数を省略した場合は 0.0f で初期化される
     Vector3D(float _x = 0.0f, float _y = 0.0f, float _z = 0.0f) : x(_x), y(_y), z(_z) {}
 
-    // --- Zq̃I[o[[h ---
-    // xNgm̉Z (v1 + v2)
+    // --- 演算子のオーバーロード ---
+    // ベクトル同士の加算 (v1 + v2)
     Vector3D operator+(const Vector3D& _vec) const { return { x + _vec.x, y + _vec.y, z + _vec.z }; }
-    // xNgZĎgɑ (v1 += v2)
+    // ベクトルを加算して自身に代入 (v1 += v2)
     void operator+=(const Vector3D& _vec) { x += _vec.x; y += _vec.y; z += _vec.z; }
-    // xNgm̌Z (v1 - v2)
+    // ベクトル同士の減算 (v1 - v2)
     Vector3D operator-(const Vector3D& _vec) const { return { x - _vec.x, y - _vec.y, z - _vec.z }; }
-    // xNgZĎgɑ (v1 -= v2)
+    // ベクトルを減算して自身に代入 (v1 -= v2)
     void operator-=(const Vector3D& _vec) { x -= _vec.x; y -= _vec.y; z -= _vec.z; }
-    // xNgƃXJ[l̏Z (vec * scale)
+    // ベクトルとスカラー値の乗算 (vec * scale)
     Vector3D operator*(float _scale) const { return { x * _scale, y * _scale, z * _scale }; }
-    // xNgɃXJ[lZĎgɑ (vec *= scale)
+    // ベクトルにスカラー値を乗算して自身に代入 (vec *= scale)
     void operator*=(float _scale) { x *= _scale; y *= _scale; z *= _scale; }
-    // (ZZq operator/ KvȂǉ\)
+    // (割り算演算子 operator/ も必要なら追加可能)
 
-    // --- o֐ ---
-    // xNg̒i傫Amj2vZ
-    // ̌vZ̓RXg߁APȑ召rȂǂł͂gƌǂ
+    // --- メンバ関数 ---
+    // ベクトルの長さ（大きさ、ノルム）の2乗を計算する
+    // 平方根の計算はコストが高いため、単純な大小比較などではこちらを使うと効率が良い
     float LengthSq() const {
         return x * x + y * y + z * z;
     }
 
-    // xNg̒i傫AmjvZ
+    // ベクトルの長さ（大きさ、ノルム）を計算する
     float Length() const {
-        return sqrtf(LengthSq()); // LengthSq()̌ʂ̕vZ
+        return sqrtf(LengthSq()); // LengthSq()の結果の平方根を計算
     }
 
-    // ̃xNgg𐳋Ki1Ɂj
-    // xNgƂĈꍇȂǂɎgp
+    // このベクトル自身を正規化（長さを1に）する
+    // 方向ベクトルとして扱いたい場合などに使用する
     void Normalize() {
-        float lenSq = LengthSq(); // ܂2vZ
-        // 2悪ɏl傫ꍇ̂ݐKs ([Z)
-        // 1e-12f  0.000000000001 (10-12)
+        float lenSq = LengthSq(); // まず長さの2乗を計算
+        // 長さの2乗が非常に小さい値より大きい場合のみ正規化処理を行う (ゼロ除算回避)
+        // 1e-12f は 0.000000000001 (10の-12乗)
         if (lenSq > 1e-12f) {
-            float len = sqrtf(lenSq); // vZ
-            float invLen = 1.0f / len; // Z̑ɋt|
+            float len = sqrtf(lenSq); // 長さを計算
+            float invLen = 1.0f / len; // 割り算の代わりに逆数を掛ける
             x *= invLen;
             y *= invLen;
             z *= invLen;
         }
         else {
-            // قڃ[̏ꍇ́AKłȂ̂Ń[xNgɂ
+            // 長さがほぼゼロの場合は、正規化できないのでゼロベクトルにする
             x = y = z = 0.0f;
         }
     }
 
-    // KꂽVxNg𐶐ĕԂ (̃xNg͕ύXȂ)
-    // : Vector3D direction = velocity.Normalized();
+    // 正規化された新しいベクトルを生成して返す (元のベクトルは変更しない)
+    // 例: Vector3D direction = velocity.Normalized();
     Vector3D Normalized() const {
-        Vector3D result = *this; // g̃Rs[쐬
-        result.Normalize();      // Rs[𐳋K
-        return result;           // KꂽRs[Ԃ
+        Vector3D result = *this; // 自分自身のコピーを作成
+        result.Normalize();      // コピーを正規化
+        return result;           // 正規化されたコピーを返す
     }
-    // ( Dot()  O Cross() ̊֐KvɉĒǉƕ֗)
+    // (内積 Dot() や 外積 Cross() の関数も必要に応じて追加すると便利)
     // static float Dot(const Vector3D& a, const Vector3D& b) { ... }
     // static Vector3D Cross(const Vector3D& a, const Vector3D& b) { ... }
 };
 
-// O[o֐: 3floatlVector3D쐬 (RXgN^̂ŕK{ł͂Ȃ)
-// _inline ̓CCWJRpCɒĂwq (̃RpCł͎Ŕf邱Ƃ)
+// グローバル関数: 3つのfloat値からVector3Dを作成する (コンストラクタがあるので必須ではない)
+// _inline はインライン展開をコンパイラに提案する指示子 (現代のコンパイラでは自動で判断することが多い)
 inline Vector3D SetVec3D(float _x, float _y, float _z) { return { _x, _y, _z }; }
 
-// O[o֐: XJ[lƃxNg̏Z (scale * vec ̏\ɂ)
+// グローバル関数: スカラー値とベクトルの乗算 (scale * vec の順序を可能にする)
 inline Vector3D operator*(float _scale, const Vector3D& _vec) {
-    return _vec * _scale; //  Vector3D::operator* Ăяo
-}
\ No newline at end of file
+    return _vec * _scale; // 既存の Vector3D::operator* を呼び出す
+}
+
+// Vector3D の 16 バイト版 (SIMD 用)
+// x, y, z の後ろに使わない成分 w (常に 0) を置いて 16 バイト境界に揃え、4 成分を 1 命令で計算する。
+// 各成分の計算は Vector3D と同じなので、同じ入力からは同じ結果になる。
+struct alignas(16) Vector3DA
+{
+    float x, y, z; // ベクトルの3つの成分
+    float w;       // 詰め物 (常に 0)
+
+    Vector3DA(float _x = 0.0f, float _y = 0.0f, float _z = 0.0f) : x(_x), y(_y), z(_z), w(0.0f) {}
+    explicit Vector3DA(const Vector3D& _vec) : x(_vec.x), y(_vec.y), z(_vec.z), w(0.0f) {}
+    // Vector3D に戻す
+    Vector3D ToVector3D() const { return { x, y, z }; }
+
+#if defined(MATH_SSE)
+    // 4 成分をまとめて読み書きする
+    // (32 ビットのヒープは 8 バイト境界しか保証しないので、境界を仮定しない命令を使う)
+    __m128 Load() const { return _mm_loadu_ps(&x); }
+    static Vector3DA FromRegister(__m128 _value) { Vector3DA result; _mm_storeu_ps(&result.x, _value); return result; }
+
+    Vector3DA operator+(const Vector3DA& _vec) const { return FromRegister(_mm_add_ps(Load(), _vec.Load())); }
+    Vector3DA operator-(const Vector3DA& _vec) const { return FromRegister(_mm_sub_ps(Load(), _vec.Load())); }
+    Vector3DA operator*(float _scale) const { return FromRegister(_mm_mul_ps(Load(), _mm_set1_ps(_scale))); }
+#else
+    Vector3DA operator+(const Vector3DA& _vec) const { return { x + _vec.x, y + _vec.y, z + _vec.z }; }
+    Vector3DA operator-(const Vector3DA& _vec) const { return { x - _vec.x, y - _vec.y, z - _vec.z }; }
+    Vector3DA operator*(float _scale) const { return { x * _scale, y * _scale, z * _scale }; }
+#endif
+    void operator+=(const Vector3DA& _vec) { *this = *this + _vec; }
+    void operator-=(const Vector3DA& _vec) { *this = *this - _vec; }
+    void operator*=(float _scale) { *this = *this * _scale; }
+
+    // 長さの2乗 (和の順序は Vector3D::LengthSq と同じ)
+    float LengthSq() const { return x * x + y * y + z * z; }
+    float Length() const { return sqrtf(LengthSq()); }
+    // 正規化された新しいベクトル (長さがほぼゼロならゼロベクトル。Vector3D::Normalize と同じ判定)
+    Vector3DA Normalized() const {
+        const float lenSq = LengthSq();
+        if (lenSq > 1e-12f) { return *this * (1.0f / sqrtf(lenSq)); }
+        return Vector3DA();
+    }
+};
+static_assert(sizeof(Vector3DA) == 16, "Vector3DA は 16 バイトである必要があります。");
+
+// 内積と外積
+inline float Dot(const Vector3DA& _a, const Vector3DA& _b) { return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z; }
+inline Vector3DA Cross(const Vector3DA& _a, const Vector3DA& _b) {
+    return { _a.y * _b.z - _a.z * _b.y, _a.z * _b.x - _a.x * _b.z, _a.x * _b.y - _a.y * _b.x };
+}
+inline Vector3DA operator*(float _scale, const Vector3DA& _vec) { return _vec * _scale; }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "WireMesh.h" // 対応するヘッダーファイル
+#include "Common.h"   // PI
+#include <cmath>      // sinf, cosf
+
+/*
+ * WireMesh.cpp
+ * 概要:
+ *   WireMesh クラスと、立方体・球のメッシュを作る関数の実装です。
+ */
+
+// 別のメッシュを変換して追加する
+void WireMesh::Append(const WireMesh& other, const Vector3D& center, float scale)
+{
+    const uint32_t base = static_cast<uint32_t>(VertexCount()); // 追加する頂点の番号のずれ
+    const size_t vertexCount = other.VertexCount();
+    version.Touch();
+    for (size_t i = 0; i < vertexCount; ++i) {
+        xs.push_back(center.x + other.xs[i] * scale);
+        ys.push_back(center.y + other.ys[i] * scale);
+        zs.push_back(center.z + other.zs[i] * scale);
+    }
+    for (const MeshEdge& e : other.edges) {
+        edges.push_back({ base + e.a, base + e.b });
+    }
+}
+
+// 全ての辺を線分に展開する
+void WireMesh::AppendSegments(SegmentBuffer& out) const
+{
+    for (const MeshEdge& e : edges) {
+        out.Append(GetVertex(e.a), GetVertex(e.b));
+    }
+}
+
+// ワイヤーフレームの立方体を作る (以前は Main.cpp の CreateCubeLines で 24 個の端点を作っていたもの)
+WireMesh CreateCubeMesh(float size, const Vector3D& center)
+{
+    WireMesh mesh;
+    const float halfSize = size * 0.5f;
+    mesh.Reserve(8, 12);
+    mesh.AddVertex(center + Vector3D{ -halfSize, -halfSize, -halfSize }); mesh.AddVertex(center + Vector3D{ halfSize, -halfSize, -halfSize });
+    mesh.AddVertex(center + Vector3D{ halfSize,  halfSize, -halfSize }); mesh.AddVertex(center + Vector3D{ -halfSize,  halfSize, -halfSize });
+    mesh.AddVertex(center + Vector3D{ -halfSize, -halfSize,  halfSize }); mesh.AddVertex(center + Vector3D{ halfSize, -halfSize,  halfSize });
+    mesh.AddVertex(center + Vector3D{ halfSize,  halfSize,  halfSize }); mesh.AddVertex(center + Vector3D{ -halfSize,  halfSize,  halfSize });
+    const uint32_t edges[12][2] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7}
+    };
+    for (const auto& edge : edges) {
+        mesh.AddEdge(edge[0], edge[1]);
+    }
+    return mesh;
+}
+
+// ワイヤーフレームの球を作る
+WireMesh CreateSphereMesh(const Vector3D& center, float radius, int latDivs, int lonDivs)
+{
+    WireMesh mesh;
+    // 頂点: 両極 2 個 + 緯線 (latDivs - 1) 本 * lonDivs 個
+    // 辺: 緯線 (latDivs - 1) 本 * lonDivs 区間 + 経線 lonDivs 本 * latDivs 区間
+    mesh.Reserve(static_cast<size_t>(2 + (latDivs - 1) * lonDivs), static_cast<size_t>((latDivs - 1) * lonDivs + lonDivs * latDivs));
+
+    // 緯線 i (1 ～ latDivs - 1) の j 番目の頂点の番号 (i = 0 が南極、i = latDivs が北極)
+    const uint32_t southPole = mesh.AddVertex({ center.x, center.y - radius, center.z });
+    const uint32_t northPole = mesh.AddVertex({ center.x, center.y + radius, center.z });
+    auto ringVertex = [&](int i, int j) -> uint32_t {
+        if (i == 0) { return southPole; }
+        if (i == latDivs) { return northPole; }
+        return static_cast<uint32_t>(2 + (i - 1) * lonDivs + (j % lonDivs));
+    };
+
+    // 頂点 (緯線の上の点。経線はこれを共有する)
+    for (int i = 1; i < latDivs; ++i) {
+        float phi = PI * ((float)i / latDivs - 0.5f);
+        float y = center.y + radius * sinf(phi);
+        float r = radius * cosf(phi);
+        for (int j = 0; j < lonDivs; ++j) {
+            float theta = 2.0f * PI * (float)j / lonDivs;
+            mesh.AddVertex({ center.x + r * cosf(theta), y, center.z + r * sinf(theta) });
+        }
+    }
+    // 緯線
+    for (int i = 1; i < latDivs; ++i) {
+        for (int j = 0; j < lonDivs; ++j) { mesh.AddEdge(ringVertex(i, j), ringVertex(i, j + 1)); }
+    }
+    // 経線
+    for (int j = 0; j < lonDivs; ++j) {
+        for (int i = 0; i < latDivs; ++i) { mesh.AddEdge(ringVertex(i, j), ringVertex(i + 1, j)); }
+    }
+    return mesh;
+}
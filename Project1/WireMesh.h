@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>         // size_t
+#include <cstdint>         // uint32_t
+#include <vector>          // std::vector
+#include "Vector.h"        // Vector3D
+#include "SegmentBuffer.h" // SegmentBuffer (FloatArray, 線分への展開)
+#include "GeometryVersion.h" // GeometryVersion (内容の版番号)
+
+/*
+ * WireMesh.h
+ * 役割:
+ *   頂点の配列と「辺 = 頂点番号の組」の配列で表すワイヤーフレームのメッシュ `WireMesh` を定義します (インデックス付きメッシュ)。
+ *   SegmentBuffer は線分ごとに両端の座標を持つため、立方体なら 8 個の頂点を 24 個の端点として持ち、
+ *   球なら内側の頂点を緯線と経線の両方で重複して持っていました。描画時にもその全ての端点を変換するため、
+ *   同じ頂点を何度も変換していました。
+ *
+ * 仕組み:
+ *   - 頂点は 1 つにつき 1 回だけ格納します (SegmentBuffer と同じく X, Y, Z の配列に分けた SoA 形式)。
+ *   - 辺は両端の頂点番号 (MeshEdge) だけを持ちます。
+ *   - 描画時 (WireframePipeline::Run の WireMesh 版) は、全頂点を 1 回ずつクリップ座標に変換して
+ *     キャッシュし、辺はそのキャッシュを頂点番号で引いてクリッピングします。
+ *     頂点を共有する辺が多いほど (立方体で 3 本、球で 4 本)、変換の回数とメモリが減ります。
+ *   - BVH や 2D グリッドのように線分単位で扱う処理には、AppendSegments で SegmentBuffer に展開して渡せます。
+ *   - 頂点や辺を変更するたびに版番号 (`GetVersion`) が変わります (SegmentBuffer と同じ。Camera::Draw の結果の使い回しに使う)。
+ *
+ * 使い方:
+ *   WireMesh cube = CreateCubeMesh(50.0f, { 0, 0, 50 });
+ *   WireMesh mesh;
+ *   uint32_t a = mesh.AddVertex({ 0, 0, 0 }), b = mesh.AddVertex({ 10, 0, 0 });
+ *   mesh.AddEdge(a, b);
+ *   pipeline.Run(mesh, viewProj, W, H, pool, out); // 頂点を 1 回ずつ変換して描画
+ */
+
+// 辺 (両端の頂点番号)
+struct MeshEdge {
+    uint32_t a, b;
+};
+
+class WireMesh
+{
+public:
+    // 座標配列の型 (SegmentBuffer と同じく 32 バイト境界に揃った float の vector)
+    typedef SegmentBuffer::FloatArray FloatArray;
+
+    // --- 容量・サイズ関連 ---
+    // 頂点 vertexCount 個、辺 edgeCount 本分の容量を事前に確保する
+    void Reserve(size_t vertexCount, size_t edgeCount) {
+        xs.reserve(vertexCount); ys.reserve(vertexCount); zs.reserve(vertexCount);
+        edges.reserve(edgeCount);
+    }
+    // 全ての頂点と辺を削除する (確保済みの容量は保持される)
+    void Clear() { xs.clear(); ys.clear(); zs.clear(); edges.clear(); version.Touch(); }
+    size_t VertexCount() const { return xs.size(); }
+    size_t EdgeCount() const { return edges.size(); }
+    bool Empty() const { return edges.empty(); }
+
+    // --- 追加 ---
+    // 頂点を追加し、その頂点番号を返す
+    uint32_t AddVertex(const Vector3D& v) {
+        xs.push_back(v.x); ys.push_back(v.y); zs.push_back(v.z);
+        version.Touch();
+        return static_cast<uint32_t>(xs.size() - 1);
+    }
+    // 頂点 a と頂点 b を結ぶ辺を追加する
+    void AddEdge(uint32_t a, uint32_t b) { edges.push_back({ a, b }); version.Touch(); }
+    // 頂点の数・辺の数を変更する (増えた分の値は未定)。SetVertex, SetEdge と組み合わせて、
+    // 取り込み処理 (MeshImporter.h) が複数のスレッドから別々の要素に直接書き込むために使う。
+    void ResizeVertices(size_t vertexCount) { xs.resize(vertexCount); ys.resize(vertexCount); zs.resize(vertexCount); version.Touch(); }
+    void ResizeEdges(size_t edgeCount) { edges.resize(edgeCount); version.Touch(); }
+    // SetVertex, SetEdge は要素ごとに版番号を変えない (全てのスレッドが同じ版番号に書き込み続けるのを避けるため)。
+    // 書き込みが全て終わったら、呼び出し側が MarkChanged を 1 回だけ呼ぶこと。
+    void SetVertex(size_t i, const Vector3D& v) { xs[i] = v.x; ys[i] = v.y; zs[i] = v.z; }
+    void SetEdge(size_t i, uint32_t a, uint32_t b) { edges[i] = { a, b }; }
+    // SetVertex, SetEdge で書き換えた内容を版番号に反映する
+    void MarkChanged() { version.Touch(); }
+    // 別のメッシュの全ての頂点を center + 頂点 * scale に変換して追加し、辺も頂点番号をずらして追加する
+    void Append(const WireMesh& other, const Vector3D& center = { 0.0f, 0.0f, 0.0f }, float scale = 1.0f);
+
+    // --- 参照 ---
+    Vector3D GetVertex(size_t i) const { return { xs[i], ys[i], zs[i] }; }
+    const MeshEdge& GetEdge(size_t i) const { return edges[i]; }
+    const std::vector<MeshEdge>& GetEdges() const { return edges; }
+    // 頂点の座標配列の先頭ポインタ (要素数は VertexCount())
+    const float* X() const { return xs.data(); }
+    const float* Y() const { return ys.data(); }
+    const float* Z() const { return zs.data(); }
+    // 内容の版番号 (頂点や辺を変更するたびに変わる。プログラム全体で一意)
+    uint64_t GetVersion() const { return version.Get(); }
+
+    // 全ての辺を線分に展開して out の末尾に追加する (線分単位で扱う BVH などに渡す場合に使う)
+    void AppendSegments(SegmentBuffer& out) const;
+
+private:
+    FloatArray xs, ys, zs;       // 頂点の座標 (1 頂点につき 1 回だけ格納)
+    std::vector<MeshEdge> edges; // 辺 (両端の頂点番号)
+    GeometryVersion version;     // 内容の版番号
+};
+
+// ワイヤーフレームの立方体 (頂点 8 個、辺 12 本) を作る
+WireMesh CreateCubeMesh(float size, const Vector3D& center);
+// ワイヤーフレームの球 (緯線 latDivs - 1 本と、経線 lonDivs 本) を作る。
+// 頂点は両極の 2 個と、緯線の上の (latDivs - 1) * lonDivs 個で、緯線と経線で共有する。
+WireMesh CreateSphereMesh(const Vector3D& center, float radius, int latDivs, int lonDivs);
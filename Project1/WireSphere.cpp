@@ -0,0 +1,90 @@
+#include "WireSphere.h" // 対応するヘッダーファイル
+#include "Common.h"     // PI
+#include <cfloat>       // FLT_MAX
+#include <cmath>        // cosf, sqrtf, tanf
+#include <vector>       // std::vector (一括判定の入力と結果)
+
+/*
+ * WireSphere.cpp
+ * 概要:
+ *   WireSphere クラスの実装です (球のメッシュ自体は WireMesh.cpp の CreateSphereMesh で作ります)。
+ *   LOD ごとの単位球 (中心が原点、半径 1) は最初に使われたときに 1 回だけ作り、全ての球で共有します。
+ */
+
+const float WireSphere::MAX_SCREEN_ERROR_PIXELS = 0.5f;
+
+namespace {
+    // LOD ごとの経線方向の分割数 (粗い順。緯線方向の分割数はこの半分)
+    const int LOD_LON_DIVS[] = { 6, 12, 24, 48, 96 };
+    const int LOD_COUNT = static_cast<int>(sizeof(LOD_LON_DIVS) / sizeof(LOD_LON_DIVS[0]));
+
+    // LOD ごとの単位球のメッシュ (最初に呼ばれたときに作る。C++11 以降、関数内の static の初期化はスレッドセーフ)
+    const std::vector<WireMesh>& GetUnitSphereLods() {
+        static const std::vector<WireMesh> lods = [] {
+            std::vector<WireMesh> result;
+            for (int lod = 0; lod < LOD_COUNT; ++lod) {
+                result.push_back(CreateSphereMesh({ 0.0f, 0.0f, 0.0f }, 1.0f, LOD_LON_DIVS[lod] / 2, LOD_LON_DIVS[lod]));
+            }
+            return result;
+        }();
+        return lods;
+    }
+}
+
+// 球の画面上の半径 (ピクセル)
+float WireSphere::GetProjectedRadius(const Vector3D& eye, float fovY, float viewportHeight) const {
+    const Vector3D d = center - eye;
+    const float distSq = d.x * d.x + d.y * d.y + d.z * d.z;
+    const float radiusSq = radius * radius;
+    if (distSq <= radiusSq) { return FLT_MAX; } // カメラが球の中にいる
+    // 球を見込む半角 α は sin α = r / 距離。画面上では tan α / tan(fovY / 2) * (画面の高さ / 2) ピクセルになる
+    const float tanAlpha = radius / sqrtf(distSq - radiusSq);
+    return tanAlpha / tanf(fovY * 0.5f) * (viewportHeight * 0.5f);
+}
+
+// 画面上の誤差が許容値以下になる最も粗い LOD を選ぶ
+int WireSphere::SelectLod(float projectedRadius) {
+    for (int lod = 0; lod < LOD_COUNT; ++lod) {
+        // lonDivs 分割の円の、弦と円弧の最大のずれ (ピクセル)
+        const float error = projectedRadius * (1.0f - cosf(PI / static_cast<float>(LOD_LON_DIVS[lod])));
+        if (error <= MAX_SCREEN_ERROR_PIXELS) { return lod; }
+    }
+    return LOD_COUNT - 1; // どの LOD でも誤差が大きい場合は最も細かいものを使う
+}
+
+// 単位球のメッシュを、この球の位置と大きさに変換して追加する
+void WireSphere::AppendLines(int lod, WireMesh& out) const {
+    out.Append(GetUnitSphereLods()[lod], center, radius);
+}
+
+int WireSphere::GetLodCount() { return LOD_COUNT; }
+int WireSphere::GetLodLonDivs(int lod) { return LOD_LON_DIVS[lod]; }
+size_t WireSphere::GetLodSegmentCount(int lod) { return GetUnitSphereLods()[lod].EdgeCount(); }
+size_t WireSphere::GetLodVertexCount(int lod) { return GetUnitSphereLods()[lod].VertexCount(); }
+
+// 全ての球を、それぞれに合った LOD で追加する
+void AppendSphereLines(const std::vector<WireSphere>& spheres, const Vector3D& eye, float fovY, float viewportHeight, WireMesh& out) {
+    for (const WireSphere& sphere : spheres) {
+        sphere.AppendLines(WireSphere::SelectLod(sphere.GetProjectedRadius(eye, fovY, viewportHeight)), out);
+    }
+}
+
+// 視錐台の外にない球だけを、それぞれに合った LOD で追加する
+void AppendSphereLines(const std::vector<WireSphere>& spheres, const Frustum& frustum, const Vector3D& eye, float fovY,
+    float viewportHeight, WireMesh& out) {
+    // 一括判定の入力 (中心と半径を成分ごとの配列にする)
+    const size_t count = spheres.size();
+    std::vector<float> xs(count), ys(count), zs(count), radii(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3D& center = spheres[i].GetCenter();
+        xs[i] = center.x; ys[i] = center.y; zs[i] = center.z;
+        radii[i] = spheres[i].GetRadius();
+    }
+    std::vector<FrustumTest> results(count);
+    TestSpheresBatch(frustum, xs.data(), ys.data(), zs.data(), radii.data(), count, results.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        if (results[i] == FrustumTest::Outside) { continue; } // 視錐台の外: 線分を作らない
+        spheres[i].AppendLines(WireSphere::SelectLod(spheres[i].GetProjectedRadius(eye, fovY, viewportHeight)), out);
+    }
+}
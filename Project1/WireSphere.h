@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>          // std::vector
+#include "CameraMath.h"    // Frustum
+#include "Vector.h"        // Vector3D
+#include "WireMesh.h"      // WireMesh
+
+/*
+ * WireSphere.h
+ * 役割:
+ *   ワイヤーフレームの球 `WireSphere` と、その LOD (Level of Detail: 詳細度) の選び方を定義します。
+ *   以前は Main.cpp の CreateSphereLines で決まった分割数 (12×24) の線分を作り、
+ *   静的な線分リストに入れていたため、遠くの球も近くの球も同じ本数の線分を使い、
+ *   近くの球は角ばって見えていました。
+ *
+ * 仕組み:
+ *   - 半径 1 の球を、分割数の違う数種類 (LOD) であらかじめ作っておきます (全ての球で共有)。
+ *   - 毎フレーム、球の画面上の半径 (ピクセル) を、カメラからの距離・垂直視野角 (fovY)・
+ *     画面の高さから求めます。
+ *   - 経線方向に lonDivs 分割した円の、弦と円弧の最大のずれ (サジッタ) は r * (1 - cos(π / lonDivs)) なので、
+ *     これが MAX_SCREEN_ERROR_PIXELS ピクセル以下になる最も粗い LOD を選びます (画面上の誤差で選ぶ)。
+ *   - 選んだ LOD の単位球を、球の中心と半径で変換して、そのフレームのメッシュに追加します。
+ *     単位球はインデックス付きメッシュ (WireMesh.h) なので、緯線と経線が共有する頂点は 1 回ずつだけ変換されます。
+ *
+ * 使い方:
+ *   std::vector<WireSphere> spheres = { WireSphere({ 80, 0, 80 }, 30) };
+ *   WireMesh frameMesh;
+ *   // 毎フレーム
+ *   frameMesh.Clear();
+ *   AppendSphereLines(spheres, camera->GetFrustum(), camera->GetPosition(), camera->GetFovY(), WINDOW_HEIGHT, frameMesh);
+ *   // (視錐台を渡すと、視錐台の外にある球は境界球の一括判定で省かれる)
+ */
+
+class WireSphere
+{
+public:
+    // 許容する画面上の誤差 (ピクセル)。これ以下の誤差になる最も粗い LOD が選ばれる
+    static const float MAX_SCREEN_ERROR_PIXELS;
+
+    WireSphere(const Vector3D& center, float radius) : center(center), radius(radius) {}
+
+    // 球の画面上の半径 (ピクセル) を求める
+    // eye: カメラの位置, fovY: 垂直視野角 (ラジアン), viewportHeight: 画面の高さ (ピクセル)
+    // カメラが球の中にある場合は非常に大きな値を返す (最も細かい LOD になる)。
+    float GetProjectedRadius(const Vector3D& eye, float fovY, float viewportHeight) const;
+
+    // 画面上の半径 projectedRadius (ピクセル) に対して使う LOD の番号を返す (0 が最も粗い)
+    static int SelectLod(float projectedRadius);
+
+    // LOD 番号 lod の頂点と辺を、この球の位置と大きさに変換して out の末尾に追加する
+    void AppendLines(int lod, WireMesh& out) const;
+
+    // --- LOD の情報 ---
+    static int GetLodCount();
+    static int GetLodLonDivs(int lod);    // 経線方向の分割数 (緯線方向はこの半分)
+    static size_t GetLodSegmentCount(int lod); // 辺の本数
+    static size_t GetLodVertexCount(int lod);  // 頂点の数
+
+    const Vector3D& GetCenter() const { return center; }
+    float GetRadius() const { return radius; }
+
+private:
+    Vector3D center; // 中心のワールド座標
+    float radius;    // 半径
+};
+
+// spheres の全ての球を、カメラから見た大きさに合った LOD で out の末尾に追加する
+void AppendSphereLines(const std::vector<WireSphere>& spheres, const Vector3D& eye, float fovY, float viewportHeight, WireMesh& out);
+// spheres のうち視錐台 frustum の外にない球だけを、同じように out の末尾に追加する
+// (全ての球の境界球を TestSpheresBatch でまとめて判定してから、映る球の線分だけを作る)
+void AppendSphereLines(const std::vector<WireSphere>& spheres, const Frustum& frustum, const Vector3D& eye, float fovY,
+    float viewportHeight, WireMesh& out);
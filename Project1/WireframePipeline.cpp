@@ -0,0 +1,334 @@
+#include "WireframePipeline.h" // 対応するヘッダーファイル
+#include "ThreadPool.h"        // ThreadPool (並列処理)
+#include "Profiler.h"          // PROFILE_SCOPE (変換・クリッピングの時間の計測)
+#include <algorithm>           // std::min, std::max
+#include <cfloat>              // FLT_MAX
+
+/*
+ * WireframePipeline.cpp
+ * 概要:
+ *   WireframePipeline クラスの実装です。
+ *   1 ブロック分の処理 (ProcessBlock) は次の順に行います。
+ *     1. ブロック内の全端点を TransformPointsBatch でクリップ座標に一括変換
+ *     2. ComputeOutCodesBatch で全端点のアウトコードを一括計算
+ *     3. ClassifySegments で線分を accept / reject / clip に振り分け
+ *     4. accept の線分はそのまま、clip の線分は ClipLineCohenSutherland で切り取ってから
+ *        スクリーン座標に変換して出力
+ *   ただし、クリッピング不要 (needsClipping が false) のブロックは 1 の後すぐにスクリーン座標に変換します。
+ *   BlockVisibilityCache を渡された場合は、3 の後にブロックの分類と余裕を記録し (StoreBlockVisibility)、
+ *   次のフレームで使い回せるブロックは、内側なら 1 の後すぐにスクリーン座標に変換し、外なら何もしません。
+ *   インデックス付きメッシュは、1 と 2 を全頂点について先に行い (TransformMeshVertices)、
+ *   3 と 4 を辺ごとに頂点番号でキャッシュを引いて行います (ProcessMeshBlock)。
+ *   処理時間は、1 を DrawTransform、2～4 を DrawClip としてブロックごとに記録します (Profiler.h)。
+ */
+
+// 静的定数メンバーの定義 (値はヘッダー側で指定。std::min などで参照として使うために必要)
+const size_t WireframePipeline::DRAW_BLOCK_SEGMENTS;
+const size_t WireframePipeline::PARALLEL_DRAW_MIN_SEGMENTS;
+
+namespace {
+    // 点のクリップ座標 (x, y, z, w) の、視錐台の平面 plane (アウトコードのビットの順: 左, 右, 下, 上, Near, Far) までの
+    // 符号付きの距離 (内側が正)。scales は各平面の係数 (ComputePlaneScales)。
+    float PlaneDistance(int plane, float x, float y, float z, float w, const float* scales) {
+        switch (plane) {
+        case 0: return (w + x) * scales[0]; // 左 (x >= -w)
+        case 1: return (w - x) * scales[1]; // 右 (x <= w)
+        case 2: return (w + y) * scales[2]; // 下 (y >= -w)
+        case 3: return (w - y) * scales[3]; // 上 (y <= w)
+        case 4: return z * scales[4];       // Near (z >= 0)
+        default: return (w - z) * scales[5]; // Far (z <= w)
+        }
+    }
+
+    // クリップ座標の w+x などを、ワールド座標の平面までの距離にする係数 (Frustum::FromViewProjection の平面の長さの逆数)
+    void ComputePlaneScales(const Matrix& m, float* scales) {
+        const Frustum::Plane planes[Frustum::PLANE_COUNT] = {
+            { m.m[0][3] + m.m[0][0], m.m[1][3] + m.m[1][0], m.m[2][3] + m.m[2][0], 0.0f },
+            { m.m[0][3] - m.m[0][0], m.m[1][3] - m.m[1][0], m.m[2][3] - m.m[2][0], 0.0f },
+            { m.m[0][3] + m.m[0][1], m.m[1][3] + m.m[1][1], m.m[2][3] + m.m[2][1], 0.0f },
+            { m.m[0][3] - m.m[0][1], m.m[1][3] - m.m[1][1], m.m[2][3] - m.m[2][1], 0.0f },
+            { m.m[0][2], m.m[1][2], m.m[2][2], 0.0f },
+            { m.m[0][3] - m.m[0][2], m.m[1][3] - m.m[1][2], m.m[2][3] - m.m[2][2], 0.0f } };
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            const float length = std::sqrt(planes[k].a * planes[k].a + planes[k].b * planes[k].b + planes[k].c * planes[k].c);
+            scales[k] = (length > 0.0f) ? 1.0f / length : 0.0f;
+        }
+    }
+}
+
+// 全線分を処理してスクリーン座標の線分リストを作る
+void WireframePipeline::Run(const SegmentBuffer& worldLines, const Matrix& viewProjMatrix,
+    float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out,
+    BlockVisibilityCache* visibility)
+{
+    // 全線分を 1 つの範囲 (クリッピングあり) として処理する
+    wholeRange.assign(1, SegmentRange{ 0, worldLines.Size(), true });
+    Run(worldLines, wholeRange, viewProjMatrix, viewportWidth, viewportHeight, pool, out, visibility);
+}
+
+// 指定された範囲の線分を処理してスクリーン座標の線分リストを作る
+void WireframePipeline::Run(const SegmentBuffer& worldLines, const std::vector<SegmentRange>& ranges, const Matrix& viewProjMatrix,
+    float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out,
+    BlockVisibilityCache* visibility)
+{
+    out.clear();
+
+    // 各範囲を DRAW_BLOCK_SEGMENTS 本ずつのブロックに区切る
+    // (区切り方は範囲だけで決まり、スレッド数には関係しない)
+    blocks.clear();
+    size_t segmentCount = 0; // 処理する線分の総数
+    for (const SegmentRange& range : ranges) {
+        for (size_t first = range.first; first < range.first + range.count; first += DRAW_BLOCK_SEGMENTS) {
+            const size_t count = std::min(DRAW_BLOCK_SEGMENTS, range.first + range.count - first);
+            blocks.push_back({ first, count, range.needsClipping });
+        }
+        segmentCount += range.count;
+    }
+    if (segmentCount == 0) { return; }
+    const size_t blockCount = blocks.size();
+
+    // 前のフレームの分類を、今回のブロックの区切り方に合わせる (区切り方が変わったブロックは分類し直す)
+    if (visibility != nullptr) {
+        visibility->BeginRun(&worldLines, worldLines.GetVersion(), blocks);
+        ComputePlaneScales(viewProjMatrix, planeScales);
+    }
+
+    // 変換結果とアウトコードの格納先を全端点分の大きさにしておく
+    // (ここで大きさを決めておけば、各ブロックは自分の範囲に書き込むだけで済む)
+    clipPoints.Resize(worldLines.PointCount());
+    outCodes.resize(worldLines.PointCount());
+
+    // 線分が少ない場合、またはスレッドプールがない場合は、現在のスレッドでブロックを順番に処理する
+    // (並列処理のときと同じ区切り方にしているので、出力の順番も同じになる)
+    if (pool == nullptr || pool->GetWorkerCount() <= 1 || segmentCount < PARALLEL_DRAW_MIN_SEGMENTS) {
+        if (workerScratch.empty()) { workerScratch.resize(1); }
+        for (size_t block = 0; block < blockCount; ++block) {
+            ProcessBlock(worldLines, viewProjMatrix, block, viewportWidth, viewportHeight, visibility, workerScratch[0], out);
+        }
+        return;
+    }
+
+    // ブロックごとに、スレッドプールで並列に処理する
+    if (workerScratch.size() < pool->GetWorkerCount()) { workerScratch.resize(pool->GetWorkerCount()); }
+    if (blockOutputs.size() < blockCount) { blockOutputs.resize(blockCount); }
+
+    pool->ParallelFor(blockCount, [&](size_t block, unsigned int worker) {
+        std::vector<ScreenSegment>& blockOut = blockOutputs[block];
+        blockOut.clear();
+        ProcessBlock(worldLines, viewProjMatrix, block, viewportWidth, viewportHeight, visibility, workerScratch[worker], blockOut);
+    });
+
+    // ブロックの番号順に連結する (スレッド数に関係なく同じ順番になる)
+    size_t total = 0;
+    for (size_t block = 0; block < blockCount; ++block) { total += blockOutputs[block].size(); }
+    out.reserve(total);
+    for (size_t block = 0; block < blockCount; ++block) {
+        out.insert(out.end(), blockOutputs[block].begin(), blockOutputs[block].end());
+    }
+}
+
+// 1 ブロック分の線分を処理する
+void WireframePipeline::ProcessBlock(const SegmentBuffer& worldLines, const Matrix& viewProjMatrix, size_t blockIndex,
+    float viewportWidth, float viewportHeight, BlockVisibilityCache* visibility, WorkerScratch& scratch,
+    std::vector<ScreenSegment>& out)
+{
+    const SegmentRange& block = blocks[blockIndex];
+    // 前のフレームの分類が今回も使えるか (クリッピング不要と分かっている範囲は調べるまでもない)
+    BlockVisibility reused = BlockVisibility::Unknown;
+    if (visibility != nullptr && block.needsClipping) { reused = visibility->TryReuse(blockIndex); }
+    // 前のフレームから視錐台の外と分かっているブロック: 変換もしない
+    if (reused == BlockVisibility::Outside) { return; }
+
+    const size_t firstSegment = block.first;
+    const size_t segmentCount = block.count;
+    const size_t firstPoint = 2 * firstSegment; // ブロック先頭の端点の添字
+    const size_t pointCount = 2 * segmentCount; // ブロック内の端点の数
+
+    // 1. ブロック内の全端点をクリップ座標へ一括変換 (SSE2/AVX2)
+    {
+        PROFILE_SCOPE(ProfileStage::DrawTransform);
+        TransformPointsBatch(worldLines.X() + firstPoint, worldLines.Y() + firstPoint, worldLines.Z() + firstPoint, pointCount,
+            viewProjMatrix, clipPoints.x.data() + firstPoint, clipPoints.y.data() + firstPoint,
+            clipPoints.z.data() + firstPoint, clipPoints.w.data() + firstPoint);
+    }
+
+    PROFILE_SCOPE(ProfileStage::DrawClip);
+    ScreenSegment screen;
+
+    // 視錐台の完全に内側と分かっているブロック: アウトコードもクリッピングも不要なので、そのままスクリーン座標へ
+    // (前のフレームから内側のままと分かっているブロックも、両端点が内部の線分だけなので同じ結果になる)
+    if (!block.needsClipping || reused == BlockVisibility::Inside) {
+        for (size_t i = firstSegment; i < firstSegment + segmentCount; ++i) {
+            if (ClipToScreen(clipPoints.Get(2 * i), clipPoints.Get(2 * i + 1), viewportWidth, viewportHeight, screen)) {
+                out.push_back(screen);
+            }
+        }
+        return;
+    }
+
+    // 2. ブロック内の全端点のアウトコードを一括計算
+    ComputeOutCodesBatch(clipPoints.x.data() + firstPoint, clipPoints.y.data() + firstPoint,
+        clipPoints.z.data() + firstPoint, clipPoints.w.data() + firstPoint, pointCount, outCodes.data() + firstPoint);
+
+    // 3. 線分を accept / reject / clip の 3 つのリストに振り分け
+    SegmentClassification& classification = scratch.classification;
+    ClassifySegments(outCodes.data(), firstSegment, segmentCount, classification);
+    if (visibility != nullptr) { StoreBlockVisibility(worldLines, blockIndex, classification, *visibility); }
+
+    // 4-1. 両端点が視錐台の内部にある線分: クリッピングせずにそのままスクリーン座標へ
+    for (size_t k = 0; k < classification.acceptedCount; ++k) {
+        const size_t i = classification.accepted[k];
+        if (ClipToScreen(clipPoints.Get(2 * i), clipPoints.Get(2 * i + 1), viewportWidth, viewportHeight, screen)) {
+            out.push_back(screen);
+        }
+    }
+
+    // 4-2. 視錐台の境界をまたぐ線分: Cohen-Sutherlandアルゴリズムで切り取ってからスクリーン座標へ
+    //      (reject リストの線分は完全に視錐台の外なので何もしない)
+    for (size_t k = 0; k < classification.clippedCount; ++k) {
+        const size_t i = classification.clipped[k];
+        Vector4D p1_clipped = clipPoints.Get(2 * i);
+        Vector4D p2_clipped = clipPoints.Get(2 * i + 1);
+        // アウトコードは計算済みのものを渡す
+        if (ClipLineCohenSutherland(p1_clipped, p2_clipped, outCodes[2 * i], outCodes[2 * i + 1]) &&
+            ClipToScreen(p1_clipped, p2_clipped, viewportWidth, viewportHeight, screen)) {
+            out.push_back(screen);
+        }
+    }
+}
+
+// 振り分け済みのブロックの分類と余裕を記録する
+void WireframePipeline::StoreBlockVisibility(const SegmentBuffer& worldLines, size_t blockIndex,
+    const SegmentClassification& classification, BlockVisibilityCache& visibility) const
+{
+    const SegmentRange& block = blocks[blockIndex];
+    // 境界をまたぐ線分があるブロックは、次のフレームでもアウトコードを計算し直す
+    BlockVisibility state = BlockVisibility::Straddling;
+    if (classification.acceptedCount == block.count) { state = BlockVisibility::Inside; }
+    else if (classification.rejectedCount == block.count) { state = BlockVisibility::Outside; }
+    if (state == BlockVisibility::Straddling) {
+        visibility.Store(blockIndex, state, 0.0f, 0.0f);
+        return;
+    }
+
+    // 余裕: 内側のブロックは、全ての点の全ての平面までの距離の最小値。
+    // 外のブロックは、線分ごとに「両端点が外にある平面のうち、外側への距離が最も大きいもの」の最小値。
+    const Vector3D& eye = visibility.GetPose().position;
+    const float* xs = worldLines.X();
+    const float* ys = worldLines.Y();
+    const float* zs = worldLines.Z();
+    float margin = FLT_MAX;
+    float maxDistanceSq = 0.0f;
+    for (size_t i = block.first; i < block.first + block.count; ++i) {
+        const size_t p1 = 2 * i, p2 = 2 * i + 1;
+        if (state == BlockVisibility::Inside) {
+            for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+                margin = std::min(margin, PlaneDistance(k, clipPoints.x[p1], clipPoints.y[p1], clipPoints.z[p1], clipPoints.w[p1], planeScales));
+                margin = std::min(margin, PlaneDistance(k, clipPoints.x[p2], clipPoints.y[p2], clipPoints.z[p2], clipPoints.w[p2], planeScales));
+            }
+        }
+        else {
+            const int shared = outCodes[p1] & outCodes[p2]; // 両端点が外にある平面 (外のブロックでは 0 にならない)
+            float segmentMargin = 0.0f;
+            for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+                if (!(shared & (1 << k))) { continue; }
+                const float outside = -std::max(
+                    PlaneDistance(k, clipPoints.x[p1], clipPoints.y[p1], clipPoints.z[p1], clipPoints.w[p1], planeScales),
+                    PlaneDistance(k, clipPoints.x[p2], clipPoints.y[p2], clipPoints.z[p2], clipPoints.w[p2], planeScales));
+                segmentMargin = std::max(segmentMargin, outside);
+            }
+            margin = std::min(margin, segmentMargin);
+        }
+        // カメラから最も遠い点までの距離 (向きが変わったときの平面の動きの大きさに効く)
+        for (size_t p = p1; p <= p2; ++p) {
+            const float dx = xs[p] - eye.x, dy = ys[p] - eye.y, dz = zs[p] - eye.z;
+            maxDistanceSq = std::max(maxDistanceSq, dx * dx + dy * dy + dz * dz);
+        }
+    }
+    visibility.Store(blockIndex, state, margin, std::sqrt(maxDistanceSq));
+}
+
+// インデックス付きメッシュの全ての辺を処理してスクリーン座標の線分リストを作る
+void WireframePipeline::Run(const WireMesh& mesh, const Matrix& viewProjMatrix,
+    float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out)
+{
+    out.clear();
+    const size_t edgeCount = mesh.EdgeCount();
+    if (edgeCount == 0) { return; }
+    const size_t vertexCount = mesh.VertexCount();
+
+    // 辺を DRAW_BLOCK_SEGMENTS 本ずつのブロックに区切る (辺は両端の頂点が変換済みなので、区切り方は辺の数だけで決まる)
+    blocks.clear();
+    for (size_t first = 0; first < edgeCount; first += DRAW_BLOCK_SEGMENTS) {
+        blocks.push_back({ first, std::min(DRAW_BLOCK_SEGMENTS, edgeCount - first), true });
+    }
+    const size_t blockCount = blocks.size();
+    // 頂点は、線分のブロックの端点の数と同じ 2 * DRAW_BLOCK_SEGMENTS 個ずつのブロックで変換する
+    const size_t vertexBlockSize = 2 * DRAW_BLOCK_SEGMENTS;
+    const size_t vertexBlockCount = (vertexCount + vertexBlockSize - 1) / vertexBlockSize;
+
+    // 頂点のクリップ座標とアウトコードのキャッシュを全頂点分の大きさにしておく
+    clipPoints.Resize(vertexCount);
+    outCodes.resize(vertexCount);
+
+    // 辺が少ない場合、またはスレッドプールがない場合は、現在のスレッドで順番に処理する
+    if (pool == nullptr || pool->GetWorkerCount() <= 1 || edgeCount < PARALLEL_DRAW_MIN_SEGMENTS) {
+        TransformMeshVertices(mesh, viewProjMatrix, 0, vertexCount);
+        for (size_t block = 0; block < blockCount; ++block) {
+            ProcessMeshBlock(mesh, blocks[block], viewportWidth, viewportHeight, out);
+        }
+        return;
+    }
+
+    // 1. 全頂点を並列に変換する (辺の処理は任意の頂点を参照するので、全て終わってから次へ進む)
+    pool->ParallelFor(vertexBlockCount, [&](size_t block, unsigned int) {
+        const size_t first = block * vertexBlockSize;
+        TransformMeshVertices(mesh, viewProjMatrix, first, std::min(vertexBlockSize, vertexCount - first));
+    });
+
+    // 2. 辺のブロックごとに並列に処理し、ブロックの番号順に連結する
+    if (blockOutputs.size() < blockCount) { blockOutputs.resize(blockCount); }
+    pool->ParallelFor(blockCount, [&](size_t block, unsigned int) {
+        std::vector<ScreenSegment>& blockOut = blockOutputs[block];
+        blockOut.clear();
+        ProcessMeshBlock(mesh, blocks[block], viewportWidth, viewportHeight, blockOut);
+    });
+    size_t total = 0;
+    for (size_t block = 0; block < blockCount; ++block) { total += blockOutputs[block].size(); }
+    out.reserve(total);
+    for (size_t block = 0; block < blockCount; ++block) {
+        out.insert(out.end(), blockOutputs[block].begin(), blockOutputs[block].end());
+    }
+}
+
+// メッシュの頂点の範囲をクリップ座標に変換し、アウトコードを計算する
+void WireframePipeline::TransformMeshVertices(const WireMesh& mesh, const Matrix& viewProjMatrix, size_t firstVertex, size_t count)
+{
+    PROFILE_SCOPE(ProfileStage::DrawTransform);
+    TransformPointsBatch(mesh.X() + firstVertex, mesh.Y() + firstVertex, mesh.Z() + firstVertex, count,
+        viewProjMatrix, clipPoints.x.data() + firstVertex, clipPoints.y.data() + firstVertex,
+        clipPoints.z.data() + firstVertex, clipPoints.w.data() + firstVertex);
+    ComputeOutCodesBatch(clipPoints.x.data() + firstVertex, clipPoints.y.data() + firstVertex,
+        clipPoints.z.data() + firstVertex, clipPoints.w.data() + firstVertex, count, outCodes.data() + firstVertex);
+}
+
+// メッシュの辺の範囲を処理する (頂点は変換済み)
+void WireframePipeline::ProcessMeshBlock(const WireMesh& mesh, const SegmentRange& block,
+    float viewportWidth, float viewportHeight, std::vector<ScreenSegment>& out)
+{
+    PROFILE_SCOPE(ProfileStage::DrawClip);
+    const std::vector<MeshEdge>& edges = mesh.GetEdges();
+    ScreenSegment screen;
+    for (size_t i = block.first; i < block.first + block.count; ++i) {
+        const MeshEdge& edge = edges[i];
+        const int code1 = outCodes[edge.a], code2 = outCodes[edge.b];
+        if ((code1 & code2) != 0) { continue; } // 両端が同じ面の外側: 完全に視錐台の外
+        Vector4D p1_clipped = clipPoints.Get(edge.a);
+        Vector4D p2_clipped = clipPoints.Get(edge.b);
+        // 両端が内側ならそのまま、境界をまたぐなら Cohen-Sutherland で切り取ってからスクリーン座標へ
+        if ((code1 | code2) != 0 && !ClipLineCohenSutherland(p1_clipped, p2_clipped, code1, code2)) { continue; }
+        if (ClipToScreen(p1_clipped, p2_clipped, viewportWidth, viewportHeight, screen)) {
+            out.push_back(screen);
+        }
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cmath>                  // std::fabs
+#include <cstddef>                // size_t
+#include <cstdint>                // uint8_t
+#include <vector>                 // std::vector
+#include "Matrix.h"               // Matrix
+#include "CameraMath.h"           // ClipSpacePoints, Frustum
+#include "Clipping.h"             // SegmentClassification
+#include "SegmentBuffer.h"        // SegmentBuffer
+#include "WireMesh.h"             // WireMesh
+#include "BlockVisibilityCache.h" // BlockVisibilityCache (前のフレームの分類の使い回し)
+
+class ThreadPool;
+
+/*
+ * WireframePipeline.h
+ * 役割:
+ *   ワールド空間の線分を「クリップ座標への変換 → クリッピング → スクリーン座標への変換」と処理し、
+ *   画面に描く線分 (`ScreenSegment`) のリストを作る処理をまとめたものです。
+ *   以前は Camera::Draw の中で直接行っていた処理を、描画 API (DxLib) から切り離して関数にしました。
+ *
+ * ブロック単位の処理と並列化:
+ *   - 線分を `DRAW_BLOCK_SEGMENTS` 本ずつの「ブロック」に区切り、ブロックごとに処理します。
+ *   - 各ブロックの線分は互いに独立しているため、ブロックを複数のスレッドに分担させられます。
+ *   - 各ブロックの結果はブロック専用のリストに書き込み、最後にブロックの番号順に連結します。
+ *     ブロックの区切り方はスレッド数に関係なく一定なので、何スレッドで処理しても
+ *     出力されるリストの内容と順番は常に同じになります (決定的)。
+ *   - 線分の本数が `PARALLEL_DRAW_MIN_SEGMENTS` より少ない場合は、スレッドを使わずに
+ *     呼び出し元のスレッドだけで処理します (スレッドを起こすコストの方が大きいため)。
+ *
+ * 範囲を指定した処理 (視錐台カリングとの組み合わせ):
+ *   - `SegmentRange` のリストを渡すと、その範囲の線分だけを処理します (範囲外の線分は変換もしません)。
+ *     範囲は `DRAW_BLOCK_SEGMENTS` 本ずつのブロックに区切られ、上と同じ方法で処理されます。
+ *   - `needsClipping` が false の範囲 (BVH で視錐台の完全に内側と分かった部分) は、
+ *     アウトコードの計算とクリッピングを省略して、変換した線分をそのままスクリーン座標にします。
+ *
+ * 前のフレームの分類の使い回し (時間的コヒーレンス):
+ *   - SegmentBuffer を処理する Run に `BlockVisibilityCache` を渡すと、ブロックごとに前のフレームの分類
+ *     (完全に内側 / 完全に外 / 境界をまたぐ) を記録し、カメラの動きが小さくて分類が変わり得ないブロックでは
+ *     それを使い回します (BlockVisibilityCache.h)。
+ *   - 完全に内側のブロックは、needsClipping が false の範囲と同じくアウトコードの計算とクリッピングを省略し、
+ *     完全に外のブロックは変換もしません。出力される線分は、使い回さない場合と同じです。
+ *
+ * インデックス付きメッシュ (WireMesh) の処理:
+ *   - 最初に全頂点を 1 回ずつクリップ座標に変換し、アウトコードも頂点ごとに 1 回だけ計算してキャッシュします。
+ *   - 次に辺を DRAW_BLOCK_SEGMENTS 本ずつのブロックに区切り、両端の頂点番号でキャッシュを引いて
+ *     accept / reject / clip を判定します。どちらの段階もブロック単位で並列に処理でき、出力の順番は一定です。
+ *
+ * 使い方:
+ *   WireframePipeline pipeline;
+ *   std::vector<ScreenSegment> visible;
+ *   pipeline.Run(worldLines, viewProjMatrix, WINDOW_WIDTH, WINDOW_HEIGHT, threadPool, visible);
+ *   for (const ScreenSegment& s : visible) { DrawLine(...); }
+ */
+
+// スクリーン座標系の線分 (ピクセル単位。左上が原点で Y は下向き)
+struct ScreenSegment {
+    float x1, y1; // 始点
+    float x2, y2; // 終点
+};
+
+class WireframePipeline
+{
+public:
+    // 1 ブロックあたりの線分の本数 (並列処理の単位)
+    static const size_t DRAW_BLOCK_SEGMENTS = 4096;
+    // この本数以上の線分があるときだけ並列処理する
+    static const size_t PARALLEL_DRAW_MIN_SEGMENTS = 16384;
+
+    // worldLines の全線分を viewProjMatrix で変換・クリッピングし、
+    // 幅 viewportWidth × 高さ viewportHeight のスクリーン座標に変換した線分を out に書き込む。
+    // pool が nullptr でなく、線分が十分に多い場合はスレッドプールで並列に処理する。
+    // out の以前の内容は消去される (容量は保持される)。
+    // visibility が nullptr でなければ、ブロックの分類を記録し、前のフレームの分類を使い回せるブロックでは
+    // アウトコードの計算を省略する (visibility の SetPose は呼び出し元が先に済ませておくこと)。
+    void Run(const SegmentBuffer& worldLines, const Matrix& viewProjMatrix,
+        float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out,
+        BlockVisibilityCache* visibility = nullptr);
+    // worldLines のうち、ranges で指定された範囲の線分だけを処理する (それ以外は上の Run と同じ)。
+    // 出力は ranges の順番 (各範囲の中はブロックの順番) に並ぶ。
+    void Run(const SegmentBuffer& worldLines, const std::vector<SegmentRange>& ranges, const Matrix& viewProjMatrix,
+        float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out,
+        BlockVisibilityCache* visibility = nullptr);
+    // mesh の全ての辺を処理する (頂点は 1 回ずつだけ変換する)。出力は辺の順番に並ぶ。
+    void Run(const WireMesh& mesh, const Matrix& viewProjMatrix,
+        float viewportWidth, float viewportHeight, ThreadPool* pool, std::vector<ScreenSegment>& out);
+
+private:
+    // ワーカーごとの作業領域 (同時に動くワーカー同士で共有しないもの)
+    struct WorkerScratch {
+        SegmentClassification classification; // ブロック内の線分の振り分け結果
+    };
+
+    // blocks[blockIndex] を 1 ブロックとして処理し、結果を out に追加する
+    // (visibility があれば、前のフレームの分類を使い回すか、今回の分類を記録する)
+    void ProcessBlock(const SegmentBuffer& worldLines, const Matrix& viewProjMatrix, size_t blockIndex,
+        float viewportWidth, float viewportHeight, BlockVisibilityCache* visibility, WorkerScratch& scratch,
+        std::vector<ScreenSegment>& out);
+    // 振り分け済みのブロックの分類と、分類が変わらない余裕を求めて visibility に記録する
+    void StoreBlockVisibility(const SegmentBuffer& worldLines, size_t blockIndex,
+        const SegmentClassification& classification, BlockVisibilityCache& visibility) const;
+    // メッシュの頂点 [firstVertex, firstVertex + count) をクリップ座標に変換し、アウトコードを計算する
+    void TransformMeshVertices(const WireMesh& mesh, const Matrix& viewProjMatrix, size_t firstVertex, size_t count);
+    // メッシュの辺の範囲 block を、変換済みの頂点を使って処理し、結果を out に追加する
+    void ProcessMeshBlock(const WireMesh& mesh, const SegmentRange& block,
+        float viewportWidth, float viewportHeight, std::vector<ScreenSegment>& out);
+
+    ClipSpacePoints clipPoints;                           // 全端点 (メッシュなら全頂点) のクリップ座標 (各ブロックは自分の範囲だけに書き込む)
+    std::vector<uint8_t> outCodes;                        // 全端点 (メッシュなら全頂点) のアウトコード (同上)
+    std::vector<WorkerScratch> workerScratch;             // ワーカーごとの作業領域
+    std::vector<SegmentRange> wholeRange;                 // 範囲を指定しない Run で使う「全線分」の範囲
+    std::vector<SegmentRange> blocks;                     // 処理する範囲をブロックに区切ったもの
+    float planeScales[Frustum::PLANE_COUNT] = {};         // クリップ座標の w+x などを、視錐台の各平面までの距離にする係数
+    std::vector<std::vector<ScreenSegment>> blockOutputs; // ブロックごとの出力 (フレームをまたいで使い回す)
+};
+
+// クリップ済みの線分 (クリップ座標) をスクリーン座標に変換する関数
+// w がゼロに近くパースペクティブ除算できない場合は false を返す
+inline bool ClipToScreen(const Vector4D& p1_clipped, const Vector4D& p2_clipped,
+    float viewportWidth, float viewportHeight, ScreenSegment& out)
+{
+    // パースペクティブ除算の前に w 成分がゼロに近くないかチェック
+    if (!(std::fabs(p1_clipped.w) > 1e-6f && std::fabs(p2_clipped.w) > 1e-6f)) { return false; }
+    // NDC座標を計算 (x/w, y/w)
+    const float ndcX1 = p1_clipped.x / p1_clipped.w, ndcY1 = p1_clipped.y / p1_clipped.w;
+    const float ndcX2 = p2_clipped.x / p2_clipped.w, ndcY2 = p2_clipped.y / p2_clipped.w;
+    // NDC[-1, 1] をスクリーン座標 [0, 幅/高さ] にマッピング。Y軸は反転。
+    const float hW = viewportWidth / 2.f, hH = viewportHeight / 2.f;
+    out.x1 = ndcX1 * hW + hW;
+    out.y1 = -ndcY1 * hH + hH;
+    out.x2 = ndcX2 * hW + hW;
+    out.y2 = -ndcY2 * hH + hH;
+    return true;
+}